@@ -20,6 +20,7 @@
 #include <fstream>
 
 #include "ArchivePacket.h"
+#include "ColumnarArchive.h"
 #include "VantageProtocolConstants.h"
 #include "VantageDecoder.h"
 #include "Weather.h"
@@ -27,12 +28,13 @@
 using namespace std;
 using namespace vws;
 
-static const char USAGE_MESSAGE[] = "Usage: archive-dumper [-v] [-b] <filename>\n    where: -v = verbose\n           -b = binary";
+static const char USAGE_MESSAGE[] = "Usage: archive-dumper [-v] [-b] [-c] <filename>\n    where: -v = verbose\n           -b = binary\n           -c = columnar archive blocks";
 
 int
 main(int argc, char *argv[]) {
     bool verbose = false;
     bool dumpBinary = false;
+    bool dumpColumns = false;
     char *file = NULL;
 
     for (int i = 1; i < argc; i++) {
@@ -41,6 +43,8 @@ main(int argc, char *argv[]) {
                 verbose = true;
             else if (strcmp(argv[i], "-b") == 0)
                 dumpBinary = true;
+            else if (strcmp(argv[i], "-c") == 0)
+                dumpColumns = true;
             else  {
                 cerr << USAGE_MESSAGE << endl;
                 exit(1);
@@ -58,6 +62,12 @@ main(int argc, char *argv[]) {
 
     VantageDecoder::setRainCollectorSize(.01);
 
+    if (dumpColumns) {
+        ColumnarArchive columnarArchive(string(file) + COLUMNAR_ARCHIVE_FILE_SUFFIX);
+        columnarArchive.dump(cout);
+        exit(0);
+    }
+
     char buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
 
     ifstream stream(file, ifstream::in | ios::binary);
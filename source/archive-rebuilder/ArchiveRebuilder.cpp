@@ -14,17 +14,35 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <set>
+#include <map>
+#include <array>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include "ArchivePacket.h"
+#include "ArchiveIndex.h"
+#include "MappedArchiveFile.h"
+#include "PacketSegmentStore.h"
 
 using namespace std;
 using namespace vws;
 
 const std::string BASE_ARCHIVE_FILE = "weather-archive-base.dat";
 
+typedef array<vws::byte, ArchivePacket::BYTES_PER_ARCHIVE_PACKET> Record;
+
+/**
+ * Add a record to the set of records to be written to the archive. If there is already a record with the same time, the first one is kept.
+ */
+void
+addRecord(const vws::byte * record, map<int32, Record> & records) {
+    int32 key = MappedArchiveFile::recordTimeKey(record);
+    if (records.find(key) == records.end()) {
+        Record & entry = records[key];
+        std::copy(record, record + ArchivePacket::BYTES_PER_ARCHIVE_PACKET, entry.begin());
+    }
+}
+
 int
 main(int argc, char *argv[]) {
     if (argc != 3) {
@@ -45,34 +63,94 @@ main(int argc, char *argv[]) {
         exit(3);
     }
 
-    set<filesystem::path> files;
+    //
+    // The records are sorted by time, so the segments and any packet files that were saved before the segments
+    // were introduced can be read in any order
+    //
+    map<int32, Record> records;
+
+    vector<string> segmentFiles;
+    PacketSegmentStore::findSegmentFiles(directory, segmentFiles);
+
+    int corruptRecords = 0;
+    vector<vws::byte> segmentRecords;
+    for (const string & segmentFile : segmentFiles) {
+        int segmentCorruptRecords;
+        segmentRecords.clear();
+        if (!PacketSegmentStore::readSegment(segmentFile, segmentRecords, segmentCorruptRecords)) {
+            cerr << "Failed to read segment file '" << segmentFile << "'" << endl;
+            continue;
+        }
+
+        corruptRecords += segmentCorruptRecords;
+        for (size_t offset = 0; offset < segmentRecords.size(); offset += ArchivePacket::BYTES_PER_ARCHIVE_PACKET)
+            addRecord(&segmentRecords[offset], records);
+    }
+
+    cout << "Read " << records.size() << " records from " << segmentFiles.size() << " segment files. Corrupt records: " << corruptRecords << endl;
+
+    //
+    // The packet files are in the yyyy/mm/dd directories below the year directories of the segments
+    //
+    int packetFileCount = 0;
+    ArchivePacket packet;
+    for (const filesystem::directory_entry & yearEntry : filesystem::directory_iterator(directory)) {
+        if (!yearEntry.is_directory())
+            continue;
+
+        for (const filesystem::directory_entry & monthEntry : filesystem::directory_iterator(yearEntry.path())) {
+            if (!monthEntry.is_directory())
+                continue;
 
-    for (const filesystem::directory_entry & dir_entry : filesystem::recursive_directory_iterator(directory)) {
-        cout << dir_entry.path() << endl;
-        if (dir_entry.is_regular_file())
-            files.insert(dir_entry.path());
+            for (const filesystem::directory_entry & fileEntry : filesystem::recursive_directory_iterator(monthEntry.path())) {
+                if (!fileEntry.is_regular_file())
+                    continue;
+
+                if (!packet.updateArchivePacketDataFromFile(fileEntry.path().string()))
+                    cerr << "Failed to load packet from file '" << fileEntry.path() << "'" << endl;
+                else {
+                    addRecord(packet.getBuffer(), records);
+                    packetFileCount++;
+                }
+            }
+        }
     }
 
+    if (packetFileCount > 0)
+        cout << "Read " << packetFileCount << " packet files" << endl;
+
     //
     // First copy any base archive file to the output file
     //
+    int32 baseArchiveEnd = 0;
     if (std::filesystem::exists(BASE_ARCHIVE_FILE)) {
         std::filesystem::copy(BASE_ARCHIVE_FILE, outputFile);
+        MappedArchiveFile baseArchive(BASE_ARCHIVE_FILE);
+        if (baseArchive.getRecordCount() > 0)
+            baseArchiveEnd = MappedArchiveFile::recordTimeKey(baseArchive.getRecord(baseArchive.getRecordCount() - 1));
     }
 
     //
-    // Now append each of the packets to the output file
+    // Now append the records that are newer than the base archive to the output file
     //
-    ArchivePacket packet;
-    ofstream ofs(outputFile, fstream::binary);
-    for (auto path : files) {
-        cout << "Path: " << path << endl;
-        if (!packet.updateArchivePacketDataFromFile(path.string())) {
-            cerr << "Failed to load packet from file '" << path << "'" << endl;
-        }
-        else
-            ofs.write(packet.getBuffer(), ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+    ofstream ofs(outputFile, fstream::binary | fstream::app);
+    int recordCount = 0;
+    for (const auto & entry : records) {
+        if (entry.first <= baseArchiveEnd)
+            continue;
+
+        ofs.write(entry.second.data(), ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        recordCount++;
     }
 
     ofs.close();
+
+    cout << "Wrote " << recordCount << " records to '" << outputFile << "'" << endl;
+
+    //
+    // Build the index for the new archive so it does not need to be built when the archive is first used
+    //
+    MappedArchiveFile archive(outputFile);
+    ArchiveIndex index(string(outputFile) + ARCHIVE_INDEX_FILE_SUFFIX);
+    index.rebuild(archive);
 }
@@ -17,9 +17,9 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
-#include "ArchiveManager.h"
-#include "ArchivePacket.h"
-#include "Weather.h"
+#include "ArchiveVerification.h"
+#include "ColumnarArchive.h"
+#include "MappedArchiveFile.h"
 
 using namespace std;
 using namespace vws;
@@ -38,27 +38,28 @@ main(int argc, char *argv[]) {
         exit(1);
     }
 
-    const char * archiveDir = NULL;
-    const char * archiveFile = NULL;
-
     if (filesystem::is_directory(argv[1])) {
         cerr << "Specified file '" << argv[1] << "' is a directory not a file." << endl;
         exit(1);
     }
 
-    filesystem::path path(argv[1]);
-    if (!path.has_parent_path()) {
-        cerr << "Directory not found in path '" << argv[1] << "' Using '.' as archive directory" << endl;
-        archiveDir = ".";
-    }
-    else {
-        archiveDir = path.parent_path().c_str();
-    }
-
-    archiveFile = path.filename().c_str();
-
-    ArchiveManager mgr(archiveDir, archiveFile);
-
-    mgr.verifyArchiveFile(argv[1]);
+    //
+    // The report is written to stdout as JSON so it can be processed by other tools, any other messages go to stderr
+    //
+    MappedArchiveFile archive(argv[1]);
+    ArchiveVerification verification(archive);
+    verification.verify();
+    cout << verification.formatJSON(argv[1]) << endl;
 
+    //
+    // The columnar archive is optional, so it is only verified if it exists
+    //
+    string columnFile = string(argv[1]) + COLUMNAR_ARCHIVE_FILE_SUFFIX;
+    if (filesystem::exists(columnFile)) {
+        ColumnarArchive columnarArchive(columnFile);
+        if (columnarArchive.verify(archive))
+            cerr << "Columnar archive file '" << columnFile << "' with " << columnarArchive.getMonthCount() << " months matches the archive" << endl;
+        else
+            cerr << "Columnar archive file '" << columnFile << "' does not match the archive" << endl;
+    }
 }
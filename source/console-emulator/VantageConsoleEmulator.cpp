@@ -0,0 +1,679 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "VantageConsoleEmulator.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <time.h>
+#include <string.h>
+#include <sstream>
+#include <chrono>
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "MappedArchiveFile.h"
+#include "VantageEepromConstants.h"
+#include "VantageCRC.h"
+#include "VantageLogger.h"
+#include "Weather.h"
+
+using namespace std;
+using namespace vws::ProtocolConstants;
+
+namespace vws {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+VantageConsoleEmulator::Settings
+VantageConsoleEmulator::defaultSettings() {
+    Settings settings;
+    settings.baudRate = 19200;
+    settings.responseLatencyMillis = 0;
+    settings.loopIntervalMillis = 2000;
+    settings.crcErrorRate = 0.0;
+    settings.wakeupFailures = 0;
+    settings.clockOffsetSeconds = 0;
+    settings.randomSeed = 1;
+    return settings;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+VantageConsoleEmulator::VantageConsoleEmulator(const Settings & settings) : settings(settings),
+                                                                            masterFd(-1),
+                                                                            slaveFd(-1),
+                                                                            running(false),
+                                                                            archive(NUM_ARCHIVE_RECORDS * ArchivePacket::BYTES_PER_ARCHIVE_PACKET, static_cast<byte>(0xFF)),
+                                                                            nextArchiveIndex(0),
+                                                                            archiveRecordCount(0),
+                                                                            clockOffset(settings.clockOffsetSeconds),
+                                                                            remainingWakeupFailures(settings.wakeupFailures),
+                                                                            statistics{},
+                                                                            randomGenerator(settings.randomSeed),
+                                                                            logger(VantageLogger::getLogger("VantageConsoleEmulator")) {
+    //
+    // A console reporting steady pressure, 70.0 F inside, 65.0 F outside and a light south wind
+    //
+    memset(loopPacket, 0, sizeof(loopPacket));
+    loopPacket[0] = 'L';
+    loopPacket[1] = 'O';
+    loopPacket[2] = 'O';
+    loopPacket[4] = LoopPacket::LOOP_PACKET_TYPE;
+    BitConverter::getBytes(29920, loopPacket, 7, 2);
+    BitConverter::getBytes(700, loopPacket, 9, 2);
+    loopPacket[11] = 45;
+    BitConverter::getBytes(650, loopPacket, 12, 2);
+    loopPacket[14] = 5;
+    loopPacket[15] = 5;
+    BitConverter::getBytes(180, loopPacket, 16, 2);
+    loopPacket[33] = 60;
+    BitConverter::getBytes(0xFFFF, loopPacket, 48, 2);
+    loopPacket[95] = LINE_FEED;
+    loopPacket[96] = CARRIAGE_RETURN;
+
+    memset(loop2Packet, 0, sizeof(loop2Packet));
+    loop2Packet[0] = 'L';
+    loop2Packet[1] = 'O';
+    loop2Packet[2] = 'O';
+    loop2Packet[4] = Loop2Packet::LOOP2_PACKET_TYPE;
+    BitConverter::getBytes(29920, loop2Packet, 7, 2);
+    BitConverter::getBytes(700, loop2Packet, 9, 2);
+    loop2Packet[11] = 45;
+    BitConverter::getBytes(650, loop2Packet, 12, 2);
+    loop2Packet[95] = LINE_FEED;
+    loop2Packet[96] = CARRIAGE_RETURN;
+
+    memset(hiLowPacket, 0, sizeof(hiLowPacket));
+    memset(eeprom, 0, sizeof(eeprom));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+VantageConsoleEmulator::~VantageConsoleEmulator() {
+    stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageConsoleEmulator::start() {
+    if (running)
+        return true;
+
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open pseudo-terminal (" << logger.strerror() << ")" << endl;
+        return false;
+    }
+
+    if (grantpt(masterFd) != 0 || unlockpt(masterFd) != 0 || ptsname(masterFd) == nullptr) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to unlock pseudo-terminal (" << logger.strerror() << ")" << endl;
+        stop();
+        return false;
+    }
+
+    devicePath = ptsname(masterFd);
+
+    //
+    // The terminal must be raw before the station connects, otherwise the commands are echoed back to the station
+    //
+    slaveFd = ::open(devicePath.c_str(), O_RDWR | O_NOCTTY);
+    struct termios tio;
+    if (slaveFd < 0 || tcgetattr(slaveFd, &tio) != 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open pseudo-terminal device '" << devicePath << "' (" << logger.strerror() << ")" << endl;
+        stop();
+        return false;
+    }
+
+    cfmakeraw(&tio);
+    tcsetattr(slaveFd, TCSANOW, &tio);
+
+    logger.log(VantageLogger::VANTAGE_INFO) << "Console emulator listening on " << devicePath << endl;
+
+    running = true;
+    protocolThread = std::thread(&VantageConsoleEmulator::serviceProtocol, this);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::stop() {
+    running = false;
+    if (protocolThread.joinable())
+        protocolThread.join();
+
+    if (slaveFd >= 0) {
+        ::close(slaveFd);
+        slaveFd = -1;
+    }
+
+    if (masterFd >= 0) {
+        ::close(masterFd);
+        masterFd = -1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const string &
+VantageConsoleEmulator::getDevicePath() const {
+    return devicePath;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::addArchiveRecord(const byte record[]) {
+    std::lock_guard<std::mutex> guard(mutex);
+    memcpy(&archive[nextArchiveIndex * ArchivePacket::BYTES_PER_ARCHIVE_PACKET], record, ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+    nextArchiveIndex = (nextArchiveIndex + 1) % NUM_ARCHIVE_RECORDS;
+    if (archiveRecordCount < NUM_ARCHIVE_RECORDS)
+        archiveRecordCount++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::addArchiveRecords(DateTime start, int periodSeconds, int count) {
+    byte record[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+
+    for (int i = 0; i < count; i++) {
+        memset(record, 0xFF, sizeof(record));
+        DateTimeFields fields(start + (static_cast<DateTime>(i) * periodSeconds));
+        int datestamp = fields.getMonthDay() + (fields.getMonth() * 32) + ((fields.getYear() - 2000) * 512);
+        int timestamp = (fields.getHour() * 100) + fields.getMinute();
+        BitConverter::getBytes(datestamp, record, 0, 2);
+        BitConverter::getBytes(timestamp, record, 2, 2);
+        BitConverter::getBytes(600 + (i % 100), record, 4, 2);
+        record[33] = 0;
+        record[42] = 0;
+        addArchiveRecord(record);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::setLoopPacket(const byte packet[]) {
+    std::lock_guard<std::mutex> guard(mutex);
+    memcpy(loopPacket, packet, sizeof(loopPacket));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::setLoop2Packet(const byte packet[]) {
+    std::lock_guard<std::mutex> guard(mutex);
+    memcpy(loop2Packet, packet, sizeof(loop2Packet));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::setEeprom(unsigned address, const byte data[], unsigned count) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (address + count <= EEPROM_SIZE)
+        memcpy(&eeprom[address], data, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::getEeprom(unsigned address, byte data[], unsigned count) const {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (address + count <= EEPROM_SIZE)
+        memcpy(data, &eeprom[address], count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+DateTime
+VantageConsoleEmulator::getConsoleTime() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return time(0) + clockOffset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+VantageConsoleEmulator::Statistics
+VantageConsoleEmulator::getStatistics() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return statistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::serviceProtocol() {
+    string command;
+    byte b;
+
+    while (running) {
+        if (!readByte(b, POLL_INTERVAL_MILLIS))
+            continue;
+
+        //
+        // A line feed by itself is a wake up request, otherwise it terminates a command
+        //
+        if (b == LINE_FEED) {
+            if (command.empty())
+                wakeup();
+            else {
+                processCommand(command);
+                command.clear();
+            }
+        }
+        else if (b == ACK && command.empty()) {
+            //
+            // The station ACKs the DMPAFT page count even when there are no pages to send, the console ignores
+            // an ACK that is not part of a command
+            //
+            continue;
+        }
+        else if (b != CARRIAGE_RETURN)
+            command.append(1, b);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::processCommand(const string & command) {
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Received command '" << command << "'" << endl;
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        statistics.commands++;
+    }
+
+    if (settings.responseLatencyMillis > 0)
+        Weather::sleep(settings.responseLatencyMillis);
+
+    istringstream iss(command);
+    string name;
+    iss >> name;
+
+    if (name == LOOP_CMD) {
+        int count = 1;
+        iss >> count;
+        send(&ACK, 1);
+        sendLoopPackets(count, false);
+    }
+    else if (name == "LPS") {
+        int packetTypes = 1;
+        int count = 1;
+        iss >> packetTypes >> count;
+        send(&ACK, 1);
+        sendLoopPackets(count, (packetTypes & 0x2) != 0);
+    }
+    else if (name == HIGH_LOW_CMD) {
+        send(&ACK, 1);
+        byte packet[HILOW_PACKET_SIZE];
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            memcpy(packet, hiLowPacket, sizeof(packet));
+        }
+        sendBlockWithCRC(packet, sizeof(packet));
+    }
+    else if (name == DUMP_ARCHIVE_CMD) {
+        send(&ACK, 1);
+        int firstPage;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            firstPage = archiveRecordCount < NUM_ARCHIVE_RECORDS ? 0 : nextArchiveIndex / RECORDS_PER_PAGE;
+        }
+        sendArchivePages(firstPage, ARCHIVE_PAGES, false);
+    }
+    else if (name == DUMP_AFTER_CMD) {
+        send(&ACK, 1);
+        processDumpAfter();
+    }
+    else if (name == READ_EEPROM_AS_BINARY_CMD || name == WRITE_EEPROM_AS_BINARY_CMD) {
+        unsigned address = 0;
+        unsigned count = 0;
+        iss >> hex >> address >> count;
+        if (count == 0 || address + count > EEPROM_SIZE) {
+            send(&NACK, 1);
+            return;
+        }
+
+        send(&ACK, 1);
+        byte data[EEPROM_SIZE];
+        if (name == READ_EEPROM_AS_BINARY_CMD) {
+            getEeprom(address, data, count);
+            sendBlockWithCRC(data, count);
+        }
+        else if (receiveBlock(data, count)) {
+            setEeprom(address, data, count);
+            send(&ACK, 1);
+        }
+    }
+    else if (name == DUMP_EEPROM_CMD) {
+        send(&ACK, 1);
+        byte data[EEPROM_SIZE];
+        getEeprom(0, data, sizeof(data));
+        sendBlockWithCRC(data, sizeof(data));
+    }
+    else if (name == WRITE_EEPROM_CMD) {
+        unsigned address = EEPROM_SIZE;
+        unsigned value = 0;
+        iss >> hex >> address >> value;
+        if (address >= EEPROM_SIZE)
+            return;
+
+        byte b = static_cast<byte>(value);
+        setEeprom(address, &b, 1);
+        send(COMMAND_RECOGNIZED_RESPONSE.data(), COMMAND_RECOGNIZED_RESPONSE.length());
+    }
+    else if (name == SET_ARCHIVE_PERIOD_CMD) {
+        int period = 0;
+        iss >> period;
+        byte b = static_cast<byte>(period);
+        setEeprom(EepromConstants::EE_ARCHIVE_PERIOD_ADDRESS, &b, 1);
+        send(COMMAND_RECOGNIZED_RESPONSE.data(), COMMAND_RECOGNIZED_RESPONSE.length());
+    }
+    else if (name == GET_TIME_CMD) {
+        send(&ACK, 1);
+        struct tm tm;
+        Weather::localtime(getConsoleTime(), tm);
+        byte data[6];
+        data[0] = static_cast<byte>(tm.tm_sec);
+        data[1] = static_cast<byte>(tm.tm_min);
+        data[2] = static_cast<byte>(tm.tm_hour);
+        data[3] = static_cast<byte>(tm.tm_mday);
+        data[4] = static_cast<byte>(tm.tm_mon + 1);
+        data[5] = static_cast<byte>(tm.tm_year);
+        sendBlockWithCRC(data, sizeof(data));
+    }
+    else if (name == SET_TIME_CMD) {
+        send(&ACK, 1);
+        byte data[6];
+        if (receiveBlock(data, sizeof(data))) {
+            struct tm tm = {};
+            tm.tm_sec = data[0];
+            tm.tm_min = data[1];
+            tm.tm_hour = data[2];
+            tm.tm_mday = data[3];
+            tm.tm_mon = data[4] - 1;
+            tm.tm_year = data[5];
+            tm.tm_isdst = -1;
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                clockOffset = mktime(&tm) - time(0);
+            }
+            send(&ACK, 1);
+        }
+    }
+    else
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Ignoring command '" << command << "' that is not emulated" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::sendLoopPackets(int count, bool includeLoop2) {
+    byte packet[LoopPacket::LOOP_PACKET_SIZE];
+
+    for (int i = 0; i < count && running; i++) {
+        //
+        // Any character from the station, which is normally a wake up request, cancels the packets
+        //
+        if (i > 0) {
+            auto deadline = chrono::steady_clock::now() + chrono::milliseconds(settings.loopIntervalMillis);
+            while (running && !isInputAvailable() && chrono::steady_clock::now() < deadline) {
+                int remaining = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+                struct pollfd pfd = {masterFd, POLLIN, 0};
+                poll(&pfd, 1, std::min(remaining, POLL_INTERVAL_MILLIS));
+            }
+
+            if (isInputAvailable()) {
+                VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Loop packets canceled after " << i << " packets" << endl;
+                return;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (includeLoop2 && i % 2 == 1)
+                memcpy(packet, loop2Packet, sizeof(packet));
+            else {
+                memcpy(packet, loopPacket, sizeof(packet));
+                BitConverter::getBytes(nextArchiveIndex, packet, 5, 2);
+            }
+
+            statistics.loopPackets++;
+        }
+
+        sendBlockWithCRC(packet, LoopPacket::LOOP_PACKET_SIZE - CRC_BYTES);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::processDumpAfter() {
+    byte data[4];
+    if (!receiveBlock(data, sizeof(data)))
+        return;
+
+    send(&ACK, 1);
+
+    //
+    // The date/time stamps of the command have the same encoding as the stamps of the archive records
+    //
+    int32 afterKey = MappedArchiveFile::recordTimeKey(data);
+    int firstIndex = -1;
+    int pageCount = 0;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        int oldestIndex = archiveRecordCount < NUM_ARCHIVE_RECORDS ? 0 : nextArchiveIndex;
+        for (int i = 0; i < archiveRecordCount; i++) {
+            int index = (oldestIndex + i) % NUM_ARCHIVE_RECORDS;
+            if (MappedArchiveFile::recordTimeKey(&archive[index * ArchivePacket::BYTES_PER_ARCHIVE_PACKET]) > afterKey) {
+                firstIndex = index;
+                break;
+            }
+        }
+
+        if (firstIndex >= 0) {
+            //
+            // When the ring has wrapped the oldest and newest records can share a page, so count the records rather than the pages
+            //
+            int newestIndex = (nextArchiveIndex + NUM_ARCHIVE_RECORDS - 1) % NUM_ARCHIVE_RECORDS;
+            int recordCount = (newestIndex - firstIndex + NUM_ARCHIVE_RECORDS) % NUM_ARCHIVE_RECORDS + 1;
+            pageCount = ((firstIndex % RECORDS_PER_PAGE) + recordCount + RECORDS_PER_PAGE - 1) / RECORDS_PER_PAGE;
+        }
+    }
+
+    byte response[4];
+    BitConverter::getBytes(pageCount, response, 0, 2);
+    BitConverter::getBytes(firstIndex >= 0 ? firstIndex % RECORDS_PER_PAGE : 0, response, 2, 2);
+    sendBlockWithCRC(response, sizeof(response));
+
+    if (pageCount > 0)
+        sendArchivePages(firstIndex / RECORDS_PER_PAGE, pageCount, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::sendArchivePages(int firstPage, int pageCount, bool waitForStart) {
+    byte b;
+
+    if (waitForStart && (!readByte(b, STATION_RESPONSE_TIMEOUT_MILLIS) || b != ACK)) {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Station did not start the archive dump" << endl;
+        return;
+    }
+
+    byte page[PAGE_SIZE];
+    for (int i = 0; i < pageCount && running; i++) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            int ringPage = (firstPage + i) % ARCHIVE_PAGES;
+            memset(page, 0, sizeof(page));
+            page[0] = static_cast<byte>(i % 256);
+            memcpy(&page[1], &archive[ringPage * RECORDS_PER_PAGE * ArchivePacket::BYTES_PER_ARCHIVE_PACKET],
+                   RECORDS_PER_PAGE * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        }
+
+        //
+        // Resend the page until the station accepts it or cancels the dump
+        //
+        bool resend = true;
+        while (resend && running) {
+            sendBlockWithCRC(page, sizeof(page));
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                statistics.archivePages++;
+            }
+
+            if (!readByte(b, STATION_RESPONSE_TIMEOUT_MILLIS)) {
+                VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Station did not respond to archive page " << i << endl;
+                return;
+            }
+
+            if (b == ACK)
+                resend = false;
+            else if (b == NACK) {
+                std::lock_guard<std::mutex> guard(mutex);
+                statistics.resentPages++;
+            }
+            else {
+                VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Station canceled the archive dump at page " << i << endl;
+                return;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageConsoleEmulator::receiveBlock(byte data[], int length) {
+    byte block[EEPROM_SIZE + CRC_BYTES];
+    for (int i = 0; i < length + CRC_BYTES; i++) {
+        if (!readByte(block[i], STATION_RESPONSE_TIMEOUT_MILLIS)) {
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Timed out reading " << length << " byte block from the station" << endl;
+            return false;
+        }
+    }
+
+    if (!VantageCRC::checkCRC(block, length)) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            statistics.crcFailuresReceived++;
+        }
+        send(&CRC_FAILURE, 1);
+        return false;
+    }
+
+    memcpy(data, block, length);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::sendBlockWithCRC(const byte data[], int length) {
+    vector<byte> block(data, data + length);
+    block.resize(length + CRC_BYTES);
+    BitConverter::getBytes(VantageCRC::calculateCRC(data, length), block.data(), length, CRC_BYTES, false);
+
+    if (injectCRCError()) {
+        block[randomGenerator() % length] ^= 0x01;
+        std::lock_guard<std::mutex> guard(mutex);
+        statistics.crcErrorsInjected++;
+    }
+
+    send(block.data(), block.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::send(const void * data, int length) {
+    //
+    // 10 bits per byte, 8 data bits plus the start and stop bits
+    //
+    if (settings.baudRate > 0)
+        this_thread::sleep_for(chrono::microseconds((static_cast<long long>(length) * 10 * 1000000) / settings.baudRate));
+
+    const byte * bytes = static_cast<const byte *>(data);
+    int written = 0;
+    while (written < length) {
+        ssize_t n = ::write(masterFd, bytes + written, length - written);
+        if (n <= 0) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Write to pseudo-terminal failed (" << logger.strerror() << ")" << endl;
+            return;
+        }
+
+        written += n;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageConsoleEmulator::readByte(byte & b, int timeoutMillis) {
+    struct pollfd pfd = {masterFd, POLLIN, 0};
+    if (poll(&pfd, 1, timeoutMillis) <= 0 || (pfd.revents & POLLIN) == 0)
+        return false;
+
+    return ::read(masterFd, &b, 1) == 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageConsoleEmulator::isInputAvailable() {
+    struct pollfd pfd = {masterFd, POLLIN, 0};
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageConsoleEmulator::wakeup() {
+    if (remainingWakeupFailures > 0) {
+        remainingWakeupFailures--;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Ignoring wake up request" << endl;
+        return;
+    }
+
+    if (settings.responseLatencyMillis > 0)
+        Weather::sleep(settings.responseLatencyMillis);
+
+    send(WAKEUP_RESPONSE.data(), WAKEUP_RESPONSE.length());
+
+    std::lock_guard<std::mutex> guard(mutex);
+    statistics.wakeups++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageConsoleEmulator::injectCRCError() {
+    if (settings.crcErrorRate <= 0.0)
+        return false;
+
+    return uniform_real_distribution<double>(0.0, 1.0)(randomGenerator) < settings.crcErrorRate;
+}
+
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef VANTAGE_CONSOLE_EMULATOR_H
+#define VANTAGE_CONSOLE_EMULATOR_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+
+#include "WeatherTypes.h"
+#include "LoopPacket.h"
+#include "Loop2Packet.h"
+#include "VantageProtocolConstants.h"
+
+namespace vws {
+class VantageLogger;
+
+/**
+ * Emulator of a Vantage console that speaks the serial protocol on the master side of a pseudo-terminal. A SerialPort that
+ * is opened on the device path of the emulator behaves as if it is connected to a console, which allows the protocol level
+ * throughput and latency of VantageWeatherStation to be measured without hardware.
+ *
+ * The emulated commands are the wake up sequence, LOOP, LPS, HILOWS, DMP, DMPAFT (with ACK, NACK and ESC paging),
+ * GETEE, EEBRD, EEBWR, EEWR, SETPER, GETTIME and SETTIME. Other commands are ignored, which the station treats as a
+ * console that did not respond.
+ *
+ * The output of the emulator is paced at the configured line rate and each response can be delayed by a fixed latency.
+ * CRC errors are injected into a configurable fraction of the CRC protected responses.
+ */
+class VantageConsoleEmulator {
+public:
+    static constexpr int EEPROM_SIZE = 4096;
+
+    /**
+     * The behavior of the emulated console.
+     */
+    struct Settings {
+        int      baudRate;                // The line rate used to pace the output, 0 for no pacing
+        int      responseLatencyMillis;   // The delay before the console responds to a command
+        int      loopIntervalMillis;      // The interval between the packets of a LOOP or LPS command, the console uses 2 seconds
+        double   crcErrorRate;            // The fraction of CRC protected responses that are corrupted
+        int      wakeupFailures;          // The number of wake up requests that are ignored before the console wakes up
+        int      clockOffsetSeconds;      // The initial offset of the console clock from the system clock
+        unsigned randomSeed;              // The seed of the CRC error injection
+    };
+
+    /**
+     * Counters of the protocol activity of the emulator.
+     */
+    struct Statistics {
+        int commands;                     // The number of commands received, not including wake up requests
+        int wakeups;                      // The number of wake up requests that were answered
+        int loopPackets;                  // The number of LOOP and LOOP2 packets sent
+        int archivePages;                 // The number of archive pages sent, including resent pages
+        int resentPages;                  // The number of archive pages resent after a NACK
+        int crcErrorsInjected;            // The number of responses that were corrupted
+        int crcFailuresReceived;          // The number of blocks received from the station that failed the CRC check
+    };
+
+    /**
+     * Get the settings of a console that responds immediately at 19200 baud without errors.
+     *
+     * @return The default settings
+     */
+    static Settings defaultSettings();
+
+    /**
+     * Constructor.
+     *
+     * @param settings The behavior of the emulated console
+     */
+    explicit VantageConsoleEmulator(const Settings & settings = defaultSettings());
+
+    /**
+     * Destructor.
+     */
+    ~VantageConsoleEmulator();
+
+    /**
+     * Open the pseudo-terminal and start the thread that services the protocol.
+     *
+     * @return True if the emulator is running
+     */
+    bool start();
+
+    /**
+     * Stop the protocol thread and close the pseudo-terminal.
+     */
+    void stop();
+
+    /**
+     * Get the path of the device that a SerialPort opens to connect to the emulator.
+     *
+     * @return The path of the slave side of the pseudo-terminal
+     */
+    const std::string & getDevicePath() const;
+
+    /**
+     * Append a record to the emulated archive. Like the console, the archive is a ring of 2560 records in 512 pages, so the
+     * oldest record is overwritten once the archive is full. The records must be appended in time order.
+     *
+     * @param record The archive record
+     */
+    void addArchiveRecord(const byte record[]);
+
+    /**
+     * Append synthetic archive records at a fixed archive period. Only the date/time stamps and a few fields of the records are set.
+     *
+     * @param start         The time of the first record
+     * @param periodSeconds The number of seconds between the records
+     * @param count         The number of records to append
+     */
+    void addArchiveRecords(DateTime start, int periodSeconds, int count);
+
+    /**
+     * Set the LOOP packet the emulator sends. The CRC is calculated by the emulator.
+     *
+     * @param packet The LOOP packet
+     */
+    void setLoopPacket(const byte packet[]);
+
+    /**
+     * Set the LOOP2 packet the emulator sends. The CRC is calculated by the emulator.
+     *
+     * @param packet The LOOP2 packet
+     */
+    void setLoop2Packet(const byte packet[]);
+
+    /**
+     * Write bytes into the emulated EEPROM.
+     *
+     * @param address The EEPROM address of the first byte
+     * @param data    The bytes to write
+     * @param count   The number of bytes to write
+     */
+    void setEeprom(unsigned address, const byte data[], unsigned count);
+
+    /**
+     * Read bytes from the emulated EEPROM.
+     *
+     * @param address The EEPROM address of the first byte
+     * @param data    The buffer into which the bytes are copied
+     * @param count   The number of bytes to read
+     */
+    void getEeprom(unsigned address, byte data[], unsigned count) const;
+
+    /**
+     * Get the current time of the emulated console clock.
+     *
+     * @return The console time
+     */
+    DateTime getConsoleTime() const;
+
+    /**
+     * Get the counters of the protocol activity.
+     *
+     * @return A copy of the counters
+     */
+    Statistics getStatistics() const;
+
+private:
+    static constexpr int ARCHIVE_PAGES = 512;
+    static constexpr int PAGE_SIZE = 265;
+    static constexpr int RECORDS_PER_PAGE = 5;
+    static constexpr int HILOW_PACKET_SIZE = 436;
+    static constexpr int CRC_BYTES = 2;
+    static constexpr int POLL_INTERVAL_MILLIS = 100;
+    static constexpr int STATION_RESPONSE_TIMEOUT_MILLIS = 2000;
+
+    /**
+     * The main loop of the protocol thread.
+     */
+    void serviceProtocol();
+
+    /**
+     * Process a command line received from the station.
+     *
+     * @param command The command without the line terminator
+     */
+    void processCommand(const std::string & command);
+
+    /**
+     * Send the LOOP and LOOP2 packets of a LOOP or LPS command until the count is reached or the station wakes up the console.
+     *
+     * @param count        The number of packets to send
+     * @param includeLoop2 Whether LOOP2 packets are sent alternately with the LOOP packets
+     */
+    void sendLoopPackets(int count, bool includeLoop2);
+
+    /**
+     * Send the pages of a DMP or DMPAFT command, handling the ACK, NACK and ESC responses of the station.
+     *
+     * @param firstPage    The index within the ring of the first page of the dump
+     * @param pageCount    The number of pages to send
+     * @param waitForStart Whether the station acknowledges the dump size before the first page, which is the case for DMPAFT
+     */
+    void sendArchivePages(int firstPage, int pageCount, bool waitForStart);
+
+    /**
+     * Process the DMPAFT command after it was acknowledged.
+     */
+    void processDumpAfter();
+
+    /**
+     * Read a block of binary data with a CRC from the station and respond with a CRC failure if the CRC is not valid.
+     * A valid block is acknowledged by the caller once the block has been applied.
+     *
+     * @param data   The buffer into which the block is read
+     * @param length The length of the block, not including the CRC
+     * @return True if the block was read and its CRC is valid
+     */
+    bool receiveBlock(byte data[], int length);
+
+    /**
+     * Send a block of data followed by its CRC, corrupting the block at the configured error rate.
+     *
+     * @param data   The data to send
+     * @param length The length of the data
+     */
+    void sendBlockWithCRC(const byte data[], int length);
+
+    /**
+     * Send bytes to the station, pacing them at the configured line rate.
+     *
+     * @param data   The data to send
+     * @param length The number of bytes to send
+     */
+    void send(const void * data, int length);
+
+    /**
+     * Read one byte from the station.
+     *
+     * @param b             The byte that was read
+     * @param timeoutMillis The maximum time to wait for the byte
+     * @return True if a byte was read
+     */
+    bool readByte(byte & b, int timeoutMillis);
+
+    /**
+     * Check whether the station sent a byte without consuming it.
+     *
+     * @return True if a byte is waiting to be read
+     */
+    bool isInputAvailable();
+
+    /**
+     * Send the response to a wake up request, unless the request is one of the configured failures.
+     */
+    void wakeup();
+
+    /**
+     * Check whether the next CRC protected response should be corrupted.
+     *
+     * @return True if the response should be corrupted
+     */
+    bool injectCRCError();
+
+    Settings                 settings;
+    std::string              devicePath;           // The path of the slave side of the pseudo-terminal
+    int                      masterFd;             // The emulator side of the pseudo-terminal
+    int                      slaveFd;              // Held open so that the master does not report a hang up between station connections
+    std::thread              protocolThread;
+    std::atomic<bool>        running;
+    mutable std::mutex       mutex;                // Protects the console state that can be changed while the emulator runs
+    std::vector<byte>        archive;              // The ring of archive records, 0xFF for a record that was never written
+    int                      nextArchiveIndex;     // The index within the ring at which the next record is written
+    int                      archiveRecordCount;   // The number of records in the ring
+    byte                     loopPacket[LoopPacket::LOOP_PACKET_SIZE];
+    byte                     loop2Packet[Loop2Packet::LOOP2_PACKET_SIZE];
+    byte                     hiLowPacket[HILOW_PACKET_SIZE];
+    byte                     eeprom[EEPROM_SIZE];
+    DateTime                 clockOffset;          // The offset of the console clock from the system clock, changed by SETTIME
+    int                      remainingWakeupFailures;
+    Statistics               statistics;
+    std::mt19937             randomGenerator;
+    VantageLogger &          logger;
+};
+}
+
+#endif
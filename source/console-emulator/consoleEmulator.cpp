@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <iostream>
+#include <atomic>
+
+#include "VantageConsoleEmulator.h"
+#include "VantageLogger.h"
+#include "Weather.h"
+
+using namespace std;
+using namespace vws;
+
+static const char USAGE_MESSAGE[] = "Usage: console-emulator [-r <baud rate>] [-l <latency millis>] [-i <loop interval millis>] [-e <CRC error rate>] "
+                                    "[-w <wake up failures>] [-a <archive records>] [-p <archive period minutes>] [-v]";
+
+static atomic<bool> stopRequested(false);
+
+void
+signalHandler(int signal) {
+    stopRequested = true;
+}
+
+/**
+ * Run a Vantage console emulator on a pseudo-terminal until interrupted. The path of the terminal device is printed so that
+ * vws or a benchmark can be pointed at it. The emulated archive is filled with records that end at the current time and
+ * a new record is added each archive period.
+ */
+int
+main(int argc, char *argv[]) {
+    VantageConsoleEmulator::Settings settings = VantageConsoleEmulator::defaultSettings();
+    int archiveRecords = 0;
+    int archivePeriodMinutes = 5;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0)
+            verbose = true;
+        else if (i + 1 < argc && strcmp(argv[i], "-r") == 0)
+            settings.baudRate = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-l") == 0)
+            settings.responseLatencyMillis = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-i") == 0)
+            settings.loopIntervalMillis = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-e") == 0)
+            settings.crcErrorRate = atof(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-w") == 0)
+            settings.wakeupFailures = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-a") == 0)
+            archiveRecords = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-p") == 0)
+            archivePeriodMinutes = atoi(argv[++i]);
+        else {
+            cerr << USAGE_MESSAGE << endl;
+            exit(1);
+        }
+    }
+
+    if (archivePeriodMinutes <= 0) {
+        cerr << USAGE_MESSAGE << endl;
+        exit(1);
+    }
+
+    VantageLogger::setLogLevel(verbose ? VantageLogger::VANTAGE_DEBUG1 : VantageLogger::VANTAGE_WARNING);
+
+    int archivePeriodSeconds = archivePeriodMinutes * 60;
+    DateTime now = time(0);
+    DateTime nextRecordTime = now - (now % archivePeriodSeconds);
+
+    VantageConsoleEmulator emulator(settings);
+    emulator.addArchiveRecords(nextRecordTime - (static_cast<DateTime>(archiveRecords) * archivePeriodSeconds), archivePeriodSeconds, archiveRecords);
+
+    if (!emulator.start()) {
+        cerr << "Failed to start the console emulator" << endl;
+        exit(2);
+    }
+
+    cout << emulator.getDevicePath() << endl;
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    while (!stopRequested) {
+        Weather::sleep(1000);
+        if (time(0) >= nextRecordTime + archivePeriodSeconds) {
+            nextRecordTime += archivePeriodSeconds;
+            emulator.addArchiveRecords(nextRecordTime, archivePeriodSeconds, 1);
+        }
+    }
+
+    emulator.stop();
+
+    VantageConsoleEmulator::Statistics statistics = emulator.getStatistics();
+    cerr << "Commands: " << statistics.commands << " Wake ups: " << statistics.wakeups << " LOOP packets: " << statistics.loopPackets
+         << " Archive pages: " << statistics.archivePages << " (" << statistics.resentPages << " resent)"
+         << " CRC errors injected: " << statistics.crcErrorsInjected << endl;
+
+    return 0;
+}
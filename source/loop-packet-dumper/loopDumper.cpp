@@ -21,6 +21,7 @@
 
 #include "LoopPacket.h"
 #include "Loop2Packet.h"
+#include "LoopPacketRing.h"
 #include "VantageProtocolConstants.h"
 #include "VantageDecoder.h"
 #include "CurrentWeather.h"
@@ -67,7 +68,16 @@ main(int argc, char *argv[]) {
     char loopBuffer[LoopPacket::LOOP_PACKET_SIZE];
     char loop2Buffer[Loop2Packet::LOOP2_PACKET_SIZE];
 
-    ifstream stream(file, ifstream::in | ios::binary);
+    //
+    // The file is either the LOOP packet ring file or one of the hourly archive files that the ring file replaced
+    //
+    LoopPacketRing ring(file);
+    bool isRing = ring.open(true);
+    int ringRecord = 0;
+    ifstream stream;
+    if (!isRing)
+        stream.open(file, ifstream::in | ios::binary);
+
     string jsonString;
     char *buffer;
     long bufferLength;
@@ -78,21 +88,27 @@ main(int argc, char *argv[]) {
     while (true) {
         DateTime time;
         int packetType;
-        stream.read(reinterpret_cast<char *>(&time), sizeof(time));
-        stream.read(reinterpret_cast<char *>(&packetType), sizeof(packetType));
-        if (!stream) {
-            stream.close();
-            exit(0);
-        }
+        char packetBuffer[LoopPacketRing::PACKET_DATA_SIZE];
 
-        if (packetType == LoopPacket::LOOP_PACKET_TYPE) {
-            loopString = "LOOP  ";
-            stream.read(loopBuffer, sizeof(loopBuffer));
+        if (isRing) {
+            if (ringRecord >= ring.getRecordCount())
+                exit(0);
+
+            memcpy(packetBuffer, ring.getRecord(ringRecord++, time, packetType), sizeof(packetBuffer));
+        }
+        else {
+            stream.read(reinterpret_cast<char *>(&time), sizeof(time));
+            stream.read(reinterpret_cast<char *>(&packetType), sizeof(packetType));
+            stream.read(packetBuffer, sizeof(packetBuffer));
             if (!stream) {
                 stream.close();
                 exit(0);
             }
+        }
 
+        if (packetType == LoopPacket::LOOP_PACKET_TYPE) {
+            loopString = "LOOP  ";
+            memcpy(loopBuffer, packetBuffer, sizeof(loopBuffer));
             loopPacket.decodeLoopPacket(loopBuffer);
             buffer = loopBuffer;
             bufferLength = sizeof(loopBuffer);
@@ -103,11 +119,7 @@ main(int argc, char *argv[]) {
         }
         else if (packetType == Loop2Packet::LOOP2_PACKET_TYPE) {
             loopString = "LOOP2 ";
-            stream.read(loop2Buffer, sizeof(loop2Buffer));
-            if (!stream) {
-                stream.close();
-                exit(0);
-            }
+            memcpy(loop2Buffer, packetBuffer, sizeof(loop2Buffer));
             loop2Packet.decodeLoop2Packet(loop2Buffer);
             buffer = loop2Buffer;
             bufferLength = sizeof(loop2Buffer);
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <unistd.h>
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "PacketSegmentStore.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "append-test-archive.dat";
+
+/**
+ * Create the packets at a 5 minute archive period starting at the specified time.
+ */
+void
+createPackets(DateTime start, int count, vector<ArchivePacket> & packets) {
+    packets.clear();
+    for (int i = 0; i < count; i++) {
+        vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+        makeArchiveRecord(start + (i * 300), buffer);
+        BitConverter::getBytes(600 + (i % 100), buffer, 4, 2);
+
+        packets.push_back(ArchivePacket(buffer));
+    }
+}
+
+/**
+ * Check that the archive file holds whole records whose times increase.
+ */
+bool
+checkArchiveFile(const string & archivePath, int expectedCount) {
+    uintmax_t fileLength = filesystem::file_size(archivePath);
+    if (fileLength != static_cast<uintmax_t>(expectedCount) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET) {
+        cout << "    Archive file is " << fileLength << " bytes, expected " << expectedCount << " records" << endl;
+        return false;
+    }
+
+    ifstream stream(archivePath, ios::binary);
+    vws::byte record[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    DateTimeFields previous;
+    for (int i = 0; i < expectedCount; i++) {
+        stream.read(record, sizeof(record));
+        ArchivePacket packet(record);
+        if (i > 0 && !(previous < packet.getDateTimeFields())) {
+            cout << "    Record " << i << " at " << packet.getDateTimeFields().formatDateTime() << " is not after the previous record" << endl;
+            return false;
+        }
+
+        previous = packet.getDateTimeFields();
+    }
+
+    return true;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: ArchiveAppendTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    filesystem::remove_all(archiveDirectory + "/packets");
+
+    DateTime start = DateTimeFields(2024, 3, 1, 0, 0, 0).getEpochDateTime();
+    vector<ArchivePacket> packets;
+    DateTimeFields oldest, newest;
+    int count;
+
+    //
+    // More records than writev() accepts in one call
+    //
+    {
+        ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+        createPackets(start, 3000, packets);
+        archiveManager.addPacketsToArchive(packets);
+        archiveManager.getArchiveRange(oldest, newest, count);
+        if (count == 3000 && newest == packets.back().getDateTimeFields() && checkArchiveFile(archivePath, 3000))
+            cout << "PASSED: Large batch was appended in order" << endl;
+        else
+            cout << "FAILED: Large batch was not appended correctly. Count: " << count << endl;
+
+        //
+        // 3000 records at a 5 minute period span 11 days
+        //
+        vector<string> segmentFiles;
+        PacketSegmentStore::findSegmentFiles(archiveDirectory + "/packets", segmentFiles);
+        size_t segmentRecordCount = 0;
+        int corruptRecords = 0;
+        for (const string & segmentFile : segmentFiles) {
+            vector<vws::byte> records;
+            int segmentCorruptRecords;
+            PacketSegmentStore::readSegment(segmentFile, records, segmentCorruptRecords);
+            segmentRecordCount += records.size() / ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+            corruptRecords += segmentCorruptRecords;
+        }
+
+        if (segmentFiles.size() == 11 && segmentRecordCount == 3000 && corruptRecords == 0)
+            cout << "PASSED: Every appended packet was saved to a daily segment file" << endl;
+        else
+            cout << "FAILED: " << segmentRecordCount << " packets were saved to " << segmentFiles.size() << " segment files, expected 3000 in 11 files" << endl;
+
+        //
+        // Only the packets after the newest record are appended, even when older packets are in the same batch
+        //
+        archiveManager.setDurabilityPolicy(ArchiveManager::DurabilityPolicy::SYNC_PERIODIC, 60);
+        createPackets(start + (2990 * 300), 20, packets);
+        archiveManager.addPacketsToArchive(packets);
+        archiveManager.getArchiveRange(oldest, newest, count);
+        if (count == 3010 && checkArchiveFile(archivePath, 3010))
+            cout << "PASSED: Packets that are not newer than the archive were skipped" << endl;
+        else
+            cout << "FAILED: Overlapping batch was not appended correctly. Count: " << count << endl;
+    }
+
+    //
+    // A torn record and a record that was allocated but never written are removed when the archive is opened
+    //
+    {
+        ofstream stream(archivePath, ios::binary | ios::app);
+        char zeros[ArchivePacket::BYTES_PER_ARCHIVE_PACKET] = {0};
+        stream.write(zeros, sizeof(zeros));
+        stream.write(packets[0].getBuffer(), 30);
+
+        vector<string> segmentFiles;
+        PacketSegmentStore::findSegmentFiles(archiveDirectory + "/packets", segmentFiles);
+        ofstream segmentStream(segmentFiles.back(), ios::binary | ios::app);
+        segmentStream.write(packets[0].getBuffer(), 10);
+    }
+
+    {
+        ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+        archiveManager.getArchiveRange(oldest, newest, count);
+        if (count == 3010 && checkArchiveFile(archivePath, 3010))
+            cout << "PASSED: Partial and unwritten records were removed from the end of the archive" << endl;
+        else
+            cout << "FAILED: Archive tail was not recovered. Count: " << count << endl;
+
+        archiveManager.setDurabilityPolicy(ArchiveManager::DurabilityPolicy::SYNC_NEVER);
+        createPackets(start + (3010 * 300), 10, packets);
+        archiveManager.addPacketsToArchive(packets);
+        archiveManager.getArchiveRange(oldest, newest, count);
+        if (count == 3020 && newest == packets.back().getDateTimeFields() && checkArchiveFile(archivePath, 3020))
+            cout << "PASSED: Records appended after recovery are aligned" << endl;
+        else
+            cout << "FAILED: Records appended after recovery are not aligned. Count: " << count << endl;
+
+        vector<string> segmentFiles;
+        PacketSegmentStore::findSegmentFiles(archiveDirectory + "/packets", segmentFiles);
+        vector<vws::byte> records;
+        int corruptRecords;
+        PacketSegmentStore::readSegment(segmentFiles.back(), records, corruptRecords);
+        if (corruptRecords == 0 && ArchivePacket(records.data() + records.size() - ArchivePacket::BYTES_PER_ARCHIVE_PACKET).getDateTimeFields() == newest)
+            cout << "PASSED: Partial segment record was removed before the packets were appended" << endl;
+        else
+            cout << "FAILED: Segment file has " << corruptRecords << " corrupt records after the packets were appended" << endl;
+    }
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    filesystem::remove_all(archiveDirectory + "/packets");
+}
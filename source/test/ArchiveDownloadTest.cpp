@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+#include "ArchiveDownload.h"
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "DateTimeFields.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+#include "VantageWeatherStation.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "download-test-archive.dat";
+
+using Page = vector<vws::byte>;
+
+/**
+ * Create the pages of a dump at a 5 minute archive period. The first record of the first page to process is the record at
+ * the start time. The records before it in the first page are older, as are the records after the newest record
+ * in the last page, which are from the beginning of the console's circular archive buffer.
+ */
+void
+createPages(DateTime start, int firstRecord, int recordCount, vector<Page> & pages) {
+    pages.clear();
+    DateTime time = start - (firstRecord * 300);
+    int records = recordCount + firstRecord;
+    int pageCount = (records + VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE - 1) / VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE;
+
+    for (int p = 0; p < pageCount; p++) {
+        Page page(VantageWeatherStation::ARCHIVE_PAGE_SIZE, 0);
+        page[0] = p;
+        for (int r = 0; r < VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE; r++) {
+            vws::byte * buffer = &page[1 + (r * ArchivePacket::BYTES_PER_ARCHIVE_PACKET)];
+            if (records > 0)
+                makeArchiveRecord(time, buffer);
+            else if (r % 2 == 0)
+                makeArchiveRecord(start - (10 * 86400), buffer);
+            else
+                memset(buffer, 0xFF, ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+
+            time += 300;
+            records--;
+        }
+
+        pages.push_back(page);
+    }
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: ArchiveDownloadTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    filesystem::remove_all(archiveDirectory + "/packets");
+
+    DateTime start = DateTimeFields(2024, 5, 1, 0, 0, 0).getEpochDateTime();
+    vector<Page> pages;
+    DateTimeFields oldest, newest;
+    int count;
+
+    {
+        ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+
+        //
+        // A complete dump whose first page starts with two older records and whose last page wraps around the circular buffer
+        //
+        createPages(start, 2, 45, pages);
+        ArchiveDownload download(archiveManager);
+        download.beginDump(DateTimeFields(start - 300), 2, pages.size());
+        for (int i = 0; i < 4; i++)
+            download.processArchivePage(pages[i].data());
+
+        ArchiveManager::DownloadProgress progress = archiveManager.getDownloadProgress();
+        if (progress.active && progress.pageCount == 10 && progress.pagesReceived == 4)
+            cout << "PASSED: Download progress is reported while the pages are received" << endl;
+        else
+            cout << "FAILED: Download progress while active: " << progress.pagesReceived << " of " << progress.pageCount << " pages" << endl;
+
+        for (size_t i = 4; i < pages.size(); i++)
+            download.processArchivePage(pages[i].data());
+
+        download.endDump(true);
+
+        archiveManager.getArchiveRange(oldest, newest, count);
+        progress = archiveManager.getDownloadProgress();
+        if (count == 45 && download.getRecordsCommitted() == 45 && newest == DateTimeFields(start + (44 * 300)) &&
+            download.getNewestRecordTime() == newest)
+            cout << "PASSED: Every new record of the dump was added to the archive" << endl;
+        else
+            cout << "FAILED: " << download.getRecordsCommitted() << " records were added to the archive, expected 45. Count: " << count << endl;
+
+        if (!progress.active && !progress.aborted && progress.pagesReceived == 10 && progress.pagesCommitted == 10 && progress.recordsCommitted == 45)
+            cout << "PASSED: Download progress reports the completed dump" << endl;
+        else
+            cout << "FAILED: Download progress after the dump: " << progress.pagesCommitted << " pages, " << progress.recordsCommitted << " records" << endl;
+
+        //
+        // A dump that aborts after three of its six pages
+        //
+        DateTime next = start + (45 * 300);
+        createPages(next, 0, 30, pages);
+        ArchiveDownload abortedDownload(archiveManager);
+        abortedDownload.beginDump(newest, 0, pages.size());
+        for (int i = 0; i < 3; i++)
+            abortedDownload.processArchivePage(pages[i].data());
+
+        abortedDownload.endDump(false);
+
+        archiveManager.getArchiveRange(oldest, newest, count);
+        progress = archiveManager.getDownloadProgress();
+        if (count == 60 && newest == DateTimeFields(next + (14 * 300)) && progress.aborted && progress.pagesCommitted == 3 && progress.recordsCommitted == 15)
+            cout << "PASSED: Records of the pages received before the abort were added to the archive" << endl;
+        else
+            cout << "FAILED: Aborted download added " << progress.recordsCommitted << " records. Count: " << count << endl;
+    }
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    filesystem::remove_all(archiveDirectory + "/packets");
+}
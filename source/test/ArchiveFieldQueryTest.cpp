@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <filesystem>
+#include <unistd.h>
+#include "ArchiveFieldQuery.h"
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "field-query-test-archive.dat";
+
+/**
+ * Build an archive packet whose outside temperature is 60.0 plus a tenth of a degree per record and whose
+ * outside humidity is dashed every fourth record.
+ */
+ArchivePacket
+createPacket(DateTime packetTime, int index) {
+    vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    makeArchiveRecord(packetTime, buffer);
+    BitConverter::getBytes(600 + index, buffer, 4, 2);
+    buffer[23] = static_cast<vws::byte>(index % 4 == 3 ? 255 : 50 + index);
+
+    return ArchivePacket(buffer);
+}
+
+/**
+ * Compare a query result with the expected JSON.
+ */
+void
+checkResult(const string & testName, const string & actual, const string & expected) {
+    if (actual == expected)
+        cout << "PASSED: " << testName << endl;
+    else
+        cout << "FAILED: " << testName << endl << "    Expected: " << expected << endl << "    Actual:   " << actual << endl;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: ArchiveFieldQueryTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    filesystem::remove_all(archiveDirectory + "/packets");
+
+    //
+    // One hour of records at a 5 minute archive period
+    //
+    DateTime start = DateTimeFields(2024, 6, 1, 0, 0, 0).getEpochDateTime();
+    vector<ArchivePacket> packets;
+    for (int i = 0; i < 12; i++)
+        packets.push_back(createPacket(start + (i * 300), i));
+
+    ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+    archiveManager.addPacketsToArchive(packets);
+
+    ArchiveFieldQuery query(archiveManager);
+
+    if (query.setFields("avgOutsideTemperature, bogusField") || query.getUnknownField() != "bogusField")
+        cout << "FAILED: Unknown field was accepted or not reported" << endl;
+    else
+        cout << "PASSED: Unknown field was rejected" << endl;
+
+    if (query.setFields(" , "))
+        cout << "FAILED: Empty field list was accepted" << endl;
+    else
+        cout << "PASSED: Empty field list was rejected" << endl;
+
+    query.setFields("avgOutsideTemperature,outsideHumidity");
+    checkResult("Projected query returns only the requested fields",
+                query.queryJSON(DateTimeFields(2024, 6, 1, 0, 0, 0), DateTimeFields(2024, 6, 1, 0, 20, 0)),
+                "{ \"fields\" : [ \"avgOutsideTemperature\", \"outsideHumidity\" ], "
+                "\"time\" : [ \"2024-06-01 00:00\", \"2024-06-01 00:05\", \"2024-06-01 00:10\", \"2024-06-01 00:15\", \"2024-06-01 00:20\" ], "
+                "\"avgOutsideTemperature\" : [ 60, 60.1, 60.2, 60.3, 60.4 ], "
+                "\"outsideHumidity\" : [ 50, 51, 52, null, 54 ] }");
+
+    checkResult("Query outside of the archive returns empty arrays",
+                query.queryJSON(DateTimeFields(2024, 7, 1, 0, 0, 0), DateTimeFields(2024, 7, 2, 0, 0, 0)),
+                "{ \"fields\" : [ \"avgOutsideTemperature\", \"outsideHumidity\" ], \"time\" : [  ], "
+                "\"avgOutsideTemperature\" : [  ], \"outsideHumidity\" : [  ] }");
+
+    //
+    // Buckets are aligned to the query start, so the first bucket only has the 00:00 and 00:05 records
+    //
+    query.setDownsampleInterval(20);
+    checkResult("Downsampled query returns the minimum, maximum and average of each bucket",
+                query.queryJSON(DateTimeFields(2024, 5, 31, 23, 50, 0), DateTimeFields(2024, 6, 1, 0, 30, 0)),
+                "{ \"fields\" : [ \"avgOutsideTemperature\", \"outsideHumidity\" ], \"interval\" : 20, "
+                "\"time\" : [ \"2024-05-31 23:50\", \"2024-06-01 00:10\", \"2024-06-01 00:30\" ], "
+                "\"count\" : [ 2, 4, 1 ], "
+                "\"avgOutsideTemperature\" : { \"min\" : [ 60, 60.2, 60.6 ], \"max\" : [ 60.1, 60.5, 60.6 ], \"avg\" : [ 60.05, 60.35, 60.6 ] }, "
+                "\"outsideHumidity\" : { \"min\" : [ 50, 52, 56 ], \"max\" : [ 51, 55, 56 ], \"avg\" : [ 50.5, 53.6667, 56 ] } }");
+
+    //
+    // The points are selected using the first field, the other fields are reported for the selected records
+    //
+    query.setDownsampleInterval(0);
+    query.setFields("outsideHumidity,avgOutsideTemperature");
+    query.setPointLimit(SeriesDownsampler::Method::MIN_MAX, 4);
+    checkResult("Point limited query returns the minimum and maximum records of each bucket",
+                query.queryJSON(DateTimeFields(2024, 6, 1, 0, 0, 0), DateTimeFields(2024, 6, 1, 0, 55, 0)),
+                "{ \"fields\" : [ \"outsideHumidity\", \"avgOutsideTemperature\" ], "
+                "\"time\" : [ \"2024-06-01 00:00\", \"2024-06-01 00:25\", \"2024-06-01 00:30\", \"2024-06-01 00:50\" ], "
+                "\"outsideHumidity\" : [ 50, 55, 56, 60 ], "
+                "\"avgOutsideTemperature\" : [ 60, 60.5, 60.6, 61 ] }");
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <set>
+#include <cstring>
+#include <unistd.h>
+#include "ArchiveManager.h"
+#include "ArchiveIndex.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "MappedArchiveFile.h"
+#include "DateTimeFields.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "index-test-archive.dat";
+
+/**
+ * Build a 10 year archive at a 5 minute archive period. The archive has random outages of a few
+ * hours to a few days and one year that uses a 30 minute archive period.
+ */
+int
+createSyntheticArchive(const string & archivePath) {
+    mt19937 random(12345);
+    uniform_int_distribution<int> outageChance(0, 8640);
+    uniform_int_distribution<int> outageLength(12, 1440);
+
+    ofstream ofs(archivePath, ios::out | ios::trunc | ios::binary);
+
+    vws::byte packetData[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    DateTime packetTime = DateTimeFields(2015, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTime endTime = DateTimeFields(2025, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTime periodChangeStart = DateTimeFields(2019, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTime periodChangeEnd = DateTimeFields(2020, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTimeFields lastPacketTime;
+    int recordCount = 0;
+
+    while (packetTime < endTime) {
+        DateTimeFields fields(packetTime);
+
+        //
+        // Like the console, do not write records during the repeated hour when DST ends
+        //
+        if (lastPacketTime < fields) {
+            makeArchiveRecord(fields, packetData);
+            ofs.write(packetData, sizeof(packetData));
+            lastPacketTime = fields;
+            recordCount++;
+        }
+
+        if (packetTime >= periodChangeStart && packetTime < periodChangeEnd)
+            packetTime += 1800;
+        else
+            packetTime += 300;
+
+        if (outageChance(random) == 0)
+            packetTime += outageLength(random) * 300;
+    }
+
+    ofs.close();
+
+    return recordCount;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+
+    if (argc != 2) {
+        cout << "Usage: ArchiveIndexTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+    string indexPath = archivePath + ARCHIVE_INDEX_FILE_SUFFIX;
+
+    unlink(indexPath.c_str());
+    int recordCount = createSyntheticArchive(archivePath);
+    cout << "Created synthetic archive with " << recordCount << " records" << endl;
+
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    ArchiveManager buildManager(archiveDirectory, ARCHIVE_FILE);
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    cout << "Archive manager startup with index build took " << chrono::duration<double, milli>(t2 - t1).count() << " ms" << endl;
+
+    t1 = chrono::steady_clock::now();
+    ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+    t2 = chrono::steady_clock::now();
+    cout << "Archive manager startup with index load took " << chrono::duration<double, milli>(t2 - t1).count() << " ms" << endl;
+
+    ArchiveIndex index(indexPath);
+    MappedArchiveFile archive(archivePath);
+
+    if (index.isConsistent(archive) && index.getIndexedRecordCount() == recordCount)
+        cout << "PASSED: Index file covers all " << recordCount << " records in " << index.getDayCount() << " days" << endl;
+    else
+        cout << "FAILED: Index file covers " << index.getIndexedRecordCount() << " records, expected " << recordCount << endl;
+
+    //
+    // Build random one day queries and verify that the indexed search finds the same records as the unindexed search
+    //
+    const int queryCount = 100000;
+    mt19937 random(54321);
+    uniform_int_distribution<int> dayDistribution(0, 3652);
+    vector<pair<DateTimeFields,DateTimeFields>> queries;
+    DateTime firstDay = DateTimeFields(2015, 1, 1, 12, 0, 0).getEpochDateTime();
+    for (int i = 0; i < queryCount; i++) {
+        DateTimeFields start(firstDay + (dayDistribution(random) * 86400));
+        start.setTime(0, 0, 0);
+        DateTimeFields end = start;
+        end.setTime(23, 59, 59);
+        queries.push_back(make_pair(start, end));
+    }
+
+    int mismatches = 0;
+    for (auto & query : queries) {
+        span<const vws::byte> indexedRecords;
+        auto mapping = archiveManager.queryArchiveRecordSpan(query.first, query.second, indexedRecords);
+        span<const vws::byte> records = archive.getRecords(query.first, query.second);
+        if (records.size() != indexedRecords.size() || (records.size() > 0 && memcmp(records.data(), indexedRecords.data(), records.size()) != 0))
+            mismatches++;
+    }
+
+    if (mismatches == 0)
+        cout << "PASSED: Indexed and unindexed searches found the same records for " << queryCount << " queries" << endl;
+    else
+        cout << "FAILED: Indexed and unindexed searches differed for " << mismatches << " queries" << endl;
+
+    //
+    // Benchmark the seek cost of the two searches. The index confines the binary search to the pages of
+    // a single day, which is what matters when the mapped archive is not in the page cache.
+    //
+    size_t totalBytes = 0;
+    t1 = chrono::steady_clock::now();
+    for (auto & query : queries)
+        totalBytes += archive.getRecords(query.first, query.second).size();
+    t2 = chrono::steady_clock::now();
+    double unindexedTime = chrono::duration<double, nano>(t2 - t1).count() / queryCount;
+
+    t1 = chrono::steady_clock::now();
+    for (auto & query : queries) {
+        int startLow, startHigh, endLow, endHigh;
+        index.findSearchRange(query.first, archive.getRecordCount(), startLow, startHigh);
+        index.findSearchRange(query.second, archive.getRecordCount(), endLow, endHigh);
+        int first = archive.findFirstRecordOnOrAfter(query.first, startLow, startHigh);
+        int last = archive.findFirstRecordAfter(query.second, endLow, endHigh);
+        totalBytes += archive.getRecordSpan(first, last).size();
+    }
+    t2 = chrono::steady_clock::now();
+    double indexedTime = chrono::duration<double, nano>(t2 - t1).count() / queryCount;
+
+    t1 = chrono::steady_clock::now();
+    for (auto & query : queries) {
+        span<const vws::byte> records;
+        auto mapping = archiveManager.queryArchiveRecordSpan(query.first, query.second, records);
+        totalBytes += records.size();
+    }
+    t2 = chrono::steady_clock::now();
+    double managerTime = chrono::duration<double, nano>(t2 - t1).count() / queryCount;
+
+    //
+    // Count the distinct archive pages that a binary search probes for a single query
+    //
+    auto countProbedPages = [&archive](const DateTimeFields & time, int low, int high) {
+        int32 key = MappedArchiveFile::timeKey(time);
+        set<size_t> pages;
+        while (low < high) {
+            int middle = low + ((high - low) / 2);
+            pages.insert((static_cast<size_t>(middle) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET) / 4096);
+            if (MappedArchiveFile::recordTimeKey(archive.getRecord(middle)) < key)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return pages.size();
+    };
+
+    double unindexedPages = 0.0;
+    double indexedPages = 0.0;
+    for (auto & query : queries) {
+        int low, high;
+        index.findSearchRange(query.first, archive.getRecordCount(), low, high);
+        unindexedPages += countProbedPages(query.first, 0, archive.getRecordCount());
+        indexedPages += countProbedPages(query.first, low, high);
+    }
+    unindexedPages /= queryCount;
+    indexedPages /= queryCount;
+
+    cout << "Average seek time for one day query without index:    " << unindexedTime << " ns (" << unindexedPages << " archive pages probed on average)" << endl;
+    cout << "Average seek time for one day query with index:       " << indexedTime << " ns (" << indexedPages << " archive pages probed on average)" << endl;
+    cout << "Average time for one day query using archive manager: " << managerTime << " ns" << endl;
+    cout << "(" << totalBytes << " bytes found)" << endl;
+
+    //
+    // Appending to the archive must extend the index incrementally
+    //
+    DateTimeFields newest;
+    DateTimeFields oldest;
+    int count;
+    archiveManager.getArchiveRange(oldest, newest, count);
+
+    vector<ArchivePacket> packets;
+    vws::byte packetData[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    DateTime packetTime = newest.getEpochDateTime();
+    for (int i = 0; i < 600; i++) {
+        packetTime += 300;
+        makeArchiveRecord(packetTime, packetData);
+        packets.push_back(ArchivePacket(packetData));
+    }
+
+    archiveManager.addPacketsToArchive(packets);
+
+    ArchiveIndex updatedIndex(indexPath);
+    MappedArchiveFile updatedArchive(archivePath);
+    if (updatedIndex.isConsistent(updatedArchive) && updatedIndex.getIndexedRecordCount() == recordCount + 600 && updatedIndex.getDayCount() > index.getDayCount())
+        cout << "PASSED: Index was extended after packets were added to the archive" << endl;
+    else
+        cout << "FAILED: Index was not extended after packets were added to the archive" << endl;
+
+    return 0;
+}
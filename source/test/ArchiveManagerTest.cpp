@@ -204,4 +204,53 @@ main(int argc, char * argv[]) {
         cout << "FAILED: Expected 3 backup files, found " << fileList.size() << endl;
 
     //am2.restoreArchiveFile();
+
+    //
+    // Test the searching of the archive file
+    //
+    unlink(std::string(std::string(archiveDirectory) + "/query-test-archive.dat").c_str());
+    ArchiveManager am3(archiveDirectory, "/query-test-archive.dat");
+
+    DateTimeFields queryTestStart(2025, 6, 1, 0, 0, 0);
+    createPackets(288, queryTestStart, packets);
+    am3.addPacketsToArchive(packets);
+
+    vector<ArchivePacket> queryPackets;
+    DateTimeFields queryStart = packets[10].getDateTimeFields();
+    DateTimeFields queryEnd = packets[20].getDateTimeFields();
+    queryEnd.setSecond(30);
+    am3.queryArchiveRecords(queryStart, queryEnd, queryPackets);
+
+    if (queryPackets.size() == 11 && queryPackets[0].getDateTimeFields() == packets[10].getDateTimeFields() && queryPackets[10].getDateTimeFields() == packets[20].getDateTimeFields())
+        cout << "PASSED: Query returned the 11 expected packets" << endl;
+    else
+        cout << "FAILED: Query did not return the 11 expected packets. Count: " << queryPackets.size() << endl;
+
+    queryStart.setSecond(10);
+    am3.queryArchiveRecords(queryStart, queryEnd, queryPackets);
+
+    if (queryPackets.size() == 10 && queryPackets[0].getDateTimeFields() == packets[11].getDateTimeFields())
+        cout << "PASSED: Query with start time seconds skipped the packet before the start time" << endl;
+    else
+        cout << "FAILED: Query with start time seconds returned " << queryPackets.size() << " packets" << endl;
+
+    am3.queryArchiveRecords(DateTimeFields(2025, 5, 1, 0, 0, 0), DateTimeFields(2025, 5, 31, 23, 59, 59), queryPackets);
+
+    if (queryPackets.size() == 0)
+        cout << "PASSED: Query before the start of the archive returned no packets" << endl;
+    else
+        cout << "FAILED: Query before the start of the archive returned " << queryPackets.size() << " packets" << endl;
+
+    am3.queryArchiveRecords(DateTimeFields(2025, 5, 1, 0, 0, 0), DateTimeFields(2025, 7, 1, 0, 0, 0), queryPackets);
+
+    if (queryPackets.size() == packets.size())
+        cout << "PASSED: Query of entire archive returned all packets" << endl;
+    else
+        cout << "FAILED: Query of entire archive returned " << queryPackets.size() << " packets, expected " << packets.size() << endl;
+
+    ArchivePacket newestRecord;
+    if (am3.getNewestRecord(newestRecord) && newestRecord.getDateTimeFields() == packets.back().getDateTimeFields())
+        cout << "PASSED: Newest record is the last packet added" << endl;
+    else
+        cout << "FAILED: Newest record is not the last packet added" << endl;
 }
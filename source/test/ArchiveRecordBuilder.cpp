@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+#include "ArchiveRecordBuilder.h"
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+
+using namespace vws;
+
+void
+makeArchiveRecord(const DateTimeFields & fields, byte buffer[]) {
+    memset(buffer, 0xFF, ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+    int datestamp = fields.getMonthDay() + (fields.getMonth() * 32) + ((fields.getYear() - 2000) * 512);
+    int timestamp = (fields.getHour() * 100) + fields.getMinute();
+    BitConverter::getBytes(datestamp, buffer, 0, 2);
+    BitConverter::getBytes(timestamp, buffer, 2, 2);
+
+    //
+    // The forecast rule and the record type (0 = Rev B)
+    //
+    buffer[33] = 0;
+    buffer[42] = 0;
+}
+
+void
+makeArchiveRecord(DateTime packetTime, byte buffer[]) {
+    makeArchiveRecord(DateTimeFields(packetTime), buffer);
+}
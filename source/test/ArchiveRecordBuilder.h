@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_RECORD_BUILDER_H
+#define ARCHIVE_RECORD_BUILDER_H
+
+#include "WeatherTypes.h"
+#include "DateTimeFields.h"
+
+/**
+ * Fill a buffer with a synthetic Rev B archive record. Every value is dashed except the date and time stamps, the
+ * forecast rule and the record type, so a test only needs to set the values that it checks.
+ *
+ * @param fields The time of the record
+ * @param buffer The buffer of ArchivePacket::BYTES_PER_ARCHIVE_PACKET bytes to fill
+ */
+void makeArchiveRecord(const vws::DateTimeFields & fields, vws::byte buffer[]);
+
+/**
+ * Fill a buffer with a synthetic Rev B archive record.
+ *
+ * @param packetTime The time of the record
+ * @param buffer     The buffer of ArchivePacket::BYTES_PER_ARCHIVE_PACKET bytes to fill
+ */
+void makeArchiveRecord(vws::DateTime packetTime, vws::byte buffer[]);
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <span>
+#include <unistd.h>
+#include "ArchiveIndex.h"
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "ArchiveResponseStream.h"
+#include "BitConverter.h"
+#include "DaySummaryStore.h"
+#include "MappedArchiveFile.h"
+#include "DateTimeFields.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "response-stream-test-archive.dat";
+static const int RECORD_COUNT = 2880;
+
+/**
+ * Create an archive of 10 days at a 5 minute archive period with a few values that change with each record.
+ */
+void
+createArchive(const string & archivePath) {
+    ofstream stream(archivePath, ios::binary | ios::trunc);
+    DateTime time = DateTimeFields(2024, 6, 1, 0, 0, 0).getEpochDateTime();
+
+    vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        makeArchiveRecord(time + (i * 300), buffer);
+        BitConverter::getBytes(600 + (i % 200), buffer, 4, 2);
+        BitConverter::getBytes(29900 + (i % 100), buffer, 14, 2);
+        buffer[23] = static_cast<vws::byte>(40 + (i % 50));
+        stream.write(buffer, sizeof(buffer));
+    }
+}
+
+/**
+ * Format the records the way the query-archive command did before the response was streamed.
+ */
+string
+formatRecords(const vector<ArchivePacket> & packets) {
+    ostringstream oss;
+
+    bool first = true;
+    for (const ArchivePacket & packet : packets) {
+        if (!first) oss << ", "; else first = false;
+        oss << packet.formatJSON();
+    }
+
+    oss << "]";
+    return oss.str();
+}
+
+/**
+ * Stream the records in a time range and compare the result to the records formatted all at once.
+ */
+void
+streamRecords(const ArchiveManager & archiveManager, const DateTimeFields & startTime, const DateTimeFields & endTime) {
+    vector<ArchivePacket> packets;
+    archiveManager.queryArchiveRecords(startTime, endTime, packets);
+    string expected = formatRecords(packets);
+
+    std::span<const vws::byte> records;
+    std::shared_ptr<const MappedArchiveFile> mapping = archiveManager.queryArchiveRecordSpan(startTime, endTime, records);
+    ArchiveResponseStream stream(mapping, records);
+    mapping.reset();
+
+    string streamed;
+    string chunk;
+    size_t largestChunk = 0;
+    int chunkCount = 0;
+    bool moreChunks = true;
+    while (moreChunks) {
+        chunk.clear();
+        moreChunks = stream.nextChunk(chunk);
+        streamed.append(chunk);
+        largestChunk = std::max(largestChunk, chunk.length());
+        chunkCount++;
+    }
+
+    int expectedChunkCount = std::max(1, (stream.getRecordCount() + ArchiveResponseStream::RECORDS_PER_CHUNK - 1) / ArchiveResponseStream::RECORDS_PER_CHUNK);
+
+    cout << "Streamed " << stream.getRecordCount() << " records from " << startTime.formatDateTime() << " to " << endTime.formatDateTime()
+         << " in " << chunkCount << " chunks. Largest chunk: " << largestChunk << " bytes, full response: " << expected.length() << " bytes" << endl;
+
+    if (stream.getRecordCount() == packets.size() && streamed == expected)
+        cout << "PASSED: Streamed response matches the formatted response" << endl;
+    else
+        cout << "FAILED: Streamed response does not match the formatted response" << endl;
+
+    if (chunkCount == expectedChunkCount)
+        cout << "PASSED: Streamed response was produced in " << chunkCount << " chunks" << endl;
+    else
+        cout << "FAILED: Streamed response was produced in " << chunkCount << " chunks, expected " << expectedChunkCount << endl;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: ArchiveResponseStreamTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    createArchive(archivePath);
+
+    ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+
+    DateTimeFields oldestRecordTime;
+    DateTimeFields newestRecordTime;
+    int recordCount;
+    archiveManager.getArchiveRange(oldestRecordTime, newestRecordTime, recordCount);
+
+    if (recordCount != RECORD_COUNT) {
+        cout << "FAILED: Archive in " << archiveDirectory << " has " << recordCount << " records, expected " << RECORD_COUNT << endl;
+        exit(1);
+    }
+
+    //
+    // The entire archive, a range that is not a multiple of the chunk size, a range with a single record and a range with no records
+    //
+    streamRecords(archiveManager, oldestRecordTime, newestRecordTime);
+
+    DateTimeFields partialEndTime(oldestRecordTime.getEpochDateTime() + 86400 + 3600);
+    streamRecords(archiveManager, oldestRecordTime, partialEndTime);
+
+    streamRecords(archiveManager, newestRecordTime, newestRecordTime);
+
+    DateTimeFields emptyStartTime(oldestRecordTime.getEpochDateTime() - (86400 * 10));
+    DateTimeFields emptyEndTime(oldestRecordTime.getEpochDateTime() - 86400);
+    streamRecords(archiveManager, emptyStartTime, emptyEndTime);
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "ArchiveVerification.h"
+#include "DateTimeFields.h"
+#include "MappedArchiveFile.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "verification-test-archive.dat";
+static const int RECORD_COUNT = 50000;
+
+/**
+ * Append an archive record with the specified time to the stream.
+ */
+void
+writeRecord(ofstream & stream, DateTime time) {
+    vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    makeArchiveRecord(time, buffer);
+    stream.write(buffer, sizeof(buffer));
+}
+
+/**
+ * Create an archive at a 5 minute archive period with anomalies at known records. The 8192 record chunks
+ * of the verification start at records 8192, 16384, 24576...
+ */
+void
+createArchive(const string & archivePath) {
+    ofstream stream(archivePath, ios::binary | ios::trunc);
+    DateTime time = DateTimeFields(2024, 4, 1, 0, 0, 0).getEpochDateTime();
+    DateTime newestTime = time;
+
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        if (i == 5000 || i == 8192)
+            time += 3 * 300;                         // Three missing records, the second gap is the first record of a chunk
+
+        if (i == 12000 || i == 16384) {
+            writeRecord(stream, newestTime - 600);   // A record that is older than the previous record
+            continue;
+        }
+
+        if (i == 40000) {
+            vws::byte empty[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+            memset(empty, 0, sizeof(empty));
+            stream.write(empty, sizeof(empty));
+            continue;
+        }
+
+        if ((i > 30000 && i <= 30010) || (i > 24570 && i <= 24590))
+            time += 60;                              // A period change, the second crosses a chunk boundary
+        else if (i > 0)
+            time += 300;
+
+        writeRecord(stream, time);
+        newestTime = time;
+    }
+}
+
+/**
+ * Check that an anomaly was found.
+ */
+bool
+hasAnomaly(const ArchiveVerification & verification, ArchiveVerification::AnomalyType type, int recordIndex, DateTime delta = 0, int runLength = 0) {
+    for (const ArchiveVerification::Anomaly & anomaly : verification.getAnomalies()) {
+        if (anomaly.type == type && anomaly.recordIndex == recordIndex && anomaly.delta == delta && anomaly.runLength == runLength)
+            return true;
+    }
+
+    cout << "    Anomaly " << ArchiveVerification::anomalyTypeName(type) << " at record " << recordIndex << " was not found" << endl;
+    return false;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+
+    if (argc != 2) {
+        cout << "Usage: ArchiveVerificationTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+    createArchive(archivePath);
+
+    MappedArchiveFile archive(archivePath);
+
+    ArchiveVerification parallel(archive, 8);
+    bool valid = parallel.verify();
+    if (!valid && parallel.getChunkCount() == 7 && parallel.getRecordCount() == RECORD_COUNT && parallel.getArchivePeriod() == 300)
+        cout << "PASSED: Archive was verified in " << parallel.getChunkCount() << " chunks" << endl;
+    else
+        cout << "FAILED: Archive verification found a period of " << parallel.getArchivePeriod() << " in " << parallel.getChunkCount() << " chunks" << endl;
+
+    if (hasAnomaly(parallel, ArchiveVerification::AnomalyType::GAP, 5000, 1200, 1) &&
+        hasAnomaly(parallel, ArchiveVerification::AnomalyType::GAP, 8192, 1200, 1))
+        cout << "PASSED: Gaps were found, including the gap at a chunk boundary" << endl;
+    else
+        cout << "FAILED: Gaps were not found" << endl;
+
+    if (hasAnomaly(parallel, ArchiveVerification::AnomalyType::OUT_OF_ORDER, 12000) &&
+        hasAnomaly(parallel, ArchiveVerification::AnomalyType::OUT_OF_ORDER, 16384) &&
+        hasAnomaly(parallel, ArchiveVerification::AnomalyType::INVALID_TIME, 40000))
+        cout << "PASSED: Out of order and invalid records were found, including the record at a chunk boundary" << endl;
+    else
+        cout << "FAILED: Out of order or invalid records were not found" << endl;
+
+    if (hasAnomaly(parallel, ArchiveVerification::AnomalyType::DELTA_CHANGE, 30001, 60, 10) &&
+        hasAnomaly(parallel, ArchiveVerification::AnomalyType::DELTA_CHANGE, 24571, 60, 20))
+        cout << "PASSED: Delta changes were found, including the change that crosses a chunk boundary" << endl;
+    else
+        cout << "FAILED: Delta changes were not found" << endl;
+
+    //
+    // The record after an out of order record and the record after the invalid record are compared with the newest record
+    // before them, so no other anomalies are reported
+    //
+    if (parallel.getAnomalies().size() == 7 && parallel.getErrorCount() == 3 && parallel.getWarningCount() == 4)
+        cout << "PASSED: Only the injected anomalies were found" << endl;
+    else
+        cout << "FAILED: Found " << parallel.getAnomalies().size() << " anomalies, expected 7" << endl;
+
+    ArchiveVerification sequential(archive, 1);
+    sequential.verify();
+    bool same = sequential.getChunkCount() == 1 && sequential.getAnomalies().size() == parallel.getAnomalies().size();
+    for (size_t i = 0; same && i < sequential.getAnomalies().size(); i++) {
+        const ArchiveVerification::Anomaly & a = sequential.getAnomalies()[i];
+        const ArchiveVerification::Anomaly & b = parallel.getAnomalies()[i];
+        same = a.type == b.type && a.recordIndex == b.recordIndex && a.delta == b.delta && a.runLength == b.runLength && a.previousTime == b.previousTime;
+    }
+
+    if (same)
+        cout << "PASSED: Parallel verification matches the single chunk verification" << endl;
+    else
+        cout << "FAILED: Parallel verification does not match the single chunk verification" << endl;
+
+    string json = parallel.formatJSON(archivePath);
+    if (json.find("\"type\" : \"gap\", \"record\" : 8192, \"offset\" : 425984") != string::npos && json.find("\"errors\" : 3") != string::npos)
+        cout << "PASSED: JSON report contains the anomalies with their file offsets" << endl;
+    else
+        cout << "FAILED: JSON report is missing the anomalies: " << json.substr(0, 200) << endl;
+
+    //
+    // The archive manager verifies the current archive on a background thread and writes the report
+    //
+    string reportPath = archiveDirectory + ARCHIVE_VERIFY_REPORT;
+    unlink(reportPath.c_str());
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_ERROR);
+    {
+        ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+        if (archiveManager.startCurrentArchiveVerification())
+            cout << "PASSED: Background verification was started" << endl;
+        else
+            cout << "FAILED: Background verification was not started" << endl;
+    }
+
+    ifstream reportStream(reportPath);
+    stringstream report;
+    report << reportStream.rdbuf();
+    if (report.str().find("\"records\" : 50000") != string::npos && report.str().find("\"delta-change\"") != string::npos)
+        cout << "PASSED: Background verification wrote the JSON report" << endl;
+    else
+        cout << "FAILED: Background verification did not write the JSON report" << endl;
+
+    unlink(reportPath.c_str());
+    unlink((archiveDirectory + ARCHIVE_VERIFY_LOG).c_str());
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstring>
+#include "ArchiveColumn.h"
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+#include "LoopPacket.h"
+#include "VantageCRC.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+/**
+ * Benchmark that decodes a million synthetic LOOP packets and a million archive packets. The field loads of the packets
+ * are also timed with the byte-at-a-time conversion that BitConverter used before the conversions were specialized
+ * by width, signedness and byte order.
+ */
+
+static const int PACKET_COUNT = 1000000;
+static const int DISTINCT_PACKETS = 1024;
+
+static mt19937 randomGenerator(24680);
+
+/**
+ * The byte-at-a-time conversion with runtime byte order that was used before load().
+ */
+template <typename T>
+T
+legacyBitsToInt(const vws::byte * bits, bool littleEndian, bool isSigned) {
+    T result = 0;
+    bool signBitSet = false;
+    if (littleEndian) {
+        signBitSet = bits[sizeof(T) - 1] & 0x80;
+        for (int n = sizeof(T) - 1; n >= 0; n--)
+            result = (result << 8) + (static_cast<int>(bits[n]) & 0xFF);
+    }
+    else {
+        signBitSet = bits[0] & 0x80;
+        for (int n = 0; n < static_cast<int>(sizeof(T)); n++)
+            result = (result << 8) + (static_cast<int>(bits[n]) & 0xFF);
+    }
+
+    (void)signBitSet;
+    return result;
+}
+
+/**
+ * Create LOOP packets with random field values that pass the LOOP packet validation.
+ */
+void
+createLoopPackets(vector<vws::byte> & packets) {
+    packets.resize(DISTINCT_PACKETS * LoopPacket::LOOP_PACKET_SIZE);
+    for (int i = 0; i < DISTINCT_PACKETS; i++) {
+        vws::byte * packet = &packets[i * LoopPacket::LOOP_PACKET_SIZE];
+        for (int j = 0; j < LoopPacket::LOOP_PACKET_SIZE; j++)
+            packet[j] = randomGenerator() & 0xFF;
+
+        packet[0] = 'L';
+        packet[1] = 'O';
+        packet[2] = 'O';
+        packet[3] = 0;                                   // Steady barometer trend
+        packet[4] = LoopPacket::LOOP_PACKET_TYPE;
+        packet[95] = '\n';
+        packet[96] = '\r';
+        BitConverter::getBytes(VantageCRC::calculateCRC(packet, 97), packet, 97, 2, false);
+    }
+}
+
+/**
+ * Create archive packets with random field values.
+ */
+void
+createArchivePackets(vector<vws::byte> & packets) {
+    packets.resize(DISTINCT_PACKETS * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+    for (vws::byte & b : packets)
+        b = randomGenerator() & 0xFF;
+}
+
+/**
+ * Report the time it took to process the packets.
+ */
+void
+report(const string & description, chrono::steady_clock::time_point start, chrono::steady_clock::time_point end) {
+    double millis = chrono::duration<double, milli>(end - start).count();
+    cout << description << " " << PACKET_COUNT << " packets in " << millis << " ms ("
+         << static_cast<int>(PACKET_COUNT / (millis / 1000.0)) << " packets/s)" << endl;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_ERROR);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    vector<vws::byte> loopPackets;
+    vector<vws::byte> archivePackets;
+    createLoopPackets(loopPackets);
+    createArchivePackets(archivePackets);
+
+    //
+    // Every two byte field of the LOOP packet, with the runtime byte order conversion and with load()
+    //
+    int legacySum = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        const vws::byte * packet = &loopPackets[(i % DISTINCT_PACKETS) * LoopPacket::LOOP_PACKET_SIZE];
+        for (int offset = 5; offset < 95; offset += 2)
+            legacySum += legacyBitsToInt<int16>(&packet[offset], true, true);
+    }
+
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    int loadSum = 0;
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        const vws::byte * packet = &loopPackets[(i % DISTINCT_PACKETS) * LoopPacket::LOOP_PACKET_SIZE];
+        for (int offset = 5; offset < 95; offset += 2)
+            loadSum += BitConverter::load<int16>(packet, offset);
+    }
+
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+
+    if (legacySum == loadSum)
+        cout << "PASSED: Byte-at-a-time and specialized loads produce the same values" << endl;
+    else
+        cout << "FAILED: Byte-at-a-time and specialized loads produce different values" << endl;
+
+    report("Loaded the 16 bit fields byte-at-a-time of", t0, t1);
+    report("Loaded the 16 bit fields with load() of", t1, t2);
+
+    //
+    // Full decodes with the packet classes
+    //
+    LoopPacket loopPacket;
+    int decoded = 0;
+    t0 = chrono::steady_clock::now();
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        if (loopPacket.decodeLoopPacket(&loopPackets[(i % DISTINCT_PACKETS) * LoopPacket::LOOP_PACKET_SIZE]))
+            decoded++;
+    }
+
+    t1 = chrono::steady_clock::now();
+
+    if (decoded == PACKET_COUNT)
+        cout << "PASSED: Every LOOP packet was decoded" << endl;
+    else
+        cout << "FAILED: " << decoded << " of " << PACKET_COUNT << " LOOP packets were decoded" << endl;
+
+    report("Decoded", t0, t1);
+
+    double columnSum = 0.0;
+    t0 = chrono::steady_clock::now();
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        const vws::byte * record = &archivePackets[(i % DISTINCT_PACKETS) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+        for (int column = 0; column < ArchiveColumn::getColumnCount(); column++) {
+            Measurement<double> value = ArchiveColumn::getColumn(column).decodeValue(record);
+            if (value.isValid())
+                columnSum += value.getValue();
+        }
+    }
+
+    t1 = chrono::steady_clock::now();
+    report("Decoded every column of", t0, t1);
+
+    //
+    // Keep the sums live so that the loops are not optimized away
+    //
+    if (columnSum == 0.0)
+        cout << "No archive column values were decoded" << endl;
+}
@@ -96,5 +96,55 @@ main(int argc, char *argv[]) {
     int value = -9;
     BitConverter::getBytes(value, buffer, 0, 1);
 
-    cout << "Bytes: 0x" << hex << (int)buffer[0] << endl;
+    cout << "Bytes: 0x" << hex << (int)buffer[0] << dec << endl;
+
+    //
+    // The loads can be evaluated at compile time
+    //
+    static constexpr vws::byte CONSTANT_BYTES[] = {static_cast<vws::byte>(0x34), static_cast<vws::byte>(0x12), static_cast<vws::byte>(0xFE), static_cast<vws::byte>(0xFF)};
+    static_assert(BitConverter::load<uint16>(CONSTANT_BYTES, 0) == 0x1234);
+    static_assert(BitConverter::load<uint16, BitConverter::Endian::BIG>(CONSTANT_BYTES, 0) == 0x3412);
+    static_assert(BitConverter::load<int16>(CONSTANT_BYTES, 2) == -2);
+    static_assert(BitConverter::load<int32>(CONSTANT_BYTES, 0) == static_cast<int32>(0xFFFE1234));
+    static_assert(BitConverter::toInt8(CONSTANT_BYTES, 2) == -2);
+
+    //
+    // Every 16 bit value in both byte orders, signed and unsigned, matches the shift-and-add conversion
+    //
+    int mismatches = 0;
+    for (int v = 0; v < 65536; v++) {
+        buffer[0] = v & 0xFF;
+        buffer[1] = (v >> 8) & 0xFF;
+        int bigEndianValue = ((v & 0xFF) << 8) | ((v >> 8) & 0xFF);
+        if (BitConverter::toUint16(buffer, 0) != v ||
+            BitConverter::toInt16(buffer, 0) != static_cast<int16>(v) ||
+            BitConverter::toUint16(buffer, 0, false) != bigEndianValue ||
+            BitConverter::load<int16, BitConverter::Endian::BIG>(buffer, 0) != static_cast<int16>(bigEndianValue))
+            mismatches++;
+
+        if (v < 256 && (BitConverter::toUint8(buffer, 0) != v || BitConverter::toInt8(buffer, 0) != static_cast<signed char>(v)))
+            mismatches++;
+    }
+
+    //
+    // 32 bit values at every alignment
+    //
+    vws::byte buffer32[12];
+    uint32 values[] = {0, 1, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, 0x12345678, 0xDEADBEEF};
+    for (uint32 v : values) {
+        for (int offset = 0; offset < 8; offset++) {
+            BitConverter::getBytes(v, buffer32, offset, 4);
+            if (BitConverter::toUint32(buffer32, offset) != v || BitConverter::toInt32(buffer32, offset) != static_cast<int32>(v))
+                mismatches++;
+
+            BitConverter::getBytes(v, buffer32, offset, 4, false);
+            if (BitConverter::toUint32(buffer32, offset, false) != v || BitConverter::load<int32, BitConverter::Endian::BIG>(buffer32, offset) != static_cast<int32>(v))
+                mismatches++;
+        }
+    }
+
+    if (mismatches == 0)
+        cout << "PASSED: Conversions of every 16 bit value and of 32 bit values at every alignment are correct" << endl;
+    else
+        cout << "FAILED: " << mismatches << " conversions are not correct" << endl;
 }
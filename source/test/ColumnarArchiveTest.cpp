@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <unistd.h>
+#include "ArchiveColumn.h"
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "ColumnarArchive.h"
+#include "MappedArchiveFile.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "columnar-test-archive.dat";
+
+static mt19937 randomGenerator(13579);
+
+/**
+ * Build an archive packet whose values drift slowly, the way real weather does.
+ */
+ArchivePacket
+createPacket(DateTime packetTime, int & temperature) {
+    uniform_int_distribution<int> step(-3, 3);
+    uniform_int_distribution<int> rain(0, 30);
+    uniform_int_distribution<int> heading(0, 16);
+    uniform_int_distribution<int> speed(0, 25);
+
+    vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    DateTimeFields fields(packetTime);
+    makeArchiveRecord(fields, buffer);
+
+    temperature += step(randomGenerator);
+    BitConverter::getBytes(temperature, buffer, 4, 2);
+    BitConverter::getBytes(temperature + 5, buffer, 6, 2);
+    BitConverter::getBytes(temperature - 5, buffer, 8, 2);
+
+    int rainClicks = rain(randomGenerator);
+    if (rainClicks > 2)
+        rainClicks = 0;
+
+    BitConverter::getBytes(rainClicks, buffer, 10, 2);
+    BitConverter::getBytes(rainClicks * 12, buffer, 12, 2);
+    BitConverter::getBytes(29900 + (temperature % 100), buffer, 14, 2);
+    BitConverter::getBytes(fields.getHour() * 40, buffer, 16, 2);
+    BitConverter::getBytes(temperature + 50, buffer, 20, 2);
+    buffer[22] = static_cast<vws::byte>(45);
+    buffer[23] = static_cast<vws::byte>(60 + (temperature % 30));
+
+    //
+    // A heading of 16 is stored as the dashed value
+    //
+    int windHeading = heading(randomGenerator);
+    int windSpeed = speed(randomGenerator);
+    buffer[24] = static_cast<vws::byte>(windSpeed);
+    buffer[25] = static_cast<vws::byte>(windSpeed + 5);
+    buffer[26] = static_cast<vws::byte>(windHeading == 16 ? 255 : windHeading);
+    buffer[27] = static_cast<vws::byte>(windHeading == 16 ? 255 : windHeading);
+    buffer[28] = static_cast<vws::byte>(fields.getHour() / 3);
+    buffer[29] = static_cast<vws::byte>(rainClicks);
+    buffer[32] = static_cast<vws::byte>(fields.getHour() / 2);
+
+    return ArchivePacket(buffer);
+}
+
+/**
+ * Create the packets from a start time up to, but not including, an end time at a 5 minute archive period.
+ */
+void
+createPackets(const DateTimeFields & start, const DateTimeFields & end, int & temperature, vector<ArchivePacket> & packets) {
+    packets.clear();
+    DateTimeFields lastPacketTime;
+
+    for (DateTime packetTime = start.getEpochDateTime(); packetTime < end.getEpochDateTime(); packetTime += 300) {
+        //
+        // Like the console, do not write records during the repeated hour when DST ends
+        //
+        DateTimeFields fields(packetTime);
+        if (lastPacketTime < fields) {
+            packets.push_back(createPacket(packetTime, temperature));
+            lastPacketTime = fields;
+        }
+    }
+}
+
+/**
+ * Compare the column values returned by the archive manager with the values decoded from the raw records.
+ */
+bool
+compareColumn(const ArchiveManager & archiveManager, const DateTimeFields & start, const DateTimeFields & end, const ArchiveColumn & column) {
+    vector<ColumnSample> samples;
+    archiveManager.queryArchiveColumn(start, end, column, samples);
+
+    std::span<const vws::byte> records;
+    std::shared_ptr<const MappedArchiveFile> mapping = archiveManager.queryArchiveRecordSpan(start, end, records);
+    size_t recordCount = records.size() / ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+
+    if (samples.size() != recordCount) {
+        cout << "    Column " << column.name << " has " << samples.size() << " samples, expected " << recordCount << endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < recordCount; i++) {
+        const vws::byte * record = records.data() + (i * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        Measurement<double> expected = column.decodeValue(record);
+        if (samples[i].time != ArchivePacket(record).getDateTimeFields() ||
+            samples[i].value.isValid() != expected.isValid() || samples[i].value.getValue() != expected.getValue()) {
+            cout << "    Column " << column.name << " sample " << i << " at " << samples[i].time.formatDateTime() << " does not match the archive" << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: ColumnarArchiveTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+    string columnPath = archivePath + COLUMNAR_ARCHIVE_FILE_SUFFIX;
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    unlink(columnPath.c_str());
+    filesystem::remove_all(archiveDirectory + "/packets");
+
+    //
+    // Three complete months, including the end of DST and the end of a year, and a few days of January
+    //
+    int temperature = 600;
+    vector<ArchivePacket> packets;
+    createPackets(DateTimeFields(2024, 10, 1, 0, 0, 0), DateTimeFields(2025, 1, 6, 0, 0, 0), temperature, packets);
+
+    ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+    archiveManager.addPacketsToArchive(packets);
+    archiveManager.enableColumnarArchive();
+
+    {
+        ColumnarArchive columnarArchive(columnPath);
+        MappedArchiveFile archive(archivePath);
+        if (columnarArchive.getMonthCount() == 3 && columnarArchive.verify(archive))
+            cout << "PASSED: Columnar archive contains the three complete months and matches the archive" << endl;
+        else
+            cout << "FAILED: Columnar archive contains " << columnarArchive.getMonthCount() << " months, expected 3" << endl;
+
+        size_t columnarSize = filesystem::file_size(columnPath);
+        size_t rawSize = static_cast<size_t>(columnarArchive.getSummarizedRecordCount()) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+        if (columnarSize * 4 < rawSize)
+            cout << "PASSED: Columnar archive is " << columnarSize << " bytes for " << rawSize << " bytes of archive records" << endl;
+        else
+            cout << "FAILED: Columnar archive is " << columnarSize << " bytes for " << rawSize << " bytes of archive records" << endl;
+    }
+
+    //
+    // Queries that start and end within months, span the columnar and raw records and lie entirely within one tier
+    //
+    DateTimeFields queryRanges[][2] = {
+        {DateTimeFields(2024, 10, 15, 13, 2, 0), DateTimeFields(2025, 1, 3, 8, 30, 0)},
+        {DateTimeFields(2024, 11, 3, 0, 0, 0),   DateTimeFields(2024, 11, 3, 23, 59, 0)},
+        {DateTimeFields(2024, 1, 1, 0, 0, 0),    DateTimeFields(2026, 1, 1, 0, 0, 0)},
+        {DateTimeFields(2025, 1, 2, 0, 0, 0),    DateTimeFields(2025, 1, 4, 0, 0, 0)}
+    };
+
+    int columnMismatches = 0;
+    for (const auto & range : queryRanges) {
+        for (int i = 0; i < ArchiveColumn::getColumnCount(); i++) {
+            if (!compareColumn(archiveManager, range[0], range[1], ArchiveColumn::getColumn(i)))
+                columnMismatches++;
+        }
+    }
+
+    if (columnMismatches == 0)
+        cout << "PASSED: Column queries match the archive records" << endl;
+    else
+        cout << "FAILED: " << columnMismatches << " column queries do not match the archive records" << endl;
+
+    //
+    // Completing January appends a month block
+    //
+    createPackets(DateTimeFields(2025, 1, 6, 0, 0, 0), DateTimeFields(2025, 2, 2, 0, 0, 0), temperature, packets);
+    archiveManager.addPacketsToArchive(packets);
+    {
+        ColumnarArchive columnarArchive(columnPath);
+        MappedArchiveFile archive(archivePath);
+        if (columnarArchive.getMonthCount() == 4 && columnarArchive.verify(archive))
+            cout << "PASSED: Completed month was appended to the columnar archive" << endl;
+        else
+            cout << "FAILED: Columnar archive contains " << columnarArchive.getMonthCount() << " months after January was completed, expected 4" << endl;
+    }
+
+    //
+    // A partial month block at the end of the file is removed and the month is encoded again
+    //
+    filesystem::resize_file(columnPath, filesystem::file_size(columnPath) - 100);
+    {
+        ColumnarArchive columnarArchive(columnPath);
+        MappedArchiveFile archive(archivePath);
+        int monthsAfterTruncation = columnarArchive.getMonthCount();
+        columnarArchive.synchronize(archive);
+        if (monthsAfterTruncation == 3 && columnarArchive.getMonthCount() == 4 && columnarArchive.verify(archive))
+            cout << "PASSED: Partial month block was replaced" << endl;
+        else
+            cout << "FAILED: Partial month block was not replaced" << endl;
+    }
+
+    //
+    // A corrupted column is detected by the verification and repaired by the archive verification
+    //
+    {
+        fstream stream(columnPath.c_str(), ios::in | ios::out | ios::binary);
+        stream.seekp(filesystem::file_size(columnPath) - 10);
+        stream.write("XXXX", 4);
+    }
+    {
+        ColumnarArchive columnarArchive(columnPath);
+        MappedArchiveFile archive(archivePath);
+        bool detected = !columnarArchive.verify(archive);
+        ArchiveManager repairingManager(archiveDirectory, ARCHIVE_FILE);
+        repairingManager.enableColumnarArchive();
+        repairingManager.verifyCurrentArchiveFile();
+        ColumnarArchive repairedArchive(columnPath);
+        if (detected && repairedArchive.verify(archive))
+            cout << "PASSED: Corrupted column was detected and rebuilt" << endl;
+        else
+            cout << "FAILED: Corrupted column was not detected or rebuilt" << endl;
+    }
+
+    //
+    // Compare the time to read one column of the complete months from each tier
+    //
+    {
+        const ArchiveColumn & column = *ArchiveColumn::findColumn("avgOutsideTemperature");
+        DateTimeFields start(2024, 10, 1, 0, 0, 0);
+        DateTimeFields end(2024, 12, 31, 23, 59, 0);
+        ColumnarArchive columnarArchive(columnPath);
+        vector<ColumnSample> samples;
+
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+        columnarArchive.readColumn(start, end, column.columnId, samples);
+        chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+
+        vector<ArchivePacket> list;
+        archiveManager.queryArchiveRecords(start, end, list);
+        double sum = 0.0;
+        for (const ArchivePacket & packet : list)
+            sum += packet.getAverageOutsideTemperature().getValue();
+        chrono::steady_clock::time_point t3 = chrono::steady_clock::now();
+
+        cout << "Read " << samples.size() << " values from the columnar archive in " << chrono::duration<double, milli>(t2 - t1).count()
+             << " ms, decoded " << list.size() << " archive packets in " << chrono::duration<double, milli>(t3 - t2).count() << " ms" << endl;
+    }
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    unlink(columnPath.c_str());
+}
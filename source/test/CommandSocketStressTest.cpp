@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "CommandSocket.h"
+
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <string.h>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include "CommandHandler.h"
+#include "CommandData.h"
+#include "ResponseStream.h"
+#include "VantageLogger.h"
+
+using namespace std;
+using namespace vws;
+
+static const int PORT = 11464;
+static const int COMMANDS_PER_CLIENT = 5;
+static const int LARGE_RESPONSE_CHUNKS = 512;
+static const int LARGE_RESPONSE_CHUNK_SIZE = 65536;
+static const int HELD_COMMANDS = 200;
+static const int MAX_COMMANDS_IN_PROGRESS = 32;   // CommandSocket::MAX_PENDING_RESPONSES
+
+/**
+ * Response stream that produces a large response of a known size.
+ */
+class LargeResponseStream : public ResponseStream {
+public:
+    LargeResponseStream() : chunkCount(0) {}
+
+    virtual bool nextChunk(std::string & chunk) {
+        chunk.append(LARGE_RESPONSE_CHUNK_SIZE, 'x');
+        chunkCount++;
+        if (chunkCount < LARGE_RESPONSE_CHUNKS)
+            return true;
+
+        chunk.append("\"");
+        return false;
+    }
+
+private:
+    int chunkCount;
+};
+
+/**
+ * Command handler that responds to commands on its own thread, like the handlers of the console.
+ */
+class StressCommandHandler : public CommandHandler {
+public:
+    StressCommandHandler() : terminating(false), holdCommands(true), heldCommandCount(0) {}
+
+    virtual void handleCommand(CommandData & commandData) {
+        //
+        // Held commands are not answered until they are released, like a command waiting for the console
+        //
+        if (commandData.commandName == "held") {
+            while (holdCommands)
+                this_thread::sleep_for(chrono::milliseconds(10));
+        }
+
+        if (commandData.commandName == "large-response") {
+            commandData.response.append("\"success\", \"data\" : \"");
+            commandData.responseStream = std::make_shared<LargeResponseStream>();
+        }
+        else {
+            string client;
+            string sequence;
+            for (auto & arg : commandData.arguments) {
+                if (arg.first == "client")
+                    client = arg.second;
+                else if (arg.first == "sequence")
+                    sequence = arg.second;
+            }
+
+            commandData.response.append("\"success\", \"data\" : { \"client\" : \"" + client + "\", \"sequence\" : \"" + sequence + "\" }");
+        }
+    }
+
+    virtual bool offerCommand(const CommandData & commandData) {
+        if (commandData.commandName == "held")
+            heldCommandCount++;
+
+        commandQueue.queueCommand(commandData);
+        return true;
+    }
+
+    void mainLoop() {
+        while (!terminating) {
+            CommandData commandData;
+            if (commandQueue.waitForCommand(commandData))
+                processCommand(commandData);
+        }
+    }
+
+    void terminate() {
+        terminating = true;
+        commandQueue.interrupt();
+    }
+
+    void releaseCommands() {
+        holdCommands = false;
+    }
+
+    int getHeldCommandCount() const {
+        return heldCommandCount;
+    }
+
+private:
+    std::atomic<bool> terminating;
+    std::atomic<bool> holdCommands;
+    std::atomic<int>  heldCommandCount;
+};
+
+/**
+ * Connect a client socket to the command socket.
+ */
+int
+connectSocket() {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+
+    sockaddr_in serverAddress;
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(PORT);
+    serverAddress.sin_addr.s_addr = INADDR_ANY;
+
+    struct timeval tv;
+    tv.tv_sec = 20;
+    tv.tv_usec = 0;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    if (connect(s, (struct sockaddr*)&serverAddress, sizeof(serverAddress)) < 0) {
+        close(s);
+        return -1;
+    }
+
+    return s;
+}
+
+/**
+ * Build a command with the header.
+ */
+string
+buildCommand(const string & commandName, int client, int sequence) {
+    ostringstream body;
+    body << "{ \"command\" : \"" << commandName << "\", \"arguments\" : [ { \"client\" : \"" << client << "\" }, { \"sequence\" : \"" << sequence << "\" } ] }";
+
+    ostringstream command;
+    command << "VANTAGE " << setw(6) << setfill('0') << body.str().length() << " " << body.str();
+    return command.str();
+}
+
+/**
+ * Read from a socket until the specified number of responses have been received.
+ */
+bool
+readResponses(int s, int responseCount, string & responses) {
+    char buffer[65536];
+    int terminators = 0;
+
+    while (terminators < responseCount) {
+        int n = read(s, buffer, sizeof(buffer));
+        if (n <= 0)
+            return false;
+
+        responses.append(buffer, n);
+
+        terminators = 0;
+        for (size_t pos = responses.find("\n\n"); pos != string::npos; pos = responses.find("\n\n", pos + 2))
+            terminators++;
+    }
+
+    return true;
+}
+
+/**
+ * A client that sends its first command in pieces, then the rest of its commands in a single write.
+ * The sockets are connected before the clients run so the connection backlog does not limit the test.
+ */
+void
+runClient(int s, int client, std::atomic<int> & successCount) {
+    string firstCommand = buildCommand("echo", client, 0);
+    write(s, firstCommand.c_str(), 5);
+    this_thread::sleep_for(chrono::milliseconds(10));
+    write(s, firstCommand.c_str() + 5, 12);
+    this_thread::sleep_for(chrono::milliseconds(10));
+    write(s, firstCommand.c_str() + 17, firstCommand.length() - 17);
+
+    string pipelined;
+    for (int i = 1; i < COMMANDS_PER_CLIENT; i++)
+        pipelined.append(buildCommand("echo", client, i));
+
+    write(s, pipelined.c_str(), pipelined.length());
+
+    string responses;
+    bool success = readResponses(s, COMMANDS_PER_CLIENT, responses);
+    close(s);
+
+    if (!success)
+        return;
+
+    for (int i = 0; i < COMMANDS_PER_CLIENT; i++) {
+        ostringstream expected;
+        expected << "{ \"client\" : \"" << client << "\", \"sequence\" : \"" << i << "\" }";
+        if (responses.find(expected.str()) == string::npos)
+            return;
+    }
+
+    successCount++;
+}
+
+int
+main(int argc, char *argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+
+    int clientCount = 600;
+    if (argc > 1)
+        clientCount = atoi(argv[1]);
+
+    //
+    // Allow more than 1024 open files, which is the limit of select()
+    //
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = std::min(limit.rlim_max, static_cast<rlim_t>(8192));
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    StressCommandHandler handler;
+    thread handlerThread(&StressCommandHandler::mainLoop, &handler);
+
+    CommandSocket commandSocket(PORT);
+    commandSocket.addCommandHandler(handler);
+
+    if (!commandSocket.start()) {
+        cout << "FAILED: Could not start the command socket" << endl;
+        exit(1);
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(500));
+
+    //
+    // Start a slow client that requests a large response, but does not read it
+    //
+    int slowSocket = connectSocket();
+    string largeCommand = buildCommand("large-response", -1, 0);
+    write(slowSocket, largeCommand.c_str(), largeCommand.length());
+    this_thread::sleep_for(chrono::milliseconds(500));
+
+    //
+    // All of the other clients must be served while the slow client is not reading
+    //
+    vector<int> clientSockets;
+    for (int i = 0; i < clientCount; i++) {
+        int s = connectSocket();
+        if (s < 0) {
+            cout << "FAILED: Could not connect client " << i << endl;
+            exit(1);
+        }
+
+        clientSockets.push_back(s);
+    }
+
+    std::atomic<int> successCount(0);
+    vector<thread> clients;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < clientCount; i++)
+        clients.emplace_back(runClient, clientSockets[i], i, std::ref(successCount));
+
+    for (auto & client : clients)
+        client.join();
+
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    if (successCount == clientCount)
+        cout << "PASSED: " << clientCount << " concurrent clients received all " << COMMANDS_PER_CLIENT << " responses in " << elapsed << " ms" << endl;
+    else
+        cout << "FAILED: Only " << successCount << " of " << clientCount << " concurrent clients received all of their responses" << endl;
+
+    //
+    // Now read the large response
+    //
+    string largeResponse;
+    bool success = readResponses(slowSocket, 1, largeResponse);
+    close(slowSocket);
+
+    size_t expectedLength = string("{ \"response\" : \"large-response\", \"result\" : \"success\", \"data\" : \"").length()
+                          + (LARGE_RESPONSE_CHUNKS * LARGE_RESPONSE_CHUNK_SIZE) + string("\"}\n\n").length();
+
+    if (success && largeResponse.length() == expectedLength && largeResponse.ends_with("xx\"}\n\n"))
+        cout << "PASSED: Slow client received the entire " << largeResponse.length() << " byte response" << endl;
+    else
+        cout << "FAILED: Slow client received " << largeResponse.length() << " bytes, expected " << expectedLength << endl;
+
+    //
+    // A command that is longer than the command socket will buffer must close the connection
+    //
+    int oversizedSocket = connectSocket();
+    string oversizedHeader = "VANTAGE 999999 ";
+    write(oversizedSocket, oversizedHeader.c_str(), oversizedHeader.length());
+    char byte;
+    ssize_t oversizedRead = read(oversizedSocket, &byte, 1);
+    close(oversizedSocket);
+
+    if (oversizedRead == 0)
+        cout << "PASSED: A command longer than the maximum command length closed the connection" << endl;
+    else
+        cout << "FAILED: A command longer than the maximum command length did not close the connection" << endl;
+
+    //
+    // A client that sends many commands while the handler is not answering them must not have all of them queued
+    //
+    int pipelinedSocket = connectSocket();
+    string heldCommands;
+    for (int i = 0; i < HELD_COMMANDS; i++)
+        heldCommands.append(buildCommand("held", -2, i));
+
+    write(pipelinedSocket, heldCommands.c_str(), heldCommands.length());
+    this_thread::sleep_for(chrono::milliseconds(500));
+    int offeredWhileHeld = handler.getHeldCommandCount();
+
+    if (offeredWhileHeld <= MAX_COMMANDS_IN_PROGRESS)
+        cout << "PASSED: Only " << offeredWhileHeld << " of " << HELD_COMMANDS << " commands were accepted while none were answered" << endl;
+    else
+        cout << "FAILED: " << offeredWhileHeld << " commands were accepted while none were answered, limit is " << MAX_COMMANDS_IN_PROGRESS << endl;
+
+    //
+    // A client that hangs up while it has the most commands in progress must not make the event loop spin
+    //
+    int hangupSocket = connectSocket();
+    write(hangupSocket, heldCommands.c_str(), heldCommands.length());
+    this_thread::sleep_for(chrono::milliseconds(200));
+    close(hangupSocket);
+
+    struct rusage usageBefore;
+    struct rusage usageAfter;
+    getrusage(RUSAGE_SELF, &usageBefore);
+    this_thread::sleep_for(chrono::milliseconds(1000));
+    getrusage(RUSAGE_SELF, &usageAfter);
+    long cpuMillis = ((usageAfter.ru_utime.tv_sec - usageBefore.ru_utime.tv_sec) + (usageAfter.ru_stime.tv_sec - usageBefore.ru_stime.tv_sec)) * 1000 +
+                     ((usageAfter.ru_utime.tv_usec - usageBefore.ru_utime.tv_usec) + (usageAfter.ru_stime.tv_usec - usageBefore.ru_stime.tv_usec)) / 1000;
+
+    if (cpuMillis < 200)
+        cout << "PASSED: " << cpuMillis << " ms of CPU were used in the second after a client hung up with commands in progress" << endl;
+    else
+        cout << "FAILED: " << cpuMillis << " ms of CPU were used in the second after a client hung up with commands in progress" << endl;
+
+    handler.releaseCommands();
+    string heldResponses;
+    success = readResponses(pipelinedSocket, HELD_COMMANDS, heldResponses);
+    close(pipelinedSocket);
+
+    if (success && heldResponses.find("\"sequence\" : \"" + to_string(HELD_COMMANDS - 1) + "\"") != string::npos)
+        cout << "PASSED: All " << HELD_COMMANDS << " commands were answered after the handler was released" << endl;
+    else
+        cout << "FAILED: Only part of the " << HELD_COMMANDS << " commands were answered after the handler was released" << endl;
+
+    commandSocket.terminate();
+    commandSocket.join();
+    handler.terminate();
+    handlerThread.join();
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <vector>
+#include "AlarmManager.h"
+#include "ArchiveManager.h"
+#include "BaudRate.h"
+#include "CommandData.h"
+#include "ConsoleCommandHandler.h"
+#include "ResponseHandler.h"
+#include "SerialPort.h"
+#include "VantageConfiguration.h"
+#include "VantageConsoleEmulator.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+#include "VantageStationNetwork.h"
+#include "VantageWeatherStation.h"
+
+using namespace vws;
+using namespace std;
+
+/**
+ * Response handler that keeps the responses so that they can be checked.
+ */
+class ResponseCollector : public ResponseHandler {
+public:
+    virtual void handleCommandResponse(const CommandData & commandData) {
+        responses.push_back(commandData);
+    }
+
+    vector<CommandData> responses;
+};
+
+/**
+ * Create a command that will respond to the collector.
+ */
+CommandData
+createCommand(ResponseCollector & collector, const string & commandName, int socketId) {
+    CommandData commandData(collector, socketId);
+    commandData.commandName = commandName;
+    commandData.loadResponseTemplate();
+    return commandData;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_ERROR);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: ConsoleCommandBatchTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+
+    VantageConsoleEmulator::Settings settings = VantageConsoleEmulator::defaultSettings();
+    settings.baudRate = 0;
+    VantageConsoleEmulator emulator(settings);
+    emulator.start();
+
+    SerialPort serialPort(emulator.getDevicePath(), vws::BaudRate::BR_19200);
+    serialPort.open();
+    VantageWeatherStation station(serialPort, 5, .01);
+    station.wakeupStation();
+
+    ArchiveManager archiveManager(archiveDirectory);
+    VantageConfiguration configurator(station);
+    VantageStationNetwork network(archiveDirectory, station, archiveManager, 1);
+    AlarmManager alarmManager(archiveDirectory, station);
+    ConsoleCommandHandler commandHandler(station, configurator, network, alarmManager);
+
+    //
+    // A burst of commands like the one a dashboard sends when it is loaded
+    //
+    ResponseCollector collector;
+    for (int i = 0; i < 6; i++)
+        commandHandler.offerCommand(createCommand(collector, "query-highlows", 100 + i));
+
+    commandHandler.offerCommand(createCommand(collector, "query-console-time", 200));
+    commandHandler.offerCommand(createCommand(collector, "query-console-time", 201));
+
+    CommandData withArgument = createCommand(collector, "query-console-time", 202);
+    withArgument.arguments.push_back(CommandData::CommandArgument("name", "value"));
+    commandHandler.offerCommand(withArgument);
+
+    int commandsBefore = emulator.getStatistics().commands;
+    commandHandler.processQueuedCommands();
+    int consoleCommands = emulator.getStatistics().commands - commandsBefore;
+
+    if (collector.responses.size() == 9 && !commandHandler.isCommandAvailable())
+        cout << "PASSED: Every queued command was processed in one batch" << endl;
+    else
+        cout << "FAILED: " << collector.responses.size() << " of 9 queued commands were processed" << endl;
+
+    //
+    // One HILOWS for the six high/low queries and one GETTIME for each distinct console time query
+    //
+    if (consoleCommands == 3)
+        cout << "PASSED: Identical read-only commands shared one console transaction" << endl;
+    else
+        cout << "FAILED: Batch sent " << consoleCommands << " console commands, expected 3" << endl;
+
+    string highLowResponse;
+    int highLowResponses = 0;
+    bool identical = true;
+    for (const CommandData & response : collector.responses) {
+        if (response.commandName != "query-highlows")
+            continue;
+
+        if (highLowResponses++ == 0)
+            highLowResponse = response.response;
+        else if (response.response != highLowResponse)
+            identical = false;
+    }
+
+    if (highLowResponses == 6 && identical && highLowResponse.find(SUCCESS_TOKEN) != string::npos)
+        cout << "PASSED: The high/low response was sent to every requester" << endl;
+    else
+        cout << "FAILED: The high/low response was not sent to every requester. Responses: " << highLowResponses << endl;
+
+    //
+    // A command that changes the console is never shared
+    //
+    collector.responses.clear();
+    CommandData update = createCommand(collector, "update-archive-period", 300);
+    update.arguments.push_back(CommandData::CommandArgument("period", "10"));
+    commandHandler.offerCommand(update);
+    update.socketId = 301;
+    commandHandler.offerCommand(update);
+    commandsBefore = emulator.getStatistics().commands;
+    commandHandler.processQueuedCommands();
+    consoleCommands = emulator.getStatistics().commands - commandsBefore;
+    if (collector.responses.size() == 2 && consoleCommands == 2)
+        cout << "PASSED: Commands that change the console were each sent to the console" << endl;
+    else
+        cout << "FAILED: Commands that change the console sent " << consoleCommands << " console commands" << endl;
+
+    //
+    // A query after a command that changes the console must see the change
+    //
+    collector.responses.clear();
+    commandHandler.offerCommand(createCommand(collector, "query-archive-period", 400));
+    update.arguments.clear();
+    update.arguments.push_back(CommandData::CommandArgument("period", "15"));
+    update.socketId = 401;
+    commandHandler.offerCommand(update);
+    commandHandler.offerCommand(createCommand(collector, "query-archive-period", 402));
+    commandHandler.processQueuedCommands();
+
+    string firstPeriod, secondPeriod;
+    for (const CommandData & response : collector.responses) {
+        if (response.socketId == 400)
+            firstPeriod = response.response;
+        else if (response.socketId == 402)
+            secondPeriod = response.response;
+    }
+
+    if (collector.responses.size() == 3 && firstPeriod.find("\"period\" : 10") != string::npos && secondPeriod.find("\"period\" : 15") != string::npos)
+        cout << "PASSED: A query after an update was not given the response from before the update" << endl;
+    else
+        cout << "FAILED: Query after an update returned " << secondPeriod << endl;
+
+    serialPort.close();
+    emulator.stop();
+}
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+#include "ArchiveDownload.h"
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "BaudRate.h"
+#include "DateTimeFields.h"
+#include "LoopPacketListener.h"
+#include "SerialPort.h"
+#include "VantageConsoleEmulator.h"
+#include "VantageDecoder.h"
+#include "VantageEepromConstants.h"
+#include "VantageLogger.h"
+#include "VantageWeatherStation.h"
+
+using namespace vws;
+using namespace std;
+
+/**
+ * Benchmark of the serial protocol of VantageWeatherStation against a console emulator on a pseudo-terminal. The unpaced runs
+ * measure the cost of the protocol handling itself, the paced runs measure the behavior at the 19200 baud line rate of the
+ * console, including the recovery from CRC errors.
+ */
+
+static const int ROUND_TRIPS = 200;
+static const int ARCHIVE_PERIOD = 300;
+
+/**
+ * Listener that counts the LOOP and LOOP2 packets of a current values loop.
+ */
+class PacketCounter : public LoopPacketListener {
+public:
+    int loopPackets = 0;
+    int loop2Packets = 0;
+
+    virtual bool processLoopPacket(const LoopPacket & packet) {
+        loopPackets++;
+        return true;
+    }
+
+    virtual bool processLoop2Packet(const Loop2Packet & packet) {
+        loop2Packets++;
+        return true;
+    }
+};
+
+/**
+ * Milliseconds since a start time.
+ */
+double
+elapsedMillis(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Check that the downloaded records are every record of the emulated archive in order.
+ */
+bool
+checkRecords(const vector<ArchivePacket> & list, DateTime firstTime, int expectedCount) {
+    if (static_cast<int>(list.size()) != expectedCount) {
+        cout << "    Received " << list.size() << " records, expected " << expectedCount << endl;
+        return false;
+    }
+
+    for (int i = 0; i < expectedCount; i++) {
+        if (list[i].getDateTimeFields() != DateTimeFields(firstTime + (static_cast<DateTime>(i) * ARCHIVE_PERIOD))) {
+            cout << "    Record " << i << " has time " << list[i].getDateTimeFields() << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Run the unpaced protocol benchmarks.
+ */
+void
+benchmarkUnpaced(const string & archiveDirectory) {
+    VantageConsoleEmulator::Settings settings = VantageConsoleEmulator::defaultSettings();
+    settings.baudRate = 0;
+    settings.loopIntervalMillis = 0;
+    settings.clockOffsetSeconds = 3600;
+
+    //
+    // More records than the console holds, so the ring has wrapped
+    //
+    DateTime archiveStart = DateTimeFields(2024, 6, 1, 0, 0, 0).getEpochDateTime();
+    int totalRecords = NUM_ARCHIVE_RECORDS + 500;
+    DateTime oldestTime = archiveStart + (static_cast<DateTime>(totalRecords - NUM_ARCHIVE_RECORDS) * ARCHIVE_PERIOD);
+
+    VantageConsoleEmulator emulator(settings);
+    emulator.addArchiveRecords(archiveStart, ARCHIVE_PERIOD, totalRecords);
+    emulator.start();
+
+    SerialPort serialPort(emulator.getDevicePath(), vws::BaudRate::BR_19200);
+    serialPort.open();
+    VantageWeatherStation station(serialPort, ARCHIVE_PERIOD / 60, .01);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int awake = 0;
+    for (int i = 0; i < ROUND_TRIPS; i++)
+        if (station.wakeupStation())
+            awake++;
+
+    double millis = elapsedMillis(start);
+    if (awake == ROUND_TRIPS)
+        cout << "PASSED: Wake up " << ROUND_TRIPS << " times in " << millis << " ms (" << millis / ROUND_TRIPS << " ms per wake up)" << endl;
+    else
+        cout << "FAILED: Console woke up " << awake << " of " << ROUND_TRIPS << " times" << endl;
+
+    PacketCounter counter;
+    station.addLoopPacketListener(counter);
+    start = chrono::steady_clock::now();
+    station.currentValuesLoop(ROUND_TRIPS);
+    millis = elapsedMillis(start);
+    station.removeLoopPacketListener(counter);
+    if (counter.loopPackets == ROUND_TRIPS && counter.loop2Packets == ROUND_TRIPS)
+        cout << "PASSED: LPS loop of " << ROUND_TRIPS * 2 << " packets in " << millis << " ms (" << millis / (ROUND_TRIPS * 2) << " ms per packet)" << endl;
+    else
+        cout << "FAILED: LPS loop received " << counter.loopPackets << " LOOP and " << counter.loop2Packets << " LOOP2 packets" << endl;
+
+    vws::byte eepromData[16];
+    for (int i = 0; i < static_cast<int>(sizeof(eepromData)); i++)
+        eepromData[i] = i * 3;
+
+    //
+    // The graph data is never served from the EEPROM shadow, so every read is a round trip to the console
+    //
+    const unsigned eepromAddress = EepromConstants::EE_GRAPH_DATA_ADDRESS;
+    emulator.setEeprom(eepromAddress, eepromData, sizeof(eepromData));
+    vws::byte readData[sizeof(eepromData)];
+    int matches = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < ROUND_TRIPS; i++)
+        if (station.eepromBinaryRead(eepromAddress, sizeof(readData), readData) && memcmp(readData, eepromData, sizeof(readData)) == 0)
+            matches++;
+
+    millis = elapsedMillis(start);
+    if (matches == ROUND_TRIPS)
+        cout << "PASSED: EEBRD of " << sizeof(readData) << " bytes " << ROUND_TRIPS << " times in " << millis << " ms (" << millis / ROUND_TRIPS << " ms per read)" << endl;
+    else
+        cout << "FAILED: " << matches << " of " << ROUND_TRIPS << " EEBRD reads matched the EEPROM" << endl;
+
+    //
+    // A write that leaves its ACK unread would make the next command read the stale ACK
+    //
+    vws::byte writeData[4] = {1, 2, 3, 4};
+    vws::byte eepromContents[4];
+    bool written = station.eepromBinaryWrite(0x100, writeData, sizeof(writeData));
+    emulator.getEeprom(0x100, eepromContents, sizeof(eepromContents));
+    if (written && memcmp(writeData, eepromContents, sizeof(writeData)) == 0 && station.eepromBinaryRead(eepromAddress, sizeof(readData), readData))
+        cout << "PASSED: EEBWR wrote the EEPROM and was acknowledged" << endl;
+    else
+        cout << "FAILED: EEBWR did not write the EEPROM" << endl;
+
+    DateTimeFields consoleTime;
+    int times = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < ROUND_TRIPS; i++)
+        if (station.retrieveConsoleTime(consoleTime))
+            times++;
+
+    millis = elapsedMillis(start);
+    if (times == ROUND_TRIPS && abs(consoleTime.getEpochDateTime() - (time(0) + 3600)) <= 2)
+        cout << "PASSED: GETTIME " << ROUND_TRIPS << " times in " << millis << " ms (" << millis / ROUND_TRIPS << " ms per request)" << endl;
+    else
+        cout << "FAILED: " << times << " of " << ROUND_TRIPS << " GETTIME requests succeeded. Console time: " << consoleTime << endl;
+
+    if (station.updateConsoleTime() && abs(emulator.getConsoleTime() - time(0)) <= 2)
+        cout << "PASSED: SETTIME corrected the console clock" << endl;
+    else
+        cout << "FAILED: SETTIME did not correct the console clock. Console time offset: " << emulator.getConsoleTime() - time(0) << endl;
+
+    //
+    // The entire console archive with the byte-at-a-time download and with the pipelined download into an archive
+    //
+    vector<ArchivePacket> list;
+    start = chrono::steady_clock::now();
+    bool dumped = station.dumpAfter(DateTimeFields(), list);
+    millis = elapsedMillis(start);
+    int pages = NUM_ARCHIVE_RECORDS / VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE;
+    if (dumped && checkRecords(list, oldestTime, NUM_ARCHIVE_RECORDS))
+        cout << "PASSED: DMPAFT of " << pages << " pages in " << millis << " ms (" << static_cast<int>(pages / (millis / 1000.0)) << " pages/s)" << endl;
+    else
+        cout << "FAILED: DMPAFT of the entire archive" << endl;
+
+    DateTimeFields afterTime(oldestTime + (static_cast<DateTime>(NUM_ARCHIVE_RECORDS - 23) * ARCHIVE_PERIOD));
+    dumped = station.dumpAfter(afterTime, list);
+    if (dumped && checkRecords(list, afterTime.getEpochDateTime() + ARCHIVE_PERIOD, 22))
+        cout << "PASSED: DMPAFT of the newest records starts in the middle of a page" << endl;
+    else
+        cout << "FAILED: DMPAFT of the newest records" << endl;
+
+    {
+        string archiveFile = "console-benchmark-archive.dat";
+        string archivePath = archiveDirectory + "/" + archiveFile;
+        ArchiveManager archiveManager(archiveDirectory, archiveFile);
+        archiveManager.setDurabilityPolicy(ArchiveManager::DurabilityPolicy::SYNC_NEVER);
+        ArchiveDownload download(archiveManager);
+        start = chrono::steady_clock::now();
+        dumped = station.dumpAfter(DateTimeFields(), download);
+        millis = elapsedMillis(start);
+        if (dumped && download.getRecordsCommitted() == NUM_ARCHIVE_RECORDS)
+            cout << "PASSED: Pipelined DMPAFT of " << pages << " pages into the archive in " << millis << " ms (" << static_cast<int>(pages / (millis / 1000.0)) << " pages/s)" << endl;
+        else
+            cout << "FAILED: Pipelined DMPAFT added " << download.getRecordsCommitted() << " records to the archive" << endl;
+
+        unlink(archivePath.c_str());
+        unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+        unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+        filesystem::remove_all(archiveDirectory + "/packets");
+    }
+
+    serialPort.close();
+    emulator.stop();
+}
+
+/**
+ * Run the benchmarks that are paced at the console line rate.
+ */
+void
+benchmarkPaced() {
+    static const int PAGE_COUNT = 40;
+    VantageConsoleEmulator::Settings settings = VantageConsoleEmulator::defaultSettings();
+    settings.loopIntervalMillis = 0;
+    settings.crcErrorRate = 0.1;
+    settings.wakeupFailures = 1;
+    settings.responseLatencyMillis = 5;
+
+    DateTime archiveStart = DateTimeFields(2024, 6, 1, 0, 0, 0).getEpochDateTime();
+    VantageConsoleEmulator emulator(settings);
+    emulator.addArchiveRecords(archiveStart, ARCHIVE_PERIOD, PAGE_COUNT * VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE);
+    emulator.start();
+
+    SerialPort serialPort(emulator.getDevicePath(), vws::BaudRate::BR_19200);
+    serialPort.open();
+    VantageWeatherStation station(serialPort, ARCHIVE_PERIOD / 60, .01);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool awake = station.wakeupStation();
+    double millis = elapsedMillis(start);
+    if (awake)
+        cout << "PASSED: Wake up with one ignored request in " << millis << " ms" << endl;
+    else
+        cout << "FAILED: Console did not wake up" << endl;
+
+    //
+    // The station resends the pages with CRC errors, a page that fails three times aborts the dump, so allow a retry
+    //
+    vector<ArchivePacket> list;
+    bool dumped = false;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < 3 && !dumped; i++)
+        dumped = station.wakeupStation() && station.dumpAfter(DateTimeFields(), list);
+
+    millis = elapsedMillis(start);
+    VantageConsoleEmulator::Statistics statistics = emulator.getStatistics();
+    if (dumped && checkRecords(list, archiveStart, PAGE_COUNT * VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE))
+        cout << "PASSED: DMPAFT of " << PAGE_COUNT << " pages at 19200 baud with " << statistics.crcErrorsInjected << " CRC errors and "
+             << statistics.resentPages << " resent pages in " << millis << " ms (" << static_cast<int>(PAGE_COUNT / (millis / 1000.0)) << " pages/s)" << endl;
+    else
+        cout << "FAILED: DMPAFT at 19200 baud with CRC errors" << endl;
+
+    serialPort.close();
+    emulator.stop();
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_ERROR);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: ConsoleProtocolBenchmark <archive-directory>" << endl;
+        exit(1);
+    }
+
+    benchmarkUnpaced(argv[1]);
+    benchmarkPaced();
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <unistd.h>
+#include "BitConverter.h"
+#include "CurrentWeather.h"
+#include "CurrentWeatherManager.h"
+#include "CurrentWeatherPublisher.h"
+#include "Loop2Packet.h"
+#include "LoopPacket.h"
+#include "LoopPacketRing.h"
+#include "VantageCRC.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+#include "VantageProtocolConstants.h"
+#include "Weather.h"
+
+using namespace vws;
+using namespace std;
+
+class CountingPublisher : public CurrentWeatherPublisher {
+public:
+    CountingPublisher() : publishCount(0) {}
+    virtual void publishCurrentWeather(const CurrentWeather & currentWeather, const string & currentWeatherJson) { publishCount++; lastJson = currentWeatherJson; }
+    int    publishCount;
+    string lastJson;
+};
+
+/**
+ * Build a LOOP or LOOP2 packet that passes the packet validation. The outside temperature identifies the packet.
+ */
+void
+buildPacket(vws::byte buffer[], int packetType, int outsideTemperature) {
+    memset(buffer, 0, LoopPacket::LOOP_PACKET_SIZE);
+    buffer[0] = 'L';
+    buffer[1] = 'O';
+    buffer[2] = 'O';
+    buffer[3] = 'P';
+    buffer[4] = static_cast<vws::byte>(packetType);
+    BitConverter::getBytes(30000, buffer, 7, 2);
+    BitConverter::getBytes(outsideTemperature, buffer, 12, 2);
+    buffer[95] = ProtocolConstants::LINE_FEED;
+    buffer[96] = ProtocolConstants::CARRIAGE_RETURN;
+    int crc = VantageCRC::calculateCRC(buffer, 97);
+    BitConverter::getBytes(crc, buffer, 97, 2, false);
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: CurrentWeatherManagerTest <directory>" << endl;
+        exit(1);
+    }
+
+    string dataDirectory = string(argv[1]) + "/cwm-test";
+    std::filesystem::remove_all(dataDirectory);
+    std::filesystem::create_directories(dataDirectory + LOOP_ARCHIVE_DIR);
+
+    //
+    // Write 3 hours of LOOP/LOOP2 pairs to the loop archive, one pair a minute, with a pair from 2 days ago that must not be loaded
+    //
+    DateTime now = time(0);
+    vws::byte buffer[LoopPacket::LOOP_PACKET_SIZE];
+    {
+        LoopPacketRing ring(dataDirectory + LOOP_ARCHIVE_DIR + LOOP_ARCHIVE_FILE);
+        ring.open();
+        buildPacket(buffer, LoopPacket::LOOP_PACKET_TYPE, 500);
+        ring.writePacket(now - (2 * Weather::SECONDS_PER_DAY), LoopPacket::LOOP_PACKET_TYPE, buffer, sizeof(buffer));
+        buildPacket(buffer, Loop2Packet::LOOP2_PACKET_TYPE, 500);
+        ring.writePacket(now - (2 * Weather::SECONDS_PER_DAY), Loop2Packet::LOOP2_PACKET_TYPE, buffer, sizeof(buffer));
+
+        for (int i = 180; i > 0; i--) {
+            buildPacket(buffer, LoopPacket::LOOP_PACKET_TYPE, 600 + i);
+            ring.writePacket(now - (i * 60), LoopPacket::LOOP_PACKET_TYPE, buffer, sizeof(buffer));
+            buildPacket(buffer, Loop2Packet::LOOP2_PACKET_TYPE, 600 + i);
+            ring.writePacket(now - (i * 60) + 1, Loop2Packet::LOOP2_PACKET_TYPE, buffer, sizeof(buffer));
+        }
+    }
+
+    CountingPublisher publisher;
+    CurrentWeatherManager manager(dataDirectory, publisher);
+    manager.initialize();
+
+    CurrentWeatherManager::CurrentWeatherRecordList list;
+    manager.queryCurrentWeatherArchive(23, list);
+    if (list.size() == 180 && list.front()->getPacketTime() == now - (180 * 60) + 1)
+        cout << "PASSED: Loaded the records of the past 24 hours from the loop archive" << endl;
+    else
+        cout << "FAILED: Loaded " << list.size() << " records from the loop archive, expected 180" << endl;
+
+    //
+    // Process live packets. A LOOP2 packet that does not follow a LOOP packet does not create a record.
+    //
+    LoopPacket loopPacket;
+    Loop2Packet loop2Packet;
+    buildPacket(buffer, LoopPacket::LOOP_PACKET_TYPE, 700);
+    loopPacket.decodeLoopPacket(buffer);
+    buildPacket(buffer, Loop2Packet::LOOP2_PACKET_TYPE, 700);
+    loop2Packet.decodeLoop2Packet(buffer);
+
+    manager.processLoopPacket(loopPacket);
+    manager.processLoop2Packet(loop2Packet);
+    manager.processLoop2Packet(loop2Packet);
+
+    manager.queryCurrentWeatherArchive(23, list);
+    if (list.size() == 181 && list.back()->getLoopPacket().getOutsideTemperature().getValue() == 70.0)
+        cout << "PASSED: Live LOOP/LOOP2 packet pair was added to the recent records" << endl;
+    else
+        cout << "FAILED: Recent records contain " << list.size() << " records, expected 181" << endl;
+
+    //
+    // The published and queried JSON is the same snapshot until the next packet is processed
+    //
+    shared_ptr<const string> json1 = manager.getCurrentWeatherJSON();
+    shared_ptr<const string> json2 = manager.getCurrentWeatherJSON();
+    if (json1 == json2 && *json1 == publisher.lastJson && publisher.publishCount == 2)
+        cout << "PASSED: Published and queried current weather JSON is a shared snapshot" << endl;
+    else
+        cout << "FAILED: Published and queried current weather JSON is not a shared snapshot" << endl;
+
+    string json1Copy = *json1;
+    manager.processLoopPacket(loopPacket);
+    if (manager.getCurrentWeatherJSON() != json1 && *json1 == json1Copy && publisher.publishCount == 3)
+        cout << "PASSED: New packet replaced the current weather JSON snapshot without changing the previous one" << endl;
+    else
+        cout << "FAILED: New packet did not replace the current weather JSON snapshot" << endl;
+
+    double value;
+    CurrentWeather cw = manager.getCurrentWeather();
+    if (cw.getFieldValue("outsideTemperature", value) && value == 70.0 && !cw.getFieldValue("stormRain", value) && !cw.getFieldValue("extraTemperatures", value))
+        cout << "PASSED: Current weather field accessor found the outside temperature" << endl;
+    else
+        cout << "FAILED: Current weather field accessor did not find the outside temperature" << endl;
+
+    //
+    // The one hour query starts at the top of the previous hour
+    //
+    struct tm tm;
+    Weather::localtime(now - Weather::SECONDS_PER_HOUR, tm);
+    tm.tm_min = 0;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    DateTime startTime = mktime(&tm);
+    manager.queryCurrentWeatherArchive(1, list);
+    if (!list.empty() && list.front()->getPacketTime() >= startTime && list.front()->getPacketTime() < startTime + 60)
+        cout << "PASSED: One hour query starts at the top of the hour" << endl;
+    else
+        cout << "FAILED: One hour query returned " << list.size() << " records" << endl;
+
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++)
+        manager.queryCurrentWeatherArchive(23, list);
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    cout << "1000 queries of " << list.size() << " records took " << chrono::duration<double, milli>(t2 - t1).count() << " ms" << endl;
+
+    std::filesystem::remove_all(dataDirectory);
+
+    //
+    // The records of the past 24 hours in the hourly archive files that preceded the ring file are imported in time order.
+    // The newer records are in the lower numbered file, like the hour files after midnight.
+    //
+    std::filesystem::create_directories(dataDirectory + LOOP_ARCHIVE_DIR);
+    for (int file = 0; file < 2; file++) {
+        ofstream ofs(dataDirectory + LOOP_ARCHIVE_DIR + (file == 0 ? "LoopPacketArchive_00.dat" : "LoopPacketArchive_23.dat"), ios::binary);
+        for (int i = 0; i < 60; i++) {
+            DateTime packetTime = now - (file == 0 ? 3600 : 7200) + (i * 60);
+            if (file == 1 && i == 0)
+                packetTime = now - (2 * Weather::SECONDS_PER_DAY);
+
+            int packetType = LoopPacket::LOOP_PACKET_TYPE;
+            buildPacket(buffer, packetType, 600 + i);
+            ofs.write(reinterpret_cast<char *>(&packetTime), sizeof(packetTime)).write(reinterpret_cast<char *>(&packetType), sizeof(packetType)).write(reinterpret_cast<char *>(buffer), sizeof(buffer));
+            packetType = Loop2Packet::LOOP2_PACKET_TYPE;
+            buildPacket(buffer, packetType, 600 + i);
+            ofs.write(reinterpret_cast<char *>(&packetTime), sizeof(packetTime)).write(reinterpret_cast<char *>(&packetType), sizeof(packetType)).write(reinterpret_cast<char *>(buffer), sizeof(buffer));
+        }
+    }
+
+    {
+        CurrentWeatherManager hourlyManager(dataDirectory, publisher);
+        hourlyManager.initialize();
+        hourlyManager.queryCurrentWeatherArchive(23, list);
+        bool inOrder = true;
+        for (size_t i = 1; i < list.size(); i++)
+            if (list[i]->getPacketTime() <= list[i - 1]->getPacketTime())
+                inOrder = false;
+
+        if (list.size() == 119 && inOrder && !std::filesystem::exists(dataDirectory + LOOP_ARCHIVE_DIR + "LoopPacketArchive_00.dat") &&
+            !std::filesystem::exists(dataDirectory + LOOP_ARCHIVE_DIR + "LoopPacketArchive_23.dat"))
+            cout << "PASSED: Hourly archive files were imported into the loop archive and deleted" << endl;
+        else
+            cout << "FAILED: Imported " << list.size() << " records from the hourly archive files, expected 119 in time order" << endl;
+    }
+
+    std::filesystem::remove_all(dataDirectory);
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <unistd.h>
+#include "AlarmManager.h"
+#include "ArchiveIndex.h"
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "BitConverter.h"
+#include "CommandData.h"
+#include "CurrentWeatherManager.h"
+#include "CurrentWeatherPublisher.h"
+#include "DataCommandHandler.h"
+#include "DateTimeFields.h"
+#include "DaySummaryStore.h"
+#include "GraphDataRetriever.h"
+#include "ResponseHandler.h"
+#include "SerialPort.h"
+#include "StormArchiveManager.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+#include "VantageWeatherStation.h"
+
+using namespace vws;
+using namespace std;
+
+/**
+ * Benchmark that measures the latency of the data commands under a mixed query load. Clients that issue
+ * long running archive summary queries run at the same time as clients that issue cheap current weather and
+ * archive statistics queries. The latency percentiles of each command are reported for a number of worker counts.
+ */
+
+static const string ARCHIVE_FILE = "worker-benchmark-archive.dat";
+static const int    SUMMARY_CLIENTS = 3;
+static const int    SUMMARY_QUERIES_PER_CLIENT = 8;
+static const int    CHEAP_CLIENTS = 4;
+static const int    CHEAP_QUERIES_PER_CLIENT = 200;
+
+class NullPublisher : public CurrentWeatherPublisher {
+public:
+    virtual void publishCurrentWeather(const CurrentWeather & currentWeather, const string & currentWeatherJson) {}
+};
+
+/**
+ * A client that issues one command at a time and waits for the response before issuing the next.
+ */
+class BenchmarkClient : public ResponseHandler {
+public:
+    BenchmarkClient() : responseReceived(false) {}
+
+    virtual void handleCommandResponse(const CommandData & commandData) {
+        std::scoped_lock<std::mutex> guard(mutex);
+        responseReceived = true;
+        cv.notify_all();
+    }
+
+    /**
+     * Offer the command to the handler and wait for the response.
+     *
+     * @return The latency of the command in milliseconds
+     */
+    double execute(DataCommandHandler & handler, CommandData command) {
+        command.responseHandler = this;
+        command.loadResponseTemplate();
+
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+        {
+            std::scoped_lock<std::mutex> guard(mutex);
+            responseReceived = false;
+        }
+
+        handler.offerCommand(command);
+
+        std::unique_lock<std::mutex> guard(mutex);
+        cv.wait(guard, [this]{ return responseReceived; });
+        chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+
+        return chrono::duration<double, milli>(t2 - t1).count();
+    }
+
+private:
+    std::mutex              mutex;
+    std::condition_variable cv;
+    bool                    responseReceived;
+};
+
+/**
+ * Build an archive of a number of years at a 5 minute archive period.
+ */
+int
+createSyntheticArchive(const string & archivePath, int firstYear, int years) {
+    mt19937 random(24680);
+    uniform_int_distribution<int> temperature(300, 900);
+    uniform_int_distribution<int> small(0, 30);
+
+    ofstream ofs(archivePath, ios::out | ios::trunc | ios::binary);
+
+    vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    DateTime packetTime = DateTimeFields(firstYear, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTime endTime = DateTimeFields(firstYear + years, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTimeFields lastPacketTime;
+    int recordCount = 0;
+
+    for (; packetTime < endTime; packetTime += 300) {
+        DateTimeFields fields(packetTime);
+
+        //
+        // Skip the repeated hour at the end of DST so that the archive stays in time order
+        //
+        if (fields <= lastPacketTime)
+            continue;
+
+        lastPacketTime = fields;
+
+        makeArchiveRecord(fields, buffer);
+
+        int averageTemperature = temperature(random);
+        BitConverter::getBytes(averageTemperature, buffer, 4, 2);
+        BitConverter::getBytes(averageTemperature + 5, buffer, 6, 2);
+        BitConverter::getBytes(averageTemperature - 5, buffer, 8, 2);
+        BitConverter::getBytes(0, buffer, 10, 2);
+        BitConverter::getBytes(0, buffer, 12, 2);
+        BitConverter::getBytes(30000, buffer, 14, 2);
+        buffer[22] = static_cast<vws::byte>(small(random) + 20);
+        buffer[23] = static_cast<vws::byte>(small(random) + 50);
+        buffer[24] = static_cast<vws::byte>(small(random));
+        buffer[25] = static_cast<vws::byte>(small(random) + 5);
+        buffer[26] = static_cast<vws::byte>(small(random) % 16);
+        buffer[27] = static_cast<vws::byte>(small(random) % 16);
+
+        ofs.write(buffer, sizeof(buffer));
+        recordCount++;
+    }
+
+    return recordCount;
+}
+
+/**
+ * Calculate a percentile of a sorted list of latencies.
+ */
+double
+percentile(const vector<double> & sortedLatencies, double percent) {
+    if (sortedLatencies.empty())
+        return 0.0;
+
+    size_t index = static_cast<size_t>((percent / 100.0) * (sortedLatencies.size() - 1) + .5);
+    return sortedLatencies[index];
+}
+
+void
+reportLatencies(const string & commandName, vector<double> & latencies) {
+    sort(latencies.begin(), latencies.end());
+    cout << "    " << left << setw(26) << commandName << right << fixed << setprecision(2)
+         << " count: " << setw(5) << latencies.size()
+         << "  p50: " << setw(8) << percentile(latencies, 50.0)
+         << "  p95: " << setw(8) << percentile(latencies, 95.0)
+         << "  p99: " << setw(8) << percentile(latencies, 99.0)
+         << "  max: " << setw(8) << latencies.back() << " ms" << endl;
+}
+
+/**
+ * Run the mixed query load against a data command handler with the specified number of worker threads.
+ */
+void
+runMixedLoad(int workerCount, ArchiveManager & archiveManager, StormArchiveManager & stormArchiveManager,
+             CurrentWeatherManager & currentWeatherManager, AlarmManager & alarmManager) {
+
+    DataCommandHandler handler(archiveManager, stormArchiveManager, currentWeatherManager, alarmManager, workerCount);
+    handler.start();
+
+    vector<vector<double>> summaryLatencies(SUMMARY_CLIENTS);
+    vector<vector<double>> currentWeatherLatencies(CHEAP_CLIENTS);
+    vector<vector<double>> statisticsLatencies(CHEAP_CLIENTS);
+    vector<thread> clients;
+
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+
+    for (int i = 0; i < SUMMARY_CLIENTS; i++) {
+        clients.emplace_back([&, i]() {
+            BenchmarkClient client;
+            CommandData command;
+            command.commandName = "query-archive-summary";
+            command.arguments.push_back(CommandData::CommandArgument("start-time", "2022-01-01 00:00"));
+            command.arguments.push_back(CommandData::CommandArgument("end-time", "2023-12-31 23:59"));
+            command.arguments.push_back(CommandData::CommandArgument("summary-period", "Day"));
+            command.arguments.push_back(CommandData::CommandArgument("speed-bin-count", "5"));
+            command.arguments.push_back(CommandData::CommandArgument("speed-bin-increment", "2.5"));
+            command.arguments.push_back(CommandData::CommandArgument("speed-units", "mph"));
+
+            for (int q = 0; q < SUMMARY_QUERIES_PER_CLIENT; q++)
+                summaryLatencies[i].push_back(client.execute(handler, command));
+        });
+    }
+
+    for (int i = 0; i < CHEAP_CLIENTS; i++) {
+        clients.emplace_back([&, i]() {
+            BenchmarkClient client;
+            CommandData currentWeatherCommand;
+            currentWeatherCommand.commandName = "query-current-weather";
+            CommandData statisticsCommand;
+            statisticsCommand.commandName = "query-archive-statistics";
+
+            for (int q = 0; q < CHEAP_QUERIES_PER_CLIENT; q++) {
+                if (q % 2 == 0)
+                    currentWeatherLatencies[i].push_back(client.execute(handler, currentWeatherCommand));
+                else
+                    statisticsLatencies[i].push_back(client.execute(handler, statisticsCommand));
+
+                usleep(2000);
+            }
+        });
+    }
+
+    for (auto & client : clients)
+        client.join();
+
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+
+    handler.terminate();
+    handler.join();
+
+    vector<double> summary, currentWeather, statistics;
+    for (auto & list : summaryLatencies)
+        summary.insert(summary.end(), list.begin(), list.end());
+
+    for (auto & list : currentWeatherLatencies)
+        currentWeather.insert(currentWeather.end(), list.begin(), list.end());
+
+    for (auto & list : statisticsLatencies)
+        statistics.insert(statistics.end(), list.begin(), list.end());
+
+    cout << "Workers: " << workerCount << " (total time " << fixed << setprecision(0)
+         << chrono::duration<double, milli>(t2 - t1).count() << " ms)" << endl;
+    reportLatencies("query-archive-summary", summary);
+    reportLatencies("query-current-weather", currentWeather);
+    reportLatencies("query-archive-statistics", statistics);
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: DataCommandHandlerBenchmark <data-directory>" << endl;
+        exit(1);
+    }
+
+    string dataDirectory = argv[1];
+    string archivePath = dataDirectory + "/" + ARCHIVE_FILE;
+
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+    int recordCount = createSyntheticArchive(archivePath, 2022, 2);
+    cout << "Created synthetic archive with " << recordCount << " records" << endl;
+
+    SerialPort serialPort("/dev/null", vws::BaudRate::BR_19200);
+    VantageWeatherStation station(serialPort);
+    ArchiveManager archiveManager(dataDirectory, ARCHIVE_FILE);
+    GraphDataRetriever graphDataRetriever(station);
+    StormArchiveManager stormArchiveManager(dataDirectory, graphDataRetriever);
+    NullPublisher publisher;
+    CurrentWeatherManager currentWeatherManager(dataDirectory, publisher);
+    AlarmManager alarmManager(dataDirectory, station);
+
+    cout << SUMMARY_CLIENTS << " clients issuing " << SUMMARY_QUERIES_PER_CLIENT << " two year day summaries and "
+         << CHEAP_CLIENTS << " clients issuing " << CHEAP_QUERIES_PER_CLIENT << " current weather/statistics queries" << endl;
+
+    int workerCounts[] = {1, 2, 4};
+    for (int workerCount : workerCounts)
+        runMixedLoad(workerCount, archiveManager, stormArchiveManager, currentWeatherManager, alarmManager);
+
+    unlink(archivePath.c_str());
+    unlink((archivePath + ARCHIVE_INDEX_FILE_SUFFIX).c_str());
+    unlink((archivePath + DAY_SUMMARY_FILE_SUFFIX).c_str());
+}
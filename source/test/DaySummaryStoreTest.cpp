@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+#include "ArchiveManager.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "DaySummaryStore.h"
+#include "MappedArchiveFile.h"
+#include "SummaryReport.h"
+#include "WindRoseData.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string ARCHIVE_FILE = "day-summary-test-archive.dat";
+
+static mt19937 randomGenerator(24680);
+
+/**
+ * Build an archive packet with varying weather values.
+ */
+ArchivePacket
+createPacket(DateTime packetTime) {
+    uniform_int_distribution<int> temperature(300, 900);
+    uniform_int_distribution<int> rain(0, 20);
+    uniform_int_distribution<int> heading(0, 16);
+    uniform_int_distribution<int> speed(0, 25);
+    uniform_int_distribution<int> humidity(10, 100);
+    uniform_int_distribution<int> pressure(29000, 31000);
+    uniform_int_distribution<int> solar(0, 1000);
+
+    vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    makeArchiveRecord(packetTime, buffer);
+
+    int averageTemperature = temperature(randomGenerator);
+    BitConverter::getBytes(averageTemperature, buffer, 4, 2);
+    BitConverter::getBytes(averageTemperature + 5, buffer, 6, 2);
+    BitConverter::getBytes(averageTemperature - 5, buffer, 8, 2);
+
+    //
+    // Rain about one tenth of the time
+    //
+    int rainClicks = rain(randomGenerator);
+    if (rainClicks > 2)
+        rainClicks = 0;
+
+    BitConverter::getBytes(rainClicks, buffer, 10, 2);
+    BitConverter::getBytes(rainClicks * 12, buffer, 12, 2);
+    BitConverter::getBytes(pressure(randomGenerator), buffer, 14, 2);
+    int solarRadiation = solar(randomGenerator);
+    BitConverter::getBytes(solarRadiation, buffer, 16, 2);
+    BitConverter::getBytes(100, buffer, 18, 2);
+    BitConverter::getBytes(averageTemperature + 50, buffer, 20, 2);
+    buffer[22] = static_cast<vws::byte>(humidity(randomGenerator));
+    buffer[23] = static_cast<vws::byte>(humidity(randomGenerator));
+
+    //
+    // A heading of 16 is stored as the dashed value with no wind
+    //
+    int windHeading = heading(randomGenerator);
+    int windSpeed = windHeading == 16 ? 0 : speed(randomGenerator);
+    buffer[24] = static_cast<vws::byte>(windSpeed);
+    buffer[25] = static_cast<vws::byte>(windSpeed + 5);
+    buffer[26] = static_cast<vws::byte>(windHeading == 16 ? 255 : windHeading);
+    buffer[27] = static_cast<vws::byte>(windHeading == 16 ? 255 : windHeading);
+    buffer[28] = static_cast<vws::byte>(solarRadiation / 100);
+    buffer[29] = static_cast<vws::byte>(rainClicks);
+    BitConverter::getBytes(solarRadiation + 20, buffer, 30, 2);
+    buffer[32] = static_cast<vws::byte>(solarRadiation / 90);
+
+    //
+    // One extra temperature sensor, which is stored with a 90 degree offset
+    //
+    buffer[45] = static_cast<vws::byte>((averageTemperature / 10) + 80);
+
+    return ArchivePacket(buffer);
+}
+
+/**
+ * Create the packets for a range of days at a 5 minute archive period.
+ */
+void
+createPackets(const DateTimeFields & firstDay, int days, vector<ArchivePacket> & packets) {
+    packets.clear();
+    DateTime packetTime = firstDay.getEpochDateTime();
+    DateTime endTime = packetTime + (days * 86400);
+    DateTimeFields lastPacketTime;
+
+    while (packetTime < endTime) {
+        //
+        // Like the console, do not write records during the repeated hour when DST ends
+        //
+        DateTimeFields fields(packetTime);
+        if (lastPacketTime < fields) {
+            packets.push_back(createPacket(packetTime));
+            lastPacketTime = fields;
+        }
+
+        packetTime += 300;
+    }
+}
+
+/**
+ * Build a day summary directly from the archive packets of a day.
+ */
+DaySummary
+summarizeDay(const ArchiveManager & archiveManager, const DateTimeFields & day) {
+    vector<ArchivePacket> packets;
+    archiveManager.queryArchiveRecordsForDay(day, packets);
+
+    DaySummary summary(day);
+    for (const auto & packet : packets)
+        summary.applyArchivePacket(packet);
+
+    return summary;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    if (argc != 2) {
+        cout << "Usage: DaySummaryStoreTest <archive-directory>" << endl;
+        exit(1);
+    }
+
+    string archiveDirectory = argv[1];
+    string archivePath = archiveDirectory + "/" + ARCHIVE_FILE;
+    string storePath = archivePath + DAY_SUMMARY_FILE_SUFFIX;
+
+    unlink(archivePath.c_str());
+    unlink(storePath.c_str());
+    filesystem::remove_all(archiveDirectory + "/packets");
+
+    //
+    // Two months that include the end of DST
+    //
+    const int testDays = 61;
+    DateTimeFields firstDay(2024, 10, 1, 0, 0, 0);
+    vector<ArchivePacket> packets;
+    createPackets(firstDay, testDays, packets);
+
+    ArchiveManager archiveManager(archiveDirectory, ARCHIVE_FILE);
+    archiveManager.addPacketsToArchive(packets);
+
+    DaySummaryStore store(storePath);
+    MappedArchiveFile archive(archivePath);
+
+    if (store.isConsistent(archive) && store.getDayCount() == testDays - 1)
+        cout << "PASSED: Day summary store contains all complete days" << endl;
+    else
+        cout << "FAILED: Day summary store contains " << store.getDayCount() << " days, expected " << testDays - 1 << endl;
+
+    //
+    // Each day summary must match a summary of the same day built from the archive packets
+    //
+    int mismatchedDays = 0;
+    DateTime day = firstDay.getEpochDateTime() + 43200;
+    for (int i = 0; i < testDays - 1; i++, day += 86400) {
+        DateTimeFields dayFields(day);
+        vector<DaySummary> summaries;
+        store.readDaySummaries(dayFields, dayFields, summaries);
+        DaySummary expected = summarizeDay(archiveManager, dayFields);
+
+        if (summaries.size() != 1 ||
+            summaries[0].summaryRecord.formatJSON() != expected.summaryRecord.formatJSON() ||
+            memcmp(summaries[0].hourRainfall, expected.hourRainfall, sizeof(expected.hourRainfall)) != 0 ||
+            summaries[0].windSamples.size() != expected.windSamples.size()) {
+            mismatchedDays++;
+            cout << "Day summary mismatch for " << dayFields.formatDate() << endl;
+        }
+    }
+
+    if (mismatchedDays == 0)
+        cout << "PASSED: Stored day summaries match the archive packets" << endl;
+    else
+        cout << "FAILED: " << mismatchedDays << " stored day summaries do not match the archive packets" << endl;
+
+    //
+    // A month summary composed from the day summaries must match one built from the archive packets
+    //
+    DateTimeFields monthStart(2024, 10, 1, 0, 0, 0);
+    DateTimeFields monthEnd(2024, 10, 31, 23, 59, 59);
+    SummaryRecord directMonth(SummaryPeriod::MONTH, monthStart.getEpochDateTime(), monthEnd.getEpochDateTime());
+    SummaryRecord composedMonth(SummaryPeriod::MONTH, monthStart.getEpochDateTime(), monthEnd.getEpochDateTime());
+    WindRoseData directWindRose(ProtocolConstants::WindUnits::MPH, 5.0, 5);
+    WindRoseData composedWindRose(ProtocolConstants::WindUnits::MPH, 5.0, 5);
+
+    vector<ArchivePacket> monthPackets;
+    archiveManager.queryArchiveRecords(monthStart, monthEnd, monthPackets);
+    for (const auto & packet : monthPackets) {
+        directMonth.applyArchivePacket(packet);
+        directWindRose.applyWindSample(packet.getPrevailingWindHeadingIndex(), packet.getAverageWindSpeed());
+    }
+
+    vector<DaySummary> monthSummaries;
+    store.readDaySummaries(monthStart, monthEnd, monthSummaries);
+    for (const auto & summary : monthSummaries) {
+        composedMonth.applySummaryRecord(summary.summaryRecord);
+        summary.applyWindSamples(composedWindRose);
+    }
+
+    if (monthSummaries.size() == 31 && directMonth.formatJSON() == composedMonth.formatJSON())
+        cout << "PASSED: Month summary composed from day summaries matches the archive packets" << endl;
+    else
+        cout << "FAILED: Month summary composed from day summaries does not match the archive packets" << endl
+             << "Direct:   " << directMonth.formatJSON() << endl
+             << "Composed: " << composedMonth.formatJSON() << endl;
+
+    if (directWindRose.formatJSON() == composedWindRose.formatJSON())
+        cout << "PASSED: Wind rose built from day summaries matches the archive packets" << endl;
+    else
+        cout << "FAILED: Wind rose built from day summaries does not match the archive packets" << endl;
+
+    //
+    // The summary report reads the day summaries plus the packets of the current day
+    //
+    for (const auto & summary : monthSummaries)
+        directMonth.applyDaySummaryRecord(summarizeDay(archiveManager, DateTimeFields(summary.summaryRecord.startDate)).summaryRecord);
+
+    WindRoseData reportWindRose(ProtocolConstants::WindUnits::MPH, 5.0, 5);
+    SummaryReport report(SummaryPeriod::MONTH, DateTimeFields(2024, 10, 1), DateTimeFields(2024, 11, 30), archiveManager, reportWindRose);
+    if (report.loadData() && report.formatJSON().find(directMonth.formatJSON()) != string::npos)
+        cout << "PASSED: Summary report contains the month summary" << endl;
+    else
+        cout << "FAILED: Summary report does not contain the month summary" << endl;
+
+    //
+    // Adding another day of packets completes the last day, which is then added to the store
+    //
+    DateTimeFields nextDay(2024, 12, 1, 0, 0, 0);
+    createPackets(nextDay, 1, packets);
+    archiveManager.addPacketsToArchive(packets);
+
+    DaySummaryStore updatedStore(storePath);
+    MappedArchiveFile updatedArchive(archivePath);
+    if (updatedStore.isConsistent(updatedArchive) && updatedStore.getDayCount() == testDays)
+        cout << "PASSED: Day summary store was extended after a day was completed" << endl;
+    else
+        cout << "FAILED: Day summary store was not extended after a day was completed. Day count = " << updatedStore.getDayCount() << endl;
+
+    //
+    // A partial day record at the end of the store is ignored and replaced by the next append
+    //
+    {
+        ofstream ofs(storePath, ios::out | ios::app | ios::binary);
+        ofs.write("partial day", 11);
+    }
+
+    createPackets(DateTimeFields(2024, 12, 2, 0, 0, 0), 1, packets);
+    archiveManager.addPacketsToArchive(packets);
+
+    DaySummaryStore repairedStore(storePath);
+    MappedArchiveFile repairedArchive(archivePath);
+    vector<DaySummary> lastDay;
+    repairedStore.readDaySummaries(nextDay, nextDay, lastDay);
+    if (repairedStore.isConsistent(repairedArchive) && repairedStore.getDayCount() == testDays + 1 && lastDay.size() == 1 &&
+        lastDay[0].summaryRecord.formatJSON() == summarizeDay(archiveManager, nextDay).summaryRecord.formatJSON())
+        cout << "PASSED: Partial day record at the end of the store was replaced" << endl;
+    else
+        cout << "FAILED: Partial day record at the end of the store was not replaced. Day count = " << repairedStore.getDayCount() << endl;
+
+    //
+    // Replacing the archive makes the store stale, so it is rebuilt
+    //
+    archiveManager.clearArchiveFile();
+    createPackets(DateTimeFields(2025, 3, 1, 0, 0, 0), 3, packets);
+    archiveManager.addPacketsToArchive(packets);
+
+    DaySummaryStore rebuiltStore(storePath);
+    MappedArchiveFile rebuiltArchive(archivePath);
+    if (!repairedStore.isConsistent(rebuiltArchive) && rebuiltStore.isConsistent(rebuiltArchive) && rebuiltStore.getDayCount() == 2)
+        cout << "PASSED: Day summary store was rebuilt after the archive was replaced" << endl;
+    else
+        cout << "FAILED: Day summary store was not rebuilt after the archive was replaced. Day count = " << rebuiltStore.getDayCount() << endl;
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <cstring>
+#include "BaudRate.h"
+#include "SerialPort.h"
+#include "VantageConsoleEmulator.h"
+#include "VantageDecoder.h"
+#include "VantageEepromConstants.h"
+#include "VantageLogger.h"
+#include "VantageWeatherStation.h"
+
+using namespace vws;
+using namespace std;
+using namespace EepromConstants;
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    VantageConsoleEmulator::Settings settings = VantageConsoleEmulator::defaultSettings();
+    settings.baudRate = 0;
+    VantageConsoleEmulator emulator(settings);
+
+    vws::byte eeprom[VantageConsoleEmulator::EEPROM_SIZE];
+    for (int i = 0; i < VantageConsoleEmulator::EEPROM_SIZE; i++)
+        eeprom[i] = (i * 7) & 0xFF;
+
+    eeprom[EE_ARCHIVE_PERIOD_ADDRESS] = 5;
+    emulator.setEeprom(0, eeprom, sizeof(eeprom));
+    emulator.start();
+
+    SerialPort serialPort(emulator.getDevicePath(), vws::BaudRate::BR_19200);
+    serialPort.open();
+    VantageWeatherStation station(serialPort, 5, .01);
+    station.wakeupStation();
+
+    //
+    // Connecting loads the shadow with one GETEE, after which the archive period is read from the shadow
+    //
+    int commandsBefore = emulator.getStatistics().commands;
+    station.consoleConnected();
+    int connectCommands = emulator.getStatistics().commands - commandsBefore;
+
+    vws::byte data[EE_ALARM_THRESHOLDS_SIZE];
+    commandsBefore = emulator.getStatistics().commands;
+    bool read = station.eepromBinaryRead(EE_ALARM_THRESHOLDS_ADDRESS, EE_ALARM_THRESHOLDS_SIZE, data) &&
+                memcmp(data, &eeprom[EE_ALARM_THRESHOLDS_ADDRESS], EE_ALARM_THRESHOLDS_SIZE) == 0 &&
+                station.eepromBinaryRead(EE_LOG_AVG_TEMP_ADDRESS, 1, data) && data[0] == eeprom[EE_LOG_AVG_TEMP_ADDRESS];
+
+    if (read && station.getArchivePeriod() == 5 && emulator.getStatistics().commands == commandsBefore && station.getEepromShadowReadCount() >= 3)
+        cout << "PASSED: Configuration reads were served from the shadow. Commands sent on connect: " << connectCommands << endl;
+    else
+        cout << "FAILED: Configuration reads were not served from the shadow. Commands sent: " << emulator.getStatistics().commands - commandsBefore << endl;
+
+    //
+    // The volatile regions are read from the console every time
+    //
+    vws::byte pointers[EE_GRAPH_POINTERS_SIZE];
+    memset(pointers, 0x42, sizeof(pointers));
+    emulator.setEeprom(EE_GRAPH_POINTERS_ADDRESS, pointers, sizeof(pointers));
+    commandsBefore = emulator.getStatistics().commands;
+    read = station.eepromBinaryRead(EE_NEXT_DAY_PTR_ADDRESS, 1, data) && data[0] == 0x42 &&
+           station.eepromBinaryRead(EE_RAIN_STORM_DATA_ADDRESS, 4, data);
+
+    if (read && emulator.getStatistics().commands == commandsBefore + 2)
+        cout << "PASSED: Graph pointer and storm data reads went to the console" << endl;
+    else
+        cout << "FAILED: Volatile reads were served from the shadow" << endl;
+
+    //
+    // Writes keep the shadow coherent
+    //
+    vws::byte latitude[4] = {0x11, 0x22, 0x33, 0x44};
+    bool written = station.eepromBinaryWrite(EE_LATITUDE_ADDRESS, latitude, sizeof(latitude)) &&
+                   station.eepromWriteByte(EE_RAIN_SEASON_START_ADDRESS, 9);
+
+    commandsBefore = emulator.getStatistics().commands;
+    vws::byte readLatitude[4];
+    vws::byte rainSeason;
+    read = station.eepromBinaryRead(EE_LATITUDE_ADDRESS, sizeof(readLatitude), readLatitude) &&
+           station.eepromBinaryRead(EE_RAIN_SEASON_START_ADDRESS, 1, &rainSeason);
+
+    vws::byte consoleLatitude[4];
+    emulator.getEeprom(EE_LATITUDE_ADDRESS, consoleLatitude, sizeof(consoleLatitude));
+    if (written && read && memcmp(readLatitude, latitude, sizeof(latitude)) == 0 && rainSeason == 9 &&
+        memcmp(consoleLatitude, latitude, sizeof(latitude)) == 0 && emulator.getStatistics().commands == commandsBefore)
+        cout << "PASSED: EEBWR and EEWR writes updated the console and the shadow" << endl;
+    else
+        cout << "FAILED: Shadow is not coherent after writes" << endl;
+
+    //
+    // A command that changes the EEPROM indirectly invalidates the bytes it changes
+    //
+    commandsBefore = emulator.getStatistics().commands;
+    ProtocolConstants::ArchivePeriod period;
+    bool updated = station.updateArchivePeriod(ProtocolConstants::ArchivePeriod::TEN_MINUTES) && station.retrieveArchivePeriod(period);
+    if (updated && period == ProtocolConstants::ArchivePeriod::TEN_MINUTES && emulator.getStatistics().commands == commandsBefore + 2)
+        cout << "PASSED: Archive period was read from the console after SETPER" << endl;
+    else
+        cout << "FAILED: Archive period was not refreshed after SETPER" << endl;
+
+    //
+    // The console may be changed while it is disconnected
+    //
+    station.consoleDisconnected();
+    vws::byte newThreshold = 0x5A;
+    emulator.setEeprom(EE_ALARM_THRESHOLDS_ADDRESS, &newThreshold, 1);
+    commandsBefore = emulator.getStatistics().commands;
+    read = station.eepromBinaryRead(EE_ALARM_THRESHOLDS_ADDRESS, 1, data) && data[0] == newThreshold;
+    if (read && emulator.getStatistics().commands == commandsBefore + 1)
+        cout << "PASSED: Shadow was discarded on disconnect" << endl;
+    else
+        cout << "FAILED: Stale shadow was used after disconnect" << endl;
+
+    serialPort.close();
+    emulator.stop();
+}
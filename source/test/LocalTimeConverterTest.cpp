@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include <time.h>
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "DateTimeFields.h"
+#include "LocalTimeConverter.h"
+#include "VantageLogger.h"
+#include "Weather.h"
+
+using namespace vws;
+using namespace std;
+
+static const int PACKET_COUNT = 500000;
+
+DateTime
+mktimeEpoch(int year, int month, int monthDay, int hour, int minute, int second) {
+    struct tm tm{};
+    tm.tm_year = year - Weather::TIME_STRUCT_YEAR_OFFSET;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = monthDay;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+/**
+ * Compare the converter with mktime() at every 5 minutes of a number of years, including the DST transitions.
+ * Each timezone is checked in a new thread so that it starts with an empty day table.
+ */
+void
+checkTimezone(const string & timezone) {
+    int mismatches = 0;
+    int conversions = 0;
+
+    thread t([&]() {
+        setenv("TZ", timezone.c_str(), 1);
+        tzset();
+
+        for (int year = 2020; year <= 2026; year++) {
+            for (int month = 1; month <= 12; month++) {
+                for (int day = 1; day <= 31; day++) {
+                    for (int minuteOfDay = 0; minuteOfDay < 24 * 60; minuteOfDay += 5) {
+                        int hour = minuteOfDay / 60;
+                        int minute = minuteOfDay % 60;
+                        conversions++;
+                        if (LocalTimeConverter::localToEpoch(year, month, day, hour, minute, 0) != mktimeEpoch(year, month, day, hour, minute, 0)) {
+                            if (mismatches++ < 5)
+                                cout << "    Mismatch at " << year << "-" << month << "-" << day << " " << hour << ":" << minute << endl;
+                        }
+                    }
+                }
+            }
+        }
+
+        //
+        // Fields that are out of range are normalized the same way as mktime()
+        //
+        conversions += 3;
+        if (LocalTimeConverter::localToEpoch(2024, 13, 1, 0, 0, 0) != mktimeEpoch(2024, 13, 1, 0, 0, 0))
+            mismatches++;
+
+        if (LocalTimeConverter::localToEpoch(2023, 2, 29, 12, 0, 0) != mktimeEpoch(2023, 2, 29, 12, 0, 0))
+            mismatches++;
+
+        if (LocalTimeConverter::localToEpoch(2024, 6, 30, 23, 75, 0) != mktimeEpoch(2024, 6, 30, 23, 75, 0))
+            mismatches++;
+    });
+    t.join();
+
+    if (mismatches == 0)
+        cout << "PASSED: " << conversions << " conversions in timezone " << timezone << " match mktime()" << endl;
+    else
+        cout << "FAILED: " << mismatches << " of " << conversions << " conversions in timezone " << timezone << " do not match mktime()" << endl;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+
+    checkTimezone("America/New_York");
+    checkTimezone("Europe/London");
+    checkTimezone("Australia/Lord_Howe");
+    checkTimezone("UTC");
+
+    setenv("TZ", "America/New_York", 1);
+    tzset();
+
+    //
+    // Build a buffer of consecutive archive packets with a 5 minute archive period
+    //
+    vector<vws::byte> packets(static_cast<size_t>(PACKET_COUNT) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+    DateTime packetTime = DateTimeFields(2024, 1, 1, 0, 0, 0).getEpochDateTime();
+    for (int i = 0; i < PACKET_COUNT; i++)
+        makeArchiveRecord(packetTime + (i * 300), &packets[static_cast<size_t>(i) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET]);
+
+    //
+    // Decode the packets without the epoch time, the way they were decoded with mktime() and with the converter
+    //
+    int minuteSum = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        ArchivePacket packet(packets.data(), i * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        minuteSum += packet.getDateTimeFields().getMinute();
+    }
+
+    DateTime mktimeSum = 0;
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        ArchivePacket packet(packets.data(), i * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        const DateTimeFields & f = packet.getDateTimeFields();
+        mktimeSum += mktimeEpoch(f.getYear(), f.getMonth(), f.getMonthDay(), f.getHour(), f.getMinute(), 0);
+    }
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+
+    DateTime converterSum = 0;
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        ArchivePacket packet(packets.data(), i * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        converterSum += packet.getEpochDateTime();
+    }
+    chrono::steady_clock::time_point t3 = chrono::steady_clock::now();
+
+    if (mktimeSum == converterSum)
+        cout << "PASSED: Archive packet epoch times match mktime()" << endl;
+    else
+        cout << "FAILED: Archive packet epoch times do not match mktime()" << endl;
+
+    double fieldsMillis = chrono::duration<double, milli>(t1 - t0).count();
+    double mktimeMillis = chrono::duration<double, milli>(t2 - t1).count();
+    double converterMillis = chrono::duration<double, milli>(t3 - t2).count();
+    cout << "Decoded " << PACKET_COUNT << " packets without the epoch time in " << fieldsMillis << " ms ("
+         << static_cast<int>(PACKET_COUNT / (fieldsMillis / 1000.0)) << " packets/s)" << endl;
+    cout << "Decoded " << PACKET_COUNT << " packets with mktime() in " << mktimeMillis << " ms ("
+         << static_cast<int>(PACKET_COUNT / (mktimeMillis / 1000.0)) << " packets/s)" << endl;
+    cout << "Decoded " << PACKET_COUNT << " packets with the converter in " << converterMillis << " ms ("
+         << static_cast<int>(PACKET_COUNT / (converterMillis / 1000.0)) << " packets/s)" << endl;
+}
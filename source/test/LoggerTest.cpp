@@ -15,27 +15,136 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <iostream>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdio>
 
 #include "VantageLogger.h"
 
 using namespace std;
 using namespace vws;
 
+static const int MAX_FILES = 20;
+static const int MESSAGE_COUNT = 100000;
+static const int THREAD_COUNT = 4;
+static const int THREAD_MESSAGE_COUNT = 2000;
+
+/**
+ * Remove the log files created by the test.
+ */
+void
+removeLogFiles(const string & prefix) {
+    for (int i = 0; i < MAX_FILES; i++) {
+        char filename[1024];
+        snprintf(filename, sizeof(filename), "%s_%02d.log", prefix.c_str(), i);
+        std::remove(filename);
+    }
+}
+
+/**
+ * Log messages from a thread.
+ */
+void
+logMessages(int threadNumber) {
+    VantageLogger & logger = VantageLogger::getLogger("ThreadLogger");
+    for (int i = 0; i < THREAD_MESSAGE_COUNT; i++)
+        logger.log(VantageLogger::VANTAGE_INFO) << "Thread " << threadNumber << " message " << i << endl;
+}
+
 int
 main(int argc, char * argv[]) {
 
     string prefix = "./logfile";
+    removeLogFiles(prefix);
 
-    VantageLogger::setLogFileParameters(prefix, 20, 1);
+    VantageLogger::setLogFileParameters(prefix, MAX_FILES, 1);
 
     VantageLogger & logger = VantageLogger::getLogger("TestLogger");
 
-    cout << "Logging 100 messages" << endl;
-
-    string message = "Logger message";
-    for (int i = 0; i < 1000; i++)
-        message += " " + to_string(i);
+    cout << "Logging " << MESSAGE_COUNT << " messages" << endl;
 
-    for (int i = 0; i < 100000; i++)
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < MESSAGE_COUNT; i++)
         logger.log(VantageLogger::VANTAGE_ERROR) << "Logger message" << endl;
+
+    double millis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    VantageLogger::flush();
+    cout << "Logged " << MESSAGE_COUNT << " messages in " << millis << " ms (" << millis * 1000.0 / MESSAGE_COUNT << " us per message)" << endl;
+
+    //
+    // Every message is either in one of the rotated files or was counted as dropped, and no file grew much beyond the maximum size
+    //
+    int lineCount = 0;
+    int fileCount = 0;
+    bool sizesValid = true;
+    for (int i = 0; i < MAX_FILES; i++) {
+        char filename[1024];
+        snprintf(filename, sizeof(filename), "%s_%02d.log", prefix.c_str(), i);
+        if (!filesystem::exists(filename))
+            continue;
+
+        fileCount++;
+        if (filesystem::file_size(filename) > 1024 * 1024 + 1024)
+            sizesValid = false;
+
+        ifstream stream(filename);
+        string line;
+        while (getline(stream, line))
+            if (line.find("Logger message") != string::npos)
+                lineCount++;
+    }
+
+    uint64_t dropped = VantageLogger::getDroppedRecordCount();
+    if (lineCount + dropped == MESSAGE_COUNT && fileCount > 1 && sizesValid)
+        cout << "PASSED: " << lineCount << " messages were written to " << fileCount << " rotated files, " << dropped << " were dropped" << endl;
+    else
+        cout << "FAILED: " << lineCount << " messages were written to " << fileCount << " files, " << dropped << " were dropped" << endl;
+
+    removeLogFiles(prefix);
+
+    //
+    // The messages of each thread are written in the order in which the thread logged them
+    //
+    ostringstream output;
+    VantageLogger::setLogStream(output);
+    dropped = VantageLogger::getDroppedRecordCount();
+
+    vector<thread> threads;
+    for (int i = 0; i < THREAD_COUNT; i++)
+        threads.push_back(thread(logMessages, i));
+
+    for (thread & t : threads)
+        t.join();
+
+    VantageLogger::flush();
+    dropped = VantageLogger::getDroppedRecordCount() - dropped;
+
+    vector<int> lastMessage(THREAD_COUNT, -1);
+    bool ordered = true;
+    int threadLineCount = 0;
+    istringstream input(output.str());
+    string line;
+    while (getline(input, line)) {
+        int threadNumber, message;
+        size_t position = line.find("Thread ");
+        if (position == string::npos || sscanf(line.c_str() + position, "Thread %d message %d", &threadNumber, &message) != 2)
+            continue;
+
+        threadLineCount++;
+        if (message <= lastMessage[threadNumber])
+            ordered = false;
+
+        lastMessage[threadNumber] = message;
+    }
+
+    if (ordered && threadLineCount + dropped == THREAD_COUNT * THREAD_MESSAGE_COUNT)
+        cout << "PASSED: Messages of " << THREAD_COUNT << " threads were written in order" << endl;
+    else
+        cout << "FAILED: " << threadLineCount << " messages of " << THREAD_COUNT << " threads were written, ordered: " << ordered << endl;
+
+    VantageLogger::setLogStream(cerr);
 }
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// Compile out the DEBUG2 and DEBUG3 statements of this file, as a release build would
+//
+#define VANTAGE_LOG_COMPILED_LEVEL VANTAGE_DEBUG1
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "BitConverter.h"
+#include "LoopPacket.h"
+#include "VantageCRC.h"
+#include "VantageDecoder.h"
+#include "VantageLogger.h"
+#include "Weather.h"
+
+using namespace vws;
+using namespace std;
+
+/**
+ * Benchmark of the LOOP packet decode path with logging at INFO, which is the level the weather station normally runs at.
+ * The debug statements of the decode path are disabled, and the cost of a disabled statement with an expensive argument is
+ * compared between log() and VANTAGE_LOG().
+ */
+
+static const int PACKET_COUNT = 1000000;
+static const int STATEMENT_COUNT = 100000;
+static const int DISTINCT_PACKETS = 1024;
+
+static mt19937 randomGenerator(13579);
+static int argumentEvaluations = 0;
+
+/**
+ * An argument of a log statement that counts how often it is evaluated.
+ */
+string
+countedArgument() {
+    argumentEvaluations++;
+    return "argument";
+}
+
+/**
+ * Create LOOP packets with random field values that pass the LOOP packet validation.
+ */
+void
+createLoopPackets(vector<vws::byte> & packets) {
+    packets.resize(DISTINCT_PACKETS * LoopPacket::LOOP_PACKET_SIZE);
+    for (int i = 0; i < DISTINCT_PACKETS; i++) {
+        vws::byte * packet = &packets[i * LoopPacket::LOOP_PACKET_SIZE];
+        for (int j = 0; j < LoopPacket::LOOP_PACKET_SIZE; j++)
+            packet[j] = randomGenerator() & 0xFF;
+
+        packet[0] = 'L';
+        packet[1] = 'O';
+        packet[2] = 'O';
+        packet[3] = 0;                                   // Steady barometer trend
+        packet[4] = LoopPacket::LOOP_PACKET_TYPE;
+        packet[95] = '\n';
+        packet[96] = '\r';
+        BitConverter::getBytes(VantageCRC::calculateCRC(packet, 97), packet, 97, 2, false);
+    }
+}
+
+/**
+ * Report the time it took to perform an operation.
+ */
+double
+report(const string & description, int count, chrono::steady_clock::time_point start, chrono::steady_clock::time_point end) {
+    double millis = chrono::duration<double, milli>(end - start).count();
+    cout << description << " " << count << " times in " << millis << " ms (" << millis * 1000000.0 / count << " ns each)" << endl;
+    return millis;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_INFO);
+    VantageDecoder::setRainCollectorSize(.01);
+    VantageLogger & logger = VantageLogger::getLogger("LoggingBenchmark");
+
+    vector<vws::byte> loopPackets;
+    createLoopPackets(loopPackets);
+
+    //
+    // The decode path, whose debug statements are disabled at INFO
+    //
+    LoopPacket loopPacket;
+    int decoded = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int i = 0; i < PACKET_COUNT; i++) {
+        if (loopPacket.decodeLoopPacket(&loopPackets[(i % DISTINCT_PACKETS) * LoopPacket::LOOP_PACKET_SIZE]))
+            decoded++;
+    }
+
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    report("Decoded LOOP packets", PACKET_COUNT, t0, t1);
+
+    if (decoded == PACKET_COUNT)
+        cout << "PASSED: Every LOOP packet was decoded" << endl;
+    else
+        cout << "FAILED: " << decoded << " of " << PACKET_COUNT << " LOOP packets were decoded" << endl;
+
+    //
+    // A disabled statement that dumps the packet, as the serial port does for every read
+    //
+    t0 = chrono::steady_clock::now();
+    for (int i = 0; i < STATEMENT_COUNT; i++)
+        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Read buffer:" << Weather::dumpBuffer(&loopPackets[(i % DISTINCT_PACKETS) * LoopPacket::LOOP_PACKET_SIZE], LoopPacket::LOOP_PACKET_SIZE);
+
+    t1 = chrono::steady_clock::now();
+    for (int i = 0; i < STATEMENT_COUNT; i++)
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Read buffer:" << Weather::dumpBuffer(&loopPackets[(i % DISTINCT_PACKETS) * LoopPacket::LOOP_PACKET_SIZE], LoopPacket::LOOP_PACKET_SIZE);
+
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    double eagerMillis = report("Disabled log() statement with a buffer dump", STATEMENT_COUNT, t0, t1);
+    double lazyMillis = report("Disabled VANTAGE_LOG() statement with a buffer dump", STATEMENT_COUNT, t1, t2);
+
+    if (lazyMillis < eagerMillis)
+        cout << "PASSED: Disabled VANTAGE_LOG() statements are faster than disabled log() statements" << endl;
+    else
+        cout << "FAILED: Disabled VANTAGE_LOG() statements are not faster than disabled log() statements" << endl;
+
+    //
+    // The arguments are evaluated only for enabled levels, and never for the levels that are compiled out
+    //
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << countedArgument() << endl;
+    if (argumentEvaluations == 0)
+        cout << "PASSED: Arguments of a disabled statement were not evaluated" << endl;
+    else
+        cout << "FAILED: Arguments of a disabled statement were evaluated" << endl;
+
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_DEBUG3);
+    VantageLogger::setLogStream(cout);
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << countedArgument() << endl;
+    if (argumentEvaluations == 0)
+        cout << "PASSED: Arguments of a statement above the compiled level were not evaluated" << endl;
+    else
+        cout << "FAILED: Arguments of a statement above the compiled level were evaluated" << endl;
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Enabled statement with " << countedArgument() << endl;
+    VantageLogger::flush();
+    if (argumentEvaluations == 1)
+        cout << "PASSED: Arguments of an enabled statement were evaluated" << endl;
+    else
+        cout << "FAILED: Arguments of an enabled statement were not evaluated" << endl;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+#include "LoopPacketRing.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+static const string RING_FILE = "loop-ring-test.dat";
+static const int    CAPACITY = 10;
+static const DateTime FIRST_TIME = 1700000000;
+
+/**
+ * Write packets whose type alternates between LOOP and LOOP2 and whose first data byte is the packet number.
+ */
+void
+writePackets(LoopPacketRing & ring, int first, int count) {
+    vws::byte data[LoopPacketRing::PACKET_DATA_SIZE];
+    for (int i = first; i < first + count; i++) {
+        memset(data, 0, sizeof(data));
+        data[0] = static_cast<vws::byte>(i);
+        ring.writePacket(FIRST_TIME + (i * 2), i % 2, data, sizeof(data));
+    }
+}
+
+/**
+ * Check that the ring holds the packets in the range [first, last) from oldest to newest.
+ */
+bool
+checkPackets(const LoopPacketRing & ring, int first, int last) {
+    if (ring.getRecordCount() != last - first) {
+        cout << "    Record count " << ring.getRecordCount() << ", expected " << (last - first) << endl;
+        return false;
+    }
+
+    for (int i = 0; i < ring.getRecordCount(); i++) {
+        DateTime packetTime;
+        int packetType;
+        const vws::byte * data = ring.getRecord(i, packetTime, packetType);
+        int packet = first + i;
+        if (packetTime != FIRST_TIME + (packet * 2) || packetType != packet % 2 || data[0] != static_cast<vws::byte>(packet)) {
+            cout << "    Record " << i << " does not contain packet " << packet << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+
+    if (argc != 2) {
+        cout << "Usage: LoopPacketRingTest <directory>" << endl;
+        exit(1);
+    }
+
+    string ringPath = string(argv[1]) + "/" + RING_FILE;
+    unlink(ringPath.c_str());
+
+    {
+        LoopPacketRing ring(ringPath, 60, CAPACITY);
+        if (ring.open() && ring.getRecordCount() == 0)
+            cout << "PASSED: Created empty ring file" << endl;
+        else
+            cout << "FAILED: Ring file was not created" << endl;
+
+        writePackets(ring, 0, 4);
+        if (checkPackets(ring, 0, 4))
+            cout << "PASSED: Partially filled ring returns the packets in order" << endl;
+        else
+            cout << "FAILED: Partially filled ring did not return the packets in order" << endl;
+
+        writePackets(ring, 4, 21);
+        if (checkPackets(ring, 15, 25))
+            cout << "PASSED: Wrapped ring returns the newest packets in order" << endl;
+        else
+            cout << "FAILED: Wrapped ring did not return the newest packets in order" << endl;
+
+        int index = ring.findFirstRecordOnOrAfter(FIRST_TIME + (20 * 2));
+        if (index == 5 && ring.findFirstRecordOnOrAfter(0) == 0 && ring.findFirstRecordOnOrAfter(FIRST_TIME + 1000) == CAPACITY)
+            cout << "PASSED: Found the first record on or after a time" << endl;
+        else
+            cout << "FAILED: Find first record on or after a time returned " << index << ", expected 5" << endl;
+    }
+
+    {
+        //
+        // The capacity of an existing ring is taken from the file
+        //
+        LoopPacketRing ring(ringPath, 60, CAPACITY * 2);
+        if (ring.open(true) && checkPackets(ring, 15, 25))
+            cout << "PASSED: Reopened ring file contains the same packets" << endl;
+        else
+            cout << "FAILED: Reopened ring file does not contain the same packets" << endl;
+    }
+
+    {
+        fstream stream(ringPath, ios::in | ios::out | ios::binary);
+        stream.write("XXXX", 4);
+        stream.close();
+
+        LoopPacketRing readOnlyRing(ringPath);
+        LoopPacketRing ring(ringPath, 60, CAPACITY);
+        if (!readOnlyRing.open(true) && ring.open() && ring.getRecordCount() == 0)
+            cout << "PASSED: Ring file with a corrupt header was recreated" << endl;
+        else
+            cout << "FAILED: Ring file with a corrupt header was not recreated" << endl;
+    }
+
+    unlink(ringPath.c_str());
+
+    //
+    // Time a day's worth of packet writes
+    //
+    LoopPacketRing ring(ringPath);
+    ring.open();
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    writePackets(ring, 0, LoopPacketRing::DEFAULT_RECORD_CAPACITY);
+    ring.flush();
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    cout << "Wrote " << ring.getRecordCount() << " packets in " << chrono::duration<double, milli>(t2 - t1).count() << " ms" << endl;
+    ring.close();
+
+    unlink(ringPath.c_str());
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "SeriesDownsampler.h"
+
+using namespace vws;
+using namespace std;
+
+/**
+ * Downsample a series, treating NaN values as dashed values.
+ */
+vector<size_t>
+downsample(SeriesDownsampler::Method method, const vector<double> & series, size_t target) {
+    SeriesDownsampler downsampler(method, series.size(), target);
+    for (size_t i = 0; i < series.size(); i++) {
+        Measurement<double> value;
+        if (!isnan(series[i]))
+            value.setValue(series[i]);
+
+        downsampler.addPoint(i, static_cast<double>(i), value);
+    }
+
+    downsampler.finish();
+    return downsampler.getSelectedIndices();
+}
+
+/**
+ * Check that a point is never selected after the downsampler reported that every point before it was decided.
+ */
+bool
+isDecidedInOrder(SeriesDownsampler::Method method, const vector<double> & series, size_t target) {
+    SeriesDownsampler downsampler(method, series.size(), target);
+    vector<size_t> firstUndecided;
+    vector<size_t> selectedCount;
+    for (size_t i = 0; i < series.size(); i++) {
+        Measurement<double> value;
+        if (!isnan(series[i]))
+            value.setValue(series[i]);
+
+        downsampler.addPoint(i, static_cast<double>(i), value);
+        firstUndecided.push_back(downsampler.getFirstUndecidedIndex());
+        selectedCount.push_back(downsampler.getSelectedIndices().size());
+    }
+
+    downsampler.finish();
+
+    const vector<size_t> & selected = downsampler.getSelectedIndices();
+    for (size_t i = 0; i < series.size(); i++) {
+        for (size_t j = selectedCount[i]; j < selected.size(); j++) {
+            if (selected[j] < firstUndecided[i])
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+isIncreasing(const vector<size_t> & indices) {
+    for (size_t i = 1; i < indices.size(); i++)
+        if (indices[i] <= indices[i - 1])
+            return false;
+
+    return true;
+}
+
+int
+main(int argc, char * argv[]) {
+    //
+    // A slow sine wave with a single spike and a single dip
+    //
+    vector<double> series;
+    for (int i = 0; i < 10000; i++)
+        series.push_back(50.0 + (10.0 * sin(i / 500.0)));
+
+    series[3333] = 100.0;
+    series[6666] = 0.0;
+
+    SeriesDownsampler::Method method;
+    if (SeriesDownsampler::parseMethod("lttb", method) && method == SeriesDownsampler::Method::LTTB &&
+        SeriesDownsampler::parseMethod("min-max", method) && method == SeriesDownsampler::Method::MIN_MAX &&
+        !SeriesDownsampler::parseMethod("average", method))
+        cout << "PASSED: Downsample method names were parsed" << endl;
+    else
+        cout << "FAILED: Downsample method names were not parsed" << endl;
+
+    vector<size_t> shortSeries = downsample(SeriesDownsampler::Method::LTTB, vector<double>(series.begin(), series.begin() + 50), 100);
+    if (shortSeries.size() == 50 && isIncreasing(shortSeries))
+        cout << "PASSED: Every point of a series shorter than the target was selected" << endl;
+    else
+        cout << "FAILED: " << shortSeries.size() << " points of a 50 point series were selected" << endl;
+
+    vector<size_t> lttb = downsample(SeriesDownsampler::Method::LTTB, series, 200);
+    if (lttb.size() == 200 && isIncreasing(lttb) && lttb.front() == 0 && lttb.back() == series.size() - 1)
+        cout << "PASSED: LTTB selected the target number of points including the first and last points" << endl;
+    else
+        cout << "FAILED: LTTB selected " << lttb.size() << " points, expected 200" << endl;
+
+    if (find(lttb.begin(), lttb.end(), 3333) != lttb.end() && find(lttb.begin(), lttb.end(), 6666) != lttb.end())
+        cout << "PASSED: LTTB selected the spike and the dip" << endl;
+    else
+        cout << "FAILED: LTTB did not select the spike and the dip" << endl;
+
+    vector<size_t> minMax = downsample(SeriesDownsampler::Method::MIN_MAX, series, 200);
+    if (minMax.size() <= 200 && minMax.size() > 150 && isIncreasing(minMax) &&
+        find(minMax.begin(), minMax.end(), 3333) != minMax.end() && find(minMax.begin(), minMax.end(), 6666) != minMax.end())
+        cout << "PASSED: Min-max selected " << minMax.size() << " points including the spike and the dip" << endl;
+    else
+        cout << "FAILED: Min-max selected " << minMax.size() << " points or missed the spike or the dip" << endl;
+
+    //
+    // Dashed values are never selected, even when they are the first or last points
+    //
+    vector<double> dashed = series;
+    for (size_t i = 0; i < dashed.size(); i += 3)
+        dashed[i] = NAN;
+
+    dashed[dashed.size() - 1] = NAN;
+
+    bool dashedSelected = false;
+    size_t lttbCount = 0;
+    for (SeriesDownsampler::Method m : {SeriesDownsampler::Method::LTTB, SeriesDownsampler::Method::MIN_MAX}) {
+        vector<size_t> selected = downsample(m, dashed, 100);
+        for (size_t index : selected)
+            if (isnan(dashed[index]))
+                dashedSelected = true;
+
+        if (m == SeriesDownsampler::Method::LTTB)
+            lttbCount = selected.size();
+    }
+
+    if (!dashedSelected && lttbCount > 0 && lttbCount <= 100)
+        cout << "PASSED: Dashed values were not selected" << endl;
+    else
+        cout << "FAILED: Dashed values were selected" << endl;
+
+    vector<size_t> allDashed = downsample(SeriesDownsampler::Method::LTTB, vector<double>(1000, NAN), 100);
+    if (allDashed.empty())
+        cout << "PASSED: No points were selected from a series of dashed values" << endl;
+    else
+        cout << "FAILED: " << allDashed.size() << " points were selected from a series of dashed values" << endl;
+
+    if (isDecidedInOrder(SeriesDownsampler::Method::LTTB, dashed, 100) && isDecidedInOrder(SeriesDownsampler::Method::MIN_MAX, dashed, 100))
+        cout << "PASSED: No point was selected after it was reported as decided" << endl;
+    else
+        cout << "FAILED: A point was selected after it was reported as decided" << endl;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <chrono>
+#include <random>
+#include "SummaryReport.h"
+#include "ArchivePacket.h"
+#include "ArchiveRecordBuilder.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "VantageDecoder.h"
+#include "VantageEnums.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+/**
+ * Benchmark that compares two ways of applying archive packets to the summary records of a summary report. The nested
+ * method offers every packet to every record. The sweep method, which SummaryReport::loadData() uses, offers each packet
+ * only to the record that contains it.
+ */
+
+static mt19937 randomGenerator(13579);
+
+/**
+ * Create the archive packets for a number of years at a 5 minute archive period.
+ */
+void
+createPackets(int firstYear, int years, vector<ArchivePacket> & packets) {
+    uniform_int_distribution<int> temperature(300, 900);
+    uniform_int_distribution<int> small(0, 30);
+    uniform_int_distribution<int> pressure(29000, 31000);
+
+    DateTime packetTime = DateTimeFields(firstYear, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTime endTime = DateTimeFields(firstYear + years, 1, 1, 0, 0, 0).getEpochDateTime();
+
+    vws::byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    for (; packetTime < endTime; packetTime += 300) {
+        makeArchiveRecord(packetTime, buffer);
+
+        int averageTemperature = temperature(randomGenerator);
+        BitConverter::getBytes(averageTemperature, buffer, 4, 2);
+        BitConverter::getBytes(averageTemperature + 5, buffer, 6, 2);
+        BitConverter::getBytes(averageTemperature - 5, buffer, 8, 2);
+        BitConverter::getBytes(small(randomGenerator) / 10, buffer, 10, 2);
+        BitConverter::getBytes(small(randomGenerator), buffer, 12, 2);
+        BitConverter::getBytes(pressure(randomGenerator), buffer, 14, 2);
+        BitConverter::getBytes(averageTemperature, buffer, 16, 2);
+        BitConverter::getBytes(100, buffer, 18, 2);
+        BitConverter::getBytes(averageTemperature + 50, buffer, 20, 2);
+        buffer[22] = static_cast<vws::byte>(small(randomGenerator) + 20);
+        buffer[23] = static_cast<vws::byte>(small(randomGenerator) + 50);
+        buffer[24] = static_cast<vws::byte>(small(randomGenerator));
+        buffer[25] = static_cast<vws::byte>(small(randomGenerator) + 5);
+        buffer[26] = static_cast<vws::byte>(small(randomGenerator) % 16);
+        buffer[27] = static_cast<vws::byte>(small(randomGenerator) % 16);
+        buffer[28] = static_cast<vws::byte>(small(randomGenerator) / 3);
+        buffer[29] = static_cast<vws::byte>(small(randomGenerator) / 10);
+        BitConverter::getBytes(averageTemperature + 20, buffer, 30, 2);
+        buffer[32] = static_cast<vws::byte>(small(randomGenerator) / 2);
+
+        packets.push_back(ArchivePacket(buffer));
+    }
+}
+
+/**
+ * Format all of the summary records so the results of the two methods can be compared.
+ */
+string
+formatRecords(const vector<SummaryRecord> & summaryRecords, const vector<SummaryRecord> & dayRecords) {
+    string json;
+    for (const auto & record : summaryRecords)
+        json += record.formatJSON();
+
+    for (const auto & record : dayRecords)
+        json += record.formatJSON();
+
+    return json;
+}
+
+/**
+ * Apply the packets by offering each packet and each day record to every summary record, which is how
+ * SummaryReport::loadData() built the report before the sweep.
+ */
+void
+applyNested(SummaryPeriod period, DateTime startTime, DateTime endTime, const vector<ArchivePacket> & packets,
+            vector<SummaryRecord> & summaryRecords, vector<SummaryRecord> & dayRecords) {
+    SummaryReport::createSummaryRecords(period, startTime, endTime, summaryRecords);
+    SummaryReport::createSummaryRecords(SummaryPeriod::DAY, startTime, endTime, dayRecords);
+
+    for (const auto & packet : packets) {
+        for (auto & dayRecord : dayRecords)
+            dayRecord.applyArchivePacket(packet);
+    }
+
+    for (auto & summaryRecord : summaryRecords) {
+        for (auto & dayRecord : dayRecords)
+            summaryRecord.applySummaryRecord(dayRecord);
+    }
+
+    if (period != SummaryPeriod::DAY) {
+        for (auto & summaryRecord : summaryRecords) {
+            for (auto & dayRecord : dayRecords)
+                summaryRecord.applyDaySummaryRecord(dayRecord);
+        }
+    }
+}
+
+/**
+ * Apply the packets and day records with sweeps.
+ */
+void
+applySweep(SummaryPeriod period, DateTime startTime, DateTime endTime, const vector<ArchivePacket> & packets,
+           vector<SummaryRecord> & summaryRecords, vector<SummaryRecord> & dayRecords) {
+    SummaryReport::createSummaryRecords(period, startTime, endTime, summaryRecords);
+    SummaryReport::createSummaryRecords(SummaryPeriod::DAY, startTime, endTime, dayRecords);
+
+    SummaryRecordSweep daySweep(dayRecords);
+    for (const auto & packet : packets)
+        daySweep.applyArchivePacket(packet);
+
+    SummaryRecordSweep summarySweep(summaryRecords);
+    for (auto & dayRecord : dayRecords)
+        summarySweep.applySummaryRecord(dayRecord);
+
+    if (period != SummaryPeriod::DAY) {
+        SummaryRecordSweep daySummarySweep(summaryRecords);
+        for (auto & dayRecord : dayRecords)
+            daySummarySweep.applyDaySummaryRecord(dayRecord);
+    }
+}
+
+/**
+ * Run both methods for a period over a number of years of packets.
+ */
+void
+benchmark(SummaryPeriod period, int years) {
+    const int firstYear = 2015;
+    vector<ArchivePacket> packets;
+    createPackets(firstYear, years, packets);
+
+    DateTime startTime = DateTimeFields(firstYear, 1, 1, 0, 0, 0).getEpochDateTime();
+    DateTime endTime = DateTimeFields(firstYear + years - 1, 12, 31, 23, 59, 59).getEpochDateTime();
+
+    vector<SummaryRecord> nestedSummaryRecords;
+    vector<SummaryRecord> nestedDayRecords;
+    auto start = chrono::steady_clock::now();
+    applyNested(period, startTime, endTime, packets, nestedSummaryRecords, nestedDayRecords);
+    auto nestedTime = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    vector<SummaryRecord> sweepSummaryRecords;
+    vector<SummaryRecord> sweepDayRecords;
+    start = chrono::steady_clock::now();
+    applySweep(period, startTime, endTime, packets, sweepSummaryRecords, sweepDayRecords);
+    auto sweepTime = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    string nestedResult = formatRecords(nestedSummaryRecords, nestedDayRecords);
+    string sweepResult = formatRecords(sweepSummaryRecords, sweepDayRecords);
+
+    cout << summaryPeriodEnum.valueToString(period) << " summary of " << years << " years (" << packets.size() << " packets): "
+         << "nested = " << nestedTime << " ms, sweep = " << sweepTime << " ms" << endl;
+
+    if (nestedResult == sweepResult)
+        cout << "PASSED: Sweep " << summaryPeriodEnum.valueToString(period) << " summary matches the nested summary" << endl;
+    else
+        cout << "FAILED: Sweep " << summaryPeriodEnum.valueToString(period) << " summary does not match the nested summary" << endl;
+}
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_WARNING);
+    VantageDecoder::setRainCollectorSize(.01);
+
+    //
+    // The number of years is scaled by the optional argument
+    //
+    int scale = 1;
+    if (argc > 1)
+        scale = atoi(argv[1]);
+
+    if (scale < 1) {
+        cout << "Usage: SummarySweepBenchmark [scale]" << endl;
+        exit(1);
+    }
+
+    benchmark(SummaryPeriod::DAY, scale);
+    benchmark(SummaryPeriod::MONTH, 2 * scale);
+    benchmark(SummaryPeriod::YEAR, 4 * scale);
+
+    return 0;
+}
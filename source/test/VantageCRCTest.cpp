@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "BitConverter.h"
+#include "VantageCRC.h"
+#include "VantageLogger.h"
+
+using namespace vws;
+using namespace std;
+
+//
+// The byte-at-a-time implementation that was used before the slicing implementation
+//
+static const int REFERENCE_CRC_TABLE[] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+    0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+    0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+    0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+    0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+    0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+    0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+    0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+    0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+    0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+    0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+    0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+    0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+    0x2b1,  0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+    0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+    0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+    0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+    0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+    0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+    0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+    0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+    0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,
+};
+
+int
+referenceCRC(const vws::byte * buffer, int length) {
+    int crc = 0;
+
+    for (int i = 0; i < length; i++)
+        crc = ((REFERENCE_CRC_TABLE[(crc >> 8) ^ (((int)buffer[i]) & 0xFF)]) ^ ((crc << 8) & 0xFFFF)) & 0xFFFF;
+
+    return crc;
+}
+
+static const int ARCHIVE_PAGE_SIZE = 265;
+static const int ARCHIVE_PAGE_COUNT = 512;
+
+int
+main(int argc, char * argv[]) {
+    VantageLogger::setLogLevel(VantageLogger::VANTAGE_ERROR);
+
+    //
+    // Every one and two byte message
+    //
+    int mismatches = 0;
+    vws::byte message[2];
+    for (int value = 0; value < 65536; value++) {
+        message[0] = value >> 8;
+        message[1] = value & 0xFF;
+        if (VantageCRC::calculateCRC(message, 2) != referenceCRC(message, 2))
+            mismatches++;
+
+        if (value < 256 && VantageCRC::calculateCRC(message + 1, 1) != referenceCRC(message + 1, 1))
+            mismatches++;
+    }
+
+    if (mismatches == 0)
+        cout << "PASSED: CRCs of every one and two byte message match the reference implementation" << endl;
+    else
+        cout << "FAILED: " << mismatches << " CRCs of one and two byte messages do not match the reference implementation" << endl;
+
+    //
+    // Every length up to a few archive pages at every alignment, so every combination of slices and remaining bytes is used
+    //
+    mt19937 random(12345);
+    vector<vws::byte> data(2048 + 8);
+    for (vws::byte & b : data)
+        b = random() & 0xFF;
+
+    mismatches = 0;
+    int checks = 0;
+    for (int alignment = 0; alignment < 8; alignment++) {
+        for (int length = 0; length <= 2048; length++) {
+            checks++;
+            if (VantageCRC::calculateCRC(&data[alignment], length) != referenceCRC(&data[alignment], length))
+                mismatches++;
+        }
+    }
+
+    for (int i = 0; i < 100000; i++) {
+        int length = random() % 300;
+        for (int j = 0; j < length; j++)
+            data[j] = random() & 0xFF;
+
+        checks++;
+        if (VantageCRC::calculateCRC(&data[0], length) != referenceCRC(&data[0], length))
+            mismatches++;
+    }
+
+    if (mismatches == 0)
+        cout << "PASSED: " << checks << " CRCs of random messages match the reference implementation" << endl;
+    else
+        cout << "FAILED: " << mismatches << " of " << checks << " CRCs of random messages do not match the reference implementation" << endl;
+
+    //
+    // A full archive dump, with the CRC after each page the way the console sends it
+    //
+    int blockLength = ARCHIVE_PAGE_SIZE + VantageCRC::CRC_LENGTH;
+    vector<vws::byte> dump(ARCHIVE_PAGE_COUNT * blockLength);
+    for (int page = 0; page < ARCHIVE_PAGE_COUNT; page++) {
+        vws::byte * pageData = &dump[page * blockLength];
+        for (int i = 0; i < ARCHIVE_PAGE_SIZE; i++)
+            pageData[i] = random() & 0xFF;
+
+        BitConverter::getBytes(VantageCRC::calculateCRC(pageData, ARCHIVE_PAGE_SIZE), pageData, ARCHIVE_PAGE_SIZE, 2, false);
+    }
+
+    if (VantageCRC::checkCRC(&dump[0], ARCHIVE_PAGE_SIZE) && VantageCRC::checkCRC(&dump[blockLength * (ARCHIVE_PAGE_COUNT - 1)], ARCHIVE_PAGE_SIZE))
+        cout << "PASSED: CRC sent most significant byte first was checked" << endl;
+    else
+        cout << "FAILED: CRC sent most significant byte first was not checked" << endl;
+
+    vector<int> failedBlocks;
+    int failedCount = VantageCRC::checkCRCs(&dump[0], ARCHIVE_PAGE_SIZE, ARCHIVE_PAGE_COUNT, failedBlocks);
+    dump[3 * blockLength + 100] ^= 0x01;
+    dump[400 * blockLength + ARCHIVE_PAGE_SIZE] ^= 0x80;
+    VantageCRC::checkCRCs(&dump[0], ARCHIVE_PAGE_SIZE, ARCHIVE_PAGE_COUNT, failedBlocks);
+    if (failedCount == 0 && failedBlocks == vector<int>{3, 400} && !VantageCRC::checkCRC(&dump[3 * blockLength], ARCHIVE_PAGE_SIZE))
+        cout << "PASSED: Corrupt pages of an archive dump were found" << endl;
+    else
+        cout << "FAILED: Corrupt pages of an archive dump were not found. Failed pages: " << failedBlocks.size() << endl;
+
+    vector<vws::byte> records(100 * 54);
+    for (int i = 0; i < 100; i++)
+        BitConverter::getBytes(VantageCRC::calculateCRC(&records[i * 54], 52), &records[i * 54], 52, 2);
+
+    records[50 * 54] = 1;
+    if (VantageCRC::checkCRCs(&records[0], 52, 100, failedBlocks, true) == 1 && failedBlocks[0] == 50)
+        cout << "PASSED: CRCs stored least significant byte first were checked" << endl;
+    else
+        cout << "FAILED: CRCs stored least significant byte first were not checked" << endl;
+
+    //
+    // Throughput of the reference and slicing implementations over full archive dumps
+    //
+    static const int DUMP_COUNT = 200;
+    int referenceSum = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int i = 0; i < DUMP_COUNT; i++)
+        for (int page = 0; page < ARCHIVE_PAGE_COUNT; page++)
+            referenceSum += referenceCRC(&dump[page * blockLength], ARCHIVE_PAGE_SIZE);
+
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    int slicingSum = 0;
+    for (int i = 0; i < DUMP_COUNT; i++)
+        for (int page = 0; page < ARCHIVE_PAGE_COUNT; page++)
+            slicingSum += VantageCRC::calculateCRC(&dump[page * blockLength], ARCHIVE_PAGE_SIZE);
+
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    for (int i = 0; i < DUMP_COUNT; i++)
+        VantageCRC::checkCRCs(&dump[0], ARCHIVE_PAGE_SIZE, ARCHIVE_PAGE_COUNT, failedBlocks);
+
+    chrono::steady_clock::time_point t3 = chrono::steady_clock::now();
+
+    if (referenceSum == slicingSum)
+        cout << "PASSED: Benchmark CRCs match" << endl;
+    else
+        cout << "FAILED: Benchmark CRCs do not match" << endl;
+
+    double megabytes = (static_cast<double>(DUMP_COUNT) * ARCHIVE_PAGE_COUNT * ARCHIVE_PAGE_SIZE) / (1024.0 * 1024.0);
+    double referenceMillis = chrono::duration<double, milli>(t1 - t0).count();
+    double slicingMillis = chrono::duration<double, milli>(t2 - t1).count();
+    double bulkMillis = chrono::duration<double, milli>(t3 - t2).count();
+    cout << "Calculated CRCs of " << DUMP_COUNT << " archive dumps byte-at-a-time in " << referenceMillis << " ms (" << (megabytes / (referenceMillis / 1000.0)) << " MB/s)" << endl;
+    cout << "Calculated CRCs of " << DUMP_COUNT << " archive dumps 8 bytes at a time in " << slicingMillis << " ms (" << (megabytes / (slicingMillis / 1000.0)) << " MB/s)" << endl;
+    cout << "Checked CRCs of " << DUMP_COUNT << " archive dumps with checkCRCs() in " << bulkMillis << " ms (" << (megabytes / (bulkMillis / 1000.0)) << " MB/s)" << endl;
+}
@@ -40,13 +40,13 @@ Alarm::Alarm(const AlarmProperties & properties) : properties(properties),
 ////////////////////////////////////////////////////////////////////////////////
 void
 Alarm::setThreshold(int eepromThreshold) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "########## Setting threshold for alarm " + properties.alarmName + " Not set value = " << properties.eepromNotSetThreshold << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "########## Setting threshold for alarm " + properties.alarmName + " Not set value = " << properties.eepromNotSetThreshold << endl;
     this->eepromThreshold = eepromThreshold;
     if (this->eepromThreshold == properties.eepromNotSetThreshold) {
         clearThreshold();
     }
     else {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "######### Setting threshold for alarm " << properties.alarmName << " to " << actualThreshold << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "######### Setting threshold for alarm " << properties.alarmName << " to " << actualThreshold << endl;
         alarmThresholdSet = true;
         alarmTriggered = false;
         actualThreshold = fromEepromToActualThreshold(eepromThreshold, properties.eepromThresholdOffset, properties.eepromThresholdScale);
@@ -57,7 +57,7 @@ Alarm::setThreshold(int eepromThreshold) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 Alarm::setThreshold(double threshold) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "######### Setting threshold for alarm " << properties.alarmName << " to " << threshold << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "######### Setting threshold for alarm " << properties.alarmName << " to " << threshold << endl;
     actualThreshold = threshold;
     eepromThreshold = fromActualToEepromThreshold(actualThreshold, properties.eepromThresholdOffset, properties.eepromThresholdScale);
     alarmThresholdSet = true;
@@ -68,7 +68,7 @@ Alarm::setThreshold(double threshold) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 Alarm::clearThreshold() {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "######### Clearing threshold for alarm " + properties.alarmName << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "######### Clearing threshold for alarm " + properties.alarmName << endl;
     eepromThreshold = properties.eepromNotSetThreshold;
     alarmThresholdSet = false;
     alarmTriggered = false;
@@ -170,7 +170,7 @@ Alarm::setRainAlarmScale(double bucketSize) {
     //
     if (properties.isRainAlarm) {
         properties.eepromThresholdScale = bucketSize;
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Setting threshold scale for alarm " + properties.alarmName + " to " << bucketSize << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Setting threshold scale for alarm " + properties.alarmName + " to " << bucketSize << endl;
     }
 }
 }
@@ -21,10 +21,8 @@
 #include <fstream>
 #include "VantageEepromConstants.h"
 #include "VantageLogger.h"
-#include "json.hpp"
 
 using namespace std;
-using json = nlohmann::json;
 
 namespace vws {
 
@@ -74,7 +72,7 @@ AlarmManager::processLoop2Packet(const Loop2Packet & packet) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 AlarmManager::processRainCollectorSizeChange(Rainfall bucketSize) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Received new rain bucket size of " << bucketSize << " inches" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Received new rain bucket size of " << bucketSize << " inches" << endl;
     rainCollectorSize = bucketSize;
 
     for (auto & alarm : alarms) {
@@ -153,7 +151,7 @@ AlarmManager::formatActiveAlarmsJSON() const {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 AlarmManager::setAlarmThreshold(const std::string & alarmName, double actualThreshold) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Setting threshold for alarm " << alarmName << " to " << actualThreshold << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Setting threshold for alarm " << alarmName << " to " << actualThreshold << endl;
     for (auto & alarm : alarms) {
         if (alarm.getAlarmName() == alarmName) {
             alarm.setThreshold(actualThreshold);
@@ -298,10 +296,8 @@ AlarmManager::updateThresholds() {
 void
 AlarmManager::setAlarmStates() {
     const LoopPacket::AlarmBitSet & alarmBits = currentWeather.getLoopPacket().getAlarmBits();
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Setting alarm states. Bitset=" << alarmBits << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Setting alarm states. Bitset=" << alarmBits << endl;
 
-    bool firstTransition = true;
-    json cwJsonObject;
     DateTimeFields now(time(0));
     for (auto & alarm : alarms) {
         bool currentState = alarm.isTriggered();
@@ -309,20 +305,8 @@ AlarmManager::setAlarmStates() {
         if (alarmBit >= 0) {
             bool newState = alarmBits[alarmBit] == 1;
             alarm.setTriggered(newState);
-             if (currentState != newState) {
-                 //
-                 // The first time we encounter a change to an alarm state build the current weather
-                 // JSON string so the current weather value can be retrieved. If there are no transitions
-                 // then we don't take up any cycles performing JSON processing.
-                 //
-                 if (firstTransition) {
-                     string cwJsonString = cwJsonString = currentWeather.formatJSON();
-                     cwJsonObject = json::parse(cwJsonString.begin(), cwJsonString.end());
-                     firstTransition = false;
-                 }
-
-                 writeAlarmTransition(cwJsonObject, alarm, now);
-             }
+             if (currentState != newState)
+                 writeAlarmTransition(alarm, now);
         }
     }
 }
@@ -360,7 +344,7 @@ AlarmManager::loadAlarmStatesFromFile() {
         bool triggered = ALARM_ACTIVE_STRING == logEntry.state;
         bool found = setAlarmState(logEntry.alarmName, triggered);
         if (found)
-            logger.log(VantageLogger::VANTAGE_DEBUG2) << "Set alarm state from log file of alarm: '" << logEntry.alarmName << "' Triggered: " << boolalpha << triggered << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Set alarm state from log file of alarm: '" << logEntry.alarmName << "' Triggered: " << boolalpha << triggered << endl;
         else
             logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to set alarm: '" << logEntry.alarmName << "' from log file. Alarm name was not found." << endl;
     });
@@ -369,7 +353,7 @@ AlarmManager::loadAlarmStatesFromFile() {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-AlarmManager::writeAlarmTransition(const json & jsonObject, const Alarm & alarm, const DateTimeFields & transitionTime) {
+AlarmManager::writeAlarmTransition(const Alarm & alarm, const DateTimeFields & transitionTime) {
     string state = ALARM_ACTIVE_STRING;
 
     if (!alarm.isTriggered())
@@ -388,7 +372,7 @@ AlarmManager::writeAlarmTransition(const json & jsonObject, const Alarm & alarm,
     else
         threshold << DASHED_VALUE_STRING;
 
-    if (findWeatherValue(jsonObject, alarm.getAlarmCurrentWeatherFieldName(), value))
+    if (findWeatherValue(alarm.getAlarmCurrentWeatherFieldName(), value))
         ofs << transitionTime.formatDateTime(true) << " " << state << " \"" << alarm.getAlarmName() << "\" " << threshold.str() << " " << value << endl;
     else
         ofs << transitionTime.formatDateTime(true) << " " << state << " \"" << alarm.getAlarmName() << "\" " << threshold.str() << " " << DASHED_VALUE_STRING << endl;
@@ -399,21 +383,15 @@ AlarmManager::writeAlarmTransition(const json & jsonObject, const Alarm & alarm,
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
-AlarmManager::findWeatherValue(const json & jsonObject, const std::string & field, double & value) {
+AlarmManager::findWeatherValue(const std::string & field, double & value) {
     //
     // TODO This lookup algorithm will not work for extra temperatures, extra humidities, leaf wetness, soil temperature,
     // soil moisture or leaf temperatures. This is because these values are part of an array.
     //
-    try {
-        json obj = jsonObject.at(field);
-        cout << "Field " << field << " has type " << obj.type_name() << endl;
-        double lookupValue = jsonObject.at(field);
-        value = lookupValue;
+    if (currentWeather.getFieldValue(field, value))
         return true;
-    }
-    catch (const json::out_of_range & e) {
-        logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to find current weather field '" << field << "'" << endl;
-        return false;
-    }
+
+    logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to find current weather field '" << field << "'" << endl;
+    return false;
 }
 }
@@ -17,7 +17,8 @@
 #ifndef ALARM_MANAGER_H
 #define ALARM_MANAGER_H
 
-#include "json.hpp"
+#include <functional>
+
 #include "VantageWeatherStation.h"
 #include "LoopPacket.h"
 #include "Alarm.h"
@@ -184,21 +185,19 @@ private:
     /**
      * Write an alarm transition record to the log file.
      *
-     * @param jsonObject     A JSON object that represents the current weather data
      * @param alarm          The alarm that has changed state
      * @param transitionTime The time at which the transition occurred
      */
-    void writeAlarmTransition(const nlohmann::json & jsonObject, const Alarm & alarm, const DateTimeFields & transitionTime);
+    void writeAlarmTransition(const Alarm & alarm, const DateTimeFields & transitionTime);
 
     /**
-     * Find the current weather value in the JSON object.
+     * Find the current weather value of a field.
      *
-     * @param [in]  jsonObject A JSON object that represents the current weather data
-     * @param [in]  field      The name of the JSON element being searched
-     * @param [out] value      The value of the field if found or unchanged if not found
+     * @param [in]  field The name of the current weather JSON element
+     * @param [out] value The value of the field if found or unchanged if not found
      * @return True if the field was found and the value argument was written
      */
-    bool findWeatherValue(const nlohmann::json & jsonObject, const std::string & field, double & value);
+    bool findWeatherValue(const std::string & field, double & value);
 
     std::vector<Alarm>      alarms;
     VantageWeatherStation & station;
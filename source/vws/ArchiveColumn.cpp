@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ArchiveColumn.h"
+
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+#include "VantageDecoder.h"
+
+using namespace std;
+
+namespace vws {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+template<typename T, Measurement<T> (*decode)(const byte [], int)>
+static Measurement<double>
+decodeMeasurement(const byte buffer[], int offset) {
+    Measurement<T> measurement = decode(buffer, offset);
+    Measurement<double> value;
+    if (measurement.isValid())
+        value.setValue(static_cast<double>(measurement.getValue()));
+
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static Measurement<double>
+decodeTemperature(const byte buffer[], int offset) {
+    Measurement<Temperature> temperature = VantageDecoder::decode16BitTemperature(buffer, offset);
+    Measurement<double> value;
+    if (temperature.isValid())
+        value.setValue(temperature.getValue());
+
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static Measurement<double>
+decodeRain(const byte buffer[], int offset) {
+    Measurement<double> value;
+    value.setValue(VantageDecoder::decodeRain(buffer, offset));
+    return value;
+}
+
+//
+// The high solar radiation is not a column because its validity depends on the average solar radiation
+//
+const ArchiveColumn ArchiveColumn::COLUMNS[] = {
+    { 0,  "avgOutsideTemperature",  ArchivePacket::OUTSIDE_TEMPERATURE_OFFSET,       2, true,  &decodeTemperature },
+    { 1,  "highOutsideTemperature", ArchivePacket::HIGH_OUTSIDE_TEMPERATURE_OFFSET,  2, true,  &decodeTemperature },
+    { 2,  "lowOutsideTemperature",  ArchivePacket::LOW_OUTSIDE_TEMPERATURE_OFFSET,   2, true,  &decodeTemperature },
+    { 3,  "rainfall",               ArchivePacket::RAINFALL_OFFSET,                  2, true,  &decodeRain },
+    { 4,  "highRainfallRate",       ArchivePacket::HIGH_RAIN_RATE_OFFSET,            2, true,  &decodeRain },
+    { 5,  "barometricPressure",     ArchivePacket::BAROMETER_OFFSET,                 2, false, &decodeMeasurement<Pressure, VantageDecoder::decodeBarometricPressure> },
+    { 6,  "avgSolarRadiation",      ArchivePacket::SOLAR_RADIATION_OFFSET,           2, false, &decodeMeasurement<SolarRadiation, VantageDecoder::decodeSolarRadiation> },
+    { 7,  "insideTemperature",      ArchivePacket::INSIDE_TEMPERATURE_OFFSET,        2, true,  &decodeTemperature },
+    { 8,  "insideHumidity",         ArchivePacket::INSIDE_HUMIDITY_OFFSET,           1, false, &decodeMeasurement<Humidity, VantageDecoder::decodeHumidity> },
+    { 9,  "outsideHumidity",        ArchivePacket::OUTSIDE_HUMIDITY_OFFSET,          1, false, &decodeMeasurement<Humidity, VantageDecoder::decodeHumidity> },
+    { 10, "avgWindSpeed",           ArchivePacket::AVG_WIND_SPEED_OFFSET,            1, false, &decodeMeasurement<Speed, VantageDecoder::decode8BitWindSpeed> },
+    { 11, "avgWindDirection",       ArchivePacket::PREVAILING_WIND_DIRECTION_OFFSET, 1, false, &decodeMeasurement<HeadingIndex, VantageDecoder::decodeWindDirectionIndex> },
+    { 12, "highWindSpeed",          ArchivePacket::HIGH_WIND_SPEED_OFFSET,           1, false, &decodeMeasurement<Speed, VantageDecoder::decode8BitWindSpeed> },
+    { 13, "highWindDirection",      ArchivePacket::DIR_OF_HIGH_WIND_SPEED_OFFSET,    1, false, &decodeMeasurement<HeadingIndex, VantageDecoder::decodeWindDirectionIndex> },
+    { 14, "avgUvIndex",             ArchivePacket::AVG_UV_INDEX_OFFSET,              1, false, &decodeMeasurement<UvIndex, VantageDecoder::decodeUvIndex> },
+    { 15, "evapotranspiration",     ArchivePacket::ET_OFFSET,                        1, false, &decodeMeasurement<Evapotranspiration, VantageDecoder::decodeArchiveET> },
+    { 16, "highUvIndex",            ArchivePacket::HIGH_UV_INDEX_OFFSET,             1, false, &decodeMeasurement<UvIndex, VantageDecoder::decodeUvIndex> }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveColumn::getColumnCount() {
+    return sizeof(COLUMNS) / sizeof(COLUMNS[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const ArchiveColumn &
+ArchiveColumn::getColumn(int columnId) {
+    return COLUMNS[columnId];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const ArchiveColumn *
+ArchiveColumn::findColumn(const string & name) {
+    for (const ArchiveColumn & column : COLUMNS) {
+        if (name == column.name)
+            return &column;
+    }
+
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int32
+ArchiveColumn::extractRawValue(const byte * record) const {
+    if (size == 1)
+        return BitConverter::toUint8(record, packetOffset);
+    else if (isSigned)
+        return BitConverter::toInt16(record, packetOffset);
+    else
+        return BitConverter::toUint16(record, packetOffset);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+Measurement<double>
+ArchiveColumn::decodeRawValue(int32 rawValue) const {
+    //
+    // The decoders read from a packet buffer, so the raw value is placed at the column's offset of a scratch packet
+    //
+    byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    BitConverter::getBytes(rawValue, buffer, packetOffset, size);
+    return decoder(buffer, packetOffset);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+Measurement<double>
+ArchiveColumn::decodeValue(const byte * record) const {
+    return decoder(record, packetOffset);
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_COLUMN_H
+#define ARCHIVE_COLUMN_H
+
+#include <string>
+
+#include "Measurement.h"
+#include "WeatherTypes.h"
+
+namespace vws {
+
+/**
+ * A scalar field of the archive packet that can be extracted and decoded from the raw packet without decoding
+ * the entire packet. The raw value is the integer the console stores in the packet, the decoded value is the
+ * value that ArchivePacket reports in its JSON using the same element name.
+ */
+class ArchiveColumn {
+public:
+    typedef Measurement<double> (*Decoder)(const byte buffer[], int offset);
+
+    /**
+     * Get the number of columns.
+     *
+     * @return The column count
+     */
+    static int getColumnCount();
+
+    /**
+     * Get a column by its ID.
+     *
+     * @param columnId The ID of the column, which must be in the range [0, getColumnCount())
+     * @return The column
+     */
+    static const ArchiveColumn & getColumn(int columnId);
+
+    /**
+     * Find a column by the name of its element in the archive packet JSON.
+     *
+     * @param name The name of the JSON element
+     * @return The column or nullptr if there is no column with that name
+     */
+    static const ArchiveColumn * findColumn(const std::string & name);
+
+    /**
+     * Extract the raw value of this column from an archive packet.
+     *
+     * @param record The raw archive packet
+     * @return The raw value
+     */
+    int32 extractRawValue(const byte * record) const;
+
+    /**
+     * Decode a raw value of this column.
+     *
+     * @param rawValue The raw value as returned by extractRawValue()
+     * @return The decoded value, which is not valid if the console reported a dashed value
+     */
+    Measurement<double> decodeRawValue(int32 rawValue) const;
+
+    /**
+     * Extract and decode the value of this column from an archive packet.
+     *
+     * @param record The raw archive packet
+     * @return The decoded value
+     */
+    Measurement<double> decodeValue(const byte * record) const;
+
+    int          columnId;      // The index of this column in the column table
+    const char * name;          // The name of the element in the archive packet JSON
+    int          packetOffset;  // The offset of the raw value within the archive packet
+    int          size;          // The number of bytes of the raw value
+    bool         isSigned;      // Whether the raw value is a signed integer
+    Decoder      decoder;       // The decoder of the raw value
+
+private:
+    static const ArchiveColumn COLUMNS[];
+};
+
+}
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ArchiveDownload.h"
+
+#include <time.h>
+#include "VantageWeatherStation.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveDownload::ArchiveDownload(ArchiveManager & archiveManager) : archiveManager(archiveManager),
+                                                                    dumpEnded(false),
+                                                                    firstRecordInFirstPage(0),
+                                                                    progress{},
+                                                                    logger(VantageLogger::getLogger("ArchiveDownload")) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveDownload::~ArchiveDownload() {
+    if (commitThread.joinable())
+        endDump(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveDownload::beginDump(const DateTimeFields & afterTime, int firstRecordInFirstPageToProcess, int pageCount) {
+    logger.log(VantageLogger::VANTAGE_INFO) << "Starting download of " << pageCount << " archive pages after " << afterTime << endl;
+
+    newestRecordTime = afterTime;
+    firstRecordInFirstPage = firstRecordInFirstPageToProcess;
+    dumpEnded = false;
+    pages.clear();
+
+    progress = ArchiveManager::DownloadProgress{};
+    progress.active = true;
+    progress.pageCount = pageCount;
+    progress.startTime = time(0);
+    archiveManager.setDownloadProgress(progress);
+
+    commitThread = std::thread(&ArchiveDownload::commitPages, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveDownload::processArchivePage(const byte * page) {
+    Page copy(page, page + VantageWeatherStation::ARCHIVE_PAGE_SIZE);
+
+    std::lock_guard<std::mutex> guard(mutex);
+    pages.push_back(std::move(copy));
+    progress.pagesReceived++;
+    publishProgress();
+    pageQueued.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveDownload::endDump(bool success) {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        dumpEnded = true;
+        progress.aborted = !success;
+        pageQueued.notify_one();
+    }
+
+    if (commitThread.joinable())
+        commitThread.join();
+
+    std::lock_guard<std::mutex> guard(mutex);
+    progress.active = false;
+    publishProgress();
+
+    if (success)
+        logger.log(VantageLogger::VANTAGE_INFO) << "Archive download added " << progress.recordsCommitted << " records from "
+                                                << progress.pagesCommitted << " pages" << endl;
+    else
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Archive download aborted after " << progress.pagesReceived << " of " << progress.pageCount
+                                                   << " pages. Added " << progress.recordsCommitted << " records from the pages that were received" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveDownload::getPagesCommitted() const {
+    return progress.pagesCommitted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveDownload::getRecordsCommitted() const {
+    return progress.recordsCommitted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const DateTimeFields &
+ArchiveDownload::getNewestRecordTime() const {
+    return newestRecordTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveDownload::commitPages() {
+    std::unique_lock<std::mutex> lock(mutex);
+    int pagesDecoded = 0;
+
+    while (true) {
+        pageQueued.wait(lock, [this]() { return !pages.empty() || dumpEnded; });
+        if (pages.empty())
+            break;
+
+        //
+        // Take every page that is queued so that they are appended as one batch
+        //
+        std::deque<Page> batch;
+        batch.swap(pages);
+        lock.unlock();
+
+        vector<ArchivePacket> packets;
+        packets.reserve(batch.size() * VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE);
+        for (const Page & page : batch) {
+            decodePage(page, pagesDecoded == 0 ? firstRecordInFirstPage : 0, packets);
+            pagesDecoded++;
+        }
+
+        DateTimeFields oldest, newest;
+        int countBefore, countAfter;
+        archiveManager.getArchiveRange(oldest, newest, countBefore);
+        archiveManager.addPacketsToArchive(packets);
+        archiveManager.getArchiveRange(oldest, newest, countAfter);
+
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Committed " << batch.size() << " archive pages containing " << packets.size() << " records" << endl;
+
+        lock.lock();
+        progress.pagesCommitted += batch.size();
+        progress.recordsCommitted += countAfter - countBefore;
+        publishProgress();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveDownload::decodePage(const Page & page, int firstRecordInPageToProcess, vector<ArchivePacket> & packets) {
+    int pageSequence = BitConverter::toUint8(page.data(), 0);
+
+    for (int i = firstRecordInPageToProcess; i < VantageWeatherStation::RECORDS_PER_ARCHIVE_PAGE; i++) {
+        //
+        // The record offset accounts for the page sequence byte and the previous records in the page
+        //
+        int recordOffset = 1 + (ArchivePacket::BYTES_PER_ARCHIVE_PACKET * i);
+        if (ArchivePacket::archivePacketContainsData(page.data(), recordOffset)) {
+            ArchivePacket packet(page.data(), recordOffset);
+
+            //
+            // The last page may contain records from the beginning of the circular archive buffer, which are older
+            // than the records of the previous pages
+            //
+            if (packet.getDateTimeFields() > newestRecordTime) {
+                newestRecordTime = packet.getDateTimeFields();
+                packets.push_back(packet);
+            }
+            else
+                VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Skipping archive record " << i << " in page " << pageSequence
+                                                                   << " with date " << packet.getPacketDateTimeString() << endl;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveDownload::publishProgress() {
+    archiveManager.setDownloadProgress(progress);
+}
+
+}
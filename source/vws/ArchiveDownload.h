@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_DOWNLOAD_H
+#define ARCHIVE_DOWNLOAD_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "WeatherTypes.h"
+#include "DateTimeFields.h"
+#include "ArchivePacket.h"
+#include "ArchiveManager.h"
+#include "ArchivePageProcessor.h"
+
+namespace vws {
+class VantageLogger;
+
+/**
+ * The decode and archive stage of a pipelined DMPAFT download. The console thread queues each page as soon as it is
+ * validated and immediately requests the next page, while the commit thread of this class decodes the queued pages and
+ * appends their records to the archive. All of the pages that are queued when the thread wakes up are appended as one batch,
+ * so a slow append results in fewer, larger batches rather than a stalled serial port. If the download is aborted the pages
+ * that were received are still added to the archive, so the next download only has to request the remaining records.
+ */
+class ArchiveDownload : public ArchivePageProcessor {
+public:
+    /**
+     * Constructor.
+     *
+     * @param archiveManager The archive manager to which the downloaded records are added
+     */
+    explicit ArchiveDownload(ArchiveManager & archiveManager);
+
+    /**
+     * Destructor.
+     */
+    virtual ~ArchiveDownload();
+
+    /**
+     * Start the commit thread.
+     *
+     * @param afterTime                       The time after which the archive records are being dumped
+     * @param firstRecordInFirstPageToProcess The first record in the first page that is part of the dump
+     * @param pageCount                       The number of pages the console will dump
+     */
+    virtual void beginDump(const DateTimeFields & afterTime, int firstRecordInFirstPageToProcess, int pageCount);
+
+    /**
+     * Queue a page for the commit thread.
+     *
+     * @param page The page to queue
+     */
+    virtual void processArchivePage(const byte * page);
+
+    /**
+     * Wait for the commit thread to add the records of the queued pages to the archive.
+     *
+     * @param success True if every page of the dump was received
+     */
+    virtual void endDump(bool success);
+
+    /**
+     * Get the number of pages whose records were added to the archive.
+     *
+     * @return The page count
+     */
+    int getPagesCommitted() const;
+
+    /**
+     * Get the number of records that were added to the archive.
+     *
+     * @return The record count
+     */
+    int getRecordsCommitted() const;
+
+    /**
+     * Get the time of the newest record that was downloaded.
+     *
+     * @return The time of the record, which is the time of the dump if no records were downloaded
+     */
+    const DateTimeFields & getNewestRecordTime() const;
+
+private:
+    using Page = std::vector<byte>;
+
+    /**
+     * The main loop of the commit thread.
+     */
+    void commitPages();
+
+    /**
+     * Decode the records of a page that are newer than the newest record that was downloaded.
+     *
+     * @param page                       The page to decode
+     * @param firstRecordInPageToProcess The first record in the page that is part of the dump
+     * @param packets                    The vector to which the decoded packets are added
+     */
+    void decodePage(const Page & page, int firstRecordInPageToProcess, std::vector<ArchivePacket> & packets);
+
+    /**
+     * Publish the progress of the download to the archive manager. The mutex must be locked by the caller.
+     */
+    void publishProgress();
+
+    ArchiveManager &                   archiveManager;
+    std::thread                        commitThread;
+    std::mutex                         mutex;               // Protects the queue and the progress counters
+    std::condition_variable            pageQueued;          // Signaled when a page is queued or the dump ends
+    std::deque<Page>                   pages;               // The pages that are waiting to be decoded
+    bool                               dumpEnded;           // Whether the console thread has queued the last page
+    int                                firstRecordInFirstPage;
+    DateTimeFields                     newestRecordTime;    // The time of the newest decoded record, only used by the commit thread while it runs
+    ArchiveManager::DownloadProgress   progress;
+    VantageLogger &                    logger;
+};
+}
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ArchiveFieldQuery.h"
+
+#include <sstream>
+#include <algorithm>
+
+#include "ArchiveColumn.h"
+#include "ArchiveManager.h"
+#include "ColumnarArchive.h"
+#include "DateTimeFields.h"
+
+using namespace std;
+
+namespace vws {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static void
+formatValue(ostream & os, const Measurement<double> & value) {
+    if (value.isValid())
+        os << value.getValue();
+    else
+        os << "null";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveFieldQuery::ArchiveFieldQuery(const ArchiveManager & am) : archiveManager(am),
+                                                                  downsampleInterval(0),
+                                                                  downsampleMethod(SeriesDownsampler::Method::LTTB),
+                                                                  maxPoints(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveFieldQuery::setFields(const string & fieldList) {
+    vector<const ArchiveColumn *> fieldColumns;
+    istringstream iss(fieldList);
+    string field;
+
+    while (getline(iss, field, ',')) {
+        field.erase(0, field.find_first_not_of(" "));
+        field.erase(field.find_last_not_of(" ") + 1);
+        if (field.empty())
+            continue;
+
+        const ArchiveColumn * column = ArchiveColumn::findColumn(field);
+        if (column == nullptr) {
+            unknownField = field;
+            return false;
+        }
+
+        if (find(fieldColumns.begin(), fieldColumns.end(), column) == fieldColumns.end())
+            fieldColumns.push_back(column);
+    }
+
+    if (fieldColumns.empty()) {
+        unknownField = fieldList;
+        return false;
+    }
+
+    columns = fieldColumns;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const string &
+ArchiveFieldQuery::getUnknownField() const {
+    return unknownField;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveFieldQuery::setDownsampleInterval(int minutes) {
+    downsampleInterval = max(minutes, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveFieldQuery::setPointLimit(SeriesDownsampler::Method method, int points) {
+    downsampleMethod = method;
+    maxPoints = max(points, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+string
+ArchiveFieldQuery::queryJSON(const DateTimeFields & startTime, const DateTimeFields & endTime) const {
+    //
+    // The archive is only appended to, so if a record was added between the column queries the columns
+    // are trimmed to the records that all of the columns have
+    //
+    vector<vector<ColumnSample>> series(columns.size());
+    size_t recordCount = 0;
+    for (size_t i = 0; i < columns.size(); i++) {
+        archiveManager.queryArchiveColumn(startTime, endTime, *columns[i], series[i]);
+        recordCount = i == 0 ? series[i].size() : min(recordCount, series[i].size());
+    }
+
+    ostringstream oss;
+    oss << "{ \"fields\" : [ ";
+    for (size_t i = 0; i < columns.size(); i++)
+        oss << (i == 0 ? "" : ", ") << "\"" << columns[i]->name << "\"";
+
+    oss << " ]";
+
+    if (downsampleInterval == 0) {
+        //
+        // The record times are the X coordinates, as outages leave gaps and the archive period can change
+        //
+        vector<size_t> selectedRecords;
+        if (maxPoints > 0) {
+            SeriesDownsampler downsampler(downsampleMethod, recordCount, maxPoints);
+            for (size_t r = 0; r < recordCount; r++)
+                downsampler.addPoint(r, static_cast<double>(series[0][r].time.getEpochDateTime()), series[0][r].value);
+
+            downsampler.finish();
+            selectedRecords = downsampler.getSelectedIndices();
+        }
+        else {
+            selectedRecords.resize(recordCount);
+            for (size_t r = 0; r < recordCount; r++)
+                selectedRecords[r] = r;
+        }
+
+        oss << ", \"time\" : [ ";
+        for (size_t r = 0; r < selectedRecords.size(); r++)
+            oss << (r == 0 ? "\"" : ", \"") << series[0][selectedRecords[r]].time.formatDateTime() << "\"";
+
+        oss << " ]";
+
+        for (size_t i = 0; i < columns.size(); i++) {
+            oss << ", \"" << columns[i]->name << "\" : [ ";
+            for (size_t r = 0; r < selectedRecords.size(); r++) {
+                if (r > 0)
+                    oss << ", ";
+
+                formatValue(oss, series[i][selectedRecords[r]].value);
+            }
+            oss << " ]";
+        }
+    }
+    else {
+        //
+        // The buckets are formed in a single pass over the records, which are in time order
+        //
+        DateTime bucketSeconds = static_cast<DateTime>(downsampleInterval) * 60;
+        DateTime queryStart = startTime.getEpochDateTime();
+        ostringstream times;
+        ostringstream counts;
+        vector<ostringstream> minimums(columns.size());
+        vector<ostringstream> maximums(columns.size());
+        vector<ostringstream> averages(columns.size());
+        vector<ColumnStatistics> statistics(columns.size());
+        DateTime currentBucket = -1;
+        int bucketCount = 0;
+
+        auto flushBucket = [&]() {
+            const char * separator = bucketCount == 0 ? "" : ", ";
+            times << separator << "\"" << DateTimeFields(queryStart + (currentBucket * bucketSeconds)).formatDateTime() << "\"";
+            counts << separator << statistics[0].recordCount;
+            for (size_t i = 0; i < columns.size(); i++) {
+                minimums[i] << separator;
+                formatValue(minimums[i], statistics[i].minimum);
+                maximums[i] << separator;
+                formatValue(maximums[i], statistics[i].maximum);
+                averages[i] << separator;
+                Measurement<double> average;
+                if (statistics[i].validCount > 0)
+                    average.setValue(statistics[i].sum / statistics[i].validCount);
+
+                formatValue(averages[i], average);
+                statistics[i] = ColumnStatistics();
+            }
+            bucketCount++;
+        };
+
+        for (size_t r = 0; r < recordCount; r++) {
+            DateTime bucket = (series[0][r].time.getEpochDateTime() - queryStart) / bucketSeconds;
+            if (bucket != currentBucket && currentBucket >= 0)
+                flushBucket();
+
+            currentBucket = bucket;
+            for (size_t i = 0; i < columns.size(); i++)
+                statistics[i].applyValue(series[i][r].value);
+        }
+
+        if (currentBucket >= 0)
+            flushBucket();
+
+        oss << ", \"interval\" : " << downsampleInterval
+            << ", \"time\" : [ " << times.str() << " ]"
+            << ", \"count\" : [ " << counts.str() << " ]";
+
+        for (size_t i = 0; i < columns.size(); i++) {
+            oss << ", \"" << columns[i]->name << "\" : { "
+                << "\"min\" : [ " << minimums[i].str() << " ], "
+                << "\"max\" : [ " << maximums[i].str() << " ], "
+                << "\"avg\" : [ " << averages[i].str() << " ] }";
+        }
+    }
+
+    oss << " }";
+
+    return oss.str();
+}
+
+}
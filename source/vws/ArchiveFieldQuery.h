@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_FIELD_QUERY_H
+#define ARCHIVE_FIELD_QUERY_H
+
+#include <string>
+#include <vector>
+
+#include "WeatherTypes.h"
+#include "SeriesDownsampler.h"
+
+namespace vws {
+class ArchiveManager;
+class ArchiveColumn;
+class DateTimeFields;
+
+/**
+ * An archive query that only returns the requested fields of the archive records. Only the requested fields are
+ * decoded and the response is an object with one array per field rather than an array of archive packets:
+ *
+ *     { "fields" : [ "avgOutsideTemperature" ], "time" : [ "2024-01-01 00:00", ... ], "avgOutsideTemperature" : [ 41.2, null, ... ] }
+ *
+ * If a downsample interval is specified, the records are grouped into buckets of that length starting at the start
+ * time of the query, the time of each bucket is the start of the bucket and each field has the minimum, maximum
+ * and average of the valid values in each bucket. Buckets without records are omitted:
+ *
+ *     { "fields" : [ ... ], "interval" : 60, "time" : [ ... ], "count" : [ 12, ... ],
+ *       "avgOutsideTemperature" : { "min" : [ ... ], "max" : [ ... ], "avg" : [ ... ] } }
+ *
+ * If a point limit is specified without a downsample interval, the records are selected by downsampling the first
+ * field and the response has the same format as a query without a downsample interval.
+ */
+class ArchiveFieldQuery {
+public:
+    /**
+     * Constructor.
+     *
+     * @param archiveManager The archive manager that is queried
+     */
+    explicit ArchiveFieldQuery(const ArchiveManager & archiveManager);
+
+    /**
+     * Set the fields to query.
+     *
+     * @param fieldList A comma separated list of archive packet JSON element names
+     * @return True if all of the fields can be queried. If false the fields are not changed.
+     */
+    bool setFields(const std::string & fieldList);
+
+    /**
+     * Get the first field of the last field list that could not be queried.
+     *
+     * @return The field name
+     */
+    const std::string & getUnknownField() const;
+
+    /**
+     * Set the length of the downsample buckets.
+     *
+     * @param minutes The length of each bucket in minutes or zero to return every record
+     */
+    void setDownsampleInterval(int minutes);
+
+    /**
+     * Limit the number of records returned by a query without a downsample interval.
+     *
+     * @param method    The method used to select the records using the values of the first field
+     * @param maxPoints The maximum number of records or zero to return every record
+     */
+    void setPointLimit(SeriesDownsampler::Method method, int maxPoints);
+
+    /**
+     * Query the archive and format the result.
+     *
+     * @param startTime The time that is used as the lower bound for the query
+     * @param endTime   The time that is used as the upper bound for the query
+     * @return The JSON object with the field arrays
+     */
+    std::string queryJSON(const DateTimeFields & startTime, const DateTimeFields & endTime) const;
+
+private:
+    const ArchiveManager &              archiveManager;     // The archive manager that is queried
+    std::vector<const ArchiveColumn *>  columns;            // The columns of the requested fields
+    std::string                         unknownField;       // The first field that could not be queried
+    int                                 downsampleInterval; // The length of the downsample buckets in minutes
+    SeriesDownsampler::Method           downsampleMethod;   // The method used to select the records when the number of records is limited
+    int                                 maxPoints;          // The maximum number of records to return or zero for no limit
+};
+
+}
+
+#endif
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ArchiveIndex.h"
+
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "MappedArchiveFile.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+static const byte INDEX_MAGIC[] = {'V', 'W', 'S', 'I'};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveIndex::ArchiveIndex(const string & file) : indexFile(file),
+                                                  indexedRecordCount(0),
+                                                  logger(VantageLogger::getLogger("ArchiveIndex")) {
+    load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveIndex::~ArchiveIndex() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveIndex::load() {
+    entries.clear();
+    indexedRecordCount = 0;
+
+    error_code ec;
+    std::uintmax_t fileSize = std::filesystem::file_size(indexFile, ec);
+    if (ec) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Archive index file '" << indexFile << "' does not exist" << endl;
+        return false;
+    }
+
+    if (fileSize < HEADER_SIZE || (fileSize - HEADER_SIZE) % ENTRY_SIZE != 0) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Archive index file '" << indexFile << "' has an invalid size of " << fileSize << endl;
+        return false;
+    }
+
+    ifstream stream(indexFile.c_str(), ios::in | ios::binary);
+    vector<byte> buffer(fileSize);
+    stream.read(buffer.data(), fileSize);
+    if (!stream) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to read archive index file '" << indexFile << "'" << endl;
+        return false;
+    }
+
+    if (!equal(begin(INDEX_MAGIC), end(INDEX_MAGIC), buffer.begin()) || BitConverter::toInt32(buffer.data(), VERSION_OFFSET) != INDEX_VERSION) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Archive index file '" << indexFile << "' has an invalid header" << endl;
+        return false;
+    }
+
+    int entryCount = (fileSize - HEADER_SIZE) / ENTRY_SIZE;
+    entries.reserve(entryCount);
+    for (int i = 0; i < entryCount; i++) {
+        int offset = HEADER_SIZE + (i * ENTRY_SIZE);
+        IndexEntry entry;
+        entry.dateStamp = BitConverter::toInt32(buffer.data(), offset);
+        entry.firstRecord = BitConverter::toInt32(buffer.data(), offset + 4);
+        entries.push_back(entry);
+    }
+
+    indexedRecordCount = BitConverter::toInt32(buffer.data(), RECORD_COUNT_OFFSET);
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Loaded archive index with " << entries.size() << " days covering " << indexedRecordCount << " records" << endl;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveIndex::synchronize(const MappedArchiveFile & archive) {
+    if (!isConsistent(archive)) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Archive index file '" << indexFile << "' is stale. Rebuilding the index." << endl;
+        rebuild(archive);
+    }
+    else if (indexedRecordCount < archive.getRecordCount()) {
+        int newEntries = indexNewRecords(archive);
+        appendToIndexFile(newEntries);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveIndex::rebuild(const MappedArchiveFile & archive) {
+    entries.clear();
+    indexedRecordCount = 0;
+    indexNewRecords(archive);
+    writeIndexFile();
+
+    logger.log(VantageLogger::VANTAGE_INFO) << "Rebuilt archive index with " << entries.size() << " days covering " << indexedRecordCount << " records" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveIndex::isConsistent(const MappedArchiveFile & archive) const {
+    if (indexedRecordCount > archive.getRecordCount())
+        return false;
+
+    if (entries.size() == 0)
+        return indexedRecordCount == 0;
+
+    //
+    // Spot check the first and last days and the last indexed record. This will catch an archive that was
+    // cleared, restored or rebuilt since the index was written.
+    //
+    const IndexEntry & first = entries.front();
+    const IndexEntry & last = entries.back();
+
+    if (first.firstRecord != 0 || last.firstRecord >= indexedRecordCount)
+        return false;
+
+    if ((MappedArchiveFile::recordTimeKey(archive.getRecord(0)) >> 16) != first.dateStamp)
+        return false;
+
+    if ((MappedArchiveFile::recordTimeKey(archive.getRecord(last.firstRecord)) >> 16) != last.dateStamp)
+        return false;
+
+    if (last.firstRecord > 0 && (MappedArchiveFile::recordTimeKey(archive.getRecord(last.firstRecord - 1)) >> 16) >= last.dateStamp)
+        return false;
+
+    if ((MappedArchiveFile::recordTimeKey(archive.getRecord(indexedRecordCount - 1)) >> 16) != last.dateStamp)
+        return false;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveIndex::clear() {
+    entries.clear();
+    indexedRecordCount = 0;
+    writeIndexFile();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveIndex::findSearchRange(const DateTimeFields & time, int recordCount, int & low, int & high) const {
+    if (entries.size() == 0) {
+        low = 0;
+        high = recordCount;
+        return;
+    }
+
+    int32 dateStamp = MappedArchiveFile::timeKey(time) >> 16;
+
+    //
+    // Any records that are not yet indexed can only belong to the last indexed day or a later day,
+    // so they are included in the search range when the search is at the end of the index.
+    //
+    int lowEntry = findFirstEntryOnOrAfter(dateStamp);
+    if (lowEntry == entries.size())
+        low = std::min(indexedRecordCount, recordCount);
+    else
+        low = std::min(entries[lowEntry].firstRecord, recordCount);
+
+    int highEntry = findFirstEntryOnOrAfter(dateStamp + 1);
+    if (highEntry == entries.size())
+        high = recordCount;
+    else
+        high = std::min(entries[highEntry].firstRecord, recordCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveIndex::getIndexedRecordCount() const {
+    return indexedRecordCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveIndex::getDayCount() const {
+    return entries.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveIndex::indexNewRecords(const MappedArchiveFile & archive) {
+    int addedEntries = 0;
+    int recordCount = archive.getRecordCount();
+
+    for (int i = indexedRecordCount; i < recordCount; i++) {
+        int32 dateStamp = MappedArchiveFile::recordTimeKey(archive.getRecord(i)) >> 16;
+        if (entries.size() == 0 || dateStamp > entries.back().dateStamp) {
+            IndexEntry entry;
+            entry.dateStamp = dateStamp;
+            entry.firstRecord = i;
+            entries.push_back(entry);
+            addedEntries++;
+        }
+        else if (dateStamp < entries.back().dateStamp)
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Archive record " << i << " is out of order. It will not be indexed." << endl;
+    }
+
+    indexedRecordCount = recordCount;
+
+    return addedEntries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveIndex::writeIndexFile() const {
+    vector<byte> buffer(HEADER_SIZE + (entries.size() * ENTRY_SIZE), 0);
+
+    copy(begin(INDEX_MAGIC), end(INDEX_MAGIC), buffer.begin());
+    BitConverter::getBytes(INDEX_VERSION, buffer.data(), VERSION_OFFSET, 4);
+    BitConverter::getBytes(indexedRecordCount, buffer.data(), RECORD_COUNT_OFFSET, 4);
+
+    for (int i = 0; i < entries.size(); i++) {
+        int offset = HEADER_SIZE + (i * ENTRY_SIZE);
+        BitConverter::getBytes(entries[i].dateStamp, buffer.data(), offset, 4);
+        BitConverter::getBytes(entries[i].firstRecord, buffer.data(), offset + 4, 4);
+    }
+
+    ofstream stream(indexFile.c_str(), ios::out | ios::trunc | ios::binary);
+    stream.write(buffer.data(), buffer.size());
+
+    if (!stream)
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to write archive index file '" << indexFile << "'" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveIndex::appendToIndexFile(int newEntryCount) const {
+    int fileEntryCount = entries.size() - newEntryCount;
+
+    fstream stream(indexFile.c_str(), ios::in | ios::out | ios::binary);
+    if (stream.fail()) {
+        writeIndexFile();
+        return;
+    }
+
+    //
+    // If the file does not contain exactly the entries that preceded the new ones, rewrite the entire file
+    //
+    stream.seekp(0, ios::end);
+    if (stream.tellp() != static_cast<streampos>(HEADER_SIZE + (fileEntryCount * ENTRY_SIZE))) {
+        stream.close();
+        writeIndexFile();
+        return;
+    }
+
+    byte buffer[ENTRY_SIZE];
+    for (int i = fileEntryCount; i < entries.size(); i++) {
+        BitConverter::getBytes(entries[i].dateStamp, buffer, 0, 4);
+        BitConverter::getBytes(entries[i].firstRecord, buffer, 4, 4);
+        stream.write(buffer, sizeof(buffer));
+    }
+
+    //
+    // Update the record count in the header last so that an interrupted append is detected as a stale index
+    //
+    BitConverter::getBytes(indexedRecordCount, buffer, 0, 4);
+    stream.seekp(RECORD_COUNT_OFFSET, ios::beg);
+    stream.write(buffer, 4);
+
+    if (!stream)
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to append to archive index file '" << indexFile << "'" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveIndex::findFirstEntryOnOrAfter(int32 dateStamp) const {
+    auto it = lower_bound(entries.begin(), entries.end(), dateStamp, [](const IndexEntry & entry, int32 value) { return entry.dateStamp < value; });
+    return it - entries.begin();
+}
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_INDEX_H
+#define ARCHIVE_INDEX_H
+
+#include <string>
+#include <vector>
+
+#include "WeatherTypes.h"
+
+namespace vws {
+class VantageLogger;
+class MappedArchiveFile;
+class DateTimeFields;
+
+static const std::string ARCHIVE_INDEX_FILE_SUFFIX = ".idx";
+
+/**
+ * A sparse index of the archive file that is kept in a file next to the archive. The index contains one entry for each day
+ * in the archive that holds the date stamp of the day and the index of the first record of that day. Gaps in the archive,
+ * caused by console outages or archive period changes, do not affect the index, so a search of the archive can be narrowed
+ * down to a single day of records with a binary search over the days.
+ *
+ * The index file is a 16 byte header followed by 8 byte entries, all stored as little endian integers:
+ *     Header: "VWSI", version, number of archive records indexed, reserved
+ *     Entry:  date stamp (same encoding as the archive packet), index of the first record with this date stamp
+ */
+class ArchiveIndex {
+public:
+    /**
+     * Constructor that loads the index file if it exists.
+     *
+     * @param indexFile The path of the index file
+     */
+    explicit ArchiveIndex(const std::string & indexFile);
+
+    /**
+     * Destructor.
+     */
+    ~ArchiveIndex();
+
+    /**
+     * Bring the index up to date with the archive. If the index is consistent with the archive only the records that
+     * were added since the last synchronization are indexed and appended to the index file, otherwise the index is rebuilt.
+     *
+     * @param archive The archive that is being indexed
+     */
+    void synchronize(const MappedArchiveFile & archive);
+
+    /**
+     * Rebuild the index from the archive and rewrite the index file.
+     *
+     * @param archive The archive that is being indexed
+     */
+    void rebuild(const MappedArchiveFile & archive);
+
+    /**
+     * Check if the index is consistent with the archive. An index that is missing entries for records
+     * at the end of the archive is still consistent.
+     *
+     * @param archive The archive that is being indexed
+     * @return True if the index entries match the archive
+     */
+    bool isConsistent(const MappedArchiveFile & archive) const;
+
+    /**
+     * Remove all the entries from the index and the index file.
+     */
+    void clear();
+
+    /**
+     * Find the range of records that must be searched to find the first record on or after the specified time,
+     * or the first record after the specified time.
+     *
+     * @param time        The time being searched for
+     * @param recordCount The number of records in the archive being searched
+     * @param low         The index of the first record to search
+     * @param high        The index one past the last record to search
+     */
+    void findSearchRange(const DateTimeFields & time, int recordCount, int & low, int & high) const;
+
+    /**
+     * Get the number of archive records that are covered by the index.
+     *
+     * @return The number of records
+     */
+    int getIndexedRecordCount() const;
+
+    /**
+     * Get the number of days in the index.
+     *
+     * @return The number of entries in the index
+     */
+    int getDayCount() const;
+
+private:
+    static constexpr int HEADER_SIZE = 16;
+    static constexpr int ENTRY_SIZE = 8;
+    static constexpr int INDEX_VERSION = 1;
+    static constexpr int VERSION_OFFSET = 4;
+    static constexpr int RECORD_COUNT_OFFSET = 8;
+
+    struct IndexEntry {
+        int32 dateStamp;     // The date stamp of the day
+        int32 firstRecord;   // The index of the first archive record of the day
+    };
+
+    /**
+     * Load the index file.
+     *
+     * @return True if the index file was loaded
+     */
+    bool load();
+
+    /**
+     * Add entries for the records in the archive that are not yet indexed.
+     *
+     * @param archive The archive that is being indexed
+     * @return The number of entries that were added
+     */
+    int indexNewRecords(const MappedArchiveFile & archive);
+
+    /**
+     * Write the entire index file.
+     */
+    void writeIndexFile() const;
+
+    /**
+     * Append the last entries in the index to the index file and update the record count in the header.
+     *
+     * @param newEntryCount The number of entries at the end of the index that are not in the index file
+     */
+    void appendToIndexFile(int newEntryCount) const;
+
+    /**
+     * Find the first entry in the index whose date stamp is on or after the specified date stamp.
+     *
+     * @param dateStamp The date stamp to search for
+     * @return The index of the entry or the number of entries if all indexed days are before the date stamp
+     */
+    int findFirstEntryOnOrAfter(int32 dateStamp) const;
+
+    std::string             indexFile;           // The path of the index file
+    std::vector<IndexEntry> entries;             // One entry per day in the archive
+    int                     indexedRecordCount;  // The number of archive records covered by the index
+    VantageLogger &         logger;
+};
+}
+
+#endif
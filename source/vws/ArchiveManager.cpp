@@ -18,6 +18,9 @@
 #include "ArchiveManager.h"
 
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <dirent.h>
 #include <time.h>
 #include <string.h>
@@ -30,7 +33,11 @@
 #include <chrono>
 #include <ratio>
 
+#include "ArchiveColumn.h"
 #include "ArchivePacket.h"
+#include "ArchiveVerification.h"
+#include "BitConverter.h"
+#include "MappedArchiveFile.h"
 #include "VantageProtocolConstants.h"
 #include "VantageLogger.h"
 #include "Weather.h"
@@ -53,215 +60,205 @@ ArchiveManager::ArchiveManager(const string & dataDirectory, const string & arch
                                                                                            packetSaveDirectory(dataDirectory + PACKET_SAVE_DIR),
                                                                                            archiveBackupDir(dataDirectory + ARCHIVE_BACKUP_DIR),
                                                                                            archiveVerifyLog(dataDirectory + ARCHIVE_VERIFY_LOG),
+                                                                                           archiveVerifyReport(dataDirectory + ARCHIVE_VERIFY_REPORT),
                                                                                            nextBackupTime(0),
                                                                                            archivePacketCount(0),
+                                                                                           archiveIndex(this->archiveFile + ARCHIVE_INDEX_FILE_SUFFIX),
+                                                                                           daySummaryStore(this->archiveFile + DAY_SUMMARY_FILE_SUFFIX),
+                                                                                           columnarArchive(this->archiveFile + COLUMNAR_ARCHIVE_FILE_SUFFIX),
+                                                                                           columnarArchiveEnabled(false),
+                                                                                           durabilityPolicy(DurabilityPolicy::SYNC_PER_BATCH),
+                                                                                           syncInterval(DEFAULT_SYNC_INTERVAL),
+                                                                                           lastSyncTime(0),
+                                                                                           packetSegmentStore(this->packetSaveDirectory),
+                                                                                           verificationActive(false),
+                                                                                           downloadProgress{},
                                                                                            logger(VantageLogger::getLogger("ArchiveManager")) {
+    recoverArchiveTail();
     findArchivePacketTimeRange();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ArchiveManager::~ArchiveManager() {
+    if (verificationThread.joinable())
+        verificationThread.join();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 DateTimeFields
 ArchiveManager::queryArchiveRecords(const DateTimeFields & startTime, const DateTimeFields & endTime, vector<ArchivePacket> & list) const {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Querying archive records between "
-                                              << startTime.formatDateTime()
-                                              << " and " << endTime.formatDateTime() << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Querying archive records between "
+                                                       << startTime.formatDateTime()
+                                                       << " and " << endTime.formatDateTime() << endl;
     list.clear();
     DateTimeFields timeOfLastRecord;
-    byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
-    std::lock_guard<std::mutex> guard(mutex);
-    ifstream stream(archiveFile.c_str(), ios::in | ios::binary);
-    if (stream.fail()) {
-        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open archive file \"" << archiveFile << "\"" << endl;
-        return timeOfLastRecord;
-    }
 
-    positionStream(stream, startTime.getEpochDateTime(), false);
+    std::span<const byte> records;
+    std::shared_ptr<const MappedArchiveFile> mapping = queryArchiveRecordSpan(startTime, endTime, records);
 
-    DateTimeFields packetTime;
-    do {
-        stream.read(buffer, sizeof(buffer));
-
-        if (!stream.eof()) {
-            ArchivePacket packet(buffer);
-            packetTime = packet.getDateTimeFields();
-            if (packetTime <= endTime) {
-                list.push_back(packet);
-                timeOfLastRecord = packetTime;
-            }
-        }
-    } while (!stream.eof() && packetTime < endTime);
-
-    stream.close();
+    int recordCount = records.size() / ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+    list.reserve(recordCount);
+    for (int i = 0; i < recordCount; i++)
+        list.emplace_back(records.data(), i * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
 
-    if (list.size() > 0)
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Query found " << list.size()
-                                                  << " items. Time of last record is "
-                                                  << timeOfLastRecord.formatDateTime() << endl;
+    if (list.size() > 0) {
+        timeOfLastRecord = list.back().getDateTimeFields();
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Query found " << list.size()
+                                                           << " items. Time of last record is "
+                                                           << timeOfLastRecord.formatDateTime() << endl;
+    }
     else
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Query found 0 items" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Query found 0 items" << endl;
 
     return timeOfLastRecord;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-int
-ArchiveManager::queryArchiveRecordsForDay(const DateTimeFields & date, std::vector<ArchivePacket> & list) const {
-    DateTimeFields startTime = date;
-    DateTimeFields endTime = date;
+std::shared_ptr<const MappedArchiveFile>
+ArchiveManager::queryArchiveRecordSpan(const DateTimeFields & startTime, const DateTimeFields & endTime, std::span<const byte> & records) const {
+    chrono::high_resolution_clock::time_point t1 = chrono::high_resolution_clock::now();
 
-    startTime.setHour(0);
-    startTime.setMinute(0);
-    startTime.setSecond(0);
+    //
+    // Only hold the mutex long enough to get the current mapping and to use the index to narrow the search
+    // to the days of the start and end times. The mapping is never modified, so the search within the days
+    // can be performed while the archive is being appended to.
+    //
+    std::shared_ptr<const MappedArchiveFile> mapping;
+    int startLow, startHigh, endLow, endHigh;
+    {
+        std::shared_lock<std::shared_mutex> guard(mutex);
+        mapping = archiveMapping;
+        archiveIndex.findSearchRange(startTime, mapping->getRecordCount(), startLow, startHigh);
+        archiveIndex.findSearchRange(endTime, mapping->getRecordCount(), endLow, endHigh);
+    }
 
-    endTime.setHour(23);
-    endTime.setMinute(59);
-    endTime.setSecond(59);
+    int first = mapping->findFirstRecordOnOrAfter(startTime, startLow, startHigh);
+    int last = mapping->findFirstRecordAfter(endTime, endLow, endHigh);
+    records = mapping->getRecordSpan(first, last);
 
-    queryArchiveRecords(startTime, endTime, list);
+    chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
+    chrono::duration<double> timeSpan = duration_cast<chrono::duration<double>>(t2 - t1);
 
-    return list.size();
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Searching for archive records in range " << startTime.formatDateTime()
+                                                       << " to " << endTime.formatDateTime()
+                                                       << " in archive with " << mapping->getRecordCount() << " records"
+                                                       << " took " << timeSpan.count() << " seconds" << endl;
+
+    return mapping;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-void
-ArchiveManager::positionStream(istream & stream, DateTime searchTime, bool afterTime) const {
-    if (archivePacketCount < 2)
-        return;
+DateTimeFields
+ArchiveManager::queryDaySummaries(const DateTimeFields & startTime, const DateTimeFields & endTime, vector<DaySummary> & summaries) const {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+
+    DateTimeFields firstUnsummarizedTime;
 
     //
-    // Use high resolution clock to track performance of positioning the stream
+    // If the day summaries cannot be read, the caller must read all of the archive records
     //
-    chrono::high_resolution_clock::time_point t1 = chrono::high_resolution_clock::now();
-    byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
-    streampos streamPosition;
-    int forwardReadsPerformed = 0;
-    int backwardReadsPerformed = 0;
+    if (!daySummaryStore.readDaySummaries(startTime, endTime, summaries)) {
+        if (archiveMapping->getRecordCount() > 0)
+            firstUnsummarizedTime = ArchivePacket(archiveMapping->getRecord(0)).getDateTimeFields();
 
-    stream.seekg(-ArchivePacket::BYTES_PER_ARCHIVE_PACKET, ios::end);
-    long fileSize = stream.tellg();
+        return firstUnsummarizedTime;
+    }
 
-    //
-    // If we are only looking for records after the specified time, then increment the
-    // search time so we can use <= in the time comparisons.
-    //
-    if (afterTime)
-        searchTime++;
+    int summarizedRecords = daySummaryStore.getSummarizedRecordCount();
+    if (summarizedRecords < archiveMapping->getRecordCount())
+        firstUnsummarizedTime = ArchivePacket(archiveMapping->getRecord(summarizedRecords)).getDateTimeFields();
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Found " << summaries.size() << " day summaries. First unsummarized record time is "
+                                                       << firstUnsummarizedTime.formatDateTime() << endl;
+
+    return firstUnsummarizedTime;
+}
 
-    DateTime oldestPacketTime = oldestPacket.getEpochDateTime();
-    DateTime newestPacketTime = newestPacket.getEpochDateTime();
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveManager::queryArchiveColumn(const DateTimeFields & startTime, const DateTimeFields & endTime, const ArchiveColumn & column, vector<ColumnSample> & samples) const {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+    samples.clear();
 
     //
-    // If the search time is newer than the oldest packet in the archive, look for the packet that is after the specified time.
-    // If the search time is before the beginning of the file, start at the beginning.
-    // If the search time is after the end of the file, go to the end so zero records will be read.
+    // The complete months come from the columnar archive, the rest of the records are read from the archive
     //
-    if (searchTime <= oldestPacketTime) {
-        stream.seekg(0, ios::beg);
-    }
-    else if (searchTime > newestPacketTime) {
-        stream.seekg(0, ios::end);
+    int firstRawRecord = 0;
+    if (columnarArchiveEnabled) {
+        if (columnarArchive.readColumn(startTime, endTime, column.columnId, samples))
+            firstRawRecord = columnarArchive.getSummarizedRecordCount();
+        else
+            samples.clear();
     }
-    else if (searchTime > oldestPacketTime && searchTime < newestPacketTime) {
-        //
-        // Use the ratio of time based on the time range of the archive. This will hopefully position the stream
-        // very close to the search time.
-        //
-        DateTime archiveRange = newestPacketTime - oldestPacketTime;
-        DateTime searchDelta = searchTime - oldestPacketTime;
-        double searchRatio = static_cast<double>(searchDelta) / static_cast<double>(archiveRange);
 
-        long searchLocation = static_cast<long>(::round(static_cast<double>(fileSize) * searchRatio));
-        searchLocation -= searchLocation % ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
-        stream.seekg(searchLocation, ios::beg);
+    int first, last;
+    findRecordRange(startTime, endTime, first, last);
+    first = max(first, firstRawRecord);
 
+    for (int i = first; i < last; i++) {
+        const byte * record = archiveMapping->getRecord(i);
+        samples.push_back(ColumnSample{ArchivePacket(record).getDateTimeFields(), column.decodeValue(record)});
+    }
 
-        //
-        // Skip forward past the search time. This will only skip forward one record if the ratio calculation
-        // positioned the stream later than the search time.
-        //
-        DateTime packetTime;
-        do {
-            stream.read(buffer, sizeof(buffer));
-            forwardReadsPerformed++;
-            ArchivePacket packet(buffer);
-            packetTime = packet.getEpochDateTime();
-        } while (packetTime < searchTime && !stream.eof());
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Found " << samples.size() << " values of column " << column.name << " of which "
+                                                       << (last > first ? last - first : 0) << " were read from the archive records" << endl;
+}
 
-        //
-        // Now back up in the archive until we find the packet just after the packet for which we are looking.
-        // Since the algorithm backs up two packets after each read, that will put the stream right on the
-        // packet being searched.
-        // 
-        do {
-            streamPosition = stream.tellg();
-            stream.read(buffer, sizeof(buffer));
-            backwardReadsPerformed++;
-            ArchivePacket packet(buffer);
-            packetTime = packet.getEpochDateTime();
-            stream.seekg(-(ArchivePacket::BYTES_PER_ARCHIVE_PACKET * 2), ios::cur);
-        } while (searchTime <= packetTime && streamPosition > 0);
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveManager::enableColumnarArchive() {
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    logger.log(VantageLogger::VANTAGE_INFO) << "Enabling the columnar archive" << endl;
+    columnarArchiveEnabled = true;
+    columnarArchive.synchronize(*archiveMapping);
+}
 
-        //
-        // The stream will not be good if the final seekg() call went past the beginning of the file.
-        // Clear the error and position the next to be the beginning of the file.
-        //
-        if (!stream.good()) {
-            stream.clear();
-            stream.seekg(0, ios::beg);
-        }
-        else
-            stream.seekg(ArchivePacket::BYTES_PER_ARCHIVE_PACKET * 2, ios::cur);
-    }
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveManager::queryArchiveRecordsForDay(const DateTimeFields & date, std::vector<ArchivePacket> & list) const {
+    DateTimeFields startTime = date;
+    DateTimeFields endTime = date;
 
-    chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
-    chrono::duration<double> timeSpan = duration_cast<chrono::duration<double>>(t2 - t1);
+    startTime.setHour(0);
+    startTime.setMinute(0);
+    startTime.setSecond(0);
 
-    logger.log(VantageLogger::VANTAGE_DEBUG2) <<  "Positioning stream to find archive record of time "
-                                              << Weather::formatDateTime(searchTime)
-                                              << " in archive with range of " << oldestPacket.getPacketDateTimeString()
-                                              << " to " << newestPacket.getPacketDateTimeString()
-                                              << " took " << timeSpan.count() << " seconds"
-                                              << " and required " << forwardReadsPerformed << " forward reads and "
-                                              << backwardReadsPerformed << " backward reads" << endl;
+    endTime.setHour(23);
+    endTime.setMinute(59);
+    endTime.setSecond(59);
 
-    return;
+    queryArchiveRecords(startTime, endTime, list);
+
+    return list.size();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
 ArchiveManager::getNewestRecord(ArchivePacket & packet) const {
-    std::lock_guard<std::mutex> guard(mutex);
-    ifstream stream(archiveFile.c_str(), ios::in | ios::binary | ios::ate);
-    if (stream.fail()) {
-        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open archive file \"" << archiveFile << "\"" << endl;
-        return false;
-    }
-
-    streampos fileSize = stream.tellg();
+    std::shared_lock<std::shared_mutex> guard(mutex);
+    int recordCount = archiveMapping->getRecordCount();
 
-    if (fileSize >= ArchivePacket::BYTES_PER_ARCHIVE_PACKET) {
-        byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
-        stream.seekg(-ArchivePacket::BYTES_PER_ARCHIVE_PACKET, ios::end);
-        stream.read(buffer, sizeof(buffer));
-        packet.updateArchivePacketData(buffer);
+    if (recordCount > 0) {
+        packet.updateArchivePacketData(archiveMapping->getRecord(recordCount - 1));
         return true;
     }
     else
         return false;
 }
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 ArchiveManager::getArchiveRange(DateTimeFields & oldest, DateTimeFields & newest, int & count) const {
+    std::shared_lock<std::shared_mutex> guard(mutex);
     oldest = oldestPacket.getDateTimeFields();
     newest = newestPacket.getDateTimeFields();
     count = archivePacketCount;
@@ -271,13 +268,29 @@ ArchiveManager::getArchiveRange(DateTimeFields & oldest, DateTimeFields & newest
 ////////////////////////////////////////////////////////////////////////////////
 bool
 ArchiveManager::clearArchiveFile() {
-    std::lock_guard<std::mutex> guard(mutex);
+    std::lock_guard<std::shared_mutex> guard(mutex);
+
+    //
+    // Remove the file rather than truncating it. Truncating a file that is mapped by a query
+    // that is in progress would cause that query to fault when it reads the mapped records.
+    //
+    if (unlink(archiveFile.c_str()) != 0 && errno != ENOENT) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to remove archive file \"" << archiveFile << "\". Error: " << logger.strerror() << endl;
+        return false;
+    }
+
     ofstream stream(archiveFile.c_str(), ios::out | ios::trunc);
 
     if (stream.good()) {
+        stream.close();
         oldestPacket.clearArchivePacketData();
         newestPacket.clearArchivePacketData();
-        archivePacketCount = 0;
+        archiveIndex.clear();
+        daySummaryStore.clear();
+        if (columnarArchiveEnabled)
+            columnarArchive.clear();
+
+        mapArchiveFile();
         return true;
     }
     else
@@ -404,6 +417,8 @@ ArchiveManager::restoreArchiveFile(const string & backupFile) {
         return false;
     }
 
+    findArchivePacketTimeRange();
+
     return true;
 }
 
@@ -439,219 +454,354 @@ ArchiveManager::getBackupFileList(vector<string> & fileList) const {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
-ArchiveManager::verifyCurrentArchiveFile() const {
-    logger.log(VantageLogger::VANTAGE_INFO) << "Verifying current archive file " << archiveFile << endl;
-    std::lock_guard<std::mutex> guard(mutex);
-    return verifyArchiveFile(archiveFile, true);
+ArchiveManager::startCurrentArchiveVerification() {
+    if (verificationActive) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Not starting archive verification. The previous verification is still running." << endl;
+        return false;
+    }
+
+    if (verificationThread.joinable())
+        verificationThread.join();
+
+    verificationActive = true;
+    verificationThread = thread([this]() {
+        verifyCurrentArchiveFile();
+        verificationActive = false;
+    });
+
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
-ArchiveManager::verifyArchiveFile(const string & archiveFilePath, bool logResults) const {
+ArchiveManager::verifyCurrentArchiveFile() const {
+    logger.log(VantageLogger::VANTAGE_INFO) << "Verifying current archive file " << archiveFile << endl;
 
-    ofstream * vlog = NULL;
+    //
+    // The mapping is never modified, so it is verified without holding the mutex. Records that are appended
+    // during the verification will be verified the next time.
+    //
+    std::shared_ptr<const MappedArchiveFile> mapping;
+    {
+        std::shared_lock<std::shared_mutex> guard(mutex);
+        mapping = archiveMapping;
+    }
 
-    if (logResults)
-        vlog = new ofstream(archiveVerifyLog, ios::app);
+    bool valid = verifyArchiveMapping(archiveFile, *mapping, true);
 
-    if (logResults) {
-        *vlog << "--------------------------------------------------------------------------------" << endl;
-        *vlog << "Verifying archive file: " << archiveFilePath << " at " << Weather::formatDateTime(time(0)) << endl;
+    //
+    // Checking the index, day summaries and columnar archive only requires the shared lock. The exclusive lock
+    // is only taken in the rare case that one of them must be rebuilt.
+    //
+    bool consistent;
+    {
+        std::shared_lock<std::shared_mutex> guard(mutex);
+        consistent = archiveIndex.isConsistent(*archiveMapping) &&
+                     daySummaryStore.isConsistent(*archiveMapping) &&
+                     (!columnarArchiveEnabled || columnarArchive.verify(*archiveMapping));
     }
 
-    logger.log(VantageLogger::VANTAGE_INFO) << "Verifying archive file " << archiveFilePath << endl;
-    ifstream is(archiveFilePath, ios::in | ios::binary);
+    if (!consistent) {
+        std::lock_guard<std::shared_mutex> guard(mutex);
+        if (!archiveIndex.isConsistent(*archiveMapping))
+            archiveIndex.rebuild(*archiveMapping);
 
-    if (is.fail()) {
+        if (!daySummaryStore.isConsistent(*archiveMapping))
+            daySummaryStore.rebuild(*archiveMapping);
+
+        if (columnarArchiveEnabled && !columnarArchive.verify(*archiveMapping))
+            columnarArchive.rebuild(*archiveMapping);
+    }
+
+    return valid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveManager::verifyArchiveFile(const string & archiveFilePath, bool logResults) const {
+    if (!filesystem::exists(archiveFilePath)) {
         logger.log(VantageLogger::VANTAGE_INFO) << "Failed to open archive file '" << archiveFilePath << " for verification" << endl;
-        if (logResults)
-            *vlog << "Aborting verification. Archive file could not be opened" << endl;
+        if (logResults) {
+            ofstream vlog(archiveVerifyLog, ios::app);
+            vlog << "Aborting verification of archive file " << archiveFilePath << ". Archive file could not be opened" << endl;
+        }
         return false;
     }
 
-    int packetsRead = 0;
-    int errorCount = 0;
-    int warningCount = 0;
-    bool hasFirstPacket = false;
-    ArchivePacket firstPacket;
-    ArchivePacket lastPacket;
-    DateTime lastPacketTime = 0;
-    DateTime lastDelta = 0;
-    int deltaTimeMismatchCount = 0;
-    char buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
-    do {
-        is.read(buffer, sizeof(buffer));
-        if (!is.eof()) {
-            packetsRead++;
-            ios::pos_type position = is.tellg();
-
-            ArchivePacket packet(buffer);
-            if (!hasFirstPacket) {
-                hasFirstPacket = true;
-                firstPacket.updateArchivePacketData(buffer, 0);
-            }
-
-            DateTime currentPacketTime = packet.getEpochDateTime();
+    MappedArchiveFile mapping(archiveFilePath);
+    return verifyArchiveMapping(archiveFilePath, mapping, logResults);
+}
 
-            if (currentPacketTime <= lastPacketTime) {
-                if (logResults)
-                    *vlog << "Detected out of order packets at file location " << position << ". " << endl
-                          << "Packet with time " << Weather::formatDateTime(currentPacketTime) << " (" << packet.getPacketDateTimeString() << ")"
-                          << " is before packet with time: " << Weather::formatDateTime(lastPacketTime) << " (" << lastPacket.getPacketDateTimeString() << ")" << endl;
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveManager::verifyArchiveMapping(const string & archiveFilePath, const MappedArchiveFile & mapping, bool logResults) const {
+    logger.log(VantageLogger::VANTAGE_INFO) << "Verifying archive file " << archiveFilePath << endl;
 
-                logger.log(VantageLogger::VANTAGE_WARNING) << "Detected out of order packets at file location " << position << ". " << endl
-                                                           << "Packet with time " << Weather::formatDateTime(currentPacketTime) << " (" << packet.getPacketDateTimeString() << ")"
-                                                           << " is before packet with time: " << Weather::formatDateTime(lastPacketTime) << " (" << lastPacket.getPacketDateTimeString() << ")" << endl;
-                errorCount++;
-            }
+    ArchiveVerification verification(mapping);
+    bool valid = verification.verify();
 
-            DateTime currentDelta = currentPacketTime - lastPacketTime;
-            if (packetsRead > 2 && currentDelta != lastDelta) {
-                if (logResults)
-                    *vlog << "Detected inconsistent time delta between packet at file location " << position << ". " << endl
-                          << "Expected time delta is " << lastDelta << ", actual delta is " << currentDelta
-                          << " for packet with times " << "[" << lastPacketTime << "] " << Weather::formatDateTime(lastPacketTime) << " (" << lastPacket.getPacketDateTimeString() << ")" << " and "
-                          << "[" << currentPacketTime << "] " << Weather::formatDateTime(currentPacketTime) << " (" << packet.getPacketDateTimeString() << ")" << endl;
-
-                logger.log(VantageLogger::VANTAGE_INFO) << "Detected inconsistent time delta between packet at file location " << position << ". " << endl
-                                                        << "Expected time delta is " << lastDelta << ", actual delta is " << currentDelta
-                                                        << " for packet with times " << "[" << lastPacketTime << "] " << Weather::formatDateTime(lastPacketTime) << " (" << lastPacket.getPacketDateTimeString() << ")" << " and "
-                                                        << "[" << currentPacketTime << "] " << Weather::formatDateTime(currentPacketTime) << " (" << packet.getPacketDateTimeString() << ")" << endl;
-                warningCount++;
-
-                //
-                // Only change the expected delta if more than three mismatches happen in a row
-                //
-                if (++deltaTimeMismatchCount > 2)
-                    lastDelta = currentDelta;
-            }
-            else
-                deltaTimeMismatchCount = 0;
+    logger.log(VantageLogger::VANTAGE_INFO) << "Archive verification complete for archive with " << verification.getRecordCount() << " packets in time range "
+                                            << verification.getFirstRecordTime().formatDateTime() << " to " << verification.getLastRecordTime().formatDateTime() << "." << endl;
+    logger.log(VantageLogger::VANTAGE_INFO) << "Found " << verification.getErrorCount() << " errors and " << verification.getWarningCount() << " warnings" << endl;
 
-            //
-            // Set the delta for checking future packets based on the first two packets in the archive
-            //
-            if (packetsRead == 2)
-                lastDelta = currentDelta;
+    if (!logResults)
+        return valid;
 
-            lastPacketTime = currentPacketTime;
-            lastPacket.updateArchivePacketData(buffer, 0);
-        }
+    ofstream vlog(archiveVerifyLog, ios::app);
+    vlog << "--------------------------------------------------------------------------------" << endl;
+    vlog << "Verifying archive file: " << archiveFilePath << " at " << Weather::formatDateTime(time(0)) << endl;
+    for (const ArchiveVerification::Anomaly & anomaly : verification.getAnomalies()) {
+        vlog << "Detected " << ArchiveVerification::anomalyTypeName(anomaly.type) << " record " << anomaly.recordIndex
+             << " at file location " << (static_cast<long>(anomaly.recordIndex) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET)
+             << ". Record time: " << anomaly.time.formatDateTime() << " Previous record time: " << anomaly.previousTime.formatDateTime();
 
-    } while (!is.eof());
+        if (anomaly.type == ArchiveVerification::AnomalyType::GAP || anomaly.type == ArchiveVerification::AnomalyType::DELTA_CHANGE)
+            vlog << " Time delta: " << anomaly.delta << " Expected time delta: " << verification.getArchivePeriod() << " Records: " << anomaly.runLength;
 
-    logger.log(VantageLogger::VANTAGE_INFO) << "Archive verification complete for archive with " << packetsRead << " packets in time range " << firstPacket.getPacketDateTimeString() << " to " << lastPacket.getPacketDateTimeString() << "." << endl;
-    logger.log(VantageLogger::VANTAGE_INFO) << "Found " << errorCount << " errors and " << warningCount << " warnings" << endl;
-    if (logResults) {
-        *vlog << "Archive verification complete for archive with " << packetsRead << " packets in time range " << firstPacket.getPacketDateTimeString() << " to " << lastPacket.getPacketDateTimeString() << "." << endl;
-        *vlog << "Found " << errorCount << " errors and " << warningCount << " warnings" << endl;
-        *vlog << "--------------------------------------------------------------------------------" << endl;
+        vlog << endl;
     }
 
-    return errorCount == 0 && warningCount == 0;
+    vlog << "Archive verification complete for archive with " << verification.getRecordCount() << " packets in time range "
+         << verification.getFirstRecordTime().formatDateTime() << " to " << verification.getLastRecordTime().formatDateTime() << "." << endl;
+    vlog << "Found " << verification.getErrorCount() << " errors and " << verification.getWarningCount() << " warnings" << endl;
+    vlog << "--------------------------------------------------------------------------------" << endl;
+
+    ofstream report(archiveVerifyReport, ios::out | ios::trunc);
+    report << verification.formatJSON(archiveFilePath) << endl;
+    if (report.fail())
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to write archive verification report '" << archiveVerifyReport << "'" << endl;
+
+    return valid;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 ArchiveManager::addPacketsToArchive(const vector<ArchivePacket> & packets) {
-    std::lock_guard<std::mutex> guard(mutex);
+    std::lock_guard<std::shared_mutex> guard(mutex);
     if (packets.size() == 0)
         return;
 
-    ofstream stream;
-    stream.open(archiveFile.c_str(), ios::out | ios::app | ios::binary);
-    if (stream.fail()) {
-        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open archive file \"" << archiveFile << "\"" << endl;
-        return;
-    }
-
+    //
+    // Only save the packets to the archive that are newer than the newest packet in the archive
+    //
+    vector<const ArchivePacket *> newPackets;
+    newPackets.reserve(packets.size());
+    DateTimeFields newestTime = newestPacket.getDateTimeFields();
     for (const auto & packet : packets) {
-        //
-        // Only save the packet to the archive if it is newer than the newest packet in the archive
-        //
-        if (newestPacket.getDateTimeFields() < packet.getDateTimeFields()) {
-            stream.write(packet.getBuffer(), ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
-            newestPacket = packet;
-            logger.log(VantageLogger::VANTAGE_DEBUG1) << "Archived packet with time: "
-                                                      << packet.getDateTimeFields().formatDateTime() << endl;
-            savePacketToFile(packet);
+        if (newestTime < packet.getDateTimeFields()) {
+            newPackets.push_back(&packet);
+            newestTime = packet.getDateTimeFields();
         }
         else
             logger.log(VantageLogger::VANTAGE_INFO) << "Skipping archive of packet with time "
                                                     << packet.getDateTimeFields().formatDateTime() << endl;
     }
 
-    streampos fileSize = stream.tellp();
-    archivePacketCount = fileSize / ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+    if (newPackets.empty())
+        return;
 
-    stream.close();
+    if (!appendRecords(newPackets))
+        return;
+
+    newestPacket = *newPackets.back();
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Archived " << newPackets.size() << " packets with times: "
+                                                       << newPackets.front()->getDateTimeFields().formatDateTime() << " - "
+                                                       << newestPacket.getDateTimeFields().formatDateTime() << endl;
+
+    if (!packetSegmentStore.savePackets(newPackets))
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to save archived packets to the packet segment files" << endl;
+
+    //
+    // Remap the archive so that the queries see the new records
+    //
+    mapArchiveFile();
+
+    if (oldestPacket.isEmptyPacket() && archivePacketCount > 0)
+        oldestPacket.updateArchivePacketData(archiveMapping->getRecord(0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveManager::setDurabilityPolicy(DurabilityPolicy policy, int interval) {
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    durabilityPolicy = policy;
+    syncInterval = interval;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-ArchiveManager::savePacketToFile(const ArchivePacket & packet) {
+ArchiveManager::setDownloadProgress(const DownloadProgress & progress) {
+    std::lock_guard<std::mutex> guard(downloadProgressMutex);
+    downloadProgress = progress;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveManager::DownloadProgress
+ArchiveManager::getDownloadProgress() const {
+    std::lock_guard<std::mutex> guard(downloadProgressMutex);
+    return downloadProgress;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveManager::appendRecords(const vector<const ArchivePacket *> & packets) {
+    int fd = open(archiveFile.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open archive file \"" << archiveFile << "\". Error: " << logger.strerror() << endl;
+        return false;
+    }
+
+    off_t originalLength = lseek(fd, 0, SEEK_END);
+
+    vector<struct iovec> iov(packets.size());
+    for (size_t i = 0; i < packets.size(); i++) {
+        iov[i].iov_base = const_cast<byte *>(packets[i]->getBuffer());
+        iov[i].iov_len = ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+    }
+
+    //
+    // writev() can write fewer bytes than requested and is limited to IOV_MAX buffers per call,
+    // so keep writing from where the previous call stopped
+    //
+    size_t nextBuffer = 0;
+    bool success = true;
+    while (nextBuffer < iov.size()) {
+        int bufferCount = static_cast<int>(std::min(iov.size() - nextBuffer, static_cast<size_t>(IOV_MAX)));
+        ssize_t bytesWritten = writev(fd, &iov[nextBuffer], bufferCount);
+        if (bytesWritten < 0) {
+            if (errno == EINTR)
+                continue;
+
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to write " << packets.size() << " records to archive file \"" << archiveFile << "\". Error: " << logger.strerror() << endl;
+            success = false;
+            break;
+        }
+
+        while (bytesWritten > 0) {
+            if (static_cast<size_t>(bytesWritten) >= iov[nextBuffer].iov_len) {
+                bytesWritten -= iov[nextBuffer].iov_len;
+                nextBuffer++;
+            }
+            else {
+                iov[nextBuffer].iov_base = static_cast<byte *>(iov[nextBuffer].iov_base) + bytesWritten;
+                iov[nextBuffer].iov_len -= bytesWritten;
+                bytesWritten = 0;
+            }
+        }
+    }
+
     //
-    // Build the path to the save file <dir>/yy/mm/dd/ap-hh-mm.dat
-    // So each directory will hold a day's worth of packets. The number of packets will depend on the archive period.
+    // Remove any part of the batch that was written. Only the bytes after the current mapping are removed,
+    // so the queries that are using the current mapping are not affected.
     //
-    ostringstream oss;
-    oss << setfill('0');
-    oss << packetSaveDirectory << "/" << packet.getDateTimeFields().getYear()
-                               << "/" << setw(2) << packet.getDateTimeFields().getMonth()
-                               << "/" << setw(2) << packet.getDateTimeFields().getMonthDay();
+    if (!success) {
+        if (ftruncate(fd, originalLength) != 0)
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to truncate archive file \"" << archiveFile << "\" after a write error. Error: " << logger.strerror() << endl;
 
+        close(fd);
+        return false;
+    }
+
+    DateTime now = time(0);
+    if (durabilityPolicy == DurabilityPolicy::SYNC_PER_BATCH ||
+        (durabilityPolicy == DurabilityPolicy::SYNC_PERIODIC && now - lastSyncTime >= syncInterval)) {
+        if (fdatasync(fd) != 0)
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to synchronize archive file \"" << archiveFile << "\". Error: " << logger.strerror() << endl;
+        else
+            lastSyncTime = now;
+    }
+
+    close(fd);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveManager::recoverArchiveTail() {
     std::error_code errorCode;
-    if (!std::filesystem::create_directories(oss.str(), errorCode) && errorCode) {
-        logger.log(VantageLogger::VANTAGE_ERROR) << "savePacketToFile() failed to save packet due to directory creation error (" << errorCode.message() << "). Directory = '" << oss.str() << "'" << endl;
+    uintmax_t fileLength = std::filesystem::file_size(archiveFile, errorCode);
+    if (errorCode)
         return;
+
+    uintmax_t validLength = fileLength - (fileLength % ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+
+    //
+    // Depending on the file system, the blocks that were allocated for records that were never written
+    // can read back as zeros. No record that was written by the console has a zero date stamp.
+    //
+    ifstream stream(archiveFile.c_str(), ios::in | ios::binary);
+    byte record[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    while (validLength > 0 && stream.good()) {
+        stream.seekg(validLength - ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        stream.read(record, sizeof(record));
+        if (!stream.good())
+            break;
+
+        int datestamp = BitConverter::toUint16(record, 0);
+        if (datestamp != 0 && ArchivePacket::archivePacketContainsData(record, 0))
+            break;
+
+        validLength -= ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
     }
 
-    oss << "/ap-" << setw(2) << packet.getDateTimeFields().getHour()
-        << "-"    << setw(2) << packet.getDateTimeFields().getMinute()
-        << ".dat";
+    stream.close();
 
-    const string & filename = oss.str();
+    if (validLength == fileLength)
+        return;
+
+    logger.log(VantageLogger::VANTAGE_WARNING) << "Archive file \"" << archiveFile << "\" has " << (fileLength - validLength)
+                                               << " bytes of partial or unwritten records at the end. Truncating to " << validLength << " bytes" << endl;
 
-    if (!packet.saveArchivePacketToFile(filename))
-        logger.log(VantageLogger::VANTAGE_ERROR) << "savePacketToFile() did not write to packet file '" << filename << endl;
+    std::filesystem::resize_file(archiveFile, validLength, errorCode);
+    if (errorCode)
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to truncate archive file \"" << archiveFile << "\". Error: " << errorCode.message() << endl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 ArchiveManager::findArchivePacketTimeRange() {
-    std::lock_guard<std::mutex> guard(mutex);
-    ifstream stream(archiveFile.c_str(), ios::in | ios::binary | ios::ate);
-
-    streampos fileSize = stream.tellg();
-    archivePacketCount = fileSize / ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    mapArchiveFile();
 
-    if (fileSize >= ArchivePacket::BYTES_PER_ARCHIVE_PACKET) {
-        byte buffer[ArchivePacket::BYTES_PER_ARCHIVE_PACKET];
+    if (archivePacketCount > 0) {
+        oldestPacket.updateArchivePacketData(archiveMapping->getRecord(0));
+        newestPacket.updateArchivePacketData(archiveMapping->getRecord(archivePacketCount - 1));
+    }
+}
 
-        //
-        // Read the packet at the beginning of the file
-        //
-        stream.seekg(0, ios::beg);
-        stream.read(buffer, sizeof(buffer));
-        ArchivePacket packet(buffer);
-        oldestPacket.updateArchivePacketData(buffer, 0);
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveManager::mapArchiveFile() {
+    archiveMapping = std::make_shared<const MappedArchiveFile>(archiveFile);
+    archivePacketCount = archiveMapping->getRecordCount();
+    archiveIndex.synchronize(*archiveMapping);
+    daySummaryStore.synchronize(*archiveMapping);
+
+    if (columnarArchiveEnabled)
+        columnarArchive.synchronize(*archiveMapping);
+}
 
-        //
-        // Read the packet at the end of the file
-        //
-        stream.seekg(-ArchivePacket::BYTES_PER_ARCHIVE_PACKET, ios::end);
-        stream.read(buffer, sizeof(buffer));
-        newestPacket.updateArchivePacketData(buffer);
-    }
-    else {
-        archivePacketCount = 0;
-    }
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveManager::findRecordRange(const DateTimeFields & startTime, const DateTimeFields & endTime, int & first, int & last) const {
+    int startLow, startHigh, endLow, endHigh;
+    archiveIndex.findSearchRange(startTime, archiveMapping->getRecordCount(), startLow, startHigh);
+    archiveIndex.findSearchRange(endTime, archiveMapping->getRecordCount(), endLow, endHigh);
 
-    stream.close();
+    first = archiveMapping->findFirstRecordOnOrAfter(startTime, startLow, startHigh);
+    last = archiveMapping->findFirstRecordAfter(endTime, endLow, endHigh);
 }
 
 }
@@ -19,19 +19,31 @@
 
 #include <string>
 #include <vector>
+#include <shared_mutex>
 #include <mutex>
+#include <memory>
+#include <span>
+#include <thread>
+#include <atomic>
 
 #include "WeatherTypes.h"
 #include "ArchivePacket.h"
+#include "ArchiveIndex.h"
+#include "DaySummaryStore.h"
+#include "ColumnarArchive.h"
+#include "PacketSegmentStore.h"
 
 namespace vws {
 class VantageLogger;
+class MappedArchiveFile;
+class ArchiveColumn;
 
 static const std::string DEFAULT_ARCHIVE_FILE = "weather-archive.dat";
 static const std::string ARCHIVE_BACKUP_FILENAME_TAIL = "weather-archive-backup.dat";
 static const std::string ARCHIVE_BACKUP_DIR = "/backup";
 static const std::string ARCHIVE_SAVE_FILE_PREFIX = "save_";
 static const std::string ARCHIVE_VERIFY_LOG = "/weather-archive-verify.log";
+static const std::string ARCHIVE_VERIFY_REPORT = "/weather-archive-verify.json";
 static const std::string PACKET_SAVE_DIR = "/packets";
 
 /**
@@ -54,6 +66,30 @@ static const std::string PACKET_SAVE_DIR = "/packets";
  */
 class ArchiveManager {
 public:
+    /**
+     * When the archive records that are appended are forced to the disk.
+     */
+    enum class DurabilityPolicy {
+        SYNC_NEVER,       // Leave the flushing of the records to the operating system
+        SYNC_PER_BATCH,   // Synchronize the archive file after every batch of records is appended
+        SYNC_PERIODIC     // Synchronize the archive file after a batch if the sync interval has elapsed since the last synchronization
+    };
+
+    static constexpr int DEFAULT_SYNC_INTERVAL = 3600;
+
+    /**
+     * The progress of the most recent download of the console's archive.
+     */
+    struct DownloadProgress {
+        bool     active;            // Whether a download is in progress
+        bool     aborted;           // Whether the download was aborted before every page was received
+        int      pageCount;         // The number of pages the console is dumping
+        int      pagesReceived;     // The number of pages received from the console
+        int      pagesCommitted;    // The number of received pages whose records were added to the archive
+        int      recordsCommitted;  // The number of records added to the archive
+        DateTime startTime;         // The time the download started
+    };
+
     /**
      * Constructor.
      * 
@@ -75,12 +111,36 @@ public:
     ~ArchiveManager();
 
     /**
-     * Add a list of packets to the archive.
+     * Add a list of packets to the archive. The packets that are newer than the newest packet in the archive are
+     * appended with a single write and then saved to the packet backup files. If the write fails the archive
+     * is truncated back to its previous length so that it never contains a partial record.
      *
      * @param packets The list packets to be added to the archive
      */
     void addPacketsToArchive(const std::vector<ArchivePacket> & packets);
 
+    /**
+     * Set when the appended archive records are forced to the disk. The default is SYNC_PER_BATCH.
+     *
+     * @param policy       The durability policy
+     * @param syncInterval The minimum number of seconds between synchronizations for the SYNC_PERIODIC policy
+     */
+    void setDurabilityPolicy(DurabilityPolicy policy, int syncInterval = DEFAULT_SYNC_INTERVAL);
+
+    /**
+     * Set the progress of the download of the console's archive so that it can be reported while the download runs.
+     *
+     * @param progress The progress of the download
+     */
+    void setDownloadProgress(const DownloadProgress & progress);
+
+    /**
+     * Get the progress of the current or most recent download of the console's archive.
+     *
+     * @return The progress of the download
+     */
+    DownloadProgress getDownloadProgress() const;
+
     /**
      * Query the archive records that occur between the specified times (inclusive).
      *
@@ -91,6 +151,46 @@ public:
      */
     DateTimeFields queryArchiveRecords(const DateTimeFields & startTime, const DateTimeFields & endTime, std::vector<ArchivePacket> & list) const;
 
+    /**
+     * Query the raw archive records that occur between the specified times (inclusive) without copying them.
+     * The records are packed ArchivePacket::BYTES_PER_ARCHIVE_PACKET byte records that point directly into the memory mapped archive.
+     *
+     * @param startTime The time that is used as the lower bound for the query
+     * @param endTime   The time that is used as the upper bound for the query
+     * @param records   The span that will refer to the records that were found
+     * @return The mapping that contains the records. The span is only valid as long as the mapping is held by the caller.
+     */
+    std::shared_ptr<const MappedArchiveFile> queryArchiveRecordSpan(const DateTimeFields & startTime, const DateTimeFields & endTime, std::span<const byte> & records) const;
+
+    /**
+     * Query the day summaries that have been rolled up from the archive for the days within the specified range.
+     * Only complete days are rolled up, so the caller must query the archive records for any days that are not
+     * included in the summaries.
+     *
+     * @param startTime The time whose day is the first day of the query
+     * @param endTime   The time whose day is the last day of the query
+     * @param summaries The day summaries that were found
+     * @return The time of the first archive record that is not included in the day summaries or an invalid time if
+     *         the summaries include all of the archive records
+     */
+    DateTimeFields queryDaySummaries(const DateTimeFields & startTime, const DateTimeFields & endTime, std::vector<DaySummary> & summaries) const;
+
+    /**
+     * Query the values of one column of the archive records that occur between the specified times (inclusive). If the columnar
+     * archive is enabled the complete months are read from it, otherwise the column is extracted from the raw archive records.
+     *
+     * @param startTime The time that is used as the lower bound for the query
+     * @param endTime   The time that is used as the upper bound for the query
+     * @param column    The column to query
+     * @param samples   The samples that were found
+     */
+    void queryArchiveColumn(const DateTimeFields & startTime, const DateTimeFields & endTime, const ArchiveColumn & column, std::vector<ColumnSample> & samples) const;
+
+    /**
+     * Enable the columnar archive and bring it up to date with the archive.
+     */
+    void enableColumnarArchive();
+
     /**
      * Query the archive records for a single day.
      *
@@ -156,7 +256,17 @@ public:
     bool getBackupFileList(std::vector<std::string> & fileList) const;
 
     /**
-     * Verify that the current archive file is good.
+     * Start the verification of the current archive file on a background thread. Nothing is started if the previous
+     * verification is still running.
+     *
+     * @return True if the verification was started
+     */
+    bool startCurrentArchiveVerification();
+
+    /**
+     * Verify that the current archive file is good. The verification is performed on the current mapping of the archive
+     * without holding the mutex, so the archive can be queried and appended to while it runs. The results are written
+     * to the verification log and the JSON verification report.
      *
      * @return True if the archive file is good
      */
@@ -165,8 +275,8 @@ public:
     /**
      * Verify that the specified archive file is good.
      *
-     * @param archiveFilePath   The path to the archive file to be verified
-     * @param verifyLogFilePath The path to the log file containing verification messages
+     * @param archiveFilePath The path to the archive file to be verified
+     * @param logResults      Whether to write the results to the verification log and the JSON verification report
      * @return True if the archive file is good
      */
     bool verifyArchiveFile(const std::string & archiveFilePath, bool logResults = false) const;
@@ -175,36 +285,75 @@ private:
     static constexpr int BACKUP_RETAIN_DAYS = 30;
 
     /**
-     * Position the stream to begin reading the archive based on the time.
+     * Find the range of raw archive records that occur between the specified times. The mutex must be held by the caller.
      *
-     * @param is         The stream that has the archive open
-     * @param searchTime The time to search within the archive
-     * @param afterTime  Whether the stream will be position on or after the search time
+     * @param startTime The time that is used as the lower bound for the query
+     * @param endTime   The time that is used as the upper bound for the query
+     * @param first     The index of the first record that is not before the start time
+     * @param last      The index one past the last record that is not after the end time
      */
-    void positionStream(std::istream & is, DateTime searchTime, bool afterTime) const;
+    void findRecordRange(const DateTimeFields & startTime, const DateTimeFields & endTime, int & first, int & last) const;
 
     /**
-     * Save a packet to a file that can be replayed at a later time.
+     * Map the archive file into memory, replacing the current mapping, and bring the archive index, day summaries and columnar archive up to date.
+     * The mutex must be held by the caller. Readers that still hold the previous mapping are not affected.
+     */
+    void mapArchiveFile();
+
+    /**
+     * Append records to the archive file with a single write and synchronize the file according to the durability policy.
+     * The mutex must be held by the caller.
      *
-     * @param packet The packet to save
+     * @param packets The packets to append
+     * @return True if all of the records were written
      */
-    void savePacketToFile(const ArchivePacket & packet);
+    bool appendRecords(const std::vector<const ArchivePacket *> & packets);
+
+    /**
+     * Remove a partial record and any records that were never written (all zero or all 0xFF bytes) from the end of the archive file.
+     * These are left behind if the power fails while records are being appended.
+     */
+    void recoverArchiveTail();
 
     /**
      * Finds the time range of the archive and set the packet time members.
      */
     void findArchivePacketTimeRange();
 
+    /**
+     * Verify a mapping of an archive file and report the results.
+     *
+     * @param archiveFilePath The path to the archive file that was mapped
+     * @param mapping         The mapping of the archive file
+     * @param logResults      Whether to write the results to the verification log and the JSON verification report
+     * @return True if the archive file is good
+     */
+    bool verifyArchiveMapping(const std::string & archiveFilePath, const MappedArchiveFile & mapping, bool logResults) const;
+
     const std::string        archiveFile;            // The name of the archive file
     const std::string        packetSaveDirectory;    // The directory into which the packets will be saved
     const std::string        archiveBackupDir;       // The name of the archive backup directory
     const std::string        archiveVerifyLog;       // The name of the file where the verification results are written
+    const std::string        archiveVerifyReport;    // The name of the file where the JSON report of the last verification is written
     DateTime                 nextBackupTime;         // The next time the archive should be backed up
     ArchivePacket            newestPacket;
     ArchivePacket            oldestPacket;
     int                      archivePacketCount;     // The number of packets in the archive
+    std::shared_ptr<const MappedArchiveFile> archiveMapping; // The read-only mapping of the archive file used by the queries
+    mutable ArchiveIndex     archiveIndex;           // The index of the days within the archive file, rebuilt by the verification if stale
+    mutable DaySummaryStore  daySummaryStore;        // The summaries of the complete days within the archive file, rebuilt by the verification if stale
+    mutable ColumnarArchive  columnarArchive;        // The columnar copy of the complete months within the archive file, rebuilt by the verification if stale
+    bool                     columnarArchiveEnabled; // Whether the columnar archive is maintained and used by the queries
+    DurabilityPolicy         durabilityPolicy;       // When the appended records are forced to the disk
+    int                      syncInterval;           // The minimum number of seconds between periodic synchronizations
+    DateTime                 lastSyncTime;           // The time the archive file was last synchronized
+    PacketSegmentStore       packetSegmentStore;     // The daily segment files of the archived packets that can be used to rebuild the archive
+    std::thread              verificationThread;     // The thread of the most recent background verification
+    std::atomic<bool>        verificationActive;     // Whether the background verification is running
+    DownloadProgress         downloadProgress;       // The progress of the most recent archive download
+    mutable std::mutex       downloadProgressMutex;  // The mutex that protects the download progress, separate so the progress can be read during an append
     VantageLogger &          logger;
-    mutable std::mutex       mutex;                  // The mutex to protect the archive file against access by multiple threads
+    mutable std::shared_mutex mutex;                 // The mutex to protect the archive file against access by multiple threads
 };
 }
 
@@ -41,7 +41,7 @@ namespace vws {
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-ArchivePacket::ArchivePacket() : packetEpochDateTime(EMPTY_ARCHIVE_PACKET_TIME), windSampleCount(0), buffer(""), logger(&VantageLogger::getLogger("ArchivePacket")) {
+ArchivePacket::ArchivePacket() : windSampleCount(0), buffer(""), logger(&VantageLogger::getLogger("ArchivePacket")) {
 }
 
 
@@ -153,7 +153,6 @@ ArchivePacket::clearArchivePacketData() {
     for (int i = 0; i < BYTES_PER_ARCHIVE_PACKET; i++)
         this->buffer[i] = PACKET_NO_VALUE;
 
-    packetEpochDateTime = EMPTY_ARCHIVE_PACKET_TIME;
     windSampleCount = 0;
     packetDateTimeFields.resetDateTimeFields();
 }
@@ -176,13 +175,22 @@ ArchivePacket::getWindSampleCount() const {
 ////////////////////////////////////////////////////////////////////////////////
 DateTime
 ArchivePacket::getEpochDateTime() const {
-    return packetEpochDateTime;
+    if (isEmptyPacket())
+        return EMPTY_ARCHIVE_PACKET_TIME;
+
+    //
+    // Note that this technique works in general, but because the Vantage Console does not report
+    // weather DST is on or off, the conversion to the UNIX epoch is platform dependent. The epoch-based
+    // date time should only be used for relative comparisons, not actual values.
+    // The epoch is not calculated when the packet is decoded because many archive scans only use the date/time fields.
+    //
+    return packetDateTimeFields.getEpochDateTime();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool ArchivePacket::isEmptyPacket() const {
-    return packetEpochDateTime == EMPTY_ARCHIVE_PACKET_TIME;
+    return !packetDateTimeFields.isDateTimeValid();
 }
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -217,13 +225,6 @@ ArchivePacket::decodeDateTimeValues() {
     int minute = time % 100;
 
     packetDateTimeFields.setDateTime(year, month, monthDay, hour, minute, 0);
-
-    //
-    // Note that this technique works in general, but because the Vantage Console does not report
-    // weather DST is on or off, the conversion to the UNIX epoch is platform dependent. The epoch-based
-    // date time should only be used for relative comparisons, not actual values.
-    //
-    packetEpochDateTime =  packetDateTimeFields.getEpochDateTime();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -123,9 +123,10 @@ public:
     int getWindSampleCount() const;
     
     /**
-     * Get the epoch based date/time that was extracted from the packet.
+     * Get the epoch based date/time that was extracted from the packet. The epoch is calculated from the
+     * date/time fields on each call.
      * 
-     * @return The date.time
+     * @return The date.time or EMPTY_ARCHIVE_PACKET_TIME if this is an empty packet
      */
     DateTime getEpochDateTime() const;
 
@@ -210,6 +211,8 @@ public:
     std::string formatJSON(bool pretty = false) const;
 
 private:
+    friend class ArchiveColumn;
+
     void decodeDateTimeValues();
 
     static constexpr DateTime EMPTY_ARCHIVE_PACKET_TIME = 0;
@@ -252,7 +255,6 @@ private:
     static constexpr int SOIL_MOISTURES_BASE_OFFSET = 48;
 
 
-    DateTime        packetEpochDateTime;
     DateTimeFields  packetDateTimeFields;
     int             windSampleCount;
     byte            buffer[BYTES_PER_ARCHIVE_PACKET];
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_PAGE_PROCESSOR_H_
+#define ARCHIVE_PAGE_PROCESSOR_H_
+
+#include "WeatherTypes.h"
+
+namespace vws {
+class DateTimeFields;
+
+/**
+ * Pure virtual class that processes the archive pages received during a DMPAFT command. The pages are passed to the
+ * processor as soon as their CRC and page sequence are checked and before the next page is requested from the console,
+ * so the processor must not perform any lengthy operations within processArchivePage().
+ */
+class ArchivePageProcessor {
+public:
+    /**
+     * Virtual destructor.
+     */
+    virtual ~ArchivePageProcessor() {}
+
+    /**
+     * Method that will be called after the console responds to the DMPAFT command and before the first page is received.
+     *
+     * @param afterTime                       The time after which the archive records are being dumped
+     * @param firstRecordInFirstPageToProcess The first record in the first page that is part of the dump
+     * @param pageCount                       The number of pages the console will dump
+     */
+    virtual void beginDump(const DateTimeFields & afterTime, int firstRecordInFirstPageToProcess, int pageCount) = 0;
+
+    /**
+     * Method that will be called for each archive page that passes the CRC and page sequence checks.
+     *
+     * @param page The page, which is only valid until this method returns
+     */
+    virtual void processArchivePage(const byte * page) = 0;
+
+    /**
+     * Method that will be called when the dump completes or is aborted. The pages received before an abort are valid.
+     *
+     * @param success True if every page of the dump was received
+     */
+    virtual void endDump(bool success) = 0;
+};
+
+}
+
+#endif
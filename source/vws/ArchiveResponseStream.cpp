@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ArchiveResponseStream.h"
+
+#include "ArchivePacket.h"
+#include "MappedArchiveFile.h"
+
+using namespace std;
+
+namespace vws {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveResponseStream::ArchiveResponseStream(const std::shared_ptr<const MappedArchiveFile> & mapping, std::span<const byte> records) : mapping(mapping),
+                                                                                                                                        records(records),
+                                                                                                                                        recordCount(records.size() / ArchivePacket::BYTES_PER_ARCHIVE_PACKET),
+                                                                                                                                        nextRecord(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveResponseStream::~ArchiveResponseStream() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveResponseStream::nextChunk(std::string & chunk) {
+    int lastRecord = std::min(nextRecord + RECORDS_PER_CHUNK, recordCount);
+
+    for (; nextRecord < lastRecord; nextRecord++) {
+        if (nextRecord != 0)
+            chunk.append(", ");
+
+        ArchivePacket packet(records.data(), nextRecord * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        chunk.append(packet.formatJSON());
+    }
+
+    if (nextRecord < recordCount)
+        return true;
+
+    chunk.append("]");
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveResponseStream::getRecordCount() const {
+    return recordCount;
+}
+}
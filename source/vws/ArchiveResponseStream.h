@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_RESPONSE_STREAM_H
+#define ARCHIVE_RESPONSE_STREAM_H
+
+#include <memory>
+#include <span>
+#include "WeatherTypes.h"
+#include "ResponseStream.h"
+
+namespace vws {
+class MappedArchiveFile;
+
+/**
+ * Response stream that formats a range of raw archive records as a JSON array. The records are decoded and formatted
+ * a chunk at a time directly from the memory mapped archive, so the memory needed to respond to a query does not
+ * depend on the number of records in the query.
+ */
+class ArchiveResponseStream : public ResponseStream {
+public:
+    static constexpr int RECORDS_PER_CHUNK = 100;
+
+    /**
+     * Constructor.
+     *
+     * @param mapping The mapping that contains the records, which keeps the records valid while the response is streamed
+     * @param records The packed records to be formatted
+     */
+    ArchiveResponseStream(const std::shared_ptr<const MappedArchiveFile> & mapping, std::span<const byte> records);
+
+    /**
+     * Destructor.
+     */
+    virtual ~ArchiveResponseStream();
+
+    /**
+     * Format the next chunk of records. The last chunk terminates the JSON array.
+     *
+     * @param chunk The string to which the formatted records are appended
+     * @return True if there are more records to be formatted
+     */
+    virtual bool nextChunk(std::string & chunk);
+
+    /**
+     * Get the number of records in the stream.
+     *
+     * @return The record count
+     */
+    int getRecordCount() const;
+
+private:
+    std::shared_ptr<const MappedArchiveFile> mapping;     // The mapping that contains the records
+    std::span<const byte>                    records;     // The records to be formatted
+    int                                      recordCount; // The number of records in the span
+    int                                      nextRecord;  // The index of the next record to be formatted
+};
+}
+#endif
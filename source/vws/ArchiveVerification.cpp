@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ArchiveVerification.h"
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+#include "MappedArchiveFile.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+static constexpr int DATE_STAMP_OFFSET = 0;
+static constexpr int TIME_STAMP_OFFSET = 2;
+static constexpr int RECORD_YEAR_OFFSET = 2000;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ArchiveVerification::ArchiveVerification(const MappedArchiveFile & archive, int threadCount) : archive(archive),
+                                                                                             threadCount(threadCount),
+                                                                                             chunkCount(0),
+                                                                                             errorCount(0),
+                                                                                             warningCount(0),
+                                                                                             archivePeriod(0),
+                                                                                             logger(VantageLogger::getLogger("ArchiveVerification")) {
+    if (this->threadCount <= 0)
+        this->threadCount = std::max(1U, std::thread::hardware_concurrency());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveVerification::verify() {
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+
+    anomalies.clear();
+    errorCount = 0;
+    warningCount = 0;
+    archivePeriod = 0;
+    firstRecordTime.resetDateTimeFields();
+    lastRecordTime.resetDateTimeFields();
+
+    int recordCount = archive.getRecordCount();
+    int chunkRecords = std::max(MIN_CHUNK_RECORDS, (recordCount + threadCount - 1) / threadCount);
+    chunkCount = (recordCount + chunkRecords - 1) / chunkRecords;
+
+    vector<Chunk> chunks(chunkCount);
+    for (int i = 0; i < chunkCount; i++) {
+        chunks[i].first = i * chunkRecords;
+        chunks[i].last = std::min(recordCount, chunks[i].first + chunkRecords);
+        chunks[i].newestRecord = -1;
+        chunks[i].precedingRecord = -1;
+    }
+
+    //
+    // Each pass verifies the chunks in parallel, the calling thread verifies the first chunk
+    //
+    auto runPass = [this, &chunks](void (ArchiveVerification::*pass)(Chunk &) const) {
+        vector<thread> threads;
+        for (size_t i = 1; i < chunks.size(); i++)
+            threads.emplace_back(pass, this, std::ref(chunks[i]));
+
+        if (!chunks.empty())
+            (this->*pass)(chunks[0]);
+
+        for (thread & t : threads)
+            t.join();
+    };
+
+    //
+    // A record is compared with the newest record before it, so each chunk starts with the newest record of all
+    // of the chunks before it, not just the last record of the previous chunk
+    //
+    runPass(&ArchiveVerification::findNewestRecord);
+
+    int newestRecord = -1;
+    for (Chunk & chunk : chunks) {
+        chunk.precedingRecord = newestRecord;
+        if (chunk.newestRecord >= 0 && (newestRecord < 0 || MappedArchiveFile::recordTimeKey(archive.getRecord(chunk.newestRecord)) > MappedArchiveFile::recordTimeKey(archive.getRecord(newestRecord))))
+            newestRecord = chunk.newestRecord;
+    }
+
+    runPass(&ArchiveVerification::verifyChunk);
+
+    for (const Chunk & chunk : chunks)
+        anomalies.insert(anomalies.end(), chunk.anomalies.begin(), chunk.anomalies.end());
+
+    mergeRuns(chunks);
+
+    stable_sort(anomalies.begin(), anomalies.end(), [](const Anomaly & a, const Anomaly & b) { return a.recordIndex < b.recordIndex; });
+
+    for (const Anomaly & anomaly : anomalies) {
+        if (anomaly.type == AnomalyType::INVALID_TIME || anomaly.type == AnomalyType::OUT_OF_ORDER)
+            errorCount++;
+        else
+            warningCount++;
+    }
+
+    for (int i = 0; i < recordCount && !decodeRecordTime(archive.getRecord(i), firstRecordTime); i++);
+    for (int i = recordCount - 1; i >= 0 && !decodeRecordTime(archive.getRecord(i), lastRecordTime); i--);
+
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    chrono::duration<double> timeSpan = chrono::duration_cast<chrono::duration<double>>(t2 - t1);
+
+    logger.log(VantageLogger::VANTAGE_INFO) << "Verified " << recordCount << " archive records in " << chunkCount << " chunks in "
+                                            << timeSpan.count() << " seconds. Found " << errorCount << " errors and "
+                                            << warningCount << " warnings" << endl;
+
+    return errorCount == 0 && warningCount == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveVerification::getRecordCount() const {
+    return archive.getRecordCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveVerification::getErrorCount() const {
+    return errorCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveVerification::getWarningCount() const {
+    return warningCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ArchiveVerification::getChunkCount() const {
+    return chunkCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+DateTime
+ArchiveVerification::getArchivePeriod() const {
+    return archivePeriod;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const DateTimeFields &
+ArchiveVerification::getFirstRecordTime() const {
+    return firstRecordTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const DateTimeFields &
+ArchiveVerification::getLastRecordTime() const {
+    return lastRecordTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const vector<ArchiveVerification::Anomaly> &
+ArchiveVerification::getAnomalies() const {
+    return anomalies;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+string
+ArchiveVerification::formatJSON(const string & archiveFile) const {
+    ostringstream oss;
+    oss << "{ \"archiveFile\" : \"" << archiveFile << "\", "
+        << "\"records\" : " << getRecordCount() << ", "
+        << "\"firstRecordTime\" : \"" << firstRecordTime.formatDateTime() << "\", "
+        << "\"lastRecordTime\" : \"" << lastRecordTime.formatDateTime() << "\", "
+        << "\"archivePeriod\" : " << archivePeriod << ", "
+        << "\"chunks\" : " << chunkCount << ", "
+        << "\"errors\" : " << errorCount << ", "
+        << "\"warnings\" : " << warningCount << ", "
+        << "\"anomalies\" : [ ";
+
+    for (size_t i = 0; i < anomalies.size(); i++) {
+        const Anomaly & anomaly = anomalies[i];
+        oss << (i == 0 ? "" : ", ")
+            << "{ \"type\" : \"" << anomalyTypeName(anomaly.type) << "\", "
+            << "\"record\" : " << anomaly.recordIndex << ", "
+            << "\"offset\" : " << static_cast<long>(anomaly.recordIndex) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET << ", "
+            << "\"time\" : \"" << anomaly.time.formatDateTime() << "\", "
+            << "\"previousTime\" : \"" << anomaly.previousTime.formatDateTime() << "\"";
+
+        if (anomaly.type == AnomalyType::GAP || anomaly.type == AnomalyType::DELTA_CHANGE)
+            oss << ", \"delta\" : " << anomaly.delta << ", \"runLength\" : " << anomaly.runLength;
+
+        oss << " }";
+    }
+
+    oss << " ] }";
+
+    return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+string
+ArchiveVerification::anomalyTypeName(AnomalyType type) {
+    switch (type) {
+        case AnomalyType::INVALID_TIME:
+            return "invalid-time";
+        case AnomalyType::OUT_OF_ORDER:
+            return "out-of-order";
+        case AnomalyType::GAP:
+            return "gap";
+        case AnomalyType::DELTA_CHANGE:
+        default:
+            return "delta-change";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveVerification::findNewestRecord(Chunk & chunk) const {
+    DateTimeFields fields;
+    int32 newestKey = 0;
+    for (int i = chunk.first; i < chunk.last; i++) {
+        const byte * record = archive.getRecord(i);
+        int32 key = MappedArchiveFile::recordTimeKey(record);
+        if (key > newestKey && decodeRecordTime(record, fields)) {
+            newestKey = key;
+            chunk.newestRecord = i;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveVerification::verifyChunk(Chunk & chunk) const {
+    const byte * previousRecord = NULL;
+    int32 previousKey = 0;
+    DateTime previousTime = 0;
+    DateTimeFields fields;
+    DateTimeFields previousFields;
+
+    if (chunk.precedingRecord >= 0) {
+        previousRecord = archive.getRecord(chunk.precedingRecord);
+        previousKey = MappedArchiveFile::recordTimeKey(previousRecord);
+        decodeRecordTime(previousRecord, previousFields);
+        previousTime = previousFields.getEpochDateTime();
+    }
+
+    bool runStarted = false;
+    DateTime runDelta = 0;
+
+    for (int i = chunk.first; i < chunk.last; i++) {
+        const byte * record = archive.getRecord(i);
+
+        if (!decodeRecordTime(record, fields)) {
+            chunk.anomalies.push_back(Anomaly{AnomalyType::INVALID_TIME, i, DateTimeFields(), previousFields, 0, 0});
+            continue;
+        }
+
+        //
+        // Out of order records are skipped so that the records that follow are compared with the newest record
+        //
+        int32 key = MappedArchiveFile::recordTimeKey(record);
+        DateTime recordTime = 0;
+        if (previousRecord != NULL && (key <= previousKey || (recordTime = fields.getEpochDateTime()) <= previousTime)) {
+            chunk.anomalies.push_back(Anomaly{AnomalyType::OUT_OF_ORDER, i, fields, previousFields, 0, 0});
+            continue;
+        }
+
+        if (previousRecord == NULL)
+            recordTime = fields.getEpochDateTime();
+        else {
+            DateTime delta = recordTime - previousTime;
+            chunk.deltaCounts[delta]++;
+            if (!runStarted || delta != runDelta) {
+                chunk.runStarts.push_back(RunStart{i, delta, previousRecord});
+                runStarted = true;
+                runDelta = delta;
+            }
+        }
+
+        previousRecord = record;
+        previousKey = key;
+        previousTime = recordTime;
+        previousFields = fields;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ArchiveVerification::mergeRuns(const vector<Chunk> & chunks) {
+    map<DateTime,int> deltaCounts;
+    for (const Chunk & chunk : chunks)
+        for (const auto & entry : chunk.deltaCounts)
+            deltaCounts[entry.first] += entry.second;
+
+    int periodCount = 0;
+    for (const auto & entry : deltaCounts) {
+        if (entry.second > periodCount) {
+            archivePeriod = entry.first;
+            periodCount = entry.second;
+        }
+    }
+
+    //
+    // A chunk always starts a new run with its first delta, so a run that continues across a chunk boundary is joined here
+    //
+    vector<RunStart> runs;
+    for (const Chunk & chunk : chunks)
+        for (const RunStart & run : chunk.runStarts)
+            if (runs.empty() || runs.back().delta != run.delta)
+                runs.push_back(run);
+
+    for (size_t i = 0; i < runs.size(); i++) {
+        const RunStart & run = runs[i];
+        if (run.delta == archivePeriod)
+            continue;
+
+        int runEnd = i + 1 < runs.size() ? runs[i + 1].recordIndex : archive.getRecordCount();
+        int runLength = runEnd - run.recordIndex;
+
+        Anomaly anomaly;
+        anomaly.type = run.delta > archivePeriod && runLength == 1 ? AnomalyType::GAP : AnomalyType::DELTA_CHANGE;
+        anomaly.recordIndex = run.recordIndex;
+        decodeRecordTime(archive.getRecord(run.recordIndex), anomaly.time);
+        decodeRecordTime(run.previousRecord, anomaly.previousTime);
+        anomaly.delta = run.delta;
+        anomaly.runLength = runLength;
+        anomalies.push_back(anomaly);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ArchiveVerification::decodeRecordTime(const byte * record, DateTimeFields & fields) {
+    int date = BitConverter::toUint16(record, DATE_STAMP_OFFSET);
+    int time = BitConverter::toUint16(record, TIME_STAMP_OFFSET);
+
+    int year = ((date >> 9) & 0x3F) + RECORD_YEAR_OFFSET;
+    int month = (date >> 5) & 0xF;
+    int monthDay = date & 0x1F;
+    int hour = time / 100;
+    int minute = time % 100;
+
+    //
+    // Records that were never written are all 0 or all 0xFF bytes
+    //
+    if (date == 0 || date == 0xFFFF || month < 1 || month > 12 || monthDay < 1 || hour > 23 || minute > 59) {
+        fields.resetDateTimeFields();
+        return false;
+    }
+
+    fields.setDateTime(year, month, monthDay, hour, minute, 0);
+    return true;
+}
+
+}
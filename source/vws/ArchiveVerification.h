@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ARCHIVE_VERIFICATION_H
+#define ARCHIVE_VERIFICATION_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "WeatherTypes.h"
+#include "DateTimeFields.h"
+
+namespace vws {
+class VantageLogger;
+class MappedArchiveFile;
+
+/**
+ * Verification of the record times of a mapped archive file. The records are split into chunks that are verified in parallel.
+ * The anomalies that are found are:
+ *     invalid-time - A record whose date/time stamp cannot be decoded (error)
+ *     out-of-order - A record that is not newer than the newest record before it (error)
+ *     gap          - A single time delta that is larger than the archive period, typically missing records (warning)
+ *     delta-change - A run of time deltas that are not the archive period, typically a change of the archive period (warning)
+ *
+ * The archive period is the most common time delta between the records. The results do not depend on the number of chunks.
+ */
+class ArchiveVerification {
+public:
+    enum class AnomalyType {
+        INVALID_TIME,
+        OUT_OF_ORDER,
+        GAP,
+        DELTA_CHANGE
+    };
+
+    /**
+     * An anomaly found by the verification.
+     */
+    struct Anomaly {
+        AnomalyType    type;
+        int            recordIndex;    // The index of the record within the archive file
+        DateTimeFields time;           // The time of the record, invalid for an INVALID_TIME anomaly
+        DateTimeFields previousTime;   // The time of the newest record before this record
+        DateTime       delta;          // The time delta from the previous record, GAP and DELTA_CHANGE only
+        int            runLength;      // The number of records up to the next change of the delta, GAP and DELTA_CHANGE only
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param archive     The archive mapping to verify, which must not be unmapped until the verification is complete
+     * @param threadCount The number of threads that verify the chunks, 0 to use the number of cores
+     */
+    explicit ArchiveVerification(const MappedArchiveFile & archive, int threadCount = 0);
+
+    /**
+     * Verify the archive.
+     *
+     * @return True if no anomalies were found
+     */
+    bool verify();
+
+    /**
+     * Get the number of records that were verified.
+     *
+     * @return The record count
+     */
+    int getRecordCount() const;
+
+    /**
+     * Get the number of invalid-time and out-of-order anomalies.
+     *
+     * @return The error count
+     */
+    int getErrorCount() const;
+
+    /**
+     * Get the number of gap and delta-change anomalies.
+     *
+     * @return The warning count
+     */
+    int getWarningCount() const;
+
+    /**
+     * Get the number of chunks into which the records were split.
+     *
+     * @return The chunk count
+     */
+    int getChunkCount() const;
+
+    /**
+     * Get the archive period, which is the most common time delta between the records.
+     *
+     * @return The archive period in seconds, 0 if the archive has fewer than two records
+     */
+    DateTime getArchivePeriod() const;
+
+    /**
+     * Get the time of the first record with a valid time.
+     *
+     * @return The time of the record
+     */
+    const DateTimeFields & getFirstRecordTime() const;
+
+    /**
+     * Get the time of the last record with a valid time.
+     *
+     * @return The time of the record
+     */
+    const DateTimeFields & getLastRecordTime() const;
+
+    /**
+     * Get the anomalies that were found.
+     *
+     * @return The anomalies in record order
+     */
+    const std::vector<Anomaly> & getAnomalies() const;
+
+    /**
+     * Format the results of the verification as a JSON report.
+     *
+     * @param archiveFile The path of the archive file that was verified
+     * @return The JSON report
+     */
+    std::string formatJSON(const std::string & archiveFile) const;
+
+    /**
+     * Get the name of an anomaly type as it appears in the JSON report.
+     *
+     * @param type The anomaly type
+     * @return The name of the type
+     */
+    static std::string anomalyTypeName(AnomalyType type);
+
+private:
+    //
+    // Chunks smaller than this are not worth the cost of a thread
+    //
+    static constexpr int MIN_CHUNK_RECORDS = 8192;
+
+    /**
+     * The start of a run of records with the same time delta from the previous record.
+     */
+    struct RunStart {
+        int            recordIndex;
+        DateTime       delta;
+        const byte *   previousRecord;
+    };
+
+    /**
+     * The results of a single chunk.
+     */
+    struct Chunk {
+        int                         first;              // The index of the first record of the chunk
+        int                         last;               // The index one past the last record of the chunk
+        int                         newestRecord;       // The index of the newest valid record within the chunk, -1 if none
+        int                         precedingRecord;    // The index of the newest valid record before the chunk, -1 if none
+        std::vector<Anomaly>        anomalies;
+        std::vector<RunStart>       runStarts;
+        std::map<DateTime,int>      deltaCounts;
+    };
+
+    /**
+     * Find the newest valid record of a chunk. This is the first pass that allows each chunk to be stitched to the chunks before it.
+     *
+     * @param chunk The chunk
+     */
+    void findNewestRecord(Chunk & chunk) const;
+
+    /**
+     * Verify the records of a chunk, comparing the first record with the newest record of the preceding chunks.
+     *
+     * @param chunk The chunk
+     */
+    void verifyChunk(Chunk & chunk) const;
+
+    /**
+     * Merge the runs of the chunks and classify the runs whose delta is not the archive period.
+     *
+     * @param chunks The verified chunks
+     */
+    void mergeRuns(const std::vector<Chunk> & chunks);
+
+    /**
+     * Decode the date/time stamp of a record.
+     *
+     * @param record The archive record
+     * @param fields The decoded date/time
+     * @return True if the date/time stamp is valid
+     */
+    static bool decodeRecordTime(const byte * record, DateTimeFields & fields);
+
+    const MappedArchiveFile & archive;
+    int                       threadCount;
+    int                       chunkCount;
+    int                       errorCount;
+    int                       warningCount;
+    DateTime                  archivePeriod;      // The most common time delta between records
+    DateTimeFields            firstRecordTime;
+    DateTimeFields            lastRecordTime;
+    std::vector<Anomaly>      anomalies;          // The anomalies in record order
+    VantageLogger &           logger;
+};
+}
+
+#endif
@@ -20,55 +20,6 @@
 
 namespace vws {
 
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-int
-BitConverter::toInt8(const byte buffer[], int index) {
-    int value8 = buffer[index];
-
-    if (buffer[index] & SIGN_BIT) {
-        value8 = (~buffer[index] & 0x7f) + 1;
-        value8 *=  -1;
-    }
-
-    return value8;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-uint8
-BitConverter::toUint8(const byte buffer[], int index) {
-    return static_cast<uint8>(buffer[index]) & ONE_BYTE_MASK;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-int16
-BitConverter::toInt16(const byte buffer[], int index, bool littleEndian) {
-    return bitsToInt<int16>(&buffer[index], littleEndian, true);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-uint16
-BitConverter::toUint16(const byte buffer[], int index, bool littleEndian) {
-    return bitsToInt<uint16>(&buffer[index], littleEndian, false);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-int32
-BitConverter::toInt32(const byte buffer[], int index, bool littleEndian) {
-    return bitsToInt<int32>(&buffer[index], littleEndian, true);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-uint32
-BitConverter::toUint32(const byte buffer[], int index, bool littleEndian) {
-    return bitsToInt<uint32>(&buffer[index], littleEndian, false);
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
@@ -84,28 +35,6 @@ BitConverter::getBytes(int value, byte buffer[], int index, int nbytes, bool lit
     }
 }
 
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-template <typename T>
-T
-BitConverter::bitsToInt(const byte * bits, bool littleEndian, bool isSigned) {
-    T result = 0;
-    bool signBitSet = false;
-    if (littleEndian) {
-        signBitSet = bits[sizeof(T) - 1] & SIGN_BIT;
-        for (int n = sizeof(T) - 1; n >= 0; n--) {
-            result = (result << BITS_PER_BYTE) + (static_cast<int>(bits[n]) & ONE_BYTE_MASK);
-        }
-    }
-    else {
-        signBitSet = bits[0] & SIGN_BIT;
-        for (int n = 0; n < sizeof(T); n++)
-            result = (result << BITS_PER_BYTE) + (static_cast<int>(bits[n]) & ONE_BYTE_MASK);
-    }
-
-    return result;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 int
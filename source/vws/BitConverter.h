@@ -17,17 +17,67 @@
 #ifndef BIT_CONVERTER_H
 #define BIT_CONVERTER_H
 
+#include <cstring>
+#include <bit>
+#include <type_traits>
+
 #include "WeatherTypes.h"
 
 namespace vws {
 /**
- * Class to convert bytes to various size of integers
+ * Class to convert bytes to various size of integers.
+ * The conversions are defined in this header so that they are inlined into the packet decoders. Each combination of
+ * width, signedness and byte order is a separate instantiation of load(), which compiles to an unaligned load followed
+ * by a byte swap when the byte order is not the native byte order.
  */
 class BitConverter {
 public:
     static constexpr int ONE_BYTE_MASK = 0xFF;
     static constexpr int BITS_PER_BYTE = 8;
-    static constexpr char SIGN_BIT = 0x80;
+
+    /**
+     * The order of the bytes of an integer within a buffer.
+     */
+    enum class Endian {
+        LITTLE,
+        BIG
+    };
+
+    /**
+     * Load an integer from a buffer. The width and signedness of the integer are those of the type T.
+     *
+     * @tparam T     The integer type to load
+     * @tparam ORDER The byte order of the integer within the buffer
+     * @param buffer The buffer from which to do the conversion
+     * @param index  The index within the buffer to do the conversion
+     * @return The converted integer
+     */
+    template<typename T, Endian ORDER = Endian::LITTLE>
+    static constexpr T load(const byte buffer[], int index) {
+        static_assert(std::is_integral_v<T>, "BitConverter::load() requires an integer type");
+        using Unsigned = std::make_unsigned_t<T>;
+        Unsigned value = 0;
+
+        //
+        // memcpy() cannot be used in a constant expression, so compile time conversions assemble the bytes one at a time
+        //
+        if (std::is_constant_evaluated()) {
+            unsigned long long bytes = 0;
+            for (size_t i = 0; i < sizeof(T); i++) {
+                size_t n = ORDER == Endian::LITTLE ? sizeof(T) - 1 - i : i;
+                bytes = (bytes << BITS_PER_BYTE) | static_cast<uint8>(buffer[index + n]);
+            }
+
+            value = static_cast<Unsigned>(bytes);
+        }
+        else {
+            memcpy(&value, &buffer[index], sizeof(T));
+            if constexpr (sizeof(T) > 1 && ((ORDER == Endian::LITTLE) != (std::endian::native == std::endian::little)))
+                value = byteSwap(value);
+        }
+
+        return static_cast<T>(value);
+    }
 
     /**
      * Convert one byte to a signed or unsigned integer.
@@ -36,8 +86,13 @@ public:
      * @param index  The index within the buffer to do the conversion
      * @return The converted integer
      */
-    static int toInt8(const byte buffer[], int index);
-    static uint8 toUint8(const byte buffer[], int index);
+    static constexpr int toInt8(const byte buffer[], int index) {
+        return load<signed char>(buffer, index);
+    }
+
+    static constexpr uint8 toUint8(const byte buffer[], int index) {
+        return load<uint8>(buffer, index);
+    }
 
     /**
      * Convert two bytes to a signed or unsigned integer.
@@ -47,8 +102,13 @@ public:
      * @param littleEndian True if the buffer holds the integer in little endian format
      * @return The converted integer
      */
-    static int16 toInt16(const byte buffer[], int index, bool littleEndian = true);
-    static uint16 toUint16(const byte buffer[], int index, bool littleEndian = true);
+    static constexpr int16 toInt16(const byte buffer[], int index, bool littleEndian = true) {
+        return littleEndian ? load<int16, Endian::LITTLE>(buffer, index) : load<int16, Endian::BIG>(buffer, index);
+    }
+
+    static constexpr uint16 toUint16(const byte buffer[], int index, bool littleEndian = true) {
+        return littleEndian ? load<uint16, Endian::LITTLE>(buffer, index) : load<uint16, Endian::BIG>(buffer, index);
+    }
 
     /**
      * Convert four bytes to a signed or unsigned integer.
@@ -58,8 +118,13 @@ public:
      * @param littleEndian True if the buffer holds the integer in little endian format
      * @return The converted integer
      */
-    static int32 toInt32(const byte buffer[], int index, bool littleEndian = true);
-    static uint32 toUint32(const byte buffer[], int index, bool littleEndian = true);
+    static constexpr int32 toInt32(const byte buffer[], int index, bool littleEndian = true) {
+        return littleEndian ? load<int32, Endian::LITTLE>(buffer, index) : load<int32, Endian::BIG>(buffer, index);
+    }
+
+    static constexpr uint32 toUint32(const byte buffer[], int index, bool littleEndian = true) {
+        return littleEndian ? load<uint32, Endian::LITTLE>(buffer, index) : load<uint32, Endian::BIG>(buffer, index);
+    }
 
     /**
      * Convert an integer into bytes.
@@ -100,15 +165,20 @@ private:
     ~BitConverter() = delete;
 
     /**
-     * Utility template function to convert bytes in a buffer to any form of integer.
-     * Note that "typename T" must be some form of integer.
-     * 
-     * @param bits         The buffer containing the integer to be converted
-     * @param littleEndian Whether the integer is stored in the buffer as little endian
-     * @param isSigned     Whether the input should be treated as signed or unsigned
-     * @return The resulting integer.
+     * Reverse the order of the bytes of an unsigned integer.
+     *
+     * @param value The value to swap
+     * @return The value with its bytes reversed
      */
-    template <typename T> static T bitsToInt(const byte bits[], bool littleEndian, bool isSigned);
+    template<typename T>
+    static constexpr T byteSwap(T value) {
+        if constexpr (sizeof(T) == 2)
+            return __builtin_bswap16(value);
+        else if constexpr (sizeof(T) == 4)
+            return __builtin_bswap32(value);
+        else
+            return __builtin_bswap64(value);
+    }
 };
 }
 #endif
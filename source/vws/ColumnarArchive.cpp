@@ -0,0 +1,729 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ColumnarArchive.h"
+
+#include <string.h>
+#include <bit>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+
+#include "ArchiveColumn.h"
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+#include "MappedArchiveFile.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+static const byte ARCHIVE_MAGIC[] = {'V', 'W', 'S', 'C'};
+
+//
+// The fields of the time key, which uses the same encoding as the date and time stamps of the archive packet
+//
+static constexpr int DATE_STAMP_SHIFT = 16;
+static constexpr int MONTH_KEY_SHIFT = 21;
+static constexpr int DAY_MASK = 0x1F;
+static constexpr int TIME_STAMP_MASK = 0xFFFF;
+static constexpr int MONTH_KEY_MONTH_MASK = 0xF;
+static constexpr int MONTH_KEY_YEAR_SHIFT = 4;
+static constexpr int YEAR_OFFSET = 2000;
+static constexpr int MINUTES_PER_DAY = 24 * 60;
+static constexpr int MAX_BIT_WIDTH = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static int32
+recordMonthKey(const MappedArchiveFile & archive, int index) {
+    return MappedArchiveFile::recordTimeKey(archive.getRecord(index)) >> MONTH_KEY_SHIFT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static int32
+minuteOfMonth(int32 timeKey) {
+    int day = (timeKey >> DATE_STAMP_SHIFT) & DAY_MASK;
+    int timeStamp = timeKey & TIME_STAMP_MASK;
+    return ((day - 1) * MINUTES_PER_DAY) + ((timeStamp / 100) * 60) + (timeStamp % 100);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static int32
+monthTimeKey(int32 monthKey, int32 minuteOfMonth) {
+    int day = (minuteOfMonth / MINUTES_PER_DAY) + 1;
+    int minuteOfDay = minuteOfMonth % MINUTES_PER_DAY;
+    return (monthKey << MONTH_KEY_SHIFT) | (day << DATE_STAMP_SHIFT) | (((minuteOfDay / 60) * 100) + (minuteOfDay % 60));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static DateTimeFields
+monthTime(int32 monthKey, int32 minuteOfMonth) {
+    int minuteOfDay = minuteOfMonth % MINUTES_PER_DAY;
+    return DateTimeFields((monthKey >> MONTH_KEY_YEAR_SHIFT) + YEAR_OFFSET,
+                          monthKey & MONTH_KEY_MONTH_MASK,
+                          (minuteOfMonth / MINUTES_PER_DAY) + 1,
+                          minuteOfDay / 60,
+                          minuteOfDay % 60);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static void
+encodeInt32(vector<byte> & buffer, int32 value) {
+    byte bytes[4];
+    BitConverter::getBytes(value, bytes, 0, 4);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(bytes));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static void
+putInt32(vector<byte> & buffer, size_t offset, int32 value) {
+    BitConverter::getBytes(value, buffer.data(), offset, 4);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static void
+putDouble(vector<byte> & buffer, size_t offset, double value) {
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putInt32(buffer, offset, static_cast<int32>(bits & 0xFFFFFFFF));
+    putInt32(buffer, offset + 4, static_cast<int32>(bits >> 32));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static double
+toDouble(const byte * buffer, int offset) {
+    int64_t bits = (static_cast<int64_t>(BitConverter::toInt32(buffer, offset + 4)) << 32) |
+                   (static_cast<int64_t>(BitConverter::toInt32(buffer, offset)) & 0xFFFFFFFF);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ColumnarArchive::ColumnarArchive(const string & file) : columnFile(file),
+                                                        fileLength(0),
+                                                        logger(VantageLogger::getLogger("ColumnarArchive")) {
+    load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ColumnarArchive::~ColumnarArchive() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ColumnarArchive::load() {
+    entries.clear();
+    fileLength = 0;
+
+    error_code ec;
+    std::uintmax_t fileSize = std::filesystem::file_size(columnFile, ec);
+    if (ec) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Columnar archive file '" << columnFile << "' does not exist" << endl;
+        return false;
+    }
+
+    ifstream stream(columnFile.c_str(), ios::in | ios::binary);
+    byte header[BLOCK_HEADER_SIZE];
+    stream.read(header, HEADER_SIZE);
+    if (!stream || !equal(begin(ARCHIVE_MAGIC), end(ARCHIVE_MAGIC), header) || BitConverter::toInt32(header, VERSION_OFFSET) != ARCHIVE_VERSION) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Columnar archive file '" << columnFile << "' has an invalid header" << endl;
+        return false;
+    }
+
+    //
+    // Only the block headers and directories are read, the column data is read when it is queried
+    //
+    vector<byte> directory;
+    size_t offset = HEADER_SIZE;
+    while (offset + BLOCK_HEADER_SIZE <= fileSize) {
+        stream.seekg(offset);
+        stream.read(header, BLOCK_HEADER_SIZE);
+        if (!stream)
+            break;
+
+        MonthEntry entry;
+        entry.length = BitConverter::toInt32(header, 0);
+        entry.monthKey = BitConverter::toInt32(header, 4);
+        entry.firstRecord = BitConverter::toInt32(header, 8);
+        entry.recordCount = BitConverter::toInt32(header, 12);
+        int columnCount = BitConverter::toInt32(header, 16);
+        entry.fileOffset = offset + BLOCK_HEADER_SIZE;
+
+        if (entry.length < 0 || entry.fileOffset + entry.length > fileSize || columnCount < 0 || columnCount * DIRECTORY_ENTRY_SIZE > entry.length)
+            break;
+
+        directory.resize(columnCount * DIRECTORY_ENTRY_SIZE);
+        stream.read(directory.data(), directory.size());
+        if (!stream)
+            break;
+
+        bool validDirectory = true;
+        for (int i = 0; i < columnCount; i++) {
+            const byte * d = directory.data() + (i * DIRECTORY_ENTRY_SIZE);
+            ColumnEntry column;
+            column.columnId = BitConverter::toInt32(d, 0);
+            column.offset = BitConverter::toInt32(d, 4);
+            column.length = BitConverter::toInt32(d, 8);
+            column.validCount = BitConverter::toInt32(d, 12);
+            column.minimum = toDouble(d, 16);
+            column.maximum = toDouble(d, 24);
+            column.sum = toDouble(d, 32);
+
+            if (column.offset < 0 || column.length < 0 || column.offset + column.length > entry.length)
+                validDirectory = false;
+
+            entry.columns.push_back(column);
+        }
+
+        if (!validDirectory)
+            break;
+
+        offset = entry.fileOffset + entry.length;
+        entries.push_back(std::move(entry));
+    }
+
+    fileLength = offset;
+
+    if (fileLength != fileSize)
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Columnar archive file '" << columnFile << "' has a partial month block at the end. It will be removed." << endl;
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Loaded columnar archive with " << entries.size() << " months covering " << getSummarizedRecordCount() << " records" << endl;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::synchronize(const MappedArchiveFile & archive) {
+    if (!isConsistent(archive)) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Columnar archive file '" << columnFile << "' is stale. Rebuilding the columnar archive." << endl;
+        rebuild(archive);
+    }
+    else
+        encodeNewMonths(archive);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::rebuild(const MappedArchiveFile & archive) {
+    entries.clear();
+    writeHeader();
+    encodeNewMonths(archive);
+
+    logger.log(VantageLogger::VANTAGE_INFO) << "Rebuilt columnar archive with " << entries.size() << " months covering " << getSummarizedRecordCount() << " records" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ColumnarArchive::isConsistent(const MappedArchiveFile & archive) const {
+    if (entries.size() == 0)
+        return true;
+
+    const MonthEntry & first = entries.front();
+    const MonthEntry & last = entries.back();
+    int nextRecord = last.firstRecord + last.recordCount;
+
+    if (first.firstRecord != 0 || last.recordCount <= 0 || nextRecord > archive.getRecordCount())
+        return false;
+
+    //
+    // Spot check the first and last months the same way the day summary store checks its days
+    //
+    if (recordMonthKey(archive, 0) != first.monthKey)
+        return false;
+
+    if (recordMonthKey(archive, last.firstRecord) != last.monthKey || recordMonthKey(archive, nextRecord - 1) != last.monthKey)
+        return false;
+
+    if (last.firstRecord > 0 && recordMonthKey(archive, last.firstRecord - 1) >= last.monthKey)
+        return false;
+
+    if (nextRecord < archive.getRecordCount() && recordMonthKey(archive, nextRecord) <= last.monthKey)
+        return false;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ColumnarArchive::verify(const MappedArchiveFile & archive) const {
+    if (!isConsistent(archive)) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Columnar archive file '" << columnFile << "' is not consistent with the archive" << endl;
+        return false;
+    }
+
+    ifstream stream(columnFile.c_str(), ios::in | ios::binary);
+    vector<int32> values;
+    bool valid = true;
+
+    for (const MonthEntry & month : entries) {
+        if (month.columns.size() != static_cast<size_t>(ArchiveColumn::getColumnCount() + 1)) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Month block " << month.monthKey << " has " << month.columns.size() << " columns" << endl;
+            valid = false;
+            continue;
+        }
+
+        for (const ColumnEntry & column : month.columns) {
+            if (!readMonthColumn(stream, month, column, values)) {
+                logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to decode column " << column.columnId << " of month block " << month.monthKey << endl;
+                valid = false;
+                continue;
+            }
+
+            const ArchiveColumn * archiveColumn = column.columnId == TIME_COLUMN_ID ? nullptr : &ArchiveColumn::getColumn(column.columnId);
+            ColumnStatistics statistics;
+            int mismatches = 0;
+            for (int i = 0; i < month.recordCount; i++) {
+                const byte * record = archive.getRecord(month.firstRecord + i);
+                if (archiveColumn == nullptr) {
+                    int32 timeKey = MappedArchiveFile::recordTimeKey(record);
+                    if ((timeKey >> MONTH_KEY_SHIFT) != month.monthKey || minuteOfMonth(timeKey) != values[i])
+                        mismatches++;
+                }
+                else {
+                    if (archiveColumn->extractRawValue(record) != values[i])
+                        mismatches++;
+
+                    statistics.applyValue(archiveColumn->decodeRawValue(values[i]));
+                }
+            }
+
+            if (mismatches > 0) {
+                logger.log(VantageLogger::VANTAGE_WARNING) << "Column " << column.columnId << " of month block " << month.monthKey
+                                                           << " has " << mismatches << " values that do not match the archive" << endl;
+                valid = false;
+            }
+
+            if (archiveColumn != nullptr &&
+                (statistics.validCount != column.validCount || statistics.sum != column.sum ||
+                 (statistics.validCount > 0 && (statistics.minimum.getValue() != column.minimum || statistics.maximum.getValue() != column.maximum)))) {
+                logger.log(VantageLogger::VANTAGE_WARNING) << "Statistics of column " << archiveColumn->name << " of month block " << month.monthKey
+                                                           << " do not match the archive" << endl;
+                valid = false;
+            }
+        }
+    }
+
+    return valid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::clear() {
+    entries.clear();
+    writeHeader();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ColumnarArchive::readColumn(const DateTimeFields & startTime, const DateTimeFields & endTime, int columnId, vector<ColumnSample> & samples) const {
+    int32 startKey = MappedArchiveFile::timeKey(startTime);
+    int32 endKey = MappedArchiveFile::timeKey(endTime);
+    int firstEntry = findFirstEntryOnOrAfter(startKey >> MONTH_KEY_SHIFT);
+    int lastEntry = findFirstEntryOnOrAfter((endKey >> MONTH_KEY_SHIFT) + 1);
+
+    if (firstEntry >= lastEntry)
+        return true;
+
+    const ArchiveColumn & archiveColumn = ArchiveColumn::getColumn(columnId);
+    ifstream stream(columnFile.c_str(), ios::in | ios::binary);
+    vector<int32> times;
+    vector<int32> values;
+
+    for (int i = firstEntry; i < lastEntry; i++) {
+        const MonthEntry & month = entries[i];
+        const ColumnEntry * timeColumn = findColumn(month, TIME_COLUMN_ID);
+        const ColumnEntry * valueColumn = findColumn(month, columnId);
+
+        if (timeColumn == nullptr || valueColumn == nullptr ||
+            !readMonthColumn(stream, month, *timeColumn, times) || !readMonthColumn(stream, month, *valueColumn, values)) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to read column " << columnId << " of month block " << month.monthKey << " from '" << columnFile << "'" << endl;
+            return false;
+        }
+
+        for (int j = 0; j < month.recordCount; j++) {
+            int32 timeKey = monthTimeKey(month.monthKey, times[j]);
+            if (timeKey < startKey || timeKey > endKey)
+                continue;
+
+            samples.push_back(ColumnSample{monthTime(month.monthKey, times[j]), archiveColumn.decodeRawValue(values[j])});
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::dump(ostream & os) const {
+    size_t totalBytes = HEADER_SIZE;
+    int totalRecords = 0;
+
+    for (const MonthEntry & month : entries) {
+        int blockBytes = BLOCK_HEADER_SIZE + month.length;
+        int rawBytes = month.recordCount * ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+        os << setfill('0') << setw(4) << (month.monthKey >> MONTH_KEY_YEAR_SHIFT) + YEAR_OFFSET << "-" << setw(2) << (month.monthKey & MONTH_KEY_MONTH_MASK) << setfill(' ')
+           << " - Records: " << month.firstRecord << " to " << month.firstRecord + month.recordCount - 1
+           << " (" << month.recordCount << "), Block: " << blockBytes << " bytes, Raw: " << rawBytes << " bytes" << endl;
+
+        for (const ColumnEntry & column : month.columns) {
+            const char * name = column.columnId == TIME_COLUMN_ID ? "time" : ArchiveColumn::getColumn(column.columnId).name;
+            os << "    " << left << setw(24) << name << right << setw(8) << column.length << " bytes";
+            if (column.columnId != TIME_COLUMN_ID) {
+                os << "  Valid: " << setw(5) << column.validCount;
+                if (column.validCount > 0)
+                    os << "  Min: " << column.minimum << "  Max: " << column.maximum << "  Avg: " << column.sum / column.validCount;
+            }
+            os << endl;
+        }
+
+        totalBytes += blockBytes;
+        totalRecords += month.recordCount;
+    }
+
+    os << entries.size() << " months, " << totalRecords << " records, " << totalBytes << " bytes, "
+       << static_cast<size_t>(totalRecords) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET << " bytes in the archive" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ColumnarArchive::getSummarizedRecordCount() const {
+    if (entries.size() == 0)
+        return 0;
+    else
+        return entries.back().firstRecord + entries.back().recordCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ColumnarArchive::getMonthCount() const {
+    return entries.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::encodeNewMonths(const MappedArchiveFile & archive) {
+    int recordCount = archive.getRecordCount();
+    int firstRecord = getSummarizedRecordCount();
+
+    if (firstRecord >= recordCount)
+        return;
+
+    if (fileLength < HEADER_SIZE)
+        writeHeader();
+
+    //
+    // The month of the newest record may still receive records, so it is not encoded
+    //
+    int32 newestMonthKey = recordMonthKey(archive, recordCount - 1);
+    int32 lastMonthKey = entries.size() > 0 ? entries.back().monthKey : -1;
+
+    vector<byte> buffer;
+    vector<MonthEntry> newEntries;
+    vector<byte> payload;
+
+    int monthStart = firstRecord;
+    while (monthStart < recordCount) {
+        int32 monthKey = recordMonthKey(archive, monthStart);
+        if (monthKey >= newestMonthKey)
+            break;
+
+        int monthEnd = monthStart + 1;
+        while (monthEnd < recordCount && recordMonthKey(archive, monthEnd) == monthKey)
+            monthEnd++;
+
+        if (monthKey <= lastMonthKey) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Archive records " << monthStart << " to " << monthEnd - 1 << " are out of order. They will not be added to the columnar archive." << endl;
+            monthStart = monthEnd;
+            continue;
+        }
+
+        MonthEntry entry;
+        entry.monthKey = monthKey;
+        entry.firstRecord = monthStart;
+        entry.recordCount = monthEnd - monthStart;
+
+        payload.clear();
+        encodeMonth(archive, entry, payload);
+        entry.length = payload.size();
+        entry.fileOffset = fileLength + buffer.size() + BLOCK_HEADER_SIZE;
+
+        encodeInt32(buffer, entry.length);
+        encodeInt32(buffer, entry.monthKey);
+        encodeInt32(buffer, entry.firstRecord);
+        encodeInt32(buffer, entry.recordCount);
+        encodeInt32(buffer, entry.columns.size());
+        buffer.insert(buffer.end(), payload.begin(), payload.end());
+        newEntries.push_back(std::move(entry));
+
+        lastMonthKey = monthKey;
+        monthStart = monthEnd;
+    }
+
+    if (newEntries.size() == 0)
+        return;
+
+    //
+    // Make sure the file does not have a partial month block at the end before appending
+    //
+    error_code ec;
+    if (std::filesystem::file_size(columnFile, ec) != fileLength && !ec)
+        std::filesystem::resize_file(columnFile, fileLength, ec);
+
+    fstream stream(columnFile.c_str(), ios::in | ios::out | ios::binary);
+    stream.seekp(fileLength);
+    stream.write(buffer.data(), buffer.size());
+    stream.close();
+
+    if (!stream) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to append month blocks to '" << columnFile << "'" << endl;
+        return;
+    }
+
+    int monthsAdded = newEntries.size();
+    for (MonthEntry & entry : newEntries)
+        entries.push_back(std::move(entry));
+
+    fileLength += buffer.size();
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Added " << monthsAdded << " months to the columnar archive" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::encodeMonth(const MappedArchiveFile & archive, MonthEntry & entry, vector<byte> & payload) {
+    int columnCount = ArchiveColumn::getColumnCount() + 1;
+
+    //
+    // The directory is at the start of the payload and is filled in once the columns have been encoded
+    //
+    payload.assign(columnCount * DIRECTORY_ENTRY_SIZE, 0);
+    entry.columns.clear();
+
+    vector<int32> values(entry.recordCount);
+    for (int columnId = TIME_COLUMN_ID; columnId < ArchiveColumn::getColumnCount(); columnId++) {
+        ColumnEntry column;
+        column.columnId = columnId;
+        column.validCount = 0;
+        column.minimum = 0.0;
+        column.maximum = 0.0;
+        column.sum = 0.0;
+
+        if (columnId == TIME_COLUMN_ID) {
+            for (int i = 0; i < entry.recordCount; i++)
+                values[i] = minuteOfMonth(MappedArchiveFile::recordTimeKey(archive.getRecord(entry.firstRecord + i)));
+
+            column.validCount = entry.recordCount;
+            column.minimum = *min_element(values.begin(), values.end());
+            column.maximum = *max_element(values.begin(), values.end());
+        }
+        else {
+            const ArchiveColumn & archiveColumn = ArchiveColumn::getColumn(columnId);
+            ColumnStatistics statistics;
+            for (int i = 0; i < entry.recordCount; i++) {
+                values[i] = archiveColumn.extractRawValue(archive.getRecord(entry.firstRecord + i));
+                statistics.applyValue(archiveColumn.decodeRawValue(values[i]));
+            }
+
+            column.validCount = statistics.validCount;
+            column.minimum = statistics.minimum.getValue();
+            column.maximum = statistics.maximum.getValue();
+            column.sum = statistics.sum;
+        }
+
+        column.offset = payload.size();
+        encodeColumn(values, payload);
+        column.length = payload.size() - column.offset;
+
+        size_t d = entry.columns.size() * DIRECTORY_ENTRY_SIZE;
+        putInt32(payload, d, column.columnId);
+        putInt32(payload, d + 4, column.offset);
+        putInt32(payload, d + 8, column.length);
+        putInt32(payload, d + 12, column.validCount);
+        putDouble(payload, d + 16, column.minimum);
+        putDouble(payload, d + 24, column.maximum);
+        putDouble(payload, d + 32, column.sum);
+
+        entry.columns.push_back(column);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::writeHeader() {
+    byte header[HEADER_SIZE];
+    copy(begin(ARCHIVE_MAGIC), end(ARCHIVE_MAGIC), header);
+    BitConverter::getBytes(ARCHIVE_VERSION, header, VERSION_OFFSET, 4);
+
+    ofstream stream(columnFile.c_str(), ios::out | ios::trunc | ios::binary);
+    stream.write(header, sizeof(header));
+
+    if (!stream)
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to write columnar archive file '" << columnFile << "'" << endl;
+
+    fileLength = HEADER_SIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ColumnarArchive::readMonthColumn(istream & stream, const MonthEntry & month, const ColumnEntry & column, vector<int32> & values) const {
+    vector<byte> data(column.length);
+    stream.clear();
+    stream.seekg(month.fileOffset + column.offset);
+    stream.read(data.data(), data.size());
+    if (!stream)
+        return false;
+
+    return decodeColumn(data.data(), data.size(), month.recordCount, values);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const ColumnarArchive::ColumnEntry *
+ColumnarArchive::findColumn(const MonthEntry & month, int columnId) {
+    for (const ColumnEntry & column : month.columns) {
+        if (column.columnId == columnId)
+            return &column;
+    }
+
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+ColumnarArchive::findFirstEntryOnOrAfter(int32 monthKey) const {
+    auto it = lower_bound(entries.begin(), entries.end(), monthKey, [](const MonthEntry & entry, int32 value) { return entry.monthKey < value; });
+    return it - entries.begin();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ColumnarArchive::encodeColumn(const vector<int32> & values, vector<byte> & buffer) {
+    if (values.size() == 0)
+        return;
+
+    encodeInt32(buffer, values[0]);
+
+    uint32 deltas[MINI_BLOCK_SIZE];
+    for (size_t blockStart = 1; blockStart < values.size(); blockStart += MINI_BLOCK_SIZE) {
+        int count = min(values.size() - blockStart, static_cast<size_t>(MINI_BLOCK_SIZE));
+
+        //
+        // Zigzag encode the deltas so that small negative deltas also have a small bit width
+        //
+        uint32 maxDelta = 0;
+        for (int i = 0; i < count; i++) {
+            uint32 delta = static_cast<uint32>(values[blockStart + i]) - static_cast<uint32>(values[blockStart + i - 1]);
+            deltas[i] = (delta << 1) ^ static_cast<uint32>(static_cast<int32>(delta) >> 31);
+            maxDelta = max(maxDelta, deltas[i]);
+        }
+
+        int bitWidth = std::bit_width(maxDelta);
+        buffer.push_back(static_cast<byte>(bitWidth));
+
+        uint64_t bits = 0;
+        int bitCount = 0;
+        for (int i = 0; i < count; i++) {
+            bits |= static_cast<uint64_t>(deltas[i]) << bitCount;
+            bitCount += bitWidth;
+            while (bitCount >= 8) {
+                buffer.push_back(static_cast<byte>(bits & 0xFF));
+                bits >>= 8;
+                bitCount -= 8;
+            }
+        }
+
+        if (bitCount > 0)
+            buffer.push_back(static_cast<byte>(bits & 0xFF));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ColumnarArchive::decodeColumn(const byte * data, int length, int count, vector<int32> & values) {
+    values.resize(count);
+    if (count == 0)
+        return length == 0;
+
+    if (length < 4)
+        return false;
+
+    values[0] = BitConverter::toInt32(data, 0);
+
+    int offset = 4;
+    for (int blockStart = 1; blockStart < count; blockStart += MINI_BLOCK_SIZE) {
+        int blockCount = min(count - blockStart, MINI_BLOCK_SIZE);
+        if (offset >= length)
+            return false;
+
+        int bitWidth = static_cast<uint8>(data[offset++]);
+        int blockBytes = ((blockCount * bitWidth) + 7) / 8;
+        if (bitWidth > MAX_BIT_WIDTH || offset + blockBytes > length)
+            return false;
+
+        uint64_t mask = (static_cast<uint64_t>(1) << bitWidth) - 1;
+        uint64_t bits = 0;
+        int bitCount = 0;
+        for (int i = 0; i < blockCount; i++) {
+            while (bitCount < bitWidth) {
+                bits |= static_cast<uint64_t>(static_cast<uint8>(data[offset++])) << bitCount;
+                bitCount += 8;
+            }
+
+            uint32 zigzag = static_cast<uint32>(bits & mask);
+            bits >>= bitWidth;
+            bitCount -= bitWidth;
+
+            uint32 delta = (zigzag >> 1) ^ (0 - (zigzag & 1));
+            values[blockStart + i] = static_cast<int32>(static_cast<uint32>(values[blockStart + i - 1]) + delta);
+        }
+    }
+
+    return offset == length;
+}
+
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COLUMNAR_ARCHIVE_H
+#define COLUMNAR_ARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+#include "WeatherTypes.h"
+#include "Measurement.h"
+#include "DateTimeFields.h"
+
+namespace vws {
+class VantageLogger;
+class MappedArchiveFile;
+
+static const std::string COLUMNAR_ARCHIVE_FILE_SUFFIX = ".columns";
+
+/**
+ * The time and decoded value of a single archive record for one column.
+ */
+struct ColumnSample {
+    DateTimeFields      time;   // The time of the archive record
+    Measurement<double> value;  // The decoded value, which is not valid if the console reported a dashed value
+};
+
+/**
+ * The statistics of one column over a range of archive records. Only the valid values are included in the minimum,
+ * maximum and sum.
+ */
+struct ColumnStatistics {
+    int                 recordCount;  // The number of archive records in the range
+    int                 validCount;   // The number of records with a valid value
+    Measurement<double> minimum;      // The minimum value
+    Measurement<double> maximum;      // The maximum value
+    double              sum;          // The sum of the valid values
+
+    ColumnStatistics() : recordCount(0), validCount(0), sum(0.0) {}
+
+    /**
+     * Add the value of an archive record to the statistics.
+     *
+     * @param value The decoded value
+     */
+    void applyValue(const Measurement<double> & value) {
+        recordCount++;
+        if (!value.isValid())
+            return;
+
+        validCount++;
+        sum += value.getValue();
+
+        if (!minimum.isValid() || value.getValue() < minimum.getValue())
+            minimum = value.getValue();
+
+        if (!maximum.isValid() || value.getValue() > maximum.getValue())
+            maximum = value.getValue();
+    }
+};
+
+/**
+ * A long-term, column oriented copy of the archive that is kept in a file next to the archive. The archive records of
+ * each complete month, that is each month before the month of the newest archive record, are stored in a month block.
+ * A month block holds a time column and one column per ArchiveColumn. Each column is delta encoded and bit packed
+ * and has its own statistics in the block directory, so a query of a few columns only reads those columns and the
+ * verification can check each column without the archive. Like the day summary store, the columnar archive is a
+ * cache of the archive; if it is found to be inconsistent with the archive it is rebuilt.
+ *
+ * The file is an 8 byte header followed by variable length month blocks:
+ *     Header:          "VWSC", version
+ *     Block header:    payload length, month key, index of the first archive record of the month, number of archive records, number of columns
+ *     Block directory: for each column: column ID, offset of the data within the payload, length of the data, valid count,
+ *                      minimum, maximum, sum
+ *     Column data
+ *
+ * The payload is the block directory and the column data. The integer fields are little endian, the minimum, maximum and
+ * sum are little endian IEEE doubles in the decoded units. The time column has an ID of -1 and holds the minute of the
+ * month of each record.
+ *
+ * A column is the raw values of the column as the console stores them in the archive packet. The first value is stored
+ * as a 32 bit integer, the remaining values are stored as zigzag encoded deltas in mini-blocks of 128 values. Each
+ * mini-block is a one byte bit width followed by the deltas packed with that width.
+ */
+class ColumnarArchive {
+public:
+    static constexpr int TIME_COLUMN_ID = -1;
+
+    /**
+     * Constructor that loads the columnar archive file if it exists.
+     *
+     * @param columnFile The path of the columnar archive file
+     */
+    explicit ColumnarArchive(const std::string & columnFile);
+
+    /**
+     * Destructor.
+     */
+    ~ColumnarArchive();
+
+    /**
+     * Bring the columnar archive up to date with the archive. If it is consistent with the archive only the months that
+     * were completed since the last synchronization are encoded and appended to the file, otherwise it is rebuilt.
+     *
+     * @param archive The archive being encoded
+     */
+    void synchronize(const MappedArchiveFile & archive);
+
+    /**
+     * Rebuild the columnar archive from the archive and rewrite the file.
+     *
+     * @param archive The archive being encoded
+     */
+    void rebuild(const MappedArchiveFile & archive);
+
+    /**
+     * Check if the columnar archive is consistent with the archive. Missing months at the end of the archive are still consistent.
+     *
+     * @param archive The archive being encoded
+     * @return True if the month blocks match the archive
+     */
+    bool isConsistent(const MappedArchiveFile & archive) const;
+
+    /**
+     * Decode every month block and compare each value and the block statistics with the archive records.
+     *
+     * @param archive The archive that the columnar archive was built from
+     * @return True if all of the month blocks match the archive
+     */
+    bool verify(const MappedArchiveFile & archive) const;
+
+    /**
+     * Remove all months from the columnar archive and its file.
+     */
+    void clear();
+
+    /**
+     * Read the values of one column for the archive records between the specified times (inclusive). Only the time column
+     * and the requested column of the months that overlap the range are read.
+     *
+     * @param startTime The lower bound of the query
+     * @param endTime   The upper bound of the query
+     * @param columnId  The ID of the ArchiveColumn to read
+     * @param samples   The samples that were read, which are appended to
+     * @return True if the file was read successfully
+     */
+    bool readColumn(const DateTimeFields & startTime, const DateTimeFields & endTime, int columnId, std::vector<ColumnSample> & samples) const;
+
+    /**
+     * Write a description of each month block and its columns.
+     *
+     * @param os The stream to which the description is written
+     */
+    void dump(std::ostream & os) const;
+
+    /**
+     * Get the number of archive records that have been encoded into the columnar archive. This is also the index of the
+     * first archive record that is not included.
+     *
+     * @return The number of archive records
+     */
+    int getSummarizedRecordCount() const;
+
+    /**
+     * Get the number of month blocks.
+     *
+     * @return The number of months
+     */
+    int getMonthCount() const;
+
+private:
+    static constexpr int HEADER_SIZE = 8;
+    static constexpr int ARCHIVE_VERSION = 1;
+    static constexpr int VERSION_OFFSET = 4;
+    static constexpr int BLOCK_HEADER_SIZE = 20;
+    static constexpr int DIRECTORY_ENTRY_SIZE = 40;
+    static constexpr int MINI_BLOCK_SIZE = 128;
+
+    struct ColumnEntry {
+        int32  columnId;     // The ID of the column or TIME_COLUMN_ID
+        int32  offset;       // The offset of the column data within the payload
+        int32  length;       // The length of the column data
+        int32  validCount;   // The number of valid values
+        double minimum;      // The minimum valid value
+        double maximum;      // The maximum valid value
+        double sum;          // The sum of the valid values
+    };
+
+    struct MonthEntry {
+        int32                    monthKey;     // The date stamp of the month without the day, (year - 2000) * 16 + month
+        int32                    firstRecord;  // The index of the first archive record of the month
+        int32                    recordCount;  // The number of archive records of the month
+        size_t                   fileOffset;   // The offset of the payload in the file
+        int32                    length;       // The length of the payload
+        std::vector<ColumnEntry> columns;      // The block directory
+    };
+
+    /**
+     * Load the block headers and directories from the file.
+     *
+     * @return True if the file was loaded
+     */
+    bool load();
+
+    /**
+     * Encode the complete months in the archive that are not yet in the columnar archive and append them to the file.
+     *
+     * @param archive The archive being encoded
+     */
+    void encodeNewMonths(const MappedArchiveFile & archive);
+
+    /**
+     * Encode the archive records of one month into a block payload.
+     *
+     * @param archive The archive being encoded
+     * @param entry   The month entry, whose records are encoded and whose directory is filled
+     * @param payload The buffer to which the payload is appended
+     */
+    static void encodeMonth(const MappedArchiveFile & archive, MonthEntry & entry, std::vector<byte> & payload);
+
+    /**
+     * Write an empty columnar archive file.
+     */
+    void writeHeader();
+
+    /**
+     * Read and decode a column of a month block.
+     *
+     * @param stream The stream of the file
+     * @param month  The month block
+     * @param column The directory entry of the column
+     * @param values The decoded raw values
+     * @return True if the column was read and decoded
+     */
+    bool readMonthColumn(std::istream & stream, const MonthEntry & month, const ColumnEntry & column, std::vector<int32> & values) const;
+
+    /**
+     * Find the directory entry of a column within a month block.
+     *
+     * @param month    The month block
+     * @param columnId The ID of the column
+     * @return The directory entry or nullptr if the block does not have the column
+     */
+    static const ColumnEntry * findColumn(const MonthEntry & month, int columnId);
+
+    /**
+     * Find the first month in the columnar archive whose month key is on or after the specified key.
+     *
+     * @param monthKey The month key to search for
+     * @return The index of the entry or the number of entries if all months are before the key
+     */
+    int findFirstEntryOnOrAfter(int32 monthKey) const;
+
+    /**
+     * Delta encode and bit pack a column of raw values.
+     *
+     * @param values The raw values
+     * @param buffer The buffer to which the encoded column is appended
+     */
+    static void encodeColumn(const std::vector<int32> & values, std::vector<byte> & buffer);
+
+    /**
+     * Decode a column that was encoded by encodeColumn().
+     *
+     * @param data   The encoded column
+     * @param length The length of the encoded column
+     * @param count  The number of values in the column
+     * @param values The decoded raw values
+     * @return True if the column was decoded successfully
+     */
+    static bool decodeColumn(const byte * data, int length, int count, std::vector<int32> & values);
+
+    std::string             columnFile;  // The path of the columnar archive file
+    std::vector<MonthEntry> entries;     // One entry per month block
+    size_t                  fileLength;  // The length of the valid portion of the file
+    VantageLogger &         logger;
+};
+}
+
+#endif
@@ -20,9 +20,12 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include <memory>
+#include <chrono>
 
 namespace vws {
 class ResponseHandler;
+class ResponseStream;
 
 static const std::string RESPONSE_TOKEN = "\"response\"";
 static const std::string RESULT_TOKEN = "\"result\"";
@@ -90,11 +93,14 @@ struct CommandData {
      */
     friend std::ostream & operator<<(std::ostream & os, const CommandData & commandData);
 
-    ResponseHandler *   responseHandler;  // The response handler that will process the response
-    int                 socketId;         // The unique socket identifier on which to send the response
-    std::string         commandName;      // The command that was processed
-    CommandArgumentList arguments;        // The arguments as a list of name/value pairs
-    std::string         response;         // The response to the command
+    ResponseHandler *                     responseHandler; // The response handler that will process the response
+    int                                   socketId;        // The unique socket identifier on which to send the response
+    std::string                           commandName;     // The command that was processed
+    CommandArgumentList                   arguments;       // The arguments as a list of name/value pairs
+    std::string                           response;        // The response to the command, or the beginning of the response if the response is streamed
+    std::shared_ptr<ResponseStream>       responseStream;  // The optional stream that produces the data of a large response
+    std::string                           responseTrailer; // The end of a streamed response that is written after the data produced by the stream
+    std::chrono::steady_clock::time_point queueTime;       // The time the command was queued, used to report how long the command waited
 };
 
 }
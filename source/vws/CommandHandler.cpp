@@ -42,12 +42,38 @@ CommandHandler::processNextCommand() {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CommandHandler::processQueuedCommands() {
+    std::vector<CommandData> commands;
+
+    if (commandQueue.consumeAllCommands(commands)) {
+        for (CommandData & commandData : commands)
+            processCommand(commandData);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 CommandHandler::processCommand(CommandData & commandData) {
     handleCommand(commandData);
-    commandData.response.append("}");
+    sendResponse(commandData);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CommandHandler::sendResponse(CommandData & commandData) {
+    //
+    // The data of a streamed response is written after the response, so the response must be closed after the stream
+    //
+    if (commandData.responseStream != NULL)
+        commandData.responseTrailer.append("}");
+    else
+        commandData.response.append("}");
+
     commandData.responseHandler->handleCommandResponse(commandData);
 }
 
@@ -51,6 +51,11 @@ public:
      */
     void processNextCommand();
 
+    /**
+     * Retrieve every command that is on the queue and process them as one batch.
+     */
+    virtual void processQueuedCommands();
+
     /**
      * Process a command.
      *
@@ -74,6 +79,13 @@ public:
     virtual bool offerCommand(const CommandData & commandData) = 0;
 
 protected:
+    /**
+     * Close the response of a command that has been handled and pass it to the response handler.
+     *
+     * @param commandData The command whose response is complete
+     */
+    void sendResponse(CommandData & commandData);
+
     CommandQueue commandQueue;
 };
 
@@ -38,17 +38,19 @@ CommandQueue::~CommandQueue() {
 bool
 CommandQueue::isCommandAvailable() const {
     std::scoped_lock<std::mutex> guard(mutex);
-    return !commandQueue.empty();
+    return !priorityQueue.empty() || !commandQueue.empty();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-CommandQueue::queueCommand(const CommandData & command) {
+CommandQueue::queueCommand(const CommandData & command, bool priority) {
     {
         std::scoped_lock<std::mutex> guard(mutex);
-        logger.log(VantageLogger::VANTAGE_DEBUG2) << "Queuing command " << command.commandName << endl;
-        commandQueue.push(command);
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Queuing " << (priority ? "priority " : "") << "command " << command.commandName << endl;
+        std::queue<CommandData> & queue = priority ? priorityQueue : commandQueue;
+        queue.push(command);
+        queue.back().queueTime = std::chrono::steady_clock::now();
     }
 
     cv.notify_all();
@@ -65,16 +67,36 @@ CommandQueue::consumeCommand(CommandData & command) {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
-CommandQueue::retrieveNextCommand(CommandData & command) {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Attempting to retrieve command" << endl;
-    if (commandQueue.empty()) {
-        logger.log(VantageLogger::VANTAGE_DEBUG3) << "No command in queue to consume" << endl;
+CommandQueue::consumeAllCommands(vector<CommandData> & commands) {
+    std::scoped_lock<std::mutex> guard(mutex);
+    commands.clear();
+
+    CommandData command;
+    while (retrieveNextCommand(command))
+        commands.push_back(command);
+
+    return !commands.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+CommandQueue::retrieveNextCommand(CommandData & command, bool priorityOnly) {
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Attempting to retrieve command" << endl;
+
+    std::queue<CommandData> * queue;
+    if (!priorityQueue.empty())
+        queue = &priorityQueue;
+    else if (!priorityOnly && !commandQueue.empty())
+        queue = &commandQueue;
+    else {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "No command in queue to consume" << endl;
         return false;
     }
 
-    command = commandQueue.front();
-    commandQueue.pop();
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Retrieved command " << command.commandName << endl;
+    command = queue->front();
+    queue->pop();
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Retrieved command " << command.commandName << endl;
 
     return true;
 }
@@ -82,29 +104,29 @@ CommandQueue::retrieveNextCommand(CommandData & command) {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
-CommandQueue::waitForCommand(CommandData & command) {
+CommandQueue::waitForCommand(CommandData & command, bool priorityOnly) {
     std::unique_lock<std::mutex> guard(mutex);
 
     //
     // If there is something in the queue, return it immediately
     //
-    if (retrieveNextCommand(command))
+    if (retrieveNextCommand(command, priorityOnly))
         return true;
 
     //
     // Wait for the condition variable to be woken
     //
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Waiting for command" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Waiting for command" << endl;
     cv.wait(guard);
 
-    return retrieveNextCommand(command);
+    return retrieveNextCommand(command, priorityOnly);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 CommandQueue::interrupt() {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Interrupting threads waiting for commands" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Interrupting threads waiting for commands" << endl;
     cv.notify_all();
 }
 
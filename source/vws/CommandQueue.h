@@ -19,6 +19,7 @@
 
 #include <queue>
 #include <string>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 
@@ -27,7 +28,8 @@ class VantageLogger;
 class CommandData;
 
 /**
- * Class to queue commands for a thread.
+ * Class to queue commands for one or more threads. Commands can be queued in a priority lane. Commands in the priority lane
+ * are always consumed before the other commands, and a thread can choose to only consume priority commands.
  */
 class CommandQueue {
 public:
@@ -52,9 +54,10 @@ public:
     /**
      * Queue a command.
      *
-     * @param command The command to be queued
+     * @param command  The command to be queued
+     * @param priority Whether the command is queued in the priority lane
      */
-    void queueCommand(const CommandData & command);
+    void queueCommand(const CommandData & command, bool priority = false);
 
     /**
      * Consume the command at the head of the queue with locking.
@@ -64,13 +67,22 @@ public:
      */
     bool consumeCommand(CommandData & command);
 
+    /**
+     * Consume every command on the queue with locking. The commands in the priority lane are first.
+     *
+     * @param commands The commands that were removed from the queue, in the order they will be processed
+     * @return True if at least one command was consumed
+     */
+    bool consumeAllCommands(std::vector<CommandData> & commands);
+
     /**
      * Wait for a command to appear on the queue.
      *
-     * @param command The command that was copied from the head of the queue
+     * @param command      The command that was copied from the head of the queue
+     * @param priorityOnly Whether to only wait for commands in the priority lane
      * @return True if a command was actually copied. If false, the parameter command is not changed.
      */
-    bool waitForCommand(CommandData & command);
+    bool waitForCommand(CommandData & command, bool priorityOnly = false);
 
     /**
      * Interrupt a thread that is waiting for a command.
@@ -85,13 +97,15 @@ public:
 
 private:
     /**
-     * Get and pop the command at the head of the queue without locking.
+     * Get and pop the command at the head of the queue without locking. The priority lane is checked first.
      *
-     * @param command The command that was copied from the head of the queue
+     * @param command      The command that was copied from the head of the queue
+     * @param priorityOnly Whether to only retrieve a command from the priority lane
      * @return True if an command was actually copied. If false, the parameter command is not changed.
      */
-    bool retrieveNextCommand(CommandData & command);
+    bool retrieveNextCommand(CommandData & command, bool priorityOnly = false);
 
+    std::queue<CommandData> priorityQueue;  // The queue on which to store the commands in the priority lane
     std::queue<CommandData> commandQueue;   // The queue on which to store commands
     mutable std::mutex      mutex;          // The mutex to protect the queue against multi-threaded contention
     std::condition_variable cv;             // The condition variable used for notifying a thread that a command is available
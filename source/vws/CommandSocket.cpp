@@ -19,18 +19,22 @@
 
 #ifndef __CYGWIN__
 #include <sys/eventfd.h>
+#include <sys/epoll.h>
 #endif
 #include <sys/socket.h>
-#include <sys/select.h>
+#include <poll.h>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
 #include <iostream>
 #include <vector>
 #include "json.hpp"
 
 #include "CommandQueue.h"
 #include "ResponseHandler.h"
+#include "ResponseStream.h"
 #include "CommandData.h"
 #include "CommandHandler.h"
 #include "VantageLogger.h"
@@ -47,14 +51,26 @@ commandThreadEntry(CommandSocket * cs) {
     cs->mainLoop();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static bool
+setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0)
+        return false;
+
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 CommandSocket::CommandSocket(int port) : port(port),
+                                         listenFd(-1),
                                          nextSocketSequence(100),
-                                         responseEventFd(-1),
                                          terminating(false),
+                                         epollFd(-1),
+                                         responseEventFd(-1),
                                          commandThread(NULL),
-                                         listenFd(-1),
                                          logger(VantageLogger::getLogger("CommandSocket")) {
 
 }
@@ -72,8 +88,13 @@ CommandSocket::~CommandSocket() {
         responseEventFd = -1;
     }
 
-    for (SocketId socket : socketList)
-        close(socket.fd);
+    if (epollFd != -1) {
+        close(epollFd);
+        epollFd = -1;
+    }
+
+    for (auto & entry : connections)
+        close(entry.second.socketId.fd);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,68 +109,9 @@ CommandSocket::addCommandHandler(CommandHandler & handler) {
 void
 CommandSocket::mainLoop() {
     logger.log(VantageLogger::VANTAGE_INFO) << "Entering command socket thread with listen fd of " << listenFd << " and eventfd of " << responseEventFd << endl;
-    struct timeval tv;
     while (!terminating) {
         try {
-            fd_set readFdSet;
-            int nfds = max(listenFd, responseEventFd);
-
-            tv.tv_sec = 1;
-            tv.tv_usec = 0;
-
-            FD_ZERO(&readFdSet); // @suppress("Symbol is not resolved") @suppress("Statement has no effect")
-            FD_SET(listenFd, &readFdSet);
-
-            if (responseEventFd != -1)
-                FD_SET(responseEventFd, &readFdSet);
-
-            logger.log(VantageLogger::VANTAGE_DEBUG3) << "Adding " << socketList.size() << " file descriptors to read mask" << endl;
-
-            for (const SocketId & socketId : socketList) {
-                logger.log(VantageLogger::VANTAGE_DEBUG3) << "Adding fd " << socketId.fd << " to read mask" << endl;
-                FD_SET(socketId.fd, &readFdSet);
-                nfds = std::max(socketId.fd, nfds);
-            }
-
-            nfds++;
-
-            logger.log(VantageLogger::VANTAGE_DEBUG3) << "Entering select()  nfds = " << nfds << endl;
-            int n = select(nfds, &readFdSet, NULL, NULL, &tv);
-            logger.log(VantageLogger::VANTAGE_DEBUG3) << "select()  returned  " << n << endl;
-
-            if (n < 0) {
-                logger.log(VantageLogger::VANTAGE_ERROR) << "select() returned an error (" << logger.strerror() << ")" << endl;
-                continue;
-            }
-
-            if (FD_ISSET(listenFd, &readFdSet))
-                acceptConnection();
-
-            //
-            // Windows does not support eventfd, so just poll for responses to be processed.
-            // This might mean a response will sit in the queue for one second or so, until
-            // the select() call times out
-            //
-            if (responseEventFd != -1) {
-                if (FD_ISSET(responseEventFd, &readFdSet))
-                    sendCommandResponses();
-            }
-            else
-                sendCommandResponses();
-
-            for (vector<SocketId>::iterator it = socketList.begin(); it != socketList.end(); ) {
-                if (FD_ISSET(it->fd, &readFdSet)) {
-                    if (!readCommand(*it)) {
-                        logger.log(VantageLogger::VANTAGE_DEBUG3) << "Closing socket " << *it <<  endl;
-                        close(it->fd);
-                        it = socketList.erase(it);
-                    }
-                    else
-                        ++it;
-                }
-                else
-                    ++it;
-            }
+            processEvents();
         }
         catch (const std::exception & e) {
             logger.log(VantageLogger::VANTAGE_ERROR) << "Caught exception in CommandSocket::mainLoop. " << e.what() << endl;
@@ -162,6 +124,81 @@ CommandSocket::mainLoop() {
     logger.log(VantageLogger::VANTAGE_INFO) << "Exiting command socket thread" << endl;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CommandSocket::processEvents() {
+#ifndef __CYGWIN__
+    struct epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(epollFd, events, MAX_EVENTS, EVENT_TIMEOUT_MILLIS);
+
+    if (n < 0) {
+        if (errno != EINTR)
+            logger.log(VantageLogger::VANTAGE_ERROR) << "epoll_wait() returned an error (" << logger.strerror() << ")" << endl;
+
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        uint64_t eventId = events[i].data.u64;
+        uint32_t eventMask = events[i].events;
+
+        if (eventId == LISTEN_EVENT_ID)
+            acceptConnections();
+        else if (eventId == RESPONSE_EVENT_ID)
+            sendCommandResponses();
+        else
+            handleConnectionEvents(static_cast<int>(eventId), (eventMask & EPOLLIN) != 0, (eventMask & EPOLLOUT) != 0,
+                                   (eventMask & (EPOLLHUP | EPOLLRDHUP)) != 0, (eventMask & EPOLLERR) != 0);
+    }
+#else
+    vector<struct pollfd> pollFds;
+    vector<int> eventIds;
+
+    struct pollfd pollFd;
+    pollFd.fd = listenFd;
+    pollFd.events = POLLIN;
+    pollFd.revents = 0;
+    pollFds.push_back(pollFd);
+    eventIds.push_back(LISTEN_EVENT_ID);
+
+    for (const auto & entry : connections) {
+        pollFd.fd = entry.second.socketId.fd;
+        pollFd.events = entry.second.events;
+        pollFds.push_back(pollFd);
+        eventIds.push_back(entry.first);
+    }
+
+    int n = poll(pollFds.data(), pollFds.size(), EVENT_TIMEOUT_MILLIS);
+
+    if (n < 0) {
+        if (errno != EINTR)
+            logger.log(VantageLogger::VANTAGE_ERROR) << "poll() returned an error (" << logger.strerror() << ")" << endl;
+
+        return;
+    }
+
+    //
+    // Windows does not support eventfd, so just poll for responses to be processed.
+    // This might mean a response will sit in the queue for one second or so, until
+    // the poll() call times out
+    //
+    sendCommandResponses();
+
+    for (int i = 0; i < pollFds.size(); i++) {
+        short eventMask = pollFds[i].revents;
+        if (eventMask == 0)
+            continue;
+
+        if (eventIds[i] == LISTEN_EVENT_ID)
+            acceptConnections();
+        else
+            handleConnectionEvents(eventIds[i], (eventMask & POLLIN) != 0, (eventMask & POLLOUT) != 0,
+                                   (eventMask & POLLHUP) != 0, (eventMask & (POLLERR | POLLNVAL)) != 0);
+    }
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
@@ -169,6 +206,7 @@ CommandSocket::terminate() {
     logger.log(VantageLogger::VANTAGE_INFO) << "Received request to terminate command socket thread" << endl;
     terminating = true;
 }
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
@@ -192,6 +230,29 @@ CommandSocket::start() {
 
 #ifndef __CYGWIN__
     responseEventFd = eventfd(0, EFD_NONBLOCK);
+
+    epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Could not create epoll file descriptor (" << logger.strerror() << ")" << endl;
+        return false;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_EVENT_ID;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) < 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Could not add listen socket to epoll (" << logger.strerror() << ")" << endl;
+        return false;
+    }
+
+    if (responseEventFd != -1) {
+        event.events = EPOLLIN;
+        event.data.u64 = RESPONSE_EVENT_ID;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, responseEventFd, &event) < 0) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Could not add response eventfd to epoll (" << logger.strerror() << ")" << endl;
+            return false;
+        }
+    }
 #endif
 
     commandThread = new thread(commandThreadEntry, this);
@@ -205,92 +266,157 @@ void
 CommandSocket::dumpSocketList() const {
     cout << "Socket list: [";
 
-    for (vector<SocketId>::const_iterator it = socketList.begin(); it != socketList.end(); ++it) {
-        cout << *it << ", ";
+    for (const auto & entry : connections) {
+        cout << entry.second.socketId << ", ";
     }
 
     cout << "]" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CommandSocket::handleConnectionEvents(int sequence, bool readable, bool writable, bool hangup, bool error) {
+    auto it = connections.find(sequence);
+
+    //
+    // The connection may have been closed while processing an earlier event
+    //
+    if (it == connections.end())
+        return;
+
+    Connection & connection = it->second;
+
+    if (error) {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Error reported on socket " << connection.socketId << ", closing socket" << endl;
+        closeConnection(sequence);
+        return;
+    }
+
+    //
+    // A hangup is reported for as long as the socket is polled, even while the connection is not reading, so the
+    // connection must be closed or the event loop would spin. The client will not read the responses of any commands
+    // in progress, which are discarded when they arrive.
+    //
+    if (hangup) {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Socket " << connection.socketId << " was closed by the other end, closing socket" << endl;
+        closeConnection(sequence);
+        return;
+    }
+
+    //
+    // Write any responses that were queued while reading commands, even if the event was not a writable event,
+    // as the socket is most likely writable
+    //
+    bool keepOpen = true;
+    if (readable)
+        keepOpen = readCommands(connection);
 
+    if (keepOpen)
+        keepOpen = writeOutput(connection);
+
+    if (keepOpen)
+        updateEvents(connection);
+    else
+        closeConnection(sequence);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
-CommandSocket::readCommand(const SocketId & socketId) {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Reading data from socket " << socketId << endl;
+CommandSocket::readCommands(Connection & connection) {
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Reading data from socket " << connection.socketId << endl;
 
-    char buffer[10240];
-    int readPosition = 0;
+    char buffer[READ_BUFFER_SIZE];
 
     //
-    // First read the header
+    // Read until the socket is drained, unless the client has too many commands in progress
     //
-    while (readPosition < HEADER_SIZE) {
-        int nbytes = read(socketId.fd, &buffer[readPosition], HEADER_SIZE - readPosition);
+    while (isAcceptingCommands(connection)) {
+        ssize_t nbytes = read(connection.socketId.fd, buffer, sizeof(buffer));
+
         //
         // If 0 bytes are read that most likely means the other end has closed the socket
         //
         if (nbytes == 0) {
-            logger.log(VantageLogger::VANTAGE_DEBUG1) << "Attempted read of command header indicates the socket has been closed by the other end, closing socket. Read returned 0." << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Read indicates the socket " << connection.socketId << " has been closed by the other end, closing socket. Read returned 0." << endl;
             return false;
         }
         else if (nbytes < 0) {
-            logger.log(VantageLogger::VANTAGE_WARNING) << "Read() returned an error while reading command header, closing socket. (" << logger.strerror() << ")" << endl;
+            if (errno == EINTR)
+                continue;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Read() returned an error on socket " << connection.socketId << ", closing socket. (" << logger.strerror() << ")" << endl;
             return false;
         }
-        else {
-            readPosition += nbytes;
-        }
-    }
 
-    if (strncmp(buffer, HEADER_TEXT, strlen(HEADER_TEXT)) != 0) {
-        logger.log(VantageLogger::VANTAGE_WARNING) << "Command does not start with header text. Received '" << buffer << "'" << endl;
-        return true;
-    }
+        connection.input.append(buffer, nbytes);
 
-    //
-    // Now pull out the size of the upcoming command
-    //
-    int messageLength = atoi(&buffer[strlen(HEADER_TEXT) + 1]);
-    if (messageLength < MIN_COMMAND_LENGTH) {
-        logger.log(VantageLogger::VANTAGE_WARNING) << "Command length in header is too small. Received " << messageLength << endl;
-        return false;
+        if (!processInput(connection))
+            return false;
     }
 
-    //
-    // Read the command body
-    //
-    readPosition = 0;
-    while (readPosition < messageLength) {
-        int nbytes = read(socketId.fd, &buffer[readPosition], messageLength - readPosition);
-        if (nbytes == 0) {
-            logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to read command body, closing socket. Read returned 0." << endl;
-            return false;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+CommandSocket::processInput(Connection & connection) {
+    while (connection.input.length() >= HEADER_SIZE && isAcceptingCommands(connection)) {
+        if (connection.input.compare(0, strlen(HEADER_TEXT), HEADER_TEXT) != 0) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Command does not start with header text. Received '" << connection.input.substr(0, HEADER_SIZE)
+                                                       << "'. Discarding " << connection.input.length() << " bytes" << endl;
+            connection.input.clear();
+            break;
         }
-        else if (nbytes < 0) {
-            logger.log(VantageLogger::VANTAGE_WARNING) << "Read() returned an error while reading command body, closing socket. (" << logger.strerror() << ")" << endl;
+
+        //
+        // Now pull out the size of the upcoming command
+        //
+        int messageLength = atoi(connection.input.substr(LENGTH_OFFSET, LENGTH_DIGITS).c_str());
+        if (messageLength < MIN_COMMAND_LENGTH) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Command length in header is too small. Received " << messageLength << endl;
             return false;
         }
-        else {
-            readPosition += nbytes;
+
+        if (messageLength > MAX_COMMAND_LENGTH) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Command length in header is too large. Received " << messageLength << ", closing socket " << connection.socketId << endl;
+            return false;
         }
+
+        if (connection.input.length() < HEADER_SIZE + messageLength)
+            break;
+
+        string commandJson = connection.input.substr(HEADER_SIZE, messageLength);
+        connection.input.erase(0, HEADER_SIZE + messageLength);
+        processCommand(connection, commandJson);
     }
 
-    //
-    // NULL terminate the string
-    //
-    buffer[readPosition] = '\0';
+    return true;
+}
 
-    //
-    // At this point the command is in buffer. Use auto-conversion to get it into the required std::string
-    //
-    CommandData commandData(*this, socketId.sequence);
-    if (!commandData.setCommandFromJson(string(buffer))) {
-        logger.log(VantageLogger::VANTAGE_ERROR) << "Received invalid JSON command: '" << buffer << "'" << endl;
-        return true;
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+CommandSocket::isAcceptingCommands(const Connection & connection) const {
+    return connection.pendingResponses.size() + connection.activeCommands < MAX_PENDING_RESPONSES;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CommandSocket::processCommand(Connection & connection, const std::string & commandJson) {
+    CommandData commandData(*this, connection.socketId.sequence);
+    if (!commandData.setCommandFromJson(commandJson)) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Received invalid JSON command: '" << commandJson << "'" << endl;
+        return;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Offering command " << commandData.commandName << " that was received on socket " << socketId << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Offering command " << commandData.commandName << " that was received on socket " << connection.socketId << endl;
     bool consumed = false;
     for (auto handler : commandHandlers) {
         consumed = consumed || handler->offerCommand(commandData);
@@ -300,13 +426,118 @@ CommandSocket::readCommand(const SocketId & socketId) {
     // If none of the command handlers consumed the command, then immediately send a failure response.
     // There is no need to queue the response as this is running on the socket thread.
     //
-    if (!consumed) {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Command " << commandData.commandName << " was not consumed by any command handlers. Command is being ignored as an unrecognized command." << endl;
+    if (consumed)
+        connection.activeCommands++;
+    else {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Command " << commandData.commandName << " was not consumed by any command handlers. Command is being ignored as an unrecognized command." << endl;
         commandData.response.append(CommandData::buildFailureString("Unrecognized command"));
-        sendCommandResponse(commandData);
+        commandData.response.append("}");
+        connection.pendingResponses.push_back(commandData);
     }
+}
 
-    return true;
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+CommandSocket::writeOutput(Connection & connection) {
+    while (true) {
+        while (connection.outputOffset < connection.output.length()) {
+            ssize_t nbytes = send(connection.socketId.fd,
+                                  connection.output.data() + connection.outputOffset,
+                                  connection.output.length() - connection.outputOffset,
+                                  MSG_NOSIGNAL);
+            if (nbytes < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                //
+                // The socket buffer is full, the rest of the output will be written when the socket is writable
+                //
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return true;
+
+                logger.log(VantageLogger::VANTAGE_ERROR) << "Write of response to command server socket failed (" << logger.strerror() << "). Socket: " << connection.socketId <<  endl;
+                return false;
+            }
+
+            connection.outputOffset += nbytes;
+        }
+
+        connection.output.clear();
+        connection.outputOffset = 0;
+
+        //
+        // Refill the output with the next chunk of the streamed response or with the next response
+        //
+        if (connection.stream != NULL) {
+            if (!connection.stream->nextChunk(connection.output)) {
+                connection.output.append(connection.streamTrailer);
+                connection.output.append(RESPONSE_TERMINATOR);
+                connection.stream.reset();
+                connection.streamTrailer.clear();
+            }
+        }
+        else if (!connection.pendingResponses.empty()) {
+            CommandData & commandData = connection.pendingResponses.front();
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Writing response on socket " << connection.socketId << " Response: '" << commandData.response << "'" << endl;
+
+            connection.output.swap(commandData.response);
+            if (commandData.responseStream != NULL) {
+                connection.stream = commandData.responseStream;
+                connection.streamTrailer = commandData.responseTrailer;
+            }
+            else
+                connection.output.append(RESPONSE_TERMINATOR);
+
+            connection.pendingResponses.pop_front();
+        }
+        else
+            return true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CommandSocket::updateEvents(Connection & connection) {
+    unsigned int events = 0;
+
+    if (isAcceptingCommands(connection))
+        events |= POLLIN;
+
+    if (connection.outputOffset < connection.output.length() || connection.stream != NULL || !connection.pendingResponses.empty())
+        events |= POLLOUT;
+
+    if (events == connection.events)
+        return;
+
+    connection.events = events;
+
+#ifndef __CYGWIN__
+    struct epoll_event event;
+    event.events = EPOLLRDHUP | ((events & POLLIN) != 0 ? EPOLLIN : 0) | ((events & POLLOUT) != 0 ? EPOLLOUT : 0);
+    event.data.u64 = connection.socketId.sequence;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.socketId.fd, &event) < 0)
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Could not modify epoll events for socket " << connection.socketId << " (" << logger.strerror() << ")" << endl;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CommandSocket::closeConnection(int sequence) {
+    auto it = connections.find(sequence);
+    if (it == connections.end())
+        return;
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Closing socket " << it->second.socketId <<  endl;
+
+#ifndef __CYGWIN__
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.socketId.fd, NULL);
+#endif
+
+    close(it->second.socketId.fd);
+    connections.erase(it);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -314,12 +545,12 @@ CommandSocket::readCommand(const SocketId & socketId) {
 void
 CommandSocket::handleCommandResponse(const CommandData & commandData) {
     std::lock_guard<std::mutex> guard(mutex);
-    logger.log(VantageLogger::VANTAGE_DEBUG2) << "Queuing response" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Queuing response" << endl;
     responseQueue.push(commandData);
 
     if (responseEventFd != -1) {
         uint64_t eventId = 1;
-        logger.log(VantageLogger::VANTAGE_DEBUG3) << "Triggering eventfd" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Triggering eventfd" << endl;
         if (write(responseEventFd, &eventId, sizeof(eventId)) < 0) {
             logger.log(VantageLogger::VANTAGE_WARNING) << "Could not write to eventfd (" << logger.strerror() << ")" <<  endl;
         }
@@ -330,36 +561,29 @@ CommandSocket::handleCommandResponse(const CommandData & commandData) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 CommandSocket::sendCommandResponse(const CommandData & commandData) {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Attempting to send response on socketId " << commandData.socketId << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Attempting to send response on socketId " << commandData.socketId << endl;
 
+    auto it = connections.find(commandData.socketId);
     //
-    // Terminate the JSON element
+    // The client may have hung up while the command was in progress
     //
-    const char * responseTerminator = "\n\n";
-    string response(commandData.response);
-    response.append(responseTerminator);
+    if (it == connections.end()) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Discarding response because the socket with ID " << commandData.socketId << " could not be found. Response: " << commandData.response << endl;
+        return;
+    }
 
-    const char * responseBuffer = response.c_str();
+    Connection & connection = it->second;
+    connection.pendingResponses.push_back(commandData);
+    if (connection.activeCommands > 0)
+        connection.activeCommands--;
 
     //
-    // Lookup the socket file descriptor
+    // Commands that were received while the connection had too many commands in progress may be waiting in the input buffer
     //
-    int fd = -1;
-    for (const SocketId & socket : socketList) {
-        if (socket.sequence == commandData.socketId)
-            fd = socket.fd;
-    }
-
-    if (fd != -1) {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Writing response on fd " << fd << " Response: '" << response << "'" << endl;
-
-        if (write(fd, responseBuffer, strlen(responseBuffer)) < 0) {
-            logger.log(VantageLogger::VANTAGE_ERROR) << "Write of response to command server socket failed (" << logger.strerror() << "). fd = " << fd <<  endl;
-        }
-    }
+    if (processInput(connection) && writeOutput(connection))
+        updateEvents(connection);
     else
-        logger.log(VantageLogger::VANTAGE_ERROR) << "Discarding response because the socket with ID " << commandData.socketId << " could not be found. Response: " << response << endl;
-
+        closeConnection(commandData.socketId);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -369,15 +593,21 @@ CommandSocket::sendCommandResponses() {
     if (responseEventFd != -1) {
         uint64_t eventId = 0;
         read(responseEventFd, &eventId, sizeof(eventId));
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Read " << eventId << " from eventfd" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Read " << eventId << " from eventfd" << endl;
     }
 
-    std::lock_guard<std::mutex> guard(mutex);
+    //
+    // Take the queued responses so the mutex is not held while the responses are written
+    //
+    std::queue<CommandData> responses;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        responses.swap(responseQueue);
+    }
 
-    while (!responseQueue.empty()) {
-        CommandData commandData = responseQueue.front();
-        responseQueue.pop();
-        sendCommandResponse(commandData);
+    while (!responses.empty()) {
+        sendCommandResponse(responses.front());
+        responses.pop();
     }
 }
 
@@ -398,6 +628,11 @@ CommandSocket::createListenSocket() {
         return false;
     }
 
+    if (!setNonBlocking(listenFd)) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Could not make command server socket non-blocking (" << logger.strerror() << ")" << endl;
+        return false;
+    }
+
     struct sockaddr_in address;
     int addrlen = sizeof(address);
     address.sin_family = AF_INET;
@@ -409,7 +644,7 @@ CommandSocket::createListenSocket() {
         return false;
     }
 
-    if (listen(listenFd, 3) < 0) {
+    if (listen(listenFd, LISTEN_BACKLOG) < 0) {
         logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to listen on command server socket (" << logger.strerror() << ")" << endl;
         return false;
     }
@@ -422,32 +657,49 @@ CommandSocket::createListenSocket() {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-CommandSocket::acceptConnection() {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Accepting socket using listen fd = " << listenFd << endl;
-    int fd = accept(listenFd, NULL, NULL);
+CommandSocket::acceptConnections() {
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Accepting sockets using listen fd = " << listenFd << endl;
 
-    if (fd < 0) {
-        logger.log(VantageLogger::VANTAGE_WARNING) << "Accept failed (" << logger.strerror() << ")" << endl;
-        return;
-    }
+    while (true) {
+        int fd = accept(listenFd, NULL, NULL);
 
-    //
-    // Set a read timeout of 250 milliseconds
-    //
-    struct timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = 250000;
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
 
-    if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
-        logger.log(VantageLogger::VANTAGE_WARNING) << "setsockopt() failed (" << logger.strerror() << ")" << endl;
-    }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                logger.log(VantageLogger::VANTAGE_WARNING) << "Accept failed (" << logger.strerror() << ")" << endl;
+
+            return;
+        }
+
+        if (!setNonBlocking(fd)) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Could not make accepted socket non-blocking (" << logger.strerror() << ")" << endl;
+            close(fd);
+            continue;
+        }
+
+        Connection connection;
+        connection.socketId.fd = fd;
+        connection.socketId.sequence = nextSocketSequence++;
+        connection.outputOffset = 0;
+        connection.activeCommands = 0;
+        connection.events = POLLIN;
 
-    SocketId socketId;
-    socketId.fd = fd;
-    socketId.sequence = nextSocketSequence++;
+#ifndef __CYGWIN__
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = connection.socketId.sequence;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Could not add accepted socket to epoll (" << logger.strerror() << ")" << endl;
+            close(fd);
+            continue;
+        }
+#endif
 
-    socketList.push_back(socketId);
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Accepted socket: " << socketId << endl;
+        connections.emplace(connection.socketId.sequence, connection);
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Accepted socket: " << connection.socketId << endl;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -20,14 +20,19 @@
 #include <string>
 #include <thread>
 #include <vector>
+#include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 
 #include "ResponseHandler.h"
+#include "CommandData.h"
 
 namespace vws {
 class VantageLogger;
 class CommandHandler;
+class ResponseStream;
 
 /**
  * The CommandSocket is a class that uses a thread to read commands from a TCP socket
@@ -38,6 +43,10 @@ class CommandHandler;
  * {command}
  *
  * where VANTAGE is a fixed string and ###### is a zero filled number indicating the length of the command that follows.
+ *
+ * All of the client sockets are non-blocking and are serviced by an event loop (epoll on Linux, poll elsewhere).
+ * Each connection buffers partial commands until the entire command has arrived and buffers the responses that
+ * could not be written yet, so a slow client does not delay the other clients.
  */
 class CommandSocket : ResponseHandler {
 public:
@@ -45,7 +54,6 @@ public:
      * Constructor.
      *
      * @param port   The port on which to bind the socket
-     * @param evtMgr The event manager to which incoming command are sent for processing
      */
     CommandSocket(int port);
 
@@ -71,7 +79,10 @@ public:
     virtual void handleCommandResponse(const CommandData & commandData);
 
     /**
-     * Actually send the response on the provided file descriptor.
+     * Queue the response on the connection on which the command was received and write as much of it as the socket will accept.
+     * This must only be called from the socket thread.
+     *
+     * @param commandData The command whose response is to be sent
      */
     void sendCommandResponse(const CommandData & commandData);
 
@@ -100,7 +111,18 @@ public:
 private:
     static constexpr int          HEADER_SIZE = 15;
     static constexpr const char * HEADER_TEXT = "VANTAGE";
-    static constexpr int          MIN_COMMAND_LENGTH = 20; // Arbitrary number for quick error checks
+    static constexpr int          MIN_COMMAND_LENGTH = 20;         // Arbitrary number for quick error checks
+    static constexpr int          MAX_COMMAND_LENGTH = 65536;      // Far larger than any command, but much less than the length digits allow
+    static constexpr int          LENGTH_OFFSET = 8;               // The offset of the command length within the header
+    static constexpr int          LENGTH_DIGITS = 6;               // The number of digits in the command length
+    static constexpr const char * RESPONSE_TERMINATOR = "\n\n";    // Terminates the JSON element of each response
+    static constexpr int          READ_BUFFER_SIZE = 16384;        // The number of bytes read from a socket at a time
+    static constexpr int          MAX_PENDING_RESPONSES = 32;      // Stop reading commands from a client with this many commands in progress or responses unread
+    static constexpr int          MAX_EVENTS = 64;                 // The number of events returned by each wait
+    static constexpr int          EVENT_TIMEOUT_MILLIS = 1000;     // The longest time to wait for events, so termination is noticed
+    static constexpr int          LISTEN_BACKLOG = 128;            // The number of pending connections the kernel will hold
+    static constexpr int          LISTEN_EVENT_ID = 0;             // The event identifier of the listen socket
+    static constexpr int          RESPONSE_EVENT_ID = 1;           // The event identifier of the response eventfd, connections use their sequence
 
     /**
      * Structure used to uniquely identify a socket to ensure that the response is sent on the same file
@@ -113,6 +135,21 @@ private:
         int fd;
     };
 
+    /**
+     * The state of a client connection.
+     */
+    struct Connection {
+        SocketId                        socketId;          // The identifier of the client socket
+        std::string                     input;             // Bytes that have been read but do not yet make up an entire command
+        std::string                     output;            // The part of the current response that is waiting to be written
+        size_t                          outputOffset;      // The number of bytes of the output that have been written
+        std::shared_ptr<ResponseStream> stream;            // The stream producing the current response, if it is streamed
+        std::string                     streamTrailer;     // The end of the current streamed response
+        std::deque<CommandData>         pendingResponses;  // The responses waiting for the current response to be written
+        int                             activeCommands;    // The commands offered to a command handler whose responses have not been received
+        unsigned int                    events;            // The events for which the connection is registered
+    };
+
     /**
      * Output the socket list on stdout.
      */
@@ -128,9 +165,14 @@ private:
     friend std::ostream & operator<<(std::ostream & os, const SocketId & socketId);
 
     /**
-     * Accept a new client socket connection.
+     * Wait for socket events and process them.
      */
-    void acceptConnection();
+    void processEvents();
+
+    /**
+     * Accept all of the pending client socket connections.
+     */
+    void acceptConnections();
 
     /**
      * Create the socket for listening for new connections.
@@ -140,12 +182,74 @@ private:
     bool createListenSocket();
 
     /**
-     * Read a command from one of the client sockets.
+     * Process the events that occurred on a client connection.
+     *
+     * @param sequence The sequence number of the connection
+     * @param readable True if the socket has data to be read
+     * @param writable True if the socket can accept more data
+     * @param hangup   True if the client closed the socket, even partially
+     * @param error    True if an error occurred on the socket
+     */
+    void handleConnectionEvents(int sequence, bool readable, bool writable, bool hangup, bool error);
+
+    /**
+     * Read all of the available data from a client socket and process the commands that are complete.
+     *
+     * @param connection The connection from which to read
+     * @return True if the connection should remain open
+     */
+    bool readCommands(Connection & connection);
+
+    /**
+     * Process each command that has been completely received, leaving any partial command in the input buffer. The processing
+     * stops while the connection has too many commands in progress and resumes when one of their responses is received.
+     *
+     * @param connection The connection whose input is processed
+     * @return True if the connection should remain open
+     */
+    bool processInput(Connection & connection);
+
+    /**
+     * Check whether more commands will be accepted from a connection. The commands that a command handler is still processing
+     * count against the limit as well as the responses that are waiting to be written, so a client cannot queue an
+     * unlimited number of commands by sending them faster than they are processed.
+     *
+     * @param connection The connection to check
+     * @return True if the connection has fewer than MAX_PENDING_RESPONSES commands in progress
+     */
+    bool isAcceptingCommands(const Connection & connection) const;
+
+    /**
+     * Process a complete command received on a connection.
+     *
+     * @param connection  The connection on which the command was received
+     * @param commandJson The body of the command
+     */
+    void processCommand(Connection & connection, const std::string & commandJson);
+
+    /**
+     * Write as much of the connection's output as the socket will accept. Chunks of a streamed response are only
+     * produced when the previous chunk has been written, so a slow client holds at most one chunk in memory.
+     *
+     * @param connection The connection to write to
+     * @return True if the connection should remain open
+     */
+    bool writeOutput(Connection & connection);
+
+    /**
+     * Register the connection for the events that match its state. The connection is not read while too many of
+     * its commands are in progress and it is only registered for writing when it has output waiting.
+     *
+     * @param connection The connection whose events are updated
+     */
+    void updateEvents(Connection & connection);
+
+    /**
+     * Close a connection and remove it from the connection list.
      *
-     * @param socket The socket from which to read
-     * @return True if socket should remain open
+     * @param sequence The sequence number of the connection
      */
-    bool readCommand(const SocketId & socket);
+    void closeConnection(int sequence);
 
     /**
      * Send any pending responses.
@@ -155,9 +259,10 @@ private:
     int                           port;                // The port on which the console will listen for client connections
     int                           listenFd;            // The file description on which this thread is listening
     int                           nextSocketSequence;  // The sequence number for the next command socket accepted
-    std::vector<SocketId>         socketList;          // The list of client file descriptors currently open
+    std::map<int,Connection>      connections;         // The client connections currently open, keyed by the socket sequence
     std::vector<CommandHandler *> commandHandlers;     // The handlers that will be offered commands
     bool                          terminating;         // True if this thread's main loop should exit
+    int                           epollFd;             // The epoll file descriptor or -1 if epoll is not supported
     int                           responseEventFd;     // The file descriptor used to receive indications of an available response
     std::queue<CommandData>       responseQueue;       // The queue on which to store event responses
     mutable std::mutex            mutex;               // The mutex to protect the queue against multi-threaded contention
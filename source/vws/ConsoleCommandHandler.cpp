@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <time.h>
 #include <iostream>
+#include <iomanip>
+#include <chrono>
 #include <vector>
 
 #include "Weather.h"
@@ -44,50 +46,51 @@ struct ConsoleCommandEntry {
     std::string commandName;
     void (ConsoleCommandHandler::*handler)(CommandData &);
     bool (VantageWeatherStation::*consoleHandler)();
+    bool readOnly;   // Identical read-only commands in a batch share one console transaction
 };
 
 static const ConsoleCommandEntry consoleCommandList[] = {
-    "backlight",                     &ConsoleCommandHandler::handleBacklight,                           NULL,
-    "clear-active-alarms",           NULL,                                                              &VantageWeatherStation::clearActiveAlarms,
-    "clear-alarm-thresholds",        NULL,                                                              &VantageWeatherStation::clearAlarmThresholds,
-    "clear-console-archive",         NULL,                                                              &VantageWeatherStation::clearArchive,
-    "clear-calibration-offsets",     NULL,                                                              &VantageWeatherStation::clearTemperatureHumidityCalibrationOffsets,
-    "clear-cumulative-values",       &ConsoleCommandHandler::handleClearCumulativeValue,                NULL,
-    "clear-current-data",            NULL,                                                              &VantageWeatherStation::clearCurrentData,
-    "clear-graph-points",            NULL,                                                              &VantageWeatherStation::clearGraphPoints,
-    "clear-high-values",             &ConsoleCommandHandler::handleClearHighValues,                     NULL,
-    "clear-low-values",              &ConsoleCommandHandler::handleClearLowValues,                      NULL,
-    "console-diagnostics",           &ConsoleCommandHandler::handleQueryConsoleDiagnostics,             NULL,
-    "get-timezones",                 &ConsoleCommandHandler::handleGetTimezones,                        NULL,
-    "query-alarm-thresholds",        &ConsoleCommandHandler::handleQueryAlarmThresholds,                NULL,
-    "query-active-alarms",           &ConsoleCommandHandler::handleQueryActiveAlarms,                   NULL,
-    "query-archive-period",          &ConsoleCommandHandler::handleQueryArchivePeriod,                  NULL,
-    "query-baro-cal-params",         &ConsoleCommandHandler::handleQueryBarometerCalibrationParameters, NULL,
-    "query-cal-adjustments",         &ConsoleCommandHandler::handleQueryCalibrationAdjustments,         NULL,
-    "query-configuration-data",      &ConsoleCommandHandler::handleQueryConfigurationData,              NULL,
-    "query-console-time",            &ConsoleCommandHandler::handleQueryConsoleTime,                    NULL,
-    "query-console-type",            &ConsoleCommandHandler::handleQueryConsoleType,                    NULL,
-    "query-firmware",                &ConsoleCommandHandler::handleQueryFirmware,                       NULL,
-    "query-highlows",                &ConsoleCommandHandler::handleQueryHighLows,                       NULL,
-    "query-network-config",          &ConsoleCommandHandler::handleQueryNetworkConfiguration,           NULL,
-    "query-network-status",          &ConsoleCommandHandler::handleQueryNetworkStatus,                  NULL,
-    "query-receiver-list",           &ConsoleCommandHandler::handleQueryReceiverList,                   NULL,
-    "query-station-list",            &ConsoleCommandHandler::handleQueryStationList,                    NULL,
-    "query-used-transmitters",       &ConsoleCommandHandler::handleQueryMonitoredStations,              NULL,
-    "query-today-network-status",    &ConsoleCommandHandler::handleQueryTodayNetworkStatus,             NULL,
-    "query-units",                   &ConsoleCommandHandler::handleQueryUnits,                          NULL,
-    "put-year-rain",                 &ConsoleCommandHandler::handlePutYearRain,                         NULL,
-    "put-year-et",                   &ConsoleCommandHandler::handlePutYearET,                           NULL,
-    "start-archiving",               NULL,                                                              &VantageWeatherStation::startArchiving,
-    "stop-archiving",                NULL,                                                              &VantageWeatherStation::stopArchiving,
-    "query-archiving-state",         &ConsoleCommandHandler::handleQueryArchivingState,                 NULL,
-    "update-alarm-thresholds",       &ConsoleCommandHandler::handleUpdateAlarmThresholds,               NULL,
-    "update-archive-period",         &ConsoleCommandHandler::handleUpdateArchivePeriod,                 NULL,
-    "update-baro-reading-elevation", &ConsoleCommandHandler::handleUpdateBarometerReadingAndElevation,  NULL,
-    "update-cal-adjustments",        &ConsoleCommandHandler::handleUpdateCalibrationAdjustments,        NULL,
-    "update-configuration-data",     &ConsoleCommandHandler::handleUpdateConfigurationData,             NULL,
-    "update-network-config",         &ConsoleCommandHandler::handleUpdateNetworkConfiguration,          NULL,
-    "update-units",                  &ConsoleCommandHandler::handleUpdateUnits,                         NULL
+    "backlight",                     &ConsoleCommandHandler::handleBacklight,                           NULL,                                                               false,
+    "clear-active-alarms",           NULL,                                                              &VantageWeatherStation::clearActiveAlarms,                          false,
+    "clear-alarm-thresholds",        NULL,                                                              &VantageWeatherStation::clearAlarmThresholds,                       false,
+    "clear-console-archive",         NULL,                                                              &VantageWeatherStation::clearArchive,                               false,
+    "clear-calibration-offsets",     NULL,                                                              &VantageWeatherStation::clearTemperatureHumidityCalibrationOffsets, false,
+    "clear-cumulative-values",       &ConsoleCommandHandler::handleClearCumulativeValue,                NULL,                                                               false,
+    "clear-current-data",            NULL,                                                              &VantageWeatherStation::clearCurrentData,                           false,
+    "clear-graph-points",            NULL,                                                              &VantageWeatherStation::clearGraphPoints,                           false,
+    "clear-high-values",             &ConsoleCommandHandler::handleClearHighValues,                     NULL,                                                               false,
+    "clear-low-values",              &ConsoleCommandHandler::handleClearLowValues,                      NULL,                                                               false,
+    "console-diagnostics",           &ConsoleCommandHandler::handleQueryConsoleDiagnostics,             NULL,                                                               true,
+    "get-timezones",                 &ConsoleCommandHandler::handleGetTimezones,                        NULL,                                                               true,
+    "query-alarm-thresholds",        &ConsoleCommandHandler::handleQueryAlarmThresholds,                NULL,                                                               true,
+    "query-active-alarms",           &ConsoleCommandHandler::handleQueryActiveAlarms,                   NULL,                                                               true,
+    "query-archive-period",          &ConsoleCommandHandler::handleQueryArchivePeriod,                  NULL,                                                               true,
+    "query-baro-cal-params",         &ConsoleCommandHandler::handleQueryBarometerCalibrationParameters, NULL,                                                               true,
+    "query-cal-adjustments",         &ConsoleCommandHandler::handleQueryCalibrationAdjustments,         NULL,                                                               true,
+    "query-configuration-data",      &ConsoleCommandHandler::handleQueryConfigurationData,              NULL,                                                               true,
+    "query-console-time",            &ConsoleCommandHandler::handleQueryConsoleTime,                    NULL,                                                               true,
+    "query-console-type",            &ConsoleCommandHandler::handleQueryConsoleType,                    NULL,                                                               true,
+    "query-firmware",                &ConsoleCommandHandler::handleQueryFirmware,                       NULL,                                                               true,
+    "query-highlows",                &ConsoleCommandHandler::handleQueryHighLows,                       NULL,                                                               true,
+    "query-network-config",          &ConsoleCommandHandler::handleQueryNetworkConfiguration,           NULL,                                                               true,
+    "query-network-status",          &ConsoleCommandHandler::handleQueryNetworkStatus,                  NULL,                                                               true,
+    "query-receiver-list",           &ConsoleCommandHandler::handleQueryReceiverList,                   NULL,                                                               true,
+    "query-station-list",            &ConsoleCommandHandler::handleQueryStationList,                    NULL,                                                               true,
+    "query-used-transmitters",       &ConsoleCommandHandler::handleQueryMonitoredStations,              NULL,                                                               true,
+    "query-today-network-status",    &ConsoleCommandHandler::handleQueryTodayNetworkStatus,             NULL,                                                               true,
+    "query-units",                   &ConsoleCommandHandler::handleQueryUnits,                          NULL,                                                               true,
+    "put-year-rain",                 &ConsoleCommandHandler::handlePutYearRain,                         NULL,                                                               false,
+    "put-year-et",                   &ConsoleCommandHandler::handlePutYearET,                           NULL,                                                               false,
+    "start-archiving",               NULL,                                                              &VantageWeatherStation::startArchiving,                             false,
+    "stop-archiving",                NULL,                                                              &VantageWeatherStation::stopArchiving,                              false,
+    "query-archiving-state",         &ConsoleCommandHandler::handleQueryArchivingState,                 NULL,                                                               true,
+    "update-alarm-thresholds",       &ConsoleCommandHandler::handleUpdateAlarmThresholds,               NULL,                                                               false,
+    "update-archive-period",         &ConsoleCommandHandler::handleUpdateArchivePeriod,                 NULL,                                                               false,
+    "update-baro-reading-elevation", &ConsoleCommandHandler::handleUpdateBarometerReadingAndElevation,  NULL,                                                               false,
+    "update-cal-adjustments",        &ConsoleCommandHandler::handleUpdateCalibrationAdjustments,        NULL,                                                               false,
+    "update-configuration-data",     &ConsoleCommandHandler::handleUpdateConfigurationData,             NULL,                                                               false,
+    "update-network-config",         &ConsoleCommandHandler::handleUpdateNetworkConfiguration,          NULL,                                                               false,
+    "update-units",                  &ConsoleCommandHandler::handleUpdateUnits,                         NULL,                                                               false
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,25 +114,90 @@ ConsoleCommandHandler::~ConsoleCommandHandler() {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 ConsoleCommandHandler::offerCommand(const CommandData & commandData) {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Being offered command " << commandData.commandName << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Being offered command " << commandData.commandName << endl;
     for (auto & entry : consoleCommandList) {
         if (commandData.commandName == entry.commandName) {
             commandQueue.queueCommand(commandData);
-            logger.log(VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " accepted" << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " accepted" << endl;
             return true;
         }
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " rejected" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " rejected" << endl;
 
     return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ConsoleCommandHandler::processQueuedCommands() {
+    vector<CommandData> commands;
+    if (!commandQueue.consumeAllCommands(commands))
+        return;
+
+    //
+    // The whole batch is processed during one interruption of the LOOP. Identical read-only commands, such as several
+    // clients asking for the high/lows, are sent to the console once and the response is copied to every requester.
+    // A response is only shared up to the next command that changes the console, as the commands after it must see
+    // the change.
+    //
+    vector<bool> responded(commands.size(), false);
+    int consoleTransactions = 0;
+    for (size_t i = 0; i < commands.size(); i++) {
+        if (responded[i])
+            continue;
+
+        CommandData & commandData = commands[i];
+        logQueueWait(commandData);
+        handleCommand(commandData);
+        consoleTransactions++;
+
+        if (isReadOnlyCommand(commandData.commandName) && commandData.responseStream == NULL) {
+            for (size_t j = i + 1; j < commands.size() && isReadOnlyCommand(commands[j].commandName); j++) {
+                CommandData & duplicate = commands[j];
+                if (!responded[j] && duplicate.commandName == commandData.commandName && duplicate.arguments == commandData.arguments) {
+                    logQueueWait(duplicate);
+                    duplicate.response = commandData.response;
+                    sendResponse(duplicate);
+                    responded[j] = true;
+                }
+            }
+        }
+
+        sendResponse(commandData);
+        responded[i] = true;
+    }
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Processed " << commands.size() << " queued commands with " << consoleTransactions << " console transactions" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+ConsoleCommandHandler::isReadOnlyCommand(const string & commandName) {
+    for (auto & entry : consoleCommandList) {
+        if (commandName == entry.commandName)
+            return entry.readOnly;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+ConsoleCommandHandler::logQueueWait(const CommandData & commandData) const {
+    double waitMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - commandData.queueTime).count();
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Command " << commandData.commandName << " from socket " << commandData.socketId
+                                                       << " waited " << fixed << setprecision(1) << waitMillis << " ms in the queue" << endl;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 ConsoleCommandHandler::handleCommand(CommandData & commandData) {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Processing command " << commandData << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Processing command " << commandData << endl;
 
     //
     // If the station has not been opened and configured just ignore the command
@@ -915,7 +983,7 @@ ConsoleCommandHandler::handleQueryNetworkStatus(CommandData & commandData) {
         commandData.response.append(CommandData::buildFailureString("Missing argument"));
     }
     else {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Query the network status with times: " << startTime.formatDateTime() << " - " << endTime.formatDateTime() << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Query the network status with times: " << startTime.formatDateTime() << " - " << endTime.formatDateTime() << endl;
 
         ostringstream oss;
         oss << SUCCESS_TOKEN << ", " << DATA_TOKEN << " : ";
@@ -52,6 +52,13 @@ public:
      */
     virtual ~ConsoleCommandHandler();
 
+    /**
+     * Retrieve every queued command and process them during one interruption of the LOOP. Identical read-only commands
+     * are sent to the console once and the response is copied to each requester. The time each command waited in the
+     * queue is logged at the DEBUG1 level.
+     */
+    virtual void processQueuedCommands();
+
     /**
      * Handle a command and write the response to the provided object.
      * Note that there will always be a response.
@@ -223,6 +230,21 @@ public:
     void handleQueryTodayNetworkStatus(CommandData & commandData);
 
 private:
+    /**
+     * Check if a command only reads from the console, so that identical commands can share one console transaction.
+     *
+     * @param commandName The name of the command
+     * @return True if the command does not change the console or the state of this program
+     */
+    static bool isReadOnlyCommand(const std::string & commandName);
+
+    /**
+     * Log the time a command waited in the queue before its response was produced.
+     *
+     * @param commandData The command
+     */
+    void logQueueWait(const CommandData & commandData) const;
+
     VantageWeatherStation & station;
     VantageConfiguration &  configurator;
     VantageStationNetwork & network;
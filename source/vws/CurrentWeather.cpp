@@ -273,4 +273,110 @@ CurrentWeather::formatJSON(bool pretty) const {
 
     return ss.str();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+bool
+CurrentWeather::measurementValue(const Measurement<T> & measurement, double & value) {
+    if (!measurement.isValid())
+        return false;
+
+    value = measurement.getValue();
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+CurrentWeather::getFieldValue(const std::string & field, double & value) const {
+    //
+    // The fields and their sources must match those in formatJSON()
+    //
+    if (field == "insideTemperature")
+        return measurementValue(loopPacket.getInsideTemperature(), value);
+    else if (field == "insideHumidity")
+        return measurementValue(loopPacket.getInsideHumidity(), value);
+    else if (field == "outsideTemperature")
+        return measurementValue(loopPacket.getOutsideTemperature(), value);
+    else if (field == "outsideHumidity")
+        return measurementValue(loopPacket.getOutsideHumidity(), value);
+    else if (field == "dewPoint")
+        return measurementValue(loop2Packet.getDewPoint(), value);
+    else if (field == "windChill")
+        return measurementValue(loop2Packet.getWindChill(), value);
+    else if (field == "heatIndex")
+        return measurementValue(loop2Packet.getHeatIndex(), value);
+    else if (field == "thsw")
+        return measurementValue(loop2Packet.getThsw(), value);
+    else if (field == "windSpeed")
+        return measurementValue(windSpeed, value);
+    else if (field == "windDirection")
+        return measurementValue(windDirection, value);
+    else if (field == "gustSpeed")
+        return measurementValue(loop2Packet.getWindGust10Minute(), value);
+    else if (field == "gustDirection")
+        return measurementValue(loop2Packet.getWindGustDirection10Minute(), value);
+    else if (field == "windSpeed10MinAvg")
+        return measurementValue(loop2Packet.getWindSpeed10MinuteAverage(), value);
+    else if (field == "windSpeed2MinAvg")
+        return measurementValue(loop2Packet.getWindSpeed2MinuteAverage(), value);
+    else if (field == "barometricPressure")
+        return measurementValue(loopPacket.getBarometricPressure(), value);
+    else if (field == "atmosphericPressure")
+        return measurementValue(loop2Packet.getBarometricSensorRawReading(), value);
+    else if (field == "solarRadiation")
+        return measurementValue(loopPacket.getSolarRadiation(), value);
+    else if (field == "uvIndex")
+        return measurementValue(loopPacket.getUvIndex(), value);
+    else if (field == "rainRate")
+        value = loopPacket.getRainRate();
+    else if (field == "rainToday")
+        value = loopPacket.getDayRain();
+    else if (field == "rain15Minute")
+        value = loop2Packet.get15MinuteRain();
+    else if (field == "rainHour")
+        value = loop2Packet.getHourRain();
+    else if (field == "rain24Hour")
+        value = loop2Packet.get24HourRain();
+    else if (field == "rainMonth")
+        value = loopPacket.getMonthRain();
+    else if (field == "rainWeatherYear")
+        value = loopPacket.getYearRain();
+    else if (field == "dayET" && loopPacket.getDayET() > 0.0)
+        value = loopPacket.getDayET();
+    else if (field == "monthET" && loopPacket.getMonthET() > 0.0)
+        value = loopPacket.getMonthET();
+    else if (field == "yearET" && loopPacket.getYearET() > 0.0)
+        value = loopPacket.getYearET();
+    else if (field == "stormRain" && loopPacket.isStormOngoing())
+        value = loopPacket.getStormRain();
+    else
+        return false;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+CurrentWeather::isField(const std::string & field) {
+    //
+    // The names must match those in getFieldValue()
+    //
+    static const std::string fieldNames[] = {
+        "insideTemperature", "insideHumidity", "outsideTemperature", "outsideHumidity", "dewPoint", "windChill",
+        "heatIndex", "thsw", "windSpeed", "windDirection", "gustSpeed", "gustDirection", "windSpeed10MinAvg",
+        "windSpeed2MinAvg", "barometricPressure", "atmosphericPressure", "solarRadiation", "uvIndex", "rainRate",
+        "rainToday", "rain15Minute", "rainHour", "rain24Hour", "rainMonth", "rainWeatherYear", "dayET", "monthET",
+        "yearET", "stormRain"
+    };
+
+    for (const std::string & name : fieldNames) {
+        if (field == name)
+            return true;
+    }
+
+    return false;
+}
 }
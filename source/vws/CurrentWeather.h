@@ -109,7 +109,37 @@ public:
      */
     std::string formatJSON(bool pretty = false) const;
 
+    /**
+     * Get the value of a numeric field by the name of its element in the current weather JSON message. This avoids
+     * formatting and parsing the JSON message when only a single value is needed. Only the top level numeric
+     * fields are supported, the array elements (extra temperatures, soil moistures, etc.) are not.
+     *
+     * @param [in]  field The name of the JSON element
+     * @param [out] value The value of the field if it is found or unchanged if not found
+     * @return True if the field would be present in the JSON message and the value argument was written
+     */
+    bool getFieldValue(const std::string & field, double & value) const;
+
+    /**
+     * Check if a field name is one of the fields supported by getFieldValue().
+     *
+     * @param field The name of the JSON element
+     * @return True if the field is supported, regardless of whether it has a value in a particular record
+     */
+    static bool isField(const std::string & field);
+
 private:
+    /**
+     * Get the value of a measurement if it is valid.
+     *
+     * @param [in]  measurement The measurement
+     * @param [out] value       The value of the measurement if it is valid
+     * @return True if the measurement is valid and the value argument was written
+     */
+    template<typename T>
+    static bool measurementValue(const Measurement<T> & measurement, double & value);
+
+
     LoopPacket               loopPacket;
     Loop2Packet              loop2Packet;
     DateTime                 packetTime;
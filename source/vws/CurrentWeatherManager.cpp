@@ -17,10 +17,11 @@
 
 #include "CurrentWeatherManager.h"
 
-#include <fstream>
+#include <algorithm>
 #include <filesystem>
-#include <sys/types.h>
-#include <sys/stat.h>
+#include <fstream>
+#include <string.h>
+#include <time.h>
 
 #include "CurrentWeatherPublisher.h"
 #include "VantageLogger.h"
@@ -32,12 +33,14 @@ namespace vws {
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-CurrentWeatherManager::CurrentWeatherManager(const string & dataDirectory, CurrentWeatherPublisher & cwPublisher) : archiveDirectory(dataDirectory + LOOP_ARCHIVE_DIR),
-                                                                                                                    initialized(false),
-                                                                                                                    currentWeatherPublisher(cwPublisher),
-                                                                                                                    firstLoop2PacketReceived(false),
-                                                                                                                    dominantWindDirections(dataDirectory),
-                                                                                                                    logger(VantageLogger::getLogger("CurrentWeatherManager")) {
+CurrentWeatherManager::CurrentWeatherManager(const string & dataDirectory, CurrentWeatherPublisher & cwPublisher, int flushInterval) : archiveDirectory(dataDirectory + LOOP_ARCHIVE_DIR),
+                                                                                                                                       loopArchive(archiveDirectory + LOOP_ARCHIVE_FILE, flushInterval),
+                                                                                                                                       loopPacketReceived(false),
+                                                                                                                                       initialized(false),
+                                                                                                                                       currentWeatherPublisher(cwPublisher),
+                                                                                                                                       firstLoop2PacketReceived(false),
+                                                                                                                                       dominantWindDirections(dataDirectory),
+                                                                                                                                       logger(VantageLogger::getLogger("CurrentWeatherManager")) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,7 +56,21 @@ CurrentWeatherManager::initialize() {
         return;
 
     createArchiveDirectory();
+
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    loopArchive.open();
     cleanupArchive();
+
+    //
+    // Fill the in-memory ring with the records of the past 24 hours
+    //
+    vector<CurrentWeather> list;
+    readArchiveRecords(loopArchive.findFirstRecordOnOrAfter(time(0) - Weather::SECONDS_PER_DAY), list);
+    for (const CurrentWeather & cw : list)
+        addRecentWeather(cw);
+
+    logger.log(VantageLogger::VANTAGE_INFO) << "Loaded " << recentWeather.size() << " current weather records from the loop archive" << endl;
+
     initialized = true;
 }
 
@@ -61,68 +78,62 @@ CurrentWeatherManager::initialize() {
 ////////////////////////////////////////////////////////////////////////////////
 CurrentWeather
 CurrentWeatherManager::getCurrentWeather() const {
-    std::lock_guard<std::mutex> guard(mutex);
+    std::shared_lock<std::shared_mutex> guard(mutex);
 
     return currentWeather;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+std::shared_ptr<const std::string>
+CurrentWeatherManager::getCurrentWeatherJSON() const {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+
+    //
+    // No packets have been received, so there is nothing to share yet
+    //
+    if (!currentWeatherJson)
+        return std::make_shared<const std::string>(currentWeather.formatJSON());
+
+    return currentWeatherJson;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CurrentWeatherManager::publishCurrentWeather() {
+    currentWeatherJson = std::make_shared<const std::string>(currentWeather.formatJSON());
+
+    if (firstLoop2PacketReceived)
+        currentWeatherPublisher.publishCurrentWeather(currentWeather, *currentWeatherJson);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 /**
- * The archive is written as a ring buffer in 24 hour files. The archive will contain
- * between 23 and 24 hours of data. As each hour starts, the hour file will be truncated.
- * Each file will contain up to 1800 records (one every two seconds). The format for each
- * record is:
- *    <time: 4 bytes><packet type: 4 bytes><packet data: 99 bytes>
- * for a total of 107 bytes per record. Each file should contain no more than 192K bytes.
- * The file can be queried to create "CurrentWeather" records from the past. This data
+ * The archive is written to a ring file that holds 24 hours of LOOP/LOOP2 packets. The ring file is kept open
+ * and memory mapped, so writing a packet does not open, stat or close any files. The format for each record is:
+ *    <time: 8 bytes><packet type: 4 bytes><packet data: 99 bytes>
+ * The archive can be queried to create "CurrentWeather" records from the past. This data
  * can be used to create graphs with very fine grained time axes.
  */
 void
 CurrentWeatherManager::writeLoopArchive(DateTime packetTime, int packetType, const byte * packetData, size_t length) {
-    string filename = archiveFilenameByTime(packetTime);
-
-    //
-    // If the hour file exists and it is more than an hour since it has changed, truncate it.
-    //
-    ios_base::openmode mode = ios::binary ;
-    struct stat fileinfo;
-    int sr = stat(filename.c_str(), &fileinfo);
-    if (sr == 0) {
-        time_t now = time(0);
-        long fileAge = now - fileinfo.st_mtim.tv_sec;
-
-        if (fileAge > Weather::SECONDS_PER_HOUR) {
-            mode |= ios::trunc;
-        }
-        else {
-            mode |= ios::app;
-        }
-    }
-    else
-        mode |= ios::app;
-
-    ofstream ofs(filename, mode);
-    if (ofs.is_open()) {
-        ofs.write(reinterpret_cast<byte *>(&packetTime), sizeof(packetTime)).
-            write(reinterpret_cast<byte *>(&packetType), sizeof(packetType)).
-            write(packetData, length);
-        if (!ofs.good()) {
-            logger.log(VantageLogger::VANTAGE_ERROR) << "Write to LOOP packet archive failed" << endl;
-        }
-        ofs.close();
+    if (!loopArchive.isOpen()) {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Skipping write of LOOP/LOOP2 packet. Loop archive is not open." << endl;
+        return;
     }
-    else
-        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open LOOP/LOOP2 packet archive file " << filename << endl;
 
+    loopArchive.writePacket(packetTime, packetType, packetData, length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
 CurrentWeatherManager::processLoopPacket(const LoopPacket & packet) {
-    std::lock_guard<std::mutex> guard(mutex);
+    std::lock_guard<std::shared_mutex> guard(mutex);
     DateTime packetTime = time(0);
+    loopPacketReceived = true;
     currentWeather.setLoopData(packet);
     writeLoopArchive(packetTime, packet.getPacketType(), packet.getPacketData(), LoopPacket::LOOP_PACKET_SIZE);
     //
@@ -134,8 +145,7 @@ CurrentWeatherManager::processLoopPacket(const LoopPacket & packet) {
         currentWeather.setDominantWindDirectionData(dominantWindDirections.dominantDirectionsForPastHour());
     }
 
-    if (firstLoop2PacketReceived)
-        currentWeatherPublisher.publishCurrentWeather(currentWeather);
+    publishCurrentWeather();
 
     return true;
 }
@@ -144,7 +154,7 @@ CurrentWeatherManager::processLoopPacket(const LoopPacket & packet) {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 CurrentWeatherManager::processLoop2Packet(const Loop2Packet & packet) {
-    std::lock_guard<std::mutex> guard(mutex);
+    std::lock_guard<std::shared_mutex> guard(mutex);
     DateTime packetTime = time(0);
     firstLoop2PacketReceived = true;
     currentWeather.setLoop2Data(packet);
@@ -157,47 +167,36 @@ CurrentWeatherManager::processLoop2Packet(const Loop2Packet & packet) {
         dominantWindDirections.processWindSample(packetTime, packet.getWindDirection().getValue(), packet.getWindSpeed().getValue());
         currentWeather.setDominantWindDirectionData(dominantWindDirections.dominantDirectionsForPastHour());
     }
-    currentWeatherPublisher.publishCurrentWeather(currentWeather);
+    publishCurrentWeather();
     dominantWindDirections.dumpData();
 
-    return true;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-std::string
-CurrentWeatherManager::archiveFilenameByTime(DateTime time) {
-    struct tm tm;
-    Weather::localtime(time, tm);
-    return archiveFilenameByHour(tm.tm_hour);
-}
+    //
+    // Only a LOOP2 packet that follows a LOOP packet completes a record, which matches the records that are read from the loop archive.
+    // The dominant wind directions are not saved in the loop archive, so they are not kept in the ring either.
+    //
+    if (loopPacketReceived) {
+        CurrentWeather cw = currentWeather;
+        cw.setPacketTime(packetTime);
+        cw.setDominantWindDirectionData(vector<string>());
+        addRecentWeather(cw);
+        loopPacketReceived = false;
+    }
 
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-std::string
-CurrentWeatherManager::archiveFilenameByHour(int hour) {
-    char filename[100];
-    snprintf(filename, sizeof(filename), "%s/LoopPacketArchive_%02d.dat", archiveDirectory.c_str(), hour);
-    return std::string(filename);
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-CurrentWeatherManager::readArchiveFile(std::ifstream & ifs, vector<CurrentWeather> & list) {
+CurrentWeatherManager::readArchiveRecords(int firstRecord, vector<CurrentWeather> & list) const {
     DateTime packetTime;
     int packetType;
     byte buffer[LoopPacket::LOOP_PACKET_SIZE];
     CurrentWeather cw;
     bool loopPacketProcessed = false;
 
-    while (ifs.good()) {
-        ifs.read(reinterpret_cast<byte *>(&packetTime), sizeof(packetTime)).
-            read(reinterpret_cast<byte *>(&packetType), sizeof(packetType)).
-            read(buffer, sizeof(buffer));
-
-        if (ifs.eof())
-            return;
+    for (int i = firstRecord; i < loopArchive.getRecordCount(); i++) {
+        memcpy(buffer, loopArchive.getRecord(i, packetTime, packetType), sizeof(buffer));
 
         if (packetType == LoopPacket::LOOP_PACKET_TYPE) {
             LoopPacket loopPacket;
@@ -213,10 +212,9 @@ CurrentWeatherManager::readArchiveFile(std::ifstream & ifs, vector<CurrentWeathe
                 cw.setLoop2Data(loop2Packet);
                 cw.setPacketTime(packetTime);
                 //
-                // Ignore the LOOP2 packet if it is the first in the file or there was an error processing the LOOP packet.
-                // If the first packet in the the file is a LOOP2 packet, then one LOOP/LOOP2 packet pair will be discarded
-                // as the last packet in the previous file should have been a LOOP packet. Given the circular buffer technique
-                // used for the Current Weather Archive, loosing a single packet is not a significant loss.
+                // Ignore the LOOP2 packet if it is the first record read or there was an error processing the LOOP packet.
+                // If the first record is a LOOP2 packet, then one LOOP/LOOP2 packet pair will be discarded.
+                // Given the circular buffer technique used for the Current Weather Archive, loosing a single packet is not a significant loss.
                 //
                 if (loopPacketProcessed) {
                     list.push_back(cw);
@@ -230,30 +228,64 @@ CurrentWeatherManager::readArchiveFile(std::ifstream & ifs, vector<CurrentWeathe
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-CurrentWeatherManager::queryCurrentWeatherArchive(int hours, std::vector<CurrentWeather> & list) {
-    std::lock_guard<std::mutex> guard(mutex);
-    list.clear();
+CurrentWeatherManager::queryCurrentWeatherArchive(int hours, CurrentWeatherRecordList & list) {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+    list.assign(recentWeather.begin() + findFirstRecentRecord(hours), recentWeather.end());
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Current weather archive records found: " << list.size() << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CurrentWeatherManager::visitCurrentWeatherArchive(int hours, std::function<void (size_t index, size_t recordCount, const CurrentWeatherRecord & record)> visitor) const {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+    size_t firstRecord = findFirstRecentRecord(hours);
+    size_t recordCount = recentWeather.size() - firstRecord;
+
+    for (size_t i = 0; i < recordCount; i++)
+        visitor(i, recordCount, recentWeather[firstRecord + i]);
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Current weather archive records visited: " << recordCount << endl;
+}
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+size_t
+CurrentWeatherManager::findFirstRecentRecord(int hours) const {
     if (hours >= 24)
         hours = 23;
 
+    //
+    // The records start at the top of the hour
+    //
     DateTime archiveTime = time(0) - (Weather::SECONDS_PER_HOUR * hours);
+    struct tm tm;
+    Weather::localtime(archiveTime, tm);
+    tm.tm_min = 0;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    DateTime startTime = mktime(&tm);
 
-    ios_base::openmode mode = ios::binary | ios::in;
-
-    for (int i = 0; i <= hours; i++) {
-        struct tm tm;
-        Weather::localtime(archiveTime, tm);
-        string filename = archiveFilenameByHour(tm.tm_hour);
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Reading loop archive file " << filename << endl;
-        ifstream ifs(filename.c_str(), mode);
-        if (ifs.is_open()) {
-            readArchiveFile(ifs, list);
-            ifs.close();
-        }
-        archiveTime += Weather::SECONDS_PER_HOUR;
-        logger.log(VantageLogger::VANTAGE_DEBUG2) << "Current weather archive records found: " << list.size() << endl;
-    }
+    //
+    // Search backward from the newest record so that a clock change cannot affect the search
+    //
+    size_t firstRecord = recentWeather.size();
+    while (firstRecord > 0 && recentWeather[firstRecord - 1]->getPacketTime() >= startTime)
+        firstRecord--;
+
+    return firstRecord;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+CurrentWeatherManager::addRecentWeather(const CurrentWeather & cw) {
+    recentWeather.push_back(std::make_shared<const CurrentWeather>(cw));
+
+    DateTime tooOldTime = cw.getPacketTime() - Weather::SECONDS_PER_DAY;
+    while (recentWeather.size() > RECENT_WEATHER_CAPACITY || recentWeather.front()->getPacketTime() < tooOldTime)
+        recentWeather.pop_front();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -272,23 +304,73 @@ CurrentWeatherManager::createArchiveDirectory() {
 void
 CurrentWeatherManager::cleanupArchive() {
     //
-    // If an archive file is older than 24 hours, the file is obsolete and must be deleted
+    // The hourly archive files have been replaced by the ring file. Keep the files if the ring file could not be opened,
+    // so their records can be imported when it can be.
     //
-    DateTime tooOldFileTime = time(0) - Weather::SECONDS_PER_DAY;
+    if (!loopArchive.isOpen())
+        return;
+
+    //
+    // The records are only imported if they are newer than the records already in the ring file, as the ring can only
+    // be written in time order
+    //
+    DateTime newestRingTime = 0;
+    int packetType;
+    if (loopArchive.getRecordCount() > 0)
+        loopArchive.getRecord(loopArchive.getRecordCount() - 1, newestRingTime, packetType);
+
+    struct HourlyRecord {
+        DateTime packetTime;
+        int      packetType;
+        byte     packetData[LoopPacketRing::PACKET_DATA_SIZE];
+    };
+
+    DateTime tooOldTime = time(0) - Weather::SECONDS_PER_DAY;
+    vector<HourlyRecord> records;
+    vector<string> archiveFilenames;
+
     for (int i = 0; i < 24; i++) {
-        string archiveFilename = archiveFilenameByHour(i);
-        struct stat statbuf;
-        if (stat(archiveFilename.c_str(), &statbuf) == 0) {
-            DateTime fileTime = statbuf.st_mtim.tv_sec;
-            logger.log(VantageLogger::VANTAGE_INFO) << "Checking Current Weather Archive file " << archiveFilename << " for deletion with last write time of " << fileTime << endl;
-            if (fileTime < tooOldFileTime) {
-                if (!std::filesystem::remove(archiveFilename))
-                    logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to remove Current Weather Archive file " << archiveFilename << endl;
-                else
-                    logger.log(VantageLogger::VANTAGE_INFO) << "Deleted old current weather archive file " << archiveFilename << endl;
-            }
+        char archiveFilename[100];
+        snprintf(archiveFilename, sizeof(archiveFilename), "%s/LoopPacketArchive_%02d.dat", archiveDirectory.c_str(), i);
+        ifstream ifs(archiveFilename, ios::in | ios::binary);
+        if (!ifs.is_open())
+            continue;
+
+        archiveFilenames.push_back(archiveFilename);
+
+        //
+        // Each record is <time: sizeof(DateTime) bytes><packet type: 4 bytes><packet data: 99 bytes>
+        //
+        HourlyRecord record;
+        while (ifs.read(reinterpret_cast<byte *>(&record.packetTime), sizeof(record.packetTime)).
+                   read(reinterpret_cast<byte *>(&record.packetType), sizeof(record.packetType)).
+                   read(record.packetData, sizeof(record.packetData))) {
+            if (record.packetTime >= tooOldTime && record.packetTime > newestRingTime)
+                records.push_back(record);
         }
     }
+
+    //
+    // The hour files are a ring themselves, so the records are sorted by time. The sort is stable so that the order of
+    // a LOOP/LOOP2 packet pair received in the same second is kept.
+    //
+    std::stable_sort(records.begin(), records.end(), [](const HourlyRecord & r1, const HourlyRecord & r2) { return r1.packetTime < r2.packetTime; });
+
+    for (const HourlyRecord & record : records)
+        loopArchive.writePacket(record.packetTime, record.packetType, record.packetData, sizeof(record.packetData));
+
+    if (!records.empty()) {
+        loopArchive.flush();
+        logger.log(VantageLogger::VANTAGE_INFO) << "Imported " << records.size() << " LOOP/LOOP2 packets from the hourly current weather archive files" << endl;
+    }
+
+    for (const string & archiveFilename : archiveFilenames) {
+        std::error_code errorCode;
+        if (std::filesystem::remove(archiveFilename, errorCode))
+            logger.log(VantageLogger::VANTAGE_INFO) << "Deleted obsolete current weather archive file " << archiveFilename << endl;
+        else if (errorCode)
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to remove obsolete Current Weather Archive file " << archiveFilename << ". Error: " << errorCode.message() << endl;
+    }
 }
 
 } /* namespace vws */
@@ -17,31 +17,44 @@
 #ifndef CURRENT_WEATHER_MANAGER_H
 #define CURRENT_WEATHER_MANAGER_H
 
-#include <mutex>
-#include <fstream>
+#include <shared_mutex>
+#include <deque>
+#include <functional>
+#include <memory>
 #include "CurrentWeather.h"
 #include "DominantWindDirections.h"
 #include "VantageWeatherStation.h"
 #include "LoopPacketListener.h"
+#include "LoopPacketRing.h"
 
 namespace vws {
 class VantageLogger;
 class CurrentWeatherPublisher;
 
 static const std::string LOOP_ARCHIVE_DIR = "/loop/";
+static const std::string LOOP_ARCHIVE_FILE = "LoopPacketArchive.dat";
 
 /**
- * Class to manage the current weather archive. This includes managing the rotating hour files and performing queries.
+ * Class to manage the current weather archive. This includes managing the LOOP packet ring file and performing queries.
+ * The queries are served from an in-memory ring of current weather records that is built as the LOOP2 packets
+ * arrive. The LOOP packet ring file is only read at startup to fill the in-memory ring.
  */
 class CurrentWeatherManager : public LoopPacketListener {
 public:
+    //
+    // The records in the in-memory ring are never modified after they are added, so they are shared with the queries
+    //
+    typedef std::shared_ptr<const CurrentWeather> CurrentWeatherRecord;
+    typedef std::vector<CurrentWeatherRecord> CurrentWeatherRecordList;
+
     /**
      * Constructor.
      *
      * @param dataDirectory The directory into which the loop archive will be written
      * @param cwPublisher   The publisher of current weather data
+     * @param flushInterval The number of seconds between flushes of the loop archive to the disk
      */
-    CurrentWeatherManager(const std::string & dataDirectory, CurrentWeatherPublisher & cwPublisher);
+    CurrentWeatherManager(const std::string & dataDirectory, CurrentWeatherPublisher & cwPublisher, int flushInterval = LoopPacketRing::DEFAULT_FLUSH_INTERVAL);
 
     /**
      * Destructor.
@@ -49,8 +62,8 @@ public:
     virtual ~CurrentWeatherManager();
 
     /**
-     * Initialize the archive which includes creating the archive directory and deleting
-     * any obsolete archive files.
+     * Initialize the archive which includes creating the archive directory, opening the loop archive ring file and
+     * importing the obsolete hourly archive files into the ring file.
      */
     void initialize();
 
@@ -61,6 +74,14 @@ public:
      */
     CurrentWeather getCurrentWeather() const;
 
+    /**
+     * Get the current weather values formatted as JSON. The JSON is formatted once when a LOOP or LOOP2 packet
+     * is processed and the same immutable string is shared with the current weather publisher and every query.
+     *
+     * @return The current weather JSON
+     */
+    std::shared_ptr<const std::string> getCurrentWeatherJSON() const;
+
     /**
      * Process a LOOP packet in a callback.
      *
@@ -78,54 +99,70 @@ public:
     virtual bool processLoop2Packet(const Loop2Packet & packet);
 
     /**
-     * Build current weather records using the LOOP packets stored in the archive.
-     * Note that a current weather record will be store when a LOOP2 packet is encountered.
+     * Retrieve the current weather records from the past hours.
+     * Note that a current weather record is stored when a LOOP2 packet is received that follows a LOOP packet.
      * Theoretically, the archive will alternate between LOOP and LOOP2
      *
-     * @param hours How many hours to go back into the archive. The archive file will not be searched, but
-     *              the records will start at the top of the hour. So if it's 2:30 and hours=2, then all
-     *              records after 12 PM will be retrieved.
-     * @param list  The vector into which the current weather records will be written
+     * @param hours How many hours to go back into the archive. The records will start at the top of
+     *              the hour. So if it's 2:30 and hours=2, then all records after 12 PM will be retrieved.
+     * @param list  The vector into which the current weather records will be written. Only the pointers are
+     *              copied while the lock is held, so the packet processing is not blocked by a large query.
      *
      */
-    void queryCurrentWeatherArchive(int hours, std::vector<CurrentWeather> & list);
+    void queryCurrentWeatherArchive(int hours, CurrentWeatherRecordList & list);
 
-private:
     /**
-     * Save the LOOP/LOOP2 packet to the archive file.
+     * Visit the current weather records from the past hours, oldest first, while the lock is held. Nothing is copied,
+     * so a visitor that only needs some of the records can keep just those records. The visitor must not call back into this manager.
      *
-     * @param packetTime The time that this packet was received
-     * @param packetType Whether this is a LOOP or a LOOP2 packet
-     * @param packetData The buffer containing the packet data
-     * @param length     The length of the packet data
+     * @param hours   How many hours to go back into the archive, with the same meaning as queryCurrentWeatherArchive()
+     * @param visitor The function that is called with the index of each record, the number of records being visited and the record
      */
-    void writeLoopArchive(DateTime packetTime, int packetType, const byte * packetData, size_t length);
+    void visitCurrentWeatherArchive(int hours, std::function<void (size_t index, size_t recordCount, const CurrentWeatherRecord & record)> visitor) const;
+
+private:
+    //
+    // One current weather record is kept for each LOOP/LOOP2 packet pair, so this holds 24 hours of records
+    //
+    static constexpr int RECENT_WEATHER_CAPACITY = LoopPacketRing::DEFAULT_RECORD_CAPACITY / 2;
 
     /**
-     * Read the archive file that is open in the stream.
+     * Add a record to the in-memory ring of recent current weather records, discarding the records that are too old.
      *
-     * @param ifs        The stream to read
-     * @param list       The list of current weather records read from the file
+     * @param cw The current weather record to add
      */
-    void readArchiveFile(std::ifstream & ifs, std::vector<CurrentWeather> & list);
+    void addRecentWeather(const CurrentWeather & cw);
 
     /**
-     * Build the name of the archive file based on a time.
+     * Find the first record of the in-memory ring that is within the past hours. The lock must be held by the caller.
      *
-     * @param time The time from which to build the archive filename
-     *
-     * @return The name of the archive file
+     * @param hours How many hours to go back into the archive
+     * @return The index of the first record in the in-memory ring
+     */
+    size_t findFirstRecentRecord(int hours) const;
+
+    /**
+     * Format the current weather JSON and publish it if a LOOP2 packet has been received.
      */
-    std::string archiveFilenameByTime(DateTime time);
+    void publishCurrentWeather();
 
     /**
-     * Build the name of the archive file based on an hour value.
+     * Save the LOOP/LOOP2 packet to the archive file.
      *
-     * @param hour The hour from which to build the archive filename
+     * @param packetTime The time that this packet was received
+     * @param packetType Whether this is a LOOP or a LOOP2 packet
+     * @param packetData The buffer containing the packet data
+     * @param length     The length of the packet data
+     */
+    void writeLoopArchive(DateTime packetTime, int packetType, const byte * packetData, size_t length);
+
+    /**
+     * Read the records of the loop archive starting at the specified record.
      *
-     * @return The name of the archive file
+     * @param firstRecord The index of the first record to read
+     * @param list        The list of current weather records read from the loop archive
      */
-    std::string archiveFilenameByHour(int hour);
+    void readArchiveRecords(int firstRecord, std::vector<CurrentWeather> & list) const;
 
     /**
      * Create archive directory.
@@ -133,14 +170,19 @@ private:
     void createArchiveDirectory();
 
     /**
-     * Cleanup the archive, removing any files that are too old.
+     * Cleanup the archive, importing the records of the past 24 hours from the hourly archive files that were used before
+     * the loop archive ring file into the ring file and then removing the hourly archive files. The ring file must be open.
      */
     void cleanupArchive();
 
-    mutable std::mutex        mutex;
+    mutable std::shared_mutex mutex;
     std::string               archiveDirectory;
+    LoopPacketRing            loopArchive;              // The ring file that holds the past 24 hours of LOOP/LOOP2 packets
+    std::deque<CurrentWeatherRecord> recentWeather;     // The current weather records of the past 24 hours, oldest first
+    bool                      loopPacketReceived;       // Whether a LOOP packet has been received since the last LOOP2 packet
     CurrentWeatherPublisher & currentWeatherPublisher;
     CurrentWeather            currentWeather;
+    std::shared_ptr<const std::string> currentWeatherJson; // The JSON of the current weather, replaced but never modified after it is formatted
     bool                      firstLoop2PacketReceived;
     DominantWindDirections    dominantWindDirections;   // The past wind direction measurements used to determine the arrows on the wind display
     bool                      initialized;
@@ -17,6 +17,7 @@
 #ifndef CURRENT_WEATHER_PUBLISHER_H
 #define CURRENT_WEATHER_PUBLISHER_H
 
+#include <string>
 
 namespace vws {
 class CurrentWeather;
@@ -34,9 +35,10 @@ public:
     /**
      * Publish a current weather record.
      *
-     * @param currentWeather The current weather record to be published
+     * @param currentWeather     The current weather record to be published
+     * @param currentWeatherJson The current weather record already formatted as JSON
      */
-    virtual void publishCurrentWeather(const CurrentWeather & currentWeather) = 0;
+    virtual void publishCurrentWeather(const CurrentWeather & currentWeather, const std::string & currentWeatherJson) = 0;
 };
 
 }
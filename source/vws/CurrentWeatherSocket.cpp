@@ -70,14 +70,13 @@ CurrentWeatherSocket::initialize() {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-CurrentWeatherSocket::publishCurrentWeather(const CurrentWeather & cw)
+CurrentWeatherSocket::publishCurrentWeather(const CurrentWeather & cw, const std::string & cwJson)
 {
     if (socketId == NO_SOCKET)
         return;
 
-    std::string s = cw.formatJSON();
-    const char * data = s.c_str();
-    size_t length = strlen(data);
+    const char * data = cwJson.c_str();
+    size_t length = cwJson.length();
     if (sendto(socketId, data, length, 0, reinterpret_cast<struct sockaddr *>(&groupAddr), sizeof(groupAddr)) != length) {
         int e = errno;
         logger.log(VantageLogger::VANTAGE_WARNING) <<  "sendto() for current weather failed. Errno = " << e << endl;
@@ -102,7 +101,7 @@ CurrentWeatherSocket::getLocalIpAddress(struct sockaddr_in & saddr)
         if (addr->ifa_addr && addr->ifa_addr->sa_family == AF_INET) {
             struct sockaddr_in *pAddr = reinterpret_cast<struct sockaddr_in *>(addr->ifa_addr);
             if (strncmp(addr->ifa_name, "lo", 2) != 0) {
-                logger.log(VantageLogger::VANTAGE_DEBUG1) << "Using " << addr->ifa_name << " (" << inet_ntoa(pAddr->sin_addr) << ") as local IP address" << endl;
+                VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Using " << addr->ifa_name << " (" << inet_ntoa(pAddr->sin_addr) << ") as local IP address" << endl;
                 saddr = *pAddr;
                 rv = true;
                 break;
@@ -67,10 +67,10 @@ public:
     /**
      * Publish the current weather.
      *
-     * @param cw The current weather to publish
-     *
+     * @param cw     The current weather to publish
+     * @param cwJson The current weather formatted as JSON
      */
-    virtual void publishCurrentWeather(const CurrentWeather & cw);
+    virtual void publishCurrentWeather(const CurrentWeather & cw, const std::string & cwJson);
 
 private:
     /**
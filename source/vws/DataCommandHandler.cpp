@@ -17,12 +17,19 @@
 
 #include "DataCommandHandler.h"
 
+#include <deque>
+#include <memory>
 #include <vector>
 #include "VantageLogger.h"
 #include "CommandData.h"
 #include "DateTimeFields.h"
 #include "StormArchiveManager.h"
 #include "ArchiveManager.h"
+#include "ArchiveResponseStream.h"
+#include "ArchiveFieldQuery.h"
+#include "ArchiveColumn.h"
+#include "ArchivePacket.h"
+#include "SeriesDownsampler.h"
 #include "AlarmManager.h"
 #include "CommandQueue.h"
 #include "SummaryReport.h"
@@ -38,38 +45,39 @@ namespace vws {
 struct DataCommandEntry {
     std::string commandName;
     void (DataCommandHandler::*handler)(CommandData &);
+    bool priority;                                      // Whether the command is cheap enough to be queued in the priority lane
 };
 
 /**
  * Table used to map the command name to the handler function.
  */
 static const DataCommandEntry dataCommandList[] = {
-        "query-archive-statistics", &DataCommandHandler::handleQueryArchiveStatistics,
-        "query-archive",            &DataCommandHandler::handleQueryArchive,
-        "query-archive-summary",    &DataCommandHandler::handleQueryArchiveSummary,
-        "query-storm-archive",      &DataCommandHandler::handleQueryStormArchive,
-        "clear-extended-archive",   &DataCommandHandler::handleClearExtendedArchive,
-        "query-weather-history",    &DataCommandHandler::handleQueryLoopArchive,
-        "query-alarm-history",      &DataCommandHandler::handleQueryAlarmHistory,
-        "query-current-weather",    &DataCommandHandler::handleQueryCurrentWeather
+        "query-archive-statistics", &DataCommandHandler::handleQueryArchiveStatistics, true,
+        "query-archive",            &DataCommandHandler::handleQueryArchive,           false,
+        "query-archive-summary",    &DataCommandHandler::handleQueryArchiveSummary,    false,
+        "query-storm-archive",      &DataCommandHandler::handleQueryStormArchive,      false,
+        "clear-extended-archive",   &DataCommandHandler::handleClearExtendedArchive,   false,
+        "query-weather-history",    &DataCommandHandler::handleQueryLoopArchive,       false,
+        "query-alarm-history",      &DataCommandHandler::handleQueryAlarmHistory,      false,
+        "query-current-weather",    &DataCommandHandler::handleQueryCurrentWeather,    true
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-dataCommandThreadEntry(DataCommandHandler * dch) {
-    dch->mainLoop();
+dataCommandThreadEntry(DataCommandHandler * dch, bool priorityOnly) {
+    dch->mainLoop(priorityOnly);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-DataCommandHandler::DataCommandHandler(ArchiveManager & am, StormArchiveManager & sam, CurrentWeatherManager & cwm, AlarmManager & alm) : archiveManager(am),
-                                                                                                                                         stormArchiveManager(sam),
-                                                                                                                                         currentWeatherManager(cwm),
-                                                                                                                                         alarmManager(alm),
-                                                                                                                                         terminating(false),
-                                                                                                                                         commandThread(NULL),
-                                                                                                                                         logger(VantageLogger::getLogger("DataCommandHandler")) {
+DataCommandHandler::DataCommandHandler(ArchiveManager & am, StormArchiveManager & sam, CurrentWeatherManager & cwm, AlarmManager & alm, int wc) : archiveManager(am),
+                                                                                                                                                 stormArchiveManager(sam),
+                                                                                                                                                 currentWeatherManager(cwm),
+                                                                                                                                                 alarmManager(alm),
+                                                                                                                                                 workerCount(wc < 1 ? 1 : wc),
+                                                                                                                                                 terminating(false),
+                                                                                                                                                 logger(VantageLogger::getLogger("DataCommandHandler")) {
 
 }
 
@@ -82,14 +90,22 @@ DataCommandHandler::~DataCommandHandler() {
 ////////////////////////////////////////////////////////////////////////////////
 void
 DataCommandHandler::start() {
-    commandThread = new thread(dataCommandThreadEntry, this);
+    logger.log(VantageLogger::VANTAGE_INFO) << "Starting " << workerCount << " data command worker threads" << endl;
+
+    //
+    // With a single worker, that worker must process both lanes
+    //
+    for (int i = 0; i < workerCount; i++) {
+        bool priorityOnly = workerCount > 1 && i == 0;
+        workerThreads.push_back(new thread(dataCommandThreadEntry, this, priorityOnly));
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 DataCommandHandler::handleCommand(CommandData & commandData) {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Processing command " << commandData << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Processing command " << commandData << endl;
     for (auto & commandEntry : dataCommandList) {
         if (commandData.commandName == commandEntry.commandName) {
             (this->*commandEntry.handler)(commandData);
@@ -104,16 +120,16 @@ DataCommandHandler::handleCommand(CommandData & commandData) {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 DataCommandHandler::offerCommand(const CommandData & commandData) {
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Being offered command " << commandData.commandName << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Being offered command " << commandData.commandName << endl;
     for (auto & entry : dataCommandList) {
         if (commandData.commandName == entry.commandName) {
-            commandQueue.queueCommand(commandData);
-            logger.log(VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " accepted" << endl;
+            commandQueue.queueCommand(commandData, entry.priority);
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " accepted" << endl;
             return true;
         }
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " rejected" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Offer of command " << commandData.commandName << " rejected" << endl;
     return false;
 }
 
@@ -128,12 +144,12 @@ DataCommandHandler::terminate() {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-DataCommandHandler::mainLoop() {
-    logger.log(VantageLogger::VANTAGE_INFO) << "Entering Data Command Handler thread" << endl;
+DataCommandHandler::mainLoop(bool priorityOnly) {
+    logger.log(VantageLogger::VANTAGE_INFO) << "Entering Data Command Handler " << (priorityOnly ? "priority " : "") << "worker thread" << endl;
     while (!terminating) {
         try {
             CommandData commandData;
-            if (commandQueue.waitForCommand(commandData)) {
+            if (commandQueue.waitForCommand(commandData, priorityOnly)) {
                 processCommand(commandData);
             }
         }
@@ -144,21 +160,27 @@ DataCommandHandler::mainLoop() {
             logger.log(VantageLogger::VANTAGE_ERROR) << "Caught unknown exception in DataCommandHandler::mainLoop." << endl;
         }
     }
-    logger.log(VantageLogger::VANTAGE_INFO) << "Exiting Data Command Handler thread" << endl;
+    logger.log(VantageLogger::VANTAGE_INFO) << "Exiting Data Command Handler " << (priorityOnly ? "priority " : "") << "worker thread" << endl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
 DataCommandHandler::join() {
-    if (commandThread != NULL && commandThread->joinable()) {
-        logger.log(VantageLogger::VANTAGE_INFO) << "Joining the thread" << endl;
-        commandThread->join();
-        delete commandThread;
-        commandThread = NULL;
+    if (workerThreads.empty()) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Ignoring join request. Threads were not created or are not running." << endl;
+        return;
     }
-    else
-        logger.log(VantageLogger::VANTAGE_WARNING) << "Ignoring join request. Thread was not created or is not running." << endl;
+
+    logger.log(VantageLogger::VANTAGE_INFO) << "Joining the worker threads" << endl;
+    for (thread * workerThread : workerThreads) {
+        if (workerThread->joinable())
+            workerThread->join();
+
+        delete workerThread;
+    }
+
+    workerThreads.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,12 +192,21 @@ DataCommandHandler::handleQueryArchiveStatistics(CommandData & commandData) {
     int            archiveRecordCount;
 
     archiveManager.getArchiveRange(oldestRecordTime, newestRecordTime, archiveRecordCount);
+    ArchiveManager::DownloadProgress download = archiveManager.getDownloadProgress();
 
     ostringstream oss;
     oss << SUCCESS_TOKEN << ", " << DATA_TOKEN << " : { "
         << "\"oldestRecordTime\" : \"" << oldestRecordTime.formatDateTime() << "\", "
         << "\"newestRecordTime\" : \"" << newestRecordTime.formatDateTime() << "\", "
-        << "\"recordCount\" : " << archiveRecordCount
+        << "\"recordCount\" : " << archiveRecordCount << ", "
+        << "\"download\" : { "
+        << "\"active\" : " << std::boolalpha << download.active << ", "
+        << "\"aborted\" : " << download.aborted << ", "
+        << "\"pageCount\" : " << download.pageCount << ", "
+        << "\"pagesReceived\" : " << download.pagesReceived << ", "
+        << "\"pagesCommitted\" : " << download.pagesCommitted << ", "
+        << "\"recordsCommitted\" : " << download.recordsCommitted
+        << " }"
         << "}";
 
     commandData.response.append(oss.str());
@@ -187,6 +218,12 @@ void
 DataCommandHandler::handleQueryArchive(CommandData & commandData) {
     DateTimeFields startTime;
     DateTimeFields endTime;
+    string fieldList;
+    int downsampleInterval = 0;
+    int maxPoints = 0;
+    string downsampleMethodName = "lttb";
+    string downsampleField = "avgOutsideTemperature";
+    SeriesDownsampler::Method downsampleMethod;
 
     for (CommandData::CommandArgument arg : commandData.arguments) {
         if (arg.first == "start-time") {
@@ -195,27 +232,103 @@ DataCommandHandler::handleQueryArchive(CommandData & commandData) {
         else if (arg.first == "end-time") {
             endTime.parseDateTime(arg.second);
         }
+        else if (arg.first == "fields") {
+            fieldList = arg.second;
+        }
+        else if (arg.first == "downsample-interval") {
+            downsampleInterval = atoi(arg.second.c_str());
+        }
+        else if (arg.first == "max-points") {
+            maxPoints = atoi(arg.second.c_str());
+        }
+        else if (arg.first == "downsample-method") {
+            downsampleMethodName = arg.second;
+        }
+        else if (arg.first == "downsample-field") {
+            downsampleField = arg.second;
+        }
     }
 
     if (!startTime.isDateTimeValid() || !endTime.isDateTimeValid()) {
         commandData.response.append(CommandData::buildFailureString("Missing argument"));
     }
-    else {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Query the archive with times: " << startTime.formatDateTime() << " - " << endTime.formatDateTime() << endl;
-        vector<ArchivePacket> packets;
-        archiveManager.queryArchiveRecords(startTime, endTime, packets);
+    else if (!SeriesDownsampler::parseMethod(downsampleMethodName, downsampleMethod)) {
+        commandData.response.append(CommandData::buildFailureString("Unknown downsample method '" + downsampleMethodName + "'"));
+    }
+    else if (!fieldList.empty() || downsampleInterval > 0) {
+        //
+        // A projected query only decodes the requested fields, so the response is small enough to be built in one piece
+        //
+        ArchiveFieldQuery query(archiveManager);
+        if (fieldList.empty()) {
+            commandData.response.append(CommandData::buildFailureString("Missing argument"));
+            return;
+        }
 
-        ostringstream oss;
-        oss << SUCCESS_TOKEN << ", " << DATA_TOKEN << " : [ ";
+        if (!query.setFields(fieldList)) {
+            commandData.response.append(CommandData::buildFailureString("Unknown archive field '" + query.getUnknownField() + "'"));
+            return;
+        }
+
+        query.setDownsampleInterval(downsampleInterval);
+        query.setPointLimit(downsampleMethod, maxPoints);
+
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Query archive fields '" << fieldList << "' with times: "
+                                                           << startTime.formatDateTime() << " - " << endTime.formatDateTime()
+                                                           << " Downsample interval: " << downsampleInterval << " Max points: " << maxPoints << endl;
 
+        commandData.response.append(SUCCESS_TOKEN + ", " + DATA_TOKEN + " : ");
+        commandData.response.append(query.queryJSON(startTime, endTime));
+    }
+    else if (maxPoints > 0) {
+        const ArchiveColumn * column = ArchiveColumn::findColumn(downsampleField);
+        if (column == nullptr) {
+            commandData.response.append(CommandData::buildFailureString("Unknown archive field '" + downsampleField + "'"));
+            return;
+        }
+
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Query the archive with times: " << startTime.formatDateTime() << " - " << endTime.formatDateTime()
+                                                           << " downsampled to " << maxPoints << " records using " << downsampleField << endl;
+
+        //
+        // Only the downsample field is decoded while the records are selected, then only the selected records
+        // are formatted, so the response is bounded by the maximum number of points regardless of the time range.
+        //
+        std::span<const byte> records;
+        std::shared_ptr<const MappedArchiveFile> mapping = archiveManager.queryArchiveRecordSpan(startTime, endTime, records);
+        size_t recordCount = records.size() / ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+
+        SeriesDownsampler downsampler(downsampleMethod, recordCount, maxPoints);
+        for (size_t i = 0; i < recordCount; i++) {
+            const byte * record = records.data() + (i * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+            downsampler.addPoint(i, static_cast<double>(ArchivePacket(record).getEpochDateTime()), column->decodeValue(record));
+        }
+
+        downsampler.finish();
+
+        string response = SUCCESS_TOKEN + ", " + DATA_TOKEN + " : [ ";
         bool first = true;
-        for (ArchivePacket packet : packets) {
-            if (!first) oss << ", "; else first = false;
-            oss << packet.formatJSON();
+        for (size_t index : downsampler.getSelectedIndices()) {
+            if (!first) response.append(", "); else first = false;
+            ArchivePacket packet(records.data(), index * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+            response.append(packet.formatJSON());
         }
 
-        oss << "]";
-        commandData.response.append(oss.str());
+        response.append(" ]");
+        commandData.response.append(response);
+    }
+    else {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Query the archive with times: " << startTime.formatDateTime() << " - " << endTime.formatDateTime() << endl;
+
+        //
+        // A long query can contain hundreds of thousands of records, so rather than formatting all of the records
+        // into the response, the records are formatted in chunks as they are written to the socket
+        //
+        std::span<const byte> records;
+        std::shared_ptr<const MappedArchiveFile> mapping = archiveManager.queryArchiveRecordSpan(startTime, endTime, records);
+
+        commandData.response.append(SUCCESS_TOKEN + ", " + DATA_TOKEN + " : [ ");
+        commandData.responseStream = std::make_shared<ArchiveResponseStream>(mapping, records);
     }
 }
 
@@ -262,7 +375,7 @@ DataCommandHandler::handleQueryArchiveSummary(CommandData & commandData) {
             !foundSummaryPeriodArgument)
             commandData.response.append(CommandData::buildFailureString("Missing argument"));
         else {
-            logger.log(VantageLogger::VANTAGE_DEBUG1) << "Query summaries from the archive with times: " << startTime << " - " << endTime << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Query summaries from the archive with times: " << startTime << " - " << endTime << endl;
             WindRoseData windRoseData(windUnits, speedBinIncrement, speedBinCount);
             SummaryReport report(summaryPeriod, startTime, endTime, archiveManager, windRoseData);
             report.loadData();
@@ -283,21 +396,88 @@ DataCommandHandler::handleQueryArchiveSummary(CommandData & commandData) {
 void
 DataCommandHandler::handleQueryLoopArchive(CommandData & commandData) {
     int hours = 1;
+    int maxPoints = 0;
+    string downsampleMethodName = "lttb";
+    string downsampleField = "outsideTemperature";
+    SeriesDownsampler::Method downsampleMethod;
+
     for (CommandData::CommandArgument arg : commandData.arguments) {
         if (arg.first == "hours") {
             hours = atoi(arg.second.c_str());
         }
+        else if (arg.first == "max-points") {
+            maxPoints = atoi(arg.second.c_str());
+        }
+        else if (arg.first == "downsample-method") {
+            downsampleMethodName = arg.second;
+        }
+        else if (arg.first == "downsample-field") {
+            downsampleField = arg.second;
+        }
+    }
+
+    if (!SeriesDownsampler::parseMethod(downsampleMethodName, downsampleMethod)) {
+        commandData.response.append(CommandData::buildFailureString("Unknown downsample method '" + downsampleMethodName + "'"));
+        return;
+    }
+
+    if (maxPoints > 0 && !CurrentWeather::isField(downsampleField)) {
+        commandData.response.append(CommandData::buildFailureString("Unknown weather history field '" + downsampleField + "'"));
+        return;
+    }
+
+    //
+    // The records are added to the downsampler as the in-memory ring is visited. Only the records that have been selected
+    // and the records that may still be selected are kept.
+    //
+    unique_ptr<SeriesDownsampler> downsampler;
+    deque<pair<size_t, CurrentWeatherManager::CurrentWeatherRecord>> candidates;
+    CurrentWeatherManager::CurrentWeatherRecordList selectedRecords;
+
+    auto keepSelectedRecords = [&downsampler, &candidates, &selectedRecords]() {
+        const vector<size_t> & selectedIndices = downsampler->getSelectedIndices();
+        for (size_t i = selectedRecords.size(); i < selectedIndices.size(); i++) {
+            while (candidates.front().first != selectedIndices[i])
+                candidates.pop_front();
+
+            selectedRecords.push_back(candidates.front().second);
+            candidates.pop_front();
+        }
+
+        size_t firstUndecidedIndex = downsampler->getFirstUndecidedIndex();
+        while (!candidates.empty() && candidates.front().first < firstUndecidedIndex)
+            candidates.pop_front();
+    };
+
+    currentWeatherManager.visitCurrentWeatherArchive(hours, [&](size_t index, size_t recordCount, const CurrentWeatherManager::CurrentWeatherRecord & record) {
+        //
+        // Without a point limit every record is selected
+        //
+        if (!downsampler)
+            downsampler.reset(new SeriesDownsampler(downsampleMethod, recordCount, maxPoints > 0 ? maxPoints : recordCount));
+
+        Measurement<double> value;
+        double fieldValue;
+        if (maxPoints > 0 && record->getFieldValue(downsampleField, fieldValue))
+            value.setValue(fieldValue);
+
+        candidates.push_back(make_pair(index, record));
+        downsampler->addPoint(index, static_cast<double>(record->getPacketTime()), value);
+        keepSelectedRecords();
+    });
+
+    if (downsampler) {
+        downsampler->finish();
+        keepSelectedRecords();
     }
 
-    vector<CurrentWeather> list;
-    currentWeatherManager.queryCurrentWeatherArchive(hours, list);
     ostringstream oss;
     oss << SUCCESS_TOKEN << ", " << DATA_TOKEN << " : [ ";
 
     bool first = true;
-    for (CurrentWeather cw : list) {
+    for (const CurrentWeatherManager::CurrentWeatherRecord & record : selectedRecords) {
         if (!first) oss << ", "; else first = false;
-        oss << cw.formatJSON();
+        oss << record->formatJSON();
     }
 
     oss << " ]";
@@ -379,7 +559,7 @@ DataCommandHandler::handleQueryAlarmHistory(CommandData & commandData) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 DataCommandHandler::handleQueryCurrentWeather(CommandData & commandData) {
-    CurrentWeather currentWeather = currentWeatherManager.getCurrentWeather();
-    commandData.response.append(SUCCESS_TOKEN).append(", ").append(DATA_TOKEN).append(" : ").append(currentWeather.formatJSON(false));
+    std::shared_ptr<const std::string> currentWeatherJson = currentWeatherManager.getCurrentWeatherJSON();
+    commandData.response.append(SUCCESS_TOKEN).append(", ").append(DATA_TOKEN).append(" : ").append(*currentWeatherJson);
 }
 }
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "CommandHandler.h"
 
@@ -33,9 +34,14 @@ class AlarmManager;
 /**
  * Command handler that will process command that do not need to talk to the Vantage Pro2 console, but can
  * retrieve all the necessary data from local storage.
+ * The commands are processed by a pool of worker threads. Cheap queries, such as the current weather, are queued
+ * in a priority lane. When there is more than one worker, the first worker only processes the priority lane so that
+ * cheap queries are never waiting behind long running queries, such as archive summaries.
  */
 class DataCommandHandler : public CommandHandler {
 public:
+    static constexpr int DEFAULT_WORKER_COUNT = 4;
+
     /**
      * Constructor.
      *
@@ -43,8 +49,9 @@ public:
      * @param stormArchiveManager   The manager to query past storms
      * @param currentWeatherManager The manager to query the loop packets that make up the current weather
      * @param alarmManager          The manager of alarm events
+     * @param workerCount           The number of worker threads that process the commands
      */
-    DataCommandHandler(ArchiveManager & archiveManager, StormArchiveManager & stormArchiveManager, CurrentWeatherManager & currentWeatherManager, AlarmManager & alarmManager);
+    DataCommandHandler(ArchiveManager & archiveManager, StormArchiveManager & stormArchiveManager, CurrentWeatherManager & currentWeatherManager, AlarmManager & alarmManager, int workerCount = DEFAULT_WORKER_COUNT);
 
     /**
      * Destructor.
@@ -52,7 +59,7 @@ public:
     virtual ~DataCommandHandler();
 
     /**
-     * Start the command loop thread.
+     * Start the worker threads.
      */
     void start();
 
@@ -73,17 +80,19 @@ public:
     virtual bool offerCommand(const CommandData & commandData);
 
     /**
-     * The main loop of the thread.
+     * The main loop of a worker thread.
+     *
+     * @param priorityOnly Whether this worker only processes the commands in the priority lane
      */
-    void mainLoop();
+    void mainLoop(bool priorityOnly);
 
     /**
-     * Trigger the thread to return.
+     * Trigger the worker threads to return.
      */
     void terminate();
 
     /**
-     * Join the thread.
+     * Join the worker threads.
      */
     void join();
 
@@ -111,8 +120,9 @@ private:
     StormArchiveManager &   stormArchiveManager;
     CurrentWeatherManager & currentWeatherManager;
     AlarmManager &          alarmManager;
+    int                     workerCount;         // The number of worker threads that process data commands
     bool                    terminating;
-    std::thread *           commandThread;       // The thread that processes data commands
+    std::vector<std::thread *> workerThreads;    // The threads that process data commands
     VantageLogger &         logger;
 };
 
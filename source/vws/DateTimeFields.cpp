@@ -17,6 +17,7 @@
 #include "DateTimeFields.h"
 
 #include <iomanip>
+#include "LocalTimeConverter.h"
 #include "Weather.h"
 
 using namespace std;
@@ -275,16 +276,9 @@ DateTimeFields::getEpochDateTime() const {
     // For instance on windows the time 2024-11-03 01:55:00 is converted to
     // a time that is not in DST where 2024-11-03 01:50:00 is in DST.
     // On LINUX both of these times are converted to times in DST.
+    // The converter returns the same value as mktime() on this platform.
     //
-    struct tm tm{};
-    tm.tm_year = year - Weather::TIME_STRUCT_YEAR_OFFSET;
-    tm.tm_mon = month - 1;
-    tm.tm_mday = monthDay;
-    tm.tm_hour = hour;
-    tm.tm_min = minute;
-    tm.tm_sec = second;
-    tm.tm_isdst = -1;
-    return mktime(&tm);
+    return LocalTimeConverter::localToEpoch(year, month, monthDay, hour, minute, second);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
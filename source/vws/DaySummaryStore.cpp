@@ -0,0 +1,636 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DaySummaryStore.h"
+
+#include <time.h>
+#include <string.h>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "MappedArchiveFile.h"
+#include "WindRoseData.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+static const byte STORE_MAGIC[] = {'V', 'W', 'S', 'D'};
+
+//
+// The date stamp fields, which use the same encoding as the archive packet
+//
+static constexpr int DATE_STAMP_DAY_MASK = 0x1F;
+static constexpr int DATE_STAMP_MONTH_SHIFT = 5;
+static constexpr int DATE_STAMP_MONTH_MASK = 0xF;
+static constexpr int DATE_STAMP_YEAR_SHIFT = 9;
+static constexpr int DATE_STAMP_YEAR_OFFSET = 2000;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static DateTimeFields
+dateStampToDay(int32 dateStamp) {
+    return DateTimeFields((dateStamp >> DATE_STAMP_YEAR_SHIFT) + DATE_STAMP_YEAR_OFFSET,
+                          (dateStamp >> DATE_STAMP_MONTH_SHIFT) & DATE_STAMP_MONTH_MASK,
+                          dateStamp & DATE_STAMP_DAY_MASK);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static int32
+recordDateStamp(const MappedArchiveFile & archive, int index) {
+    return MappedArchiveFile::recordTimeKey(archive.getRecord(index)) >> 16;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static void
+encodeInt32(vector<byte> & buffer, int32 value) {
+    byte bytes[4];
+    BitConverter::getBytes(value, bytes, 0, 4);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(bytes));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static void
+encodeInt64(vector<byte> & buffer, int64_t value) {
+    encodeInt32(buffer, static_cast<int32>(value & 0xFFFFFFFF));
+    encodeInt32(buffer, static_cast<int32>(value >> 32));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+static void
+encodeDouble(vector<byte> & buffer, double value) {
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    encodeInt64(buffer, bits);
+}
+
+/**
+ * Reads the fields of a day record payload. A read past the end of the payload returns zero and marks the decoder as failed.
+ */
+class PayloadDecoder {
+public:
+    PayloadDecoder(const byte * payload, int length) : payload(payload), length(length), offset(0), failed(false) {}
+
+    int32 decodeInt32() {
+        if (offset + 4 > length) {
+            failed = true;
+            return 0;
+        }
+
+        int32 value = BitConverter::toInt32(payload, offset);
+        offset += 4;
+        return value;
+    }
+
+    int64_t decodeInt64() {
+        uint32 low = static_cast<uint32>(decodeInt32());
+        int64_t high = decodeInt32();
+        return (high << 32) | low;
+    }
+
+    double decodeDouble() {
+        int64_t bits = decodeInt64();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    int remaining() const {
+        return length - offset;
+    }
+
+    bool isValid() const {
+        return !failed && offset == length;
+    }
+
+private:
+    const byte * payload;
+    int          length;
+    int          offset;
+    bool         failed;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+template<typename M, SummaryExtremeType ET>
+static void
+encodeExtreme(vector<byte> & buffer, const ExtremeMeasurement<M,ET> & extreme) {
+    encodeInt32(buffer, extreme.extremeValue.isValid() ? 1 : 0);
+    encodeDouble(buffer, extreme.extremeValue.getValue());
+    encodeInt64(buffer, extreme.extremeTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+template<typename M, SummaryExtremeType ET>
+static void
+decodeExtreme(PayloadDecoder & decoder, ExtremeMeasurement<M,ET> & extreme) {
+    bool valid = decoder.decodeInt32() != 0;
+    M value = static_cast<M>(decoder.decodeDouble());
+    DateTime time = decoder.decodeInt64();
+
+    if (valid) {
+        extreme.extremeValue.setValue(value);
+        extreme.extremeTime = time;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+template<typename M, SummaryExtremes SE>
+static void
+encodeSummaryMeasurement(vector<byte> & buffer, const SummaryMeasurement<M,SE> & measurement) {
+    encodeInt32(buffer, measurement.average.sampleCount);
+    encodeDouble(buffer, measurement.average.sum.getValue());
+    encodeExtreme(buffer, measurement.high);
+    encodeExtreme(buffer, measurement.low);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+template<typename M, SummaryExtremes SE>
+static void
+decodeSummaryMeasurement(PayloadDecoder & decoder, SummaryMeasurement<M,SE> & measurement) {
+    int sampleCount = decoder.decodeInt32();
+    M sum = static_cast<M>(decoder.decodeDouble());
+
+    //
+    // The average is calculated the same way as MeasurementAverage calculates it as each measurement is applied
+    //
+    if (sampleCount > 0) {
+        measurement.average.sampleCount = sampleCount;
+        measurement.average.sum.setValue(sum);
+        measurement.average.average.setValue(sum / static_cast<M>(sampleCount));
+    }
+
+    decodeExtreme(decoder, measurement.high);
+    decodeExtreme(decoder, measurement.low);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+template<typename R, typename F>
+static void
+forEachSummaryMeasurement(R & record, F function) {
+    function(record.outsideTemperature);
+    function(record.rainfallRate);
+    function(record.barometer);
+    function(record.solarRadiation);
+    function(record.insideTemperature);
+    function(record.insideHumidity);
+    function(record.outsideHumidity);
+    function(record.sustainedWindSpeed);
+    function(record.gustWindSpeed);
+    function(record.uvIndex);
+    function(record.et);
+
+    for (auto & measurement : record.extraTemperatures)
+        function(measurement);
+
+    for (auto & measurement : record.extraHumidities)
+        function(measurement);
+
+    for (auto & measurement : record.leafTemperatures)
+        function(measurement);
+
+    for (auto & measurement : record.soilTemperatures)
+        function(measurement);
+
+    for (auto & measurement : record.leafWetnesses)
+        function(measurement);
+
+    for (auto & measurement : record.soilMoistures)
+        function(measurement);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+DaySummary::DaySummary(const DateTimeFields & day) : summaryRecord(SummaryPeriod::DAY,
+                                                                   DateTimeFields(day.getYear(), day.getMonth(), day.getMonthDay(), 0, 0, 0).getEpochDateTime(),
+                                                                   DateTimeFields(day.getYear(), day.getMonth(), day.getMonthDay(), 23, 59, 59).getEpochDateTime()) {
+    for (int i = 0; i < HOURS_PER_DAY; i++)
+        hourRainfall[i] = 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummary::applyArchivePacket(const ArchivePacket & packet) {
+    summaryRecord.applyArchivePacket(packet);
+
+    DateTime packetTime = packet.getEpochDateTime();
+    struct tm tm;
+    localtime_r(&packetTime, &tm);
+    hourRainfall[tm.tm_hour] += packet.getRainfall();
+
+    Measurement<HeadingIndex> heading = packet.getPrevailingWindHeadingIndex();
+    HeadingIndex headingIndex = heading.isValid() ? heading.getValue() : -1;
+    Speed speed = packet.getAverageWindSpeed();
+
+    for (auto & sample : windSamples) {
+        if (sample.headingIndex == headingIndex && sample.speed == speed) {
+            sample.sampleCount++;
+            return;
+        }
+    }
+
+    DayWindSample sample;
+    sample.headingIndex = headingIndex;
+    sample.speed = speed;
+    sample.sampleCount = 1;
+    windSamples.push_back(sample);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummary::applyWindSamples(WindRoseData & windRoseData) const {
+    for (const auto & sample : windSamples) {
+        Measurement<HeadingIndex> heading;
+        if (sample.headingIndex >= 0)
+            heading.setValue(sample.headingIndex);
+
+        windRoseData.applyWindSample(heading, sample.speed, sample.sampleCount);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+DaySummaryStore::DaySummaryStore(const string & file) : storeFile(file),
+                                                        fileLength(0),
+                                                        logger(VantageLogger::getLogger("DaySummaryStore")) {
+    load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+DaySummaryStore::~DaySummaryStore() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+DaySummaryStore::load() {
+    entries.clear();
+    fileLength = 0;
+
+    error_code ec;
+    std::uintmax_t fileSize = std::filesystem::file_size(storeFile, ec);
+    if (ec) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Day summary file '" << storeFile << "' does not exist" << endl;
+        return false;
+    }
+
+    ifstream stream(storeFile.c_str(), ios::in | ios::binary);
+    byte header[DAY_HEADER_SIZE];
+    stream.read(header, HEADER_SIZE);
+    if (!stream || !equal(begin(STORE_MAGIC), end(STORE_MAGIC), header) || BitConverter::toInt32(header, VERSION_OFFSET) != STORE_VERSION) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Day summary file '" << storeFile << "' has an invalid header" << endl;
+        return false;
+    }
+
+    //
+    // Only the day record headers are read, the payloads are read when the summaries are queried
+    //
+    size_t offset = HEADER_SIZE;
+    while (offset + DAY_HEADER_SIZE <= fileSize) {
+        stream.seekg(offset);
+        stream.read(header, DAY_HEADER_SIZE);
+        if (!stream)
+            break;
+
+        DayEntry entry;
+        entry.length = BitConverter::toInt32(header, 0);
+        entry.dateStamp = BitConverter::toInt32(header, 4);
+        entry.firstRecord = BitConverter::toInt32(header, 8);
+        entry.recordCount = BitConverter::toInt32(header, 12);
+        entry.fileOffset = offset + DAY_HEADER_SIZE;
+
+        if (entry.length < 0 || entry.fileOffset + entry.length > fileSize)
+            break;
+
+        entries.push_back(entry);
+        offset = entry.fileOffset + entry.length;
+    }
+
+    fileLength = offset;
+
+    if (fileLength != fileSize)
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Day summary file '" << storeFile << "' has a partial day record at the end. It will be removed." << endl;
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Loaded day summary store with " << entries.size() << " days covering " << getSummarizedRecordCount() << " records" << endl;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummaryStore::synchronize(const MappedArchiveFile & archive) {
+    if (!isConsistent(archive)) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Day summary file '" << storeFile << "' is stale. Rebuilding the day summaries." << endl;
+        rebuild(archive);
+    }
+    else
+        summarizeNewDays(archive);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummaryStore::rebuild(const MappedArchiveFile & archive) {
+    entries.clear();
+    writeHeader();
+    summarizeNewDays(archive);
+
+    logger.log(VantageLogger::VANTAGE_INFO) << "Rebuilt day summary store with " << entries.size() << " days covering " << getSummarizedRecordCount() << " records" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+DaySummaryStore::isConsistent(const MappedArchiveFile & archive) const {
+    if (entries.size() == 0)
+        return true;
+
+    const DayEntry & first = entries.front();
+    const DayEntry & last = entries.back();
+    int nextRecord = last.firstRecord + last.recordCount;
+
+    if (first.firstRecord != 0 || last.recordCount <= 0 || nextRecord > archive.getRecordCount())
+        return false;
+
+    //
+    // Spot check the first and last days. This will catch an archive that was cleared, restored or rebuilt since the
+    // store was written.
+    //
+    if (recordDateStamp(archive, 0) != first.dateStamp)
+        return false;
+
+    if (recordDateStamp(archive, last.firstRecord) != last.dateStamp || recordDateStamp(archive, nextRecord - 1) != last.dateStamp)
+        return false;
+
+    if (last.firstRecord > 0 && recordDateStamp(archive, last.firstRecord - 1) >= last.dateStamp)
+        return false;
+
+    if (nextRecord < archive.getRecordCount() && recordDateStamp(archive, nextRecord) <= last.dateStamp)
+        return false;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummaryStore::clear() {
+    entries.clear();
+    writeHeader();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+DaySummaryStore::readDaySummaries(const DateTimeFields & startDay, const DateTimeFields & endDay, vector<DaySummary> & summaries) const {
+    summaries.clear();
+
+    int firstEntry = findFirstEntryOnOrAfter(MappedArchiveFile::timeKey(startDay) >> 16);
+    int lastEntry = findFirstEntryOnOrAfter((MappedArchiveFile::timeKey(endDay) >> 16) + 1);
+
+    if (firstEntry >= lastEntry)
+        return true;
+
+    //
+    // The days are contiguous in the file, so all of them are read at once
+    //
+    size_t readStart = entries[firstEntry].fileOffset;
+    size_t readEnd = entries[lastEntry - 1].fileOffset + entries[lastEntry - 1].length;
+    vector<byte> buffer(readEnd - readStart);
+
+    ifstream stream(storeFile.c_str(), ios::in | ios::binary);
+    stream.seekg(readStart);
+    stream.read(buffer.data(), buffer.size());
+    if (!stream) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to read day summaries from '" << storeFile << "'" << endl;
+        return false;
+    }
+
+    summaries.reserve(lastEntry - firstEntry);
+    for (int i = firstEntry; i < lastEntry; i++) {
+        const DayEntry & entry = entries[i];
+        summaries.emplace_back(dateStampToDay(entry.dateStamp));
+        if (!decodeDaySummary(buffer.data() + (entry.fileOffset - readStart), entry.length, summaries.back())) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to decode day summary for day with date stamp " << entry.dateStamp << " in '" << storeFile << "'" << endl;
+            summaries.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+DaySummaryStore::getSummarizedRecordCount() const {
+    if (entries.size() == 0)
+        return 0;
+    else
+        return entries.back().firstRecord + entries.back().recordCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+DaySummaryStore::getDayCount() const {
+    return entries.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummaryStore::summarizeNewDays(const MappedArchiveFile & archive) {
+    int recordCount = archive.getRecordCount();
+    int firstRecord = getSummarizedRecordCount();
+
+    if (firstRecord >= recordCount)
+        return;
+
+    if (fileLength < HEADER_SIZE)
+        writeHeader();
+
+    //
+    // The day of the newest record may still receive records, so it is not summarized
+    //
+    int32 newestDateStamp = recordDateStamp(archive, recordCount - 1);
+    int32 lastDateStamp = entries.size() > 0 ? entries.back().dateStamp : -1;
+
+    vector<byte> buffer;
+    vector<DayEntry> newEntries;
+    vector<byte> payload;
+
+    int dayStart = firstRecord;
+    while (dayStart < recordCount) {
+        int32 dateStamp = recordDateStamp(archive, dayStart);
+        if (dateStamp >= newestDateStamp)
+            break;
+
+        int dayEnd = dayStart + 1;
+        while (dayEnd < recordCount && recordDateStamp(archive, dayEnd) == dateStamp)
+            dayEnd++;
+
+        if (dateStamp <= lastDateStamp) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Archive records " << dayStart << " to " << dayEnd - 1 << " are out of order. They will not be summarized." << endl;
+            dayStart = dayEnd;
+            continue;
+        }
+
+        DaySummary summary(dateStampToDay(dateStamp));
+        for (int i = dayStart; i < dayEnd; i++)
+            summary.applyArchivePacket(ArchivePacket(archive.getRecord(i)));
+
+        payload.clear();
+        encodeDaySummary(summary, payload);
+
+        DayEntry entry;
+        entry.dateStamp = dateStamp;
+        entry.firstRecord = dayStart;
+        entry.recordCount = dayEnd - dayStart;
+        entry.length = payload.size();
+        entry.fileOffset = fileLength + buffer.size() + DAY_HEADER_SIZE;
+        newEntries.push_back(entry);
+
+        encodeInt32(buffer, entry.length);
+        encodeInt32(buffer, entry.dateStamp);
+        encodeInt32(buffer, entry.firstRecord);
+        encodeInt32(buffer, entry.recordCount);
+        buffer.insert(buffer.end(), payload.begin(), payload.end());
+
+        lastDateStamp = dateStamp;
+        dayStart = dayEnd;
+    }
+
+    if (newEntries.size() == 0)
+        return;
+
+    //
+    // Make sure the file does not have a partial day record at the end before appending
+    //
+    error_code ec;
+    if (std::filesystem::file_size(storeFile, ec) != fileLength && !ec)
+        std::filesystem::resize_file(storeFile, fileLength, ec);
+
+    fstream stream(storeFile.c_str(), ios::in | ios::out | ios::binary);
+    stream.seekp(fileLength);
+    stream.write(buffer.data(), buffer.size());
+    stream.close();
+
+    if (!stream) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to append day summaries to '" << storeFile << "'" << endl;
+        return;
+    }
+
+    entries.insert(entries.end(), newEntries.begin(), newEntries.end());
+    fileLength += buffer.size();
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Added " << newEntries.size() << " days to the day summary store" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummaryStore::writeHeader() {
+    byte header[HEADER_SIZE];
+    copy(begin(STORE_MAGIC), end(STORE_MAGIC), header);
+    BitConverter::getBytes(STORE_VERSION, header, VERSION_OFFSET, 4);
+
+    ofstream stream(storeFile.c_str(), ios::out | ios::trunc | ios::binary);
+    stream.write(header, sizeof(header));
+
+    if (!stream)
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to write day summary file '" << storeFile << "'" << endl;
+
+    fileLength = HEADER_SIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+DaySummaryStore::encodeDaySummary(const DaySummary & summary, vector<byte> & buffer) {
+    encodeInt32(buffer, summary.summaryRecord.packetCount);
+    encodeDouble(buffer, summary.summaryRecord.totalRainfall);
+
+    for (int i = 0; i < DaySummary::HOURS_PER_DAY; i++)
+        encodeDouble(buffer, summary.hourRainfall[i]);
+
+    forEachSummaryMeasurement(summary.summaryRecord, [&buffer](const auto & measurement) { encodeSummaryMeasurement(buffer, measurement); });
+
+    encodeInt32(buffer, summary.windSamples.size());
+    for (const auto & sample : summary.windSamples) {
+        encodeInt32(buffer, sample.headingIndex);
+        encodeDouble(buffer, sample.speed);
+        encodeInt32(buffer, sample.sampleCount);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+DaySummaryStore::decodeDaySummary(const byte * payload, int length, DaySummary & summary) {
+    static constexpr int WIND_SAMPLE_SIZE = 16;
+
+    PayloadDecoder decoder(payload, length);
+
+    summary.summaryRecord.packetCount = decoder.decodeInt32();
+    summary.summaryRecord.totalRainfall = decoder.decodeDouble();
+
+    for (int i = 0; i < DaySummary::HOURS_PER_DAY; i++)
+        summary.hourRainfall[i] = decoder.decodeDouble();
+
+    forEachSummaryMeasurement(summary.summaryRecord, [&decoder](auto & measurement) { decodeSummaryMeasurement(decoder, measurement); });
+
+    int sampleCount = decoder.decodeInt32();
+    if (sampleCount < 0 || sampleCount * WIND_SAMPLE_SIZE != decoder.remaining())
+        return false;
+
+    summary.windSamples.resize(sampleCount);
+    for (auto & sample : summary.windSamples) {
+        sample.headingIndex = decoder.decodeInt32();
+        sample.speed = decoder.decodeDouble();
+        sample.sampleCount = decoder.decodeInt32();
+    }
+
+    return decoder.isValid();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+DaySummaryStore::findFirstEntryOnOrAfter(int32 dateStamp) const {
+    auto it = lower_bound(entries.begin(), entries.end(), dateStamp, [](const DayEntry & entry, int32 value) { return entry.dateStamp < value; });
+    return it - entries.begin();
+}
+}
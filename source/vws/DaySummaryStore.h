@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DAY_SUMMARY_STORE_H
+#define DAY_SUMMARY_STORE_H
+
+#include <string>
+#include <vector>
+
+#include "WeatherTypes.h"
+#include "SummaryReport.h"
+
+namespace vws {
+class VantageLogger;
+class MappedArchiveFile;
+class ArchivePacket;
+class DateTimeFields;
+class WindRoseData;
+
+static const std::string DAY_SUMMARY_FILE_SUFFIX = ".days";
+
+/**
+ * A wind sample along with the number of archive packets during a day that had the same wind heading and speed.
+ */
+struct DayWindSample {
+    HeadingIndex headingIndex;  // The prevailing wind heading index or -1 if the heading was not valid
+    Speed        speed;         // The average wind speed
+    int          sampleCount;   // The number of archive packets with this heading and speed
+};
+
+/**
+ * The rollup of the archive packets for a single day. A day summary holds everything a summary report uses from the
+ * archive packets, so a summary report can be built from day summaries without reading the archive packets.
+ */
+class DaySummary {
+public:
+    static constexpr int HOURS_PER_DAY = 24;
+
+    /**
+     * Constructor.
+     *
+     * @param day The day that this summary represents, the time fields are ignored
+     */
+    explicit DaySummary(const DateTimeFields & day);
+
+    /**
+     * Apply an archive packet that was recorded on the day of this summary.
+     *
+     * @param packet The packet to apply
+     */
+    void applyArchivePacket(const ArchivePacket & packet);
+
+    /**
+     * Apply the wind samples of this day to the wind rose data.
+     *
+     * @param windRoseData The wind rose data to which the samples are applied
+     */
+    void applyWindSamples(WindRoseData & windRoseData) const;
+
+    SummaryRecord              summaryRecord;               // The summary record with a period of DAY
+    Rainfall                   hourRainfall[HOURS_PER_DAY]; // The rainfall that fell during each hour of the day
+    std::vector<DayWindSample> windSamples;                 // The distinct wind samples of the day
+};
+
+/**
+ * A store of day summaries that are rolled up from the archive and kept in a file next to the archive. Only complete days,
+ * that is days before the day of the newest archive record, are kept in the store. The store is a cache of the archive,
+ * if it is found to be inconsistent with the archive it is rebuilt.
+ *
+ * The store file is an 8 byte header followed by variable length day records:
+ *     Header:     "VWSD", version
+ *     Day record: payload length, date stamp, index of the first archive record of the day, number of archive records, payload
+ *
+ * The header fields of the day records are little endian integers. The payload is the encoded DaySummary.
+ */
+class DaySummaryStore {
+public:
+    /**
+     * Constructor that loads the store file if it exists.
+     *
+     * @param storeFile The path of the store file
+     */
+    explicit DaySummaryStore(const std::string & storeFile);
+
+    /**
+     * Destructor.
+     */
+    ~DaySummaryStore();
+
+    /**
+     * Bring the store up to date with the archive. If the store is consistent with the archive only the days that were
+     * completed since the last synchronization are rolled up and appended to the store file, otherwise the store is rebuilt.
+     *
+     * @param archive The archive being rolled up
+     */
+    void synchronize(const MappedArchiveFile & archive);
+
+    /**
+     * Rebuild the store from the archive and rewrite the store file.
+     *
+     * @param archive The archive being rolled up
+     */
+    void rebuild(const MappedArchiveFile & archive);
+
+    /**
+     * Check if the store is consistent with the archive. A store that is missing days at the end of the archive is still consistent.
+     *
+     * @param archive The archive being rolled up
+     * @return True if the days in the store match the archive
+     */
+    bool isConsistent(const MappedArchiveFile & archive) const;
+
+    /**
+     * Remove all days from the store and the store file.
+     */
+    void clear();
+
+    /**
+     * Read the summaries of the days within a range of days. Days without any archive records do not have a summary.
+     *
+     * @param startDay  The first day to read, the time fields are ignored
+     * @param endDay    The last day to read, the time fields are ignored
+     * @param summaries The day summaries that were read
+     * @return True if the store file was read successfully
+     */
+    bool readDaySummaries(const DateTimeFields & startDay, const DateTimeFields & endDay, std::vector<DaySummary> & summaries) const;
+
+    /**
+     * Get the number of archive records that have been rolled up into the store. This is also the index of the
+     * first archive record that is not included in the store.
+     *
+     * @return The number of archive records
+     */
+    int getSummarizedRecordCount() const;
+
+    /**
+     * Get the number of days in the store.
+     *
+     * @return The number of days
+     */
+    int getDayCount() const;
+
+private:
+    static constexpr int HEADER_SIZE = 8;
+    static constexpr int STORE_VERSION = 1;
+    static constexpr int VERSION_OFFSET = 4;
+    static constexpr int DAY_HEADER_SIZE = 16;
+
+    struct DayEntry {
+        int32  dateStamp;    // The date stamp of the day
+        int32  firstRecord;  // The index of the first archive record of the day
+        int32  recordCount;  // The number of archive records of the day
+        size_t fileOffset;   // The offset of the payload in the store file
+        int32  length;       // The length of the payload
+    };
+
+    /**
+     * Load the day entries from the store file.
+     *
+     * @return True if the store file was loaded
+     */
+    bool load();
+
+    /**
+     * Roll up the complete days in the archive that are not yet in the store and append them to the store file.
+     *
+     * @param archive The archive being rolled up
+     */
+    void summarizeNewDays(const MappedArchiveFile & archive);
+
+    /**
+     * Write an empty store file.
+     */
+    void writeHeader();
+
+    /**
+     * Encode a day summary into the payload of a day record.
+     *
+     * @param summary The day summary to encode
+     * @param buffer  The buffer to which the payload is appended
+     */
+    static void encodeDaySummary(const DaySummary & summary, std::vector<byte> & buffer);
+
+    /**
+     * Decode a day summary from the payload of a day record.
+     *
+     * @param payload The payload
+     * @param length  The length of the payload
+     * @param summary The day summary into which the payload is decoded
+     * @return True if the payload was decoded successfully
+     */
+    static bool decodeDaySummary(const byte * payload, int length, DaySummary & summary);
+
+    /**
+     * Find the first day in the store whose date stamp is on or after the specified date stamp.
+     *
+     * @param dateStamp The date stamp to search for
+     * @return The index of the entry or the number of entries if all days are before the date stamp
+     */
+    int findFirstEntryOnOrAfter(int32 dateStamp) const;
+
+    std::string           storeFile;  // The path of the store file
+    std::vector<DayEntry> entries;    // One entry per day in the store
+    size_t                fileLength; // The length of the valid portion of the store file
+    VantageLogger &       logger;
+};
+}
+
+#endif
@@ -112,7 +112,7 @@ DominantWindDirections::startWindow(DateTime time) {
         startOf10MinuteTimeWindow = time - (time % 60);
     }
     else if (endOf10MinuteTimeWindow + DOMINANT_DIR_DURATION < time) {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Resetting end window time due to large gap in samples" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Resetting end window time due to large gap in samples" << endl;
         startOf10MinuteTimeWindow = time - (time % 60);
     }
     else {
@@ -122,7 +122,7 @@ DominantWindDirections::startWindow(DateTime time) {
 
     endOf10MinuteTimeWindow = startOf10MinuteTimeWindow + AGE_SPAN;
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Starting new window: " << dateFormat(startOf10MinuteTimeWindow) << "-" << dateFormat(endOf10MinuteTimeWindow) << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Starting new window: " << dateFormat(startOf10MinuteTimeWindow) << "-" << dateFormat(endOf10MinuteTimeWindow) << endl;
 
     saveCheckpoint();
 }
@@ -131,12 +131,12 @@ DominantWindDirections::startWindow(DateTime time) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 DominantWindDirections::endWindow(DateTime time) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Ending window: " << dateFormat(startOf10MinuteTimeWindow) << "-" << dateFormat(endOf10MinuteTimeWindow) << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Ending window: " << dateFormat(startOf10MinuteTimeWindow) << "-" << dateFormat(endOf10MinuteTimeWindow) << endl;
     WindDirectionSlice * slice = findDominantWindDirection();
 
     if (slice != NULL) {
         slice->setLast10MinuteDominantTime(endOf10MinuteTimeWindow);
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Dominant wind direction is " << slice->getName() << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Dominant wind direction is " << slice->getName() << endl;
     }
 
     //
@@ -186,8 +186,8 @@ DominantWindDirections::checkForEndOfWindow(DateTime time) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 DominantWindDirections::processWindSample(DateTime time, Heading heading, Speed speed) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Processing wind sample at time " << dateFormat(time) << " Heading = " << heading << " Speed = " << speed << endl;
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Active window: " << dateFormat(startOf10MinuteTimeWindow) << "-" << dateFormat(endOf10MinuteTimeWindow) << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Processing wind sample at time " << dateFormat(time) << " Heading = " << heading << " Speed = " << speed << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Active window: " << dateFormat(startOf10MinuteTimeWindow) << "-" << dateFormat(endOf10MinuteTimeWindow) << endl;
     bool windowEnded = checkForEndOfWindow(time);
 
     //
@@ -288,7 +288,7 @@ DominantWindDirections::restoreCheckpoint() {
             return;
         }
 
-        logger.log(VantageLogger::VANTAGE_DEBUG3) << "Read checkpoint file line with Heading: " << heading << " Time: " << dtime << " Count: " << count << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Read checkpoint file line with Heading: " << heading << " Time: " << dtime << " Count: " << count << endl;
 
         //
         // Make sure the data is valid
@@ -371,7 +371,7 @@ DominantWindDirections::dumpDataShort() const {
         oss << "[" << setw(3) << windSlices[i].getName() << " " << windSlices[i].getSampleCount() << "], ";
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << oss.str() << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << oss.str() << endl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -395,7 +395,7 @@ DominantWindDirections::dumpData() const {
             << endl;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << endl << oss.str() << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << endl << oss.str() << endl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
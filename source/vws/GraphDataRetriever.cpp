@@ -43,7 +43,7 @@ GraphDataRetriever::~GraphDataRetriever() {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 GraphDataRetriever::retrieveStormData(std::vector<StormData> & storms) {
-    logger->log(VantageLogger::VANTAGE_DEBUG2) << "Retrieving storm data from EEPROM" << endl;
+    VANTAGE_LOG(*logger, VantageLogger::VANTAGE_DEBUG2) << "Retrieving storm data from EEPROM" << endl;
     storms.clear();
 
     byte buffer[EEPROM_STORM_DATA_SIZE];
@@ -66,17 +66,17 @@ GraphDataRetriever::retrieveStormData(std::vector<StormData> & storms) {
 
         StormData storm(stormStart, stormEnd, rainfall);
 
-        logger->log(VantageLogger::VANTAGE_DEBUG2) << "Retrieved storm record from EEPROM. Record[" << i << "]: "
-                                                   << "Start: " << storm.getStormStart().formatDate()
-                                                   << " End: " << storm.getStormEnd().formatDate()
-                                                   << " Rainfall: " << storm.getStormRain() << endl;
+        VANTAGE_LOG(*logger, VantageLogger::VANTAGE_DEBUG2) << "Retrieved storm record from EEPROM. Record[" << i << "]: "
+                                                            << "Start: " << storm.getStormStart().formatDate()
+                                                            << " End: " << storm.getStormEnd().formatDate()
+                                                            << " Rainfall: " << storm.getStormRain() << endl;
 
         if (storm.hasStormEnded())
             storms.push_back(storm);
 
     }
 
-    logger->log(VantageLogger::VANTAGE_DEBUG2) << "Retrieved " << storms.size() << " storm records from EEPROM" << endl;
+    VANTAGE_LOG(*logger, VantageLogger::VANTAGE_DEBUG2) << "Retrieved " << storms.size() << " storm records from EEPROM" << endl;
 
     std::sort(storms.begin(), storms.end());
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LocalTimeConverter.h"
+
+#include <time.h>
+
+#include "Weather.h"
+
+namespace vws {
+
+static constexpr int DAYS_PER_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+static constexpr int MINIMUM_YEAR = 1902;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+DateTime
+LocalTimeConverter::localToEpoch(int year, int month, int monthDay, int hour, int minute, int second) {
+    //
+    // mktime() normalizes fields that are out of range, so leave those conversions to mktime()
+    //
+    if (year < MINIMUM_YEAR || month < 1 || month > 12 || monthDay < 1 || hour < 0 || hour > 23 ||
+        minute < 0 || minute > 59 || second < 0 || second > 59)
+        return mktimeToEpoch(year, month, monthDay, hour, minute, second);
+
+    bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    int daysInMonth = DAYS_PER_MONTH[month - 1] + (month == 2 && leapYear ? 1 : 0);
+    if (monthDay > daysInMonth)
+        return mktimeToEpoch(year, month, monthDay, hour, minute, second);
+
+    static thread_local DayEntry dayTable[DAY_TABLE_SIZE];
+
+    long dayNumber = daysFromCivil(year, month, monthDay);
+    DayEntry & entry = dayTable[((dayNumber % DAY_TABLE_SIZE) + DAY_TABLE_SIZE) % DAY_TABLE_SIZE];
+    if (!entry.loaded || entry.dayNumber != dayNumber)
+        loadDayEntry(entry, dayNumber, year, month, monthDay);
+
+    if (!entry.constantOffset)
+        return mktimeToEpoch(year, month, monthDay, hour, minute, second);
+
+    return (dayNumber * Weather::SECONDS_PER_DAY) + (hour * Weather::SECONDS_PER_HOUR) + (minute * 60) + second - entry.utcOffset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+long
+LocalTimeConverter::daysFromCivil(int year, int month, int monthDay) {
+    //
+    // Count the years from March so that the leap day is the last day of the year
+    //
+    long y = year - (month <= 2 ? 1 : 0);
+    long era = (y >= 0 ? y : y - 399) / 400;
+    long yearOfEra = y - (era * 400);
+    long dayOfYear = (((153 * (month > 2 ? month - 3 : month + 9)) + 2) / 5) + monthDay - 1;
+    long dayOfEra = (yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear;
+
+    //
+    // 719468 is the number of days between 0000-03-01 and 1970-01-01
+    //
+    return (era * 146097) + dayOfEra - 719468;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+DateTime
+LocalTimeConverter::mktimeToEpoch(int year, int month, int monthDay, int hour, int minute, int second) {
+    struct tm tm{};
+    tm.tm_year = year - Weather::TIME_STRUCT_YEAR_OFFSET;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = monthDay;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+LocalTimeConverter::loadDayEntry(DayEntry & entry, long dayNumber, int year, int month, int monthDay) {
+    DateTime dayStart = dayNumber * Weather::SECONDS_PER_DAY;
+    DateTime firstSecond = mktimeToEpoch(year, month, monthDay, 0, 0, 0);
+    DateTime lastSecond = mktimeToEpoch(year, month, monthDay, 23, 59, 59);
+    int lastSecondOfDay = Weather::SECONDS_PER_DAY - 1;
+
+    //
+    // If the offset at the first and last second of the day are the same and the day is exactly 24 hours
+    // long, then there is no DST transition during the day
+    //
+    entry.dayNumber = dayNumber;
+    entry.utcOffset = static_cast<int>(dayStart - firstSecond);
+    entry.constantOffset = entry.utcOffset == static_cast<int>(dayStart + lastSecondOfDay - lastSecond) &&
+                           lastSecond - firstSecond == lastSecondOfDay;
+    entry.loaded = true;
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCAL_TIME_CONVERTER_H
+#define LOCAL_TIME_CONVERTER_H
+
+#include "WeatherTypes.h"
+
+namespace vws {
+
+/**
+ * Converts local date/time fields to the UNIX epoch without calling mktime() for every conversion. mktime() consults
+ * the timezone database on each call, which dominates the time it takes to scan the archive.
+ *
+ * The UTC offset of each local day is determined once with mktime() and kept in a per-thread table. A day whose
+ * offset is constant from midnight to midnight is converted with arithmetic. A day on which a DST transition occurs,
+ * and any fields that are out of range, are converted with mktime() so the results are always the same as mktime()
+ * with tm_isdst = -1. The table is not flushed if the timezone of the process is changed while it is running.
+ */
+class LocalTimeConverter {
+public:
+    /**
+     * Convert local date/time fields to the UNIX epoch.
+     *
+     * @param year     The year, e.g. 2025
+     * @param month    The month, 1 - 12
+     * @param monthDay The day of the month, 1 - 31
+     * @param hour     The hour, 0 - 23
+     * @param minute   The minute, 0 - 59
+     * @param second   The second, 0 - 59
+     * @return The epoch time, the same as mktime() would return with tm_isdst = -1
+     */
+    static DateTime localToEpoch(int year, int month, int monthDay, int hour, int minute, int second);
+
+private:
+    //
+    // The number of days in the per-thread table. Entries are selected by the day number modulo the table size,
+    // so the table covers a little more than a year before an entry needs to be replaced.
+    //
+    static constexpr int DAY_TABLE_SIZE = 512;
+
+    /**
+     * The UTC offset of one local day.
+     */
+    struct DayEntry {
+        bool     loaded;         // Whether this entry has been filled
+        long     dayNumber;      // The number of days between 1970-01-01 and this day
+        int      utcOffset;      // The number of seconds that local time is ahead of UTC for the entire day
+        bool     constantOffset; // False if the UTC offset changes during the day
+    };
+
+    /**
+     * Calculate the number of days between 1970-01-01 and a date in the proleptic Gregorian calendar.
+     *
+     * @param year     The year
+     * @param month    The month, 1 - 12
+     * @param monthDay The day of the month
+     * @return The day number, which is negative for dates before 1970
+     */
+    static long daysFromCivil(int year, int month, int monthDay);
+
+    /**
+     * Convert local date/time fields with mktime().
+     *
+     * @return The epoch time
+     */
+    static DateTime mktimeToEpoch(int year, int month, int monthDay, int hour, int minute, int second);
+
+    /**
+     * Determine the UTC offset of a local day using mktime().
+     *
+     * @param entry     The table entry to fill
+     * @param dayNumber The day number of the day
+     * @param year      The year of the day
+     * @param month     The month of the day
+     * @param monthDay  The day of the month of the day
+     */
+    static void loadDayEntry(DayEntry & entry, long dayNumber, int year, int month, int monthDay);
+
+    LocalTimeConverter() = delete;
+};
+
+}
+
+#endif
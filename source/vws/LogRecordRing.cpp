@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LogRecordRing.h"
+
+using namespace std;
+
+namespace vws {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+LogRecordRing::LogRecordRing(int capacity) : slots(capacity), capacity(capacity), head(0), tail(0), abandoned(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+LogRecordRing::push(uint64_t sequence, string & text) {
+    uint64_t currentHead = head.load(memory_order_relaxed);
+    if (currentHead - tail.load(memory_order_acquire) >= static_cast<uint64_t>(capacity))
+        return false;
+
+    Record & record = slots[currentHead % capacity];
+    record.sequence = sequence;
+    record.text.swap(text);
+    text.clear();
+
+    head.store(currentHead + 1, memory_order_release);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+LogRecordRing::popAll(vector<Record> & records) {
+    uint64_t currentTail = tail.load(memory_order_relaxed);
+    uint64_t currentHead = head.load(memory_order_acquire);
+
+    for (uint64_t i = currentTail; i < currentHead; i++) {
+        Record & record = slots[i % capacity];
+        records.push_back(Record{record.sequence, std::move(record.text)});
+        record.text.clear();
+    }
+
+    tail.store(currentHead, memory_order_release);
+    return static_cast<int>(currentHead - currentTail);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+LogRecordRing::size() const {
+    return static_cast<int>(head.load(memory_order_acquire) - tail.load(memory_order_acquire));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+LogRecordRing::getCapacity() const {
+    return capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+LogRecordRing::abandon() {
+    abandoned.store(true, memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+LogRecordRing::isAbandoned() const {
+    return abandoned.load(memory_order_acquire);
+}
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOG_RECORD_RING_H
+#define LOG_RECORD_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vws {
+
+/**
+ * A bounded single producer, single consumer ring of preformatted log records. The thread that owns the ring pushes records
+ * and the log writer thread pops them. Neither side takes a lock, and a record that does not fit is dropped and counted rather
+ * than blocking the producer.
+ */
+class LogRecordRing {
+public:
+    static constexpr int DEFAULT_CAPACITY = 4096;
+
+    /**
+     * A log record and its position in the order in which the records of all the rings were created.
+     */
+    struct Record {
+        uint64_t    sequence;
+        std::string text;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param capacity The maximum number of records the ring holds
+     */
+    explicit LogRecordRing(int capacity = DEFAULT_CAPACITY);
+
+    LogRecordRing(const LogRecordRing &) = delete;
+    LogRecordRing & operator=(const LogRecordRing &) = delete;
+
+    /**
+     * Push a record onto the ring. Only the owning thread may call this method.
+     *
+     * @param sequence The global sequence number of the record
+     * @param text     The record text, which is moved into the ring
+     * @return True if the record was pushed, false if the ring is full and the record was dropped
+     */
+    bool push(uint64_t sequence, std::string & text);
+
+    /**
+     * Pop all the records in the ring. Only the writer thread may call this method.
+     *
+     * @param records The vector to which the records are appended
+     * @return The number of records that were popped
+     */
+    int popAll(std::vector<Record> & records);
+
+    /**
+     * Get the number of records in the ring.
+     *
+     * @return The record count
+     */
+    int size() const;
+
+    /**
+     * Get the maximum number of records in the ring.
+     *
+     * @return The capacity
+     */
+    int getCapacity() const;
+
+    /**
+     * Mark the ring as abandoned by the thread that owned it, so the writer can discard it once it is empty.
+     */
+    void abandon();
+
+    /**
+     * Check if the owning thread has exited.
+     *
+     * @return True if the ring is abandoned
+     */
+    bool isAbandoned() const;
+
+private:
+    std::vector<Record>     slots;       // The record slots, indexed by the counters modulo the capacity
+    int                     capacity;
+    std::atomic<uint64_t>   head;        // The count of records pushed, written only by the producer
+    std::atomic<uint64_t>   tail;        // The count of records popped, written only by the consumer
+    std::atomic<bool>       abandoned;   // Whether the owning thread has exited
+};
+}
+
+#endif
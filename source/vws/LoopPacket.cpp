@@ -174,15 +174,15 @@ LoopPacket::decodeLoopPacket(byte buffer[]) {
             int bit = (i * 8) + j;
             alarmBits[bit] = (alarms & (1 << j)) == 0 ? false : true;
             if (alarmBits[bit])
-                logger->log(VantageLogger::VANTAGE_DEBUG2) << "Alarm byte " << i << " bit " << j << " is set. Set bitset[" << bit << "] to true" << endl;
+                VANTAGE_LOG(*logger, VantageLogger::VANTAGE_DEBUG2) << "Alarm byte " << i << " bit " << j << " is set. Set bitset[" << bit << "] to true" << endl;
         }
     }
 
     transmitterBatteryStatus = BitConverter::toUint8(packetData, TRANSMITTER_BATTERY_STATUS_OFFSET);
-    logger->log(VantageLogger::VANTAGE_DEBUG2) << "Transmitter Battery Status: " << transmitterBatteryStatus << endl;
+    VANTAGE_LOG(*logger, VantageLogger::VANTAGE_DEBUG2) << "Transmitter Battery Status: " << transmitterBatteryStatus << endl;
 
     consoleBatteryVoltage = VantageDecoder::decodeConsoleBatteryVoltage(packetData, CONSOLE_BATTERY_VOLTAGE_OFFSET);
-    logger->log(VantageLogger::VANTAGE_DEBUG2) << "Console Battery Voltage: " << consoleBatteryVoltage << endl;
+    VANTAGE_LOG(*logger, VantageLogger::VANTAGE_DEBUG2) << "Console Battery Voltage: " << consoleBatteryVoltage << endl;
 
     forecastIcon = static_cast<Forecast>(BitConverter::toUint8(packetData, FORECAST_ICONS_OFFSET));
     forecastRuleIndex = BitConverter::toUint8(packetData, FORECAST_RULE_NUMBER_OFFSET);
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LoopPacketRing.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+
+#include "BitConverter.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+static const char RING_MAGIC[] = "VWSLOOPR";
+static constexpr int RING_MAGIC_LENGTH = 8;
+static constexpr int RING_VERSION = 1;
+
+static constexpr int VERSION_OFFSET = 8;
+static constexpr int RECORD_LENGTH_OFFSET = 12;
+static constexpr int RECORD_CAPACITY_OFFSET = 16;
+static constexpr int NEXT_RECORD_OFFSET = 20;
+static constexpr int RECORD_COUNT_OFFSET = 24;
+
+static constexpr int PACKET_TYPE_OFFSET = sizeof(DateTime);
+static constexpr int PACKET_DATA_OFFSET = PACKET_TYPE_OFFSET + sizeof(int32);
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+LoopPacketRing::LoopPacketRing(const string & file, int interval, int capacity) : ringFile(file),
+                                                                                 flushInterval(interval),
+                                                                                 recordCapacity(capacity),
+                                                                                 nextRecord(0),
+                                                                                 recordCount(0),
+                                                                                 readOnly(false),
+                                                                                 mappedData(NULL),
+                                                                                 mappedLength(0),
+                                                                                 lastFlushTime(0),
+                                                                                 dirty(false),
+                                                                                 logger(VantageLogger::getLogger("LoopPacketRing")) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+LoopPacketRing::~LoopPacketRing() {
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+LoopPacketRing::open(bool ro) {
+    if (isOpen())
+        return true;
+
+    readOnly = ro;
+    int fd = ::open(ringFile.c_str(), readOnly ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open LOOP packet ring file '" << ringFile << "'. Error: " << logger.strerror() << endl;
+        return false;
+    }
+
+    //
+    // Use the existing ring if its header describes a ring of records with the current layout
+    //
+    struct stat sbuf;
+    byte header[HEADER_SIZE];
+    bool valid = false;
+    if (fstat(fd, &sbuf) == 0 && sbuf.st_size >= HEADER_SIZE && pread(fd, header, HEADER_SIZE, 0) == HEADER_SIZE) {
+        int capacity = BitConverter::toInt32(header, RECORD_CAPACITY_OFFSET);
+        int next = BitConverter::toInt32(header, NEXT_RECORD_OFFSET);
+        int count = BitConverter::toInt32(header, RECORD_COUNT_OFFSET);
+
+        valid = memcmp(header, RING_MAGIC, RING_MAGIC_LENGTH) == 0 &&
+                BitConverter::toInt32(header, VERSION_OFFSET) == RING_VERSION &&
+                BitConverter::toInt32(header, RECORD_LENGTH_OFFSET) == RECORD_LENGTH &&
+                capacity > 0 &&
+                sbuf.st_size == HEADER_SIZE + (static_cast<off_t>(capacity) * RECORD_LENGTH) &&
+                next >= 0 && next < capacity &&
+                count >= 0 && count <= capacity;
+
+        if (valid) {
+            recordCapacity = capacity;
+            nextRecord = next;
+            recordCount = count;
+        }
+    }
+
+    bool success;
+    if (valid) {
+        mappedLength = HEADER_SIZE + (static_cast<size_t>(recordCapacity) * RECORD_LENGTH);
+        void * data = mmap(NULL, mappedLength, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to map LOOP packet ring file '" << ringFile << "'. Error: " << logger.strerror() << endl;
+            mappedLength = 0;
+            success = false;
+        }
+        else {
+            mappedData = static_cast<byte *>(data);
+            success = true;
+        }
+    }
+    else if (readOnly) {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "LOOP packet ring file '" << ringFile << "' is not valid" << endl;
+        success = false;
+    }
+    else {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Creating LOOP packet ring file '" << ringFile << "' with " << recordCapacity << " records" << endl;
+        success = createRing(fd);
+    }
+
+    ::close(fd);
+
+    if (success) {
+        lastFlushTime = time(0);
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Opened LOOP packet ring file '" << ringFile << "' with " << recordCount << " records" << endl;
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+LoopPacketRing::createRing(int fd) {
+    nextRecord = 0;
+    recordCount = 0;
+    size_t length = HEADER_SIZE + (static_cast<size_t>(recordCapacity) * RECORD_LENGTH);
+
+    //
+    // Preallocate the blocks of the file so that writing to the ring never extends the file
+    //
+    if (ftruncate(fd, 0) != 0 || ftruncate(fd, length) != 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to size LOOP packet ring file '" << ringFile << "'. Error: " << logger.strerror() << endl;
+        return false;
+    }
+
+    if (posix_fallocate(fd, 0, length) != 0)
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to preallocate LOOP packet ring file '" << ringFile << "'" << endl;
+
+    void * data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to map LOOP packet ring file '" << ringFile << "'. Error: " << logger.strerror() << endl;
+        return false;
+    }
+
+    mappedData = static_cast<byte *>(data);
+    mappedLength = length;
+
+    memcpy(mappedData, RING_MAGIC, RING_MAGIC_LENGTH);
+    BitConverter::getBytes(RING_VERSION, mappedData, VERSION_OFFSET, 4);
+    BitConverter::getBytes(RECORD_LENGTH, mappedData, RECORD_LENGTH_OFFSET, 4);
+    BitConverter::getBytes(recordCapacity, mappedData, RECORD_CAPACITY_OFFSET, 4);
+    writeHeader();
+
+    dirty = true;
+    flush();
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+LoopPacketRing::close() {
+    if (!isOpen())
+        return;
+
+    flush();
+    munmap(mappedData, mappedLength);
+    mappedData = NULL;
+    mappedLength = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+LoopPacketRing::isOpen() const {
+    return mappedData != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+LoopPacketRing::writePacket(DateTime packetTime, int packetType, const byte * packetData, size_t length) {
+    if (!isOpen() || readOnly)
+        return;
+
+    if (length > PACKET_DATA_SIZE)
+        length = PACKET_DATA_SIZE;
+
+    byte * record = recordSlot(nextRecord);
+    int32 type = packetType;
+    memcpy(record, &packetTime, sizeof(packetTime));
+    memcpy(record + PACKET_TYPE_OFFSET, &type, sizeof(type));
+    memcpy(record + PACKET_DATA_OFFSET, packetData, length);
+    memset(record + PACKET_DATA_OFFSET + length, 0, PACKET_DATA_SIZE - length);
+
+    //
+    // The cursors are updated after the record is written so that a reader never sees a partial record
+    //
+    nextRecord = (nextRecord + 1) % recordCapacity;
+    if (recordCount < recordCapacity)
+        recordCount++;
+
+    writeHeader();
+    dirty = true;
+
+    if (time(0) - lastFlushTime >= flushInterval)
+        flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+LoopPacketRing::flush() {
+    if (!isOpen() || readOnly || !dirty)
+        return;
+
+    if (msync(mappedData, mappedLength, MS_SYNC) != 0)
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to flush LOOP packet ring file '" << ringFile << "'. Error: " << logger.strerror() << endl;
+
+    lastFlushTime = time(0);
+    dirty = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+LoopPacketRing::getRecordCount() const {
+    return isOpen() ? recordCount : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const byte *
+LoopPacketRing::getRecord(int index, DateTime & packetTime, int & packetType) const {
+    int oldestRecord = (nextRecord - recordCount + recordCapacity) % recordCapacity;
+    const byte * record = recordSlot((oldestRecord + index) % recordCapacity);
+
+    int32 type;
+    memcpy(&packetTime, record, sizeof(packetTime));
+    memcpy(&type, record + PACKET_TYPE_OFFSET, sizeof(type));
+    packetType = type;
+
+    return record + PACKET_DATA_OFFSET;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+LoopPacketRing::findFirstRecordOnOrAfter(DateTime time) const {
+    int count = getRecordCount();
+    int index = count;
+    DateTime packetTime;
+    int packetType;
+
+    while (index > 0) {
+        getRecord(index - 1, packetTime, packetType);
+        if (packetTime < time)
+            break;
+
+        index--;
+    }
+
+    return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+byte *
+LoopPacketRing::recordSlot(int slot) const {
+    return mappedData + HEADER_SIZE + (static_cast<size_t>(slot) * RECORD_LENGTH);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+LoopPacketRing::writeHeader() {
+    BitConverter::getBytes(nextRecord, mappedData, NEXT_RECORD_OFFSET, 4);
+    BitConverter::getBytes(recordCount, mappedData, RECORD_COUNT_OFFSET, 4);
+}
+
+}
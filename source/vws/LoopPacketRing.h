@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOOP_PACKET_RING_H
+#define LOOP_PACKET_RING_H
+
+#include <string>
+
+#include "WeatherTypes.h"
+
+namespace vws {
+class VantageLogger;
+
+/**
+ * A preallocated ring file of fixed length LOOP/LOOP2 packet records. The file is memory mapped and kept open, so
+ * writing a packet is a copy into the mapping rather than an open/stat/write/close of a file. The dirty pages are
+ * flushed to the file at a configurable interval.
+ *
+ * The file is a 32 byte header followed by the records. The header integers are little endian:
+ *     Header: "VWSLOOPR", version, record length, record capacity, next record to write, record count, reserved
+ *     Record: <time: sizeof(DateTime) bytes><packet type: 4 bytes><packet data: 99 bytes>
+ * The record layout is the same as the hourly LOOP archive files that this ring replaced.
+ */
+class LoopPacketRing {
+public:
+    static constexpr int PACKET_DATA_SIZE = 99;
+    static constexpr int RECORD_LENGTH = sizeof(DateTime) + sizeof(int32) + PACKET_DATA_SIZE;
+    static constexpr int HEADER_SIZE = 32;
+
+    //
+    // The console sends a LOOP or LOOP2 packet about every 2 seconds, so this holds 24 hours of packets
+    //
+    static constexpr int DEFAULT_RECORD_CAPACITY = 24 * 3600 / 2;
+    static constexpr int DEFAULT_FLUSH_INTERVAL = 60;
+
+    /**
+     * Constructor.
+     *
+     * @param ringFile       The path of the ring file
+     * @param flushInterval  The number of seconds between flushes of the written records to the file
+     * @param recordCapacity The number of records the ring holds when the file is created
+     */
+    LoopPacketRing(const std::string & ringFile, int flushInterval = DEFAULT_FLUSH_INTERVAL, int recordCapacity = DEFAULT_RECORD_CAPACITY);
+
+    /**
+     * Destructor that flushes and closes the ring file.
+     */
+    ~LoopPacketRing();
+
+    LoopPacketRing(const LoopPacketRing &) = delete;
+    LoopPacketRing & operator=(const LoopPacketRing &) = delete;
+
+    /**
+     * Open and map the ring file. If the file does not exist or its header is not valid, a new empty ring file
+     * is created with the record capacity of this object.
+     *
+     * @param readOnly If true the file is mapped read-only and is never created or modified
+     * @return True if the ring file is open
+     */
+    bool open(bool readOnly = false);
+
+    /**
+     * Flush and close the ring file.
+     */
+    void close();
+
+    /**
+     * Check if the ring file is open.
+     *
+     * @return True if the ring file is open
+     */
+    bool isOpen() const;
+
+    /**
+     * Write a packet to the ring, overwriting the oldest record if the ring is full.
+     *
+     * @param packetTime The time that this packet was received
+     * @param packetType Whether this is a LOOP or a LOOP2 packet
+     * @param packetData The buffer containing the packet data
+     * @param length     The length of the packet data, which is truncated to PACKET_DATA_SIZE
+     */
+    void writePacket(DateTime packetTime, int packetType, const byte * packetData, size_t length);
+
+    /**
+     * Flush the records that have been written to the file.
+     */
+    void flush();
+
+    /**
+     * Get the number of records in the ring.
+     *
+     * @return The record count
+     */
+    int getRecordCount() const;
+
+    /**
+     * Get a record from the ring.
+     *
+     * @param index      The index of the record, where 0 is the oldest record, which must be in the range [0, getRecordCount())
+     * @param packetTime The time that the packet was received
+     * @param packetType Whether this is a LOOP or a LOOP2 packet
+     * @return The pointer to the packet data of the record
+     */
+    const byte * getRecord(int index, DateTime & packetTime, int & packetType) const;
+
+    /**
+     * Find the oldest record of the newest run of records that are on or after the specified time. The search starts at
+     * the newest record and stops at the first record that is before the time, so a clock change cannot affect the search.
+     *
+     * @param time The time to search for
+     * @return The index of the record or getRecordCount() if the newest record is before the time
+     */
+    int findFirstRecordOnOrAfter(DateTime time) const;
+
+private:
+    /**
+     * Create an empty ring file and map it.
+     *
+     * @param fd The descriptor of the open ring file
+     * @return True if successful
+     */
+    bool createRing(int fd);
+
+    /**
+     * Get a pointer to a record by its slot within the file.
+     *
+     * @param slot The slot of the record
+     * @return The pointer to the first byte of the record
+     */
+    byte * recordSlot(int slot) const;
+
+    /**
+     * Write the record cursors into the header.
+     */
+    void writeHeader();
+
+    std::string     ringFile;        // The path of the ring file
+    int             flushInterval;   // The number of seconds between flushes
+    int             recordCapacity;  // The number of records the ring holds
+    int             nextRecord;      // The slot to which the next record will be written
+    int             recordCount;     // The number of records in the ring
+    bool            readOnly;        // Whether the mapping is read-only
+    byte *          mappedData;      // The start of the mapped file or NULL if the file is not open
+    size_t          mappedLength;    // The number of bytes that are mapped
+    DateTime        lastFlushTime;   // The last time the records were flushed
+    bool            dirty;           // Whether records have been written since the last flush
+    VantageLogger & logger;
+};
+}
+
+#endif
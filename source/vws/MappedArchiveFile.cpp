@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedArchiveFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <climits>
+#include <iostream>
+
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+//
+// The archive packet decoding uses 6 bits of the date stamp for the year
+//
+static constexpr int MIN_RECORD_YEAR = 2000;
+static constexpr int MAX_RECORD_YEAR = 2063;
+static constexpr int DATE_STAMP_MASK = 0x7FFF;
+
+static constexpr int DATE_STAMP_OFFSET = 0;
+static constexpr int TIME_STAMP_OFFSET = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+MappedArchiveFile::MappedArchiveFile(const string & archiveFile) : mappedData(NULL),
+                                                                   mappedLength(0),
+                                                                   recordCount(0),
+                                                                   logger(VantageLogger::getLogger("MappedArchiveFile")) {
+    int fd = open(archiveFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to open archive file '" << archiveFile << "' for mapping. Error: " << logger.strerror() << endl;
+        return;
+    }
+
+    struct stat sbuf;
+    if (fstat(fd, &sbuf) != 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to stat archive file '" << archiveFile << "'. Error: " << logger.strerror() << endl;
+        close(fd);
+        return;
+    }
+
+    //
+    // Only map complete records. A partial record at the end of the file is ignored.
+    //
+    int count = sbuf.st_size / ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+    size_t length = static_cast<size_t>(count) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET;
+
+    //
+    // mmap() does not allow zero length mappings, so an empty archive is simply left unmapped
+    //
+    if (length > 0) {
+        void * data = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to map archive file '" << archiveFile << "'. Error: " << logger.strerror() << endl;
+        }
+        else {
+            madvise(data, length, MADV_RANDOM);
+            mappedData = static_cast<const byte *>(data);
+            mappedLength = length;
+            recordCount = count;
+        }
+    }
+
+    close(fd);
+
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Mapped archive file '" << archiveFile << "' with " << recordCount << " records" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+MappedArchiveFile::~MappedArchiveFile() {
+    if (mappedData != NULL)
+        munmap(const_cast<byte *>(mappedData), mappedLength);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+MappedArchiveFile::getRecordCount() const {
+    return recordCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const byte *
+MappedArchiveFile::getRecord(int index) const {
+    return mappedData + (static_cast<size_t>(index) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+MappedArchiveFile::findFirstRecordOnOrAfter(const DateTimeFields & time) const {
+    return findFirstRecordOnOrAfter(time, 0, recordCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+MappedArchiveFile::findFirstRecordOnOrAfter(const DateTimeFields & time, int low, int high) const {
+    //
+    // The records only have minute resolution, so a search time with non-zero seconds
+    // is moved to the next minute. The resulting minute may be 60, but the key only
+    // needs to sort correctly, it does not need to be a valid time.
+    //
+    int32 searchKey = timeKey(time);
+    if (time.getSecond() > 0 && searchKey != INT_MAX)
+        searchKey++;
+
+    while (low < high) {
+        int middle = low + ((high - low) / 2);
+        if (recordTimeKey(getRecord(middle)) < searchKey)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+MappedArchiveFile::findFirstRecordAfter(const DateTimeFields & time) const {
+    return findFirstRecordAfter(time, 0, recordCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+MappedArchiveFile::findFirstRecordAfter(const DateTimeFields & time, int low, int high) const {
+    int32 searchKey = timeKey(time);
+
+    while (low < high) {
+        int middle = low + ((high - low) / 2);
+        if (recordTimeKey(getRecord(middle)) <= searchKey)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+std::span<const byte>
+MappedArchiveFile::getRecords(const DateTimeFields & startTime, const DateTimeFields & endTime) const {
+    return getRecordSpan(findFirstRecordOnOrAfter(startTime), findFirstRecordAfter(endTime));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+std::span<const byte>
+MappedArchiveFile::getRecordSpan(int first, int last) const {
+    if (first >= last)
+        return std::span<const byte>();
+
+    return std::span<const byte>(getRecord(first), static_cast<size_t>(last - first) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int32
+MappedArchiveFile::recordTimeKey(const byte * record) {
+    int32 date = BitConverter::toUint16(record, DATE_STAMP_OFFSET) & DATE_STAMP_MASK;
+    int32 time = BitConverter::toUint16(record, TIME_STAMP_OFFSET);
+
+    return (date << 16) | time;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int32
+MappedArchiveFile::timeKey(const DateTimeFields & time) {
+    //
+    // Times outside of the range that can be represented by the date stamp are before or after every record
+    //
+    if (time.getYear() < MIN_RECORD_YEAR)
+        return -1;
+    else if (time.getYear() > MAX_RECORD_YEAR)
+        return INT_MAX;
+
+    int32 date = time.getMonthDay() + (time.getMonth() * 32) + ((time.getYear() - MIN_RECORD_YEAR) * 512);
+    int32 timeOfDay = (time.getHour() * 100) + time.getMinute();
+
+    return (date << 16) | timeOfDay;
+}
+}
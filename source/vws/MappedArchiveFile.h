@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MAPPED_ARCHIVE_FILE_H
+#define MAPPED_ARCHIVE_FILE_H
+
+#include <string>
+#include <span>
+
+#include "WeatherTypes.h"
+#include "ArchivePacket.h"
+
+namespace vws {
+class VantageLogger;
+class DateTimeFields;
+
+/**
+ * Read-only, memory mapped view of an archive file. The archive file is a flat sequence of raw 52 byte archive packets
+ * in time order, so the mapped memory can be treated as an array of records that is binary searched by the packet time.
+ * A mapping only covers the size of the file at the time it was created. The archive file is only ever appended to,
+ * so a mapping remains valid after the file grows; the ArchiveManager creates a new mapping to see the new records.
+ */
+class MappedArchiveFile {
+public:
+    /**
+     * Constructor that maps the entire archive file.
+     *
+     * @param archiveFile The path of the archive file to map
+     */
+    explicit MappedArchiveFile(const std::string & archiveFile);
+
+    /**
+     * Destructor that unmaps the archive file.
+     */
+    ~MappedArchiveFile();
+
+    MappedArchiveFile(const MappedArchiveFile &) = delete;
+    MappedArchiveFile & operator=(const MappedArchiveFile &) = delete;
+
+    /**
+     * Get the number of complete records in the mapping.
+     *
+     * @return The record count
+     */
+    int getRecordCount() const;
+
+    /**
+     * Get a pointer to the raw data of a record.
+     *
+     * @param index The index of the record, which must be in the range [0, getRecordCount())
+     * @return The pointer to the first byte of the record
+     */
+    const byte * getRecord(int index) const;
+
+    /**
+     * Find the index of the first record whose time is on or after the specified time.
+     *
+     * @param time The time to search for
+     * @return The index of the record or getRecordCount() if all records are before the time
+     */
+    int findFirstRecordOnOrAfter(const DateTimeFields & time) const;
+
+    /**
+     * Find the index of the first record whose time is on or after the specified time, only searching within the specified range of records.
+     *
+     * @param time The time to search for
+     * @param low  The index of the first record to search
+     * @param high The index one past the last record to search
+     * @return The index of the record or "high" if all records in the range are before the time
+     */
+    int findFirstRecordOnOrAfter(const DateTimeFields & time, int low, int high) const;
+
+    /**
+     * Find the index of the first record whose time is after the specified time.
+     *
+     * @param time The time to search for
+     * @return The index of the record or getRecordCount() if all records are on or before the time
+     */
+    int findFirstRecordAfter(const DateTimeFields & time) const;
+
+    /**
+     * Find the index of the first record whose time is after the specified time, only searching within the specified range of records.
+     *
+     * @param time The time to search for
+     * @param low  The index of the first record to search
+     * @param high The index one past the last record to search
+     * @return The index of the record or "high" if all records in the range are on or before the time
+     */
+    int findFirstRecordAfter(const DateTimeFields & time, int low, int high) const;
+
+    /**
+     * Get the packed records that occur between the specified times (inclusive). The span points directly into the
+     * mapped file and its size is a multiple of ArchivePacket::BYTES_PER_ARCHIVE_PACKET.
+     *
+     * @param startTime The lower bound of the query
+     * @param endTime   The upper bound of the query
+     * @return The span of records, which may be empty
+     */
+    std::span<const byte> getRecords(const DateTimeFields & startTime, const DateTimeFields & endTime) const;
+
+    /**
+     * Get the packed records within a range of record indexes.
+     *
+     * @param first The index of the first record
+     * @param last  The index one past the last record
+     * @return The span of records, which may be empty
+     */
+    std::span<const byte> getRecordSpan(int first, int last) const;
+
+    /**
+     * Build a key from the raw date and time stamps of a record. The key sorts in the same order as the record
+     * times, which allows the archive to be searched without converting each record time to an epoch time.
+     * The upper 16 bits of the key are the date stamp of the record.
+     *
+     * @param record The record from which to build the key
+     * @return The search key
+     */
+    static int32 recordTimeKey(const byte * record);
+
+    /**
+     * Build a search key for a time using the same encoding as the date and time stamps of the records.
+     * The seconds are not represented in the key.
+     *
+     * @param time The time from which to build the key
+     * @return The search key
+     */
+    static int32 timeKey(const DateTimeFields & time);
+
+private:
+    const byte *    mappedData;     // The start of the mapped archive or NULL if the archive is empty
+    size_t          mappedLength;   // The number of bytes that are mapped
+    int             recordCount;    // The number of complete records in the mapped region
+    VantageLogger & logger;
+};
+}
+
+#endif
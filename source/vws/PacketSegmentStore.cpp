@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "PacketSegmentStore.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+#include "ArchivePacket.h"
+#include "BitConverter.h"
+#include "DateTimeFields.h"
+#include "VantageCRC.h"
+#include "VantageLogger.h"
+
+using namespace std;
+
+namespace vws {
+
+static constexpr int SEGMENT_RECORD_SIZE = ArchivePacket::BYTES_PER_ARCHIVE_PACKET + 2;
+static const char SEGMENT_MAGIC[4] = {'V', 'W', 'S', 'P'};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+PacketSegmentStore::PacketSegmentStore(const string & dir) : directory(dir), logger(VantageLogger::getLogger("PacketSegmentStore")) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+PacketSegmentStore::~PacketSegmentStore() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+PacketSegmentStore::savePackets(const vector<const ArchivePacket *> & packets) {
+    bool success = true;
+    vector<byte> records;
+    DateTimeFields day;
+
+    //
+    // The packets are in time order, so the records of each day are collected and written with a single write
+    //
+    for (const ArchivePacket * packet : packets) {
+        const DateTimeFields & packetTime = packet->getDateTimeFields();
+        if (!records.empty() && (packetTime.getYear() != day.getYear() || packetTime.getMonth() != day.getMonth() || packetTime.getMonthDay() != day.getMonthDay())) {
+            success = appendToSegment(day, records) && success;
+            records.clear();
+        }
+
+        day = packetTime;
+        size_t offset = records.size();
+        records.resize(offset + SEGMENT_RECORD_SIZE);
+        memcpy(&records[offset], packet->getBuffer(), ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        int crc = VantageCRC::calculateCRC(packet->getBuffer(), ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+        BitConverter::getBytes(crc, &records[0], offset + ArchivePacket::BYTES_PER_ARCHIVE_PACKET, 2);
+    }
+
+    if (!records.empty())
+        success = appendToSegment(day, records) && success;
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+string
+PacketSegmentStore::getSegmentFile(const DateTimeFields & day) const {
+    ostringstream oss;
+    oss << setfill('0');
+    oss << directory << "/" << day.getYear() << "/" << day.getYear()
+        << "-" << setw(2) << day.getMonth()
+        << "-" << setw(2) << day.getMonthDay() << PACKET_SEGMENT_FILE_SUFFIX;
+
+    return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+PacketSegmentStore::findSegmentFiles(const string & directory, vector<string> & segmentFiles) {
+    segmentFiles.clear();
+
+    std::error_code errorCode;
+    for (const auto & yearEntry : filesystem::directory_iterator(directory, errorCode)) {
+        if (!yearEntry.is_directory())
+            continue;
+
+        for (const auto & entry : filesystem::directory_iterator(yearEntry.path(), errorCode)) {
+            if (entry.is_regular_file() && entry.path().extension() == PACKET_SEGMENT_FILE_SUFFIX)
+                segmentFiles.push_back(entry.path().string());
+        }
+    }
+
+    //
+    // The file names are the dates of the segments, so sorting the paths sorts the segments by date
+    //
+    sort(segmentFiles.begin(), segmentFiles.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+PacketSegmentStore::readSegment(const string & segmentFile, vector<byte> & records, int & corruptRecords) {
+    VantageLogger & logger = VantageLogger::getLogger("PacketSegmentStore");
+    corruptRecords = 0;
+
+    ifstream stream(segmentFile.c_str(), ios::in | ios::binary);
+    if (!stream.is_open()) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open segment file '" << segmentFile << "'" << endl;
+        return false;
+    }
+
+    vector<byte> contents((istreambuf_iterator<char>(stream)), istreambuf_iterator<char>());
+
+    if (contents.size() < HEADER_SIZE ||
+        memcmp(contents.data(), SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0 ||
+        BitConverter::toInt32(contents.data(), VERSION_OFFSET) != SEGMENT_VERSION ||
+        BitConverter::toInt32(contents.data(), RECORD_SIZE_OFFSET) != SEGMENT_RECORD_SIZE) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Segment file '" << segmentFile << "' does not have a valid header" << endl;
+        return false;
+    }
+
+    int recordCount = (contents.size() - HEADER_SIZE) / SEGMENT_RECORD_SIZE;
+    vector<int> failedRecords;
+    corruptRecords = VantageCRC::checkCRCs(&contents[HEADER_SIZE], ArchivePacket::BYTES_PER_ARCHIVE_PACKET, recordCount, failedRecords, true);
+
+    records.reserve(records.size() + ((recordCount - corruptRecords) * ArchivePacket::BYTES_PER_ARCHIVE_PACKET));
+    vector<int>::const_iterator nextFailedRecord = failedRecords.begin();
+    for (int i = 0; i < recordCount; i++) {
+        if (nextFailedRecord != failedRecords.end() && *nextFailedRecord == i) {
+            ++nextFailedRecord;
+            continue;
+        }
+
+        const byte * record = &contents[HEADER_SIZE + (i * SEGMENT_RECORD_SIZE)];
+        records.insert(records.end(), record, record + ArchivePacket::BYTES_PER_ARCHIVE_PACKET);
+    }
+
+    if (static_cast<size_t>(HEADER_SIZE + (recordCount * SEGMENT_RECORD_SIZE)) != contents.size())
+        corruptRecords++;
+
+    if (corruptRecords > 0)
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Segment file '" << segmentFile << "' has " << corruptRecords << " corrupt records" << endl;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+PacketSegmentStore::appendToSegment(const DateTimeFields & day, const vector<byte> & records) {
+    string yearDirectory = directory + "/" + std::to_string(day.getYear());
+    if (yearDirectory != knownYearDirectory) {
+        std::error_code errorCode;
+        if (!filesystem::create_directories(yearDirectory, errorCode) && errorCode) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to create packet segment directory '" << yearDirectory << "'. Error: " << errorCode.message() << endl;
+            return false;
+        }
+
+        knownYearDirectory = yearDirectory;
+    }
+
+    string segmentFile = getSegmentFile(day);
+    int fd = open(segmentFile.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to open segment file '" << segmentFile << "'. Error: " << logger.strerror() << endl;
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to get the size of segment file '" << segmentFile << "'. Error: " << logger.strerror() << endl;
+        close(fd);
+        return false;
+    }
+
+    off_t fileLength = fileStat.st_size;
+    if (fileLength < HEADER_SIZE) {
+        //
+        // A new segment or a segment whose header was not completely written
+        //
+        byte header[HEADER_SIZE];
+        memcpy(header, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+        BitConverter::getBytes(SEGMENT_VERSION, header, VERSION_OFFSET, 4);
+        BitConverter::getBytes(SEGMENT_RECORD_SIZE, header, RECORD_SIZE_OFFSET, 4);
+        BitConverter::getBytes((day.getYear() * 10000) + (day.getMonth() * 100) + day.getMonthDay(), header, DATE_OFFSET, 4);
+        if (ftruncate(fd, 0) != 0 || pwrite(fd, header, HEADER_SIZE, 0) != HEADER_SIZE) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to write the header of segment file '" << segmentFile << "'. Error: " << logger.strerror() << endl;
+            close(fd);
+            return false;
+        }
+
+        fileLength = HEADER_SIZE;
+    }
+    else {
+        byte magic[sizeof(SEGMENT_MAGIC)];
+        if (pread(fd, magic, sizeof(magic), 0) != sizeof(magic) || memcmp(magic, SEGMENT_MAGIC, sizeof(magic)) != 0) {
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Segment file '" << segmentFile << "' is not a packet segment file. Not appending packets." << endl;
+            close(fd);
+            return false;
+        }
+
+        off_t partialLength = (fileLength - HEADER_SIZE) % SEGMENT_RECORD_SIZE;
+        if (partialLength != 0) {
+            logger.log(VantageLogger::VANTAGE_WARNING) << "Removing " << partialLength << " byte partial record from the end of segment file '" << segmentFile << "'" << endl;
+            fileLength -= partialLength;
+            if (ftruncate(fd, fileLength) != 0) {
+                logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to truncate segment file '" << segmentFile << "'. Error: " << logger.strerror() << endl;
+                close(fd);
+                return false;
+            }
+        }
+    }
+
+    size_t written = 0;
+    while (written < records.size()) {
+        ssize_t bytesWritten = pwrite(fd, records.data() + written, records.size() - written, fileLength + written);
+        if (bytesWritten < 0) {
+            if (errno == EINTR)
+                continue;
+
+            logger.log(VantageLogger::VANTAGE_ERROR) << "Failed to write to segment file '" << segmentFile << "'. Error: " << logger.strerror() << endl;
+            close(fd);
+            return false;
+        }
+
+        written += bytesWritten;
+    }
+
+    close(fd);
+    return true;
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PACKET_SEGMENT_STORE_H
+#define PACKET_SEGMENT_STORE_H
+
+#include <string>
+#include <vector>
+
+#include "WeatherTypes.h"
+
+namespace vws {
+class VantageLogger;
+class ArchivePacket;
+class DateTimeFields;
+
+static const std::string PACKET_SEGMENT_FILE_SUFFIX = ".seg";
+
+/**
+ * The backup store of the archive packets, which can be used to rebuild the archive. The packets of each day are
+ * appended to a daily segment file <dir>/yyyy/yyyy-mm-dd.seg, so a year of packets is a few hundred files that
+ * can be read sequentially.
+ *
+ * A segment file is a 16 byte header followed by 54 byte records, the integers are little endian:
+ *     Header: "VWSP", version, record size, date of the segment (yyyymmdd)
+ *     Record: the 52 byte archive packet, CRC of the archive packet (same CRC as the console protocol)
+ *
+ * A partial record at the end of a segment, left by a power failure, is removed before the next packets are appended.
+ */
+class PacketSegmentStore {
+public:
+    /**
+     * Constructor.
+     *
+     * @param directory The directory that holds the year directories of the segment files
+     */
+    explicit PacketSegmentStore(const std::string & directory);
+
+    /**
+     * Destructor.
+     */
+    ~PacketSegmentStore();
+
+    /**
+     * Append packets to the segment files of their days.
+     *
+     * @param packets The packets to save, in time order
+     * @return True if all of the packets were saved
+     */
+    bool savePackets(const std::vector<const ArchivePacket *> & packets);
+
+    /**
+     * Get the path of the segment file of a day.
+     *
+     * @param day A time within the day
+     * @return The path of the segment file
+     */
+    std::string getSegmentFile(const DateTimeFields & day) const;
+
+    /**
+     * Find the segment files in a segment directory.
+     *
+     * @param directory    The directory that holds the year directories of the segment files
+     * @param segmentFiles The paths of the segment files sorted by date
+     */
+    static void findSegmentFiles(const std::string & directory, std::vector<std::string> & segmentFiles);
+
+    /**
+     * Read the records of a segment file. Records whose CRC does not match and a partial record at the end are skipped.
+     *
+     * @param [in]  segmentFile    The path of the segment file
+     * @param [out] records        The buffer to which the valid 52 byte archive packets are appended
+     * @param [out] corruptRecords The number of records that were skipped
+     * @return True if the file was read and has a valid header
+     */
+    static bool readSegment(const std::string & segmentFile, std::vector<byte> & records, int & corruptRecords);
+
+private:
+    static constexpr int SEGMENT_VERSION = 1;
+    static constexpr int HEADER_SIZE = 16;
+    static constexpr int VERSION_OFFSET = 4;
+    static constexpr int RECORD_SIZE_OFFSET = 8;
+    static constexpr int DATE_OFFSET = 12;
+
+    /**
+     * Append the records of one day to its segment file, creating the file if it does not exist.
+     *
+     * @param day     A time within the day of the records
+     * @param records The segment records to append
+     * @return True if the records were written
+     */
+    bool appendToSegment(const DateTimeFields & day, const std::vector<byte> & records);
+
+    std::string     directory;            // The directory that holds the year directories
+    std::string     knownYearDirectory;   // The most recent year directory that is known to exist
+    VantageLogger & logger;
+};
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RESPONSE_STREAM_H
+#define RESPONSE_STREAM_H
+
+#include <string>
+
+namespace vws {
+
+/**
+ * Interface class that produces the data of a large command response in chunks. A command handler that attaches a
+ * response stream to a command leaves the beginning of the response in the command data, then the response handler
+ * writes each chunk as it is produced, so only one chunk needs to be in memory at a time.
+ */
+class ResponseStream {
+public:
+    /**
+     * Virtual destructor.
+     */
+    virtual ~ResponseStream() {};
+
+    /**
+     * Produce the next chunk of the response.
+     *
+     * @param chunk The string to which the chunk is appended
+     * @return True if there are more chunks to be produced
+     */
+    virtual bool nextChunk(std::string & chunk) = 0;
+};
+}
+#endif
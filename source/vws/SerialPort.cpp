@@ -107,7 +107,7 @@ SerialPort::write(const void * buffer, int nbytes) {
         return false;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG2) << "Writing " << nbytes << " bytes" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Writing " << nbytes << " bytes" << endl;
     DWORD dwWritten;
     if (!WriteFile(commPort, static_cast<LPCVOID>(buffer), nbytes, &dwWritten, nullptr)) {
         logger.log(VantageLogger::VANTAGE_ERROR) << "Write to serial port failed (" << logger.strerror() << ")" << endl;
@@ -135,7 +135,7 @@ SerialPort::read(byte buffer[], int index, int maximumBytes, int timeoutMillis)
         return -1;
     }
     else {
-        logger.log(VantageLogger::VANTAGE_DEBUG3) << "Read " << dwRead << " bytes" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Read " << dwRead << " bytes" << endl;
         return dwRead;
     }
 }
@@ -171,7 +171,7 @@ SerialPort::open() {
         return false;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Setting serial port attributes, including baud rate of " << baudRate << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Setting serial port attributes, including baud rate of " << baudRate << endl;
     cfsetospeed(&tio, baudRate.getOsValue()); // Baud rate
     cfsetispeed(&tio, B0);                    // B0 baud rate means same as the output baud rate
     cfmakeraw(&tio);                          // Sets the terminal to something like the "raw" mode of the old Version 7 terminal driver
@@ -212,7 +212,7 @@ SerialPort::write(const void * buffer, int nbytes) {
         return false;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Write buffer: " << Weather::dumpBuffer(static_cast<const byte *>(buffer), nbytes);
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Write buffer: " << Weather::dumpBuffer(static_cast<const byte *>(buffer), nbytes);
 
     ssize_t bytesWritten = ::write(commPort, buffer, nbytes);
 
@@ -252,12 +252,12 @@ SerialPort::read(byte buffer[], int index, int maximumBytes, int timeoutMillis)
         logger.log(VantageLogger::VANTAGE_WARNING) << "Select() failed (" << logger.strerror() << ")" << endl;
     }
     else if (numFdsSet == 0) {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Select() timed out" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Select() timed out" << endl;
     }
     else {
         if (FD_ISSET(commPort, &readSet)) {
             bytesRead = ::read(commPort, &buffer[index], maximumBytes);
-            logger.log(VantageLogger::VANTAGE_DEBUG2) << "Read " << bytesRead << " bytes" << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Read " << bytesRead << " bytes" << endl;
         }
     }
 
@@ -284,7 +284,7 @@ SerialPort::write(const string & s) {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 SerialPort::readBytes(byte buffer[], size_t bufferSize, int requiredBytes, int timeoutMillis) {
-    logger.log(VantageLogger::VANTAGE_DEBUG2) << "Attempting to read " << requiredBytes << " bytes" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Attempting to read " << requiredBytes << " bytes" << endl;
     int readIndex = 0;
     
     //
@@ -310,7 +310,7 @@ SerialPort::readBytes(byte buffer[], size_t bufferSize, int requiredBytes, int t
         int nbytes = this->read(buffer, readIndex, maximumBytes, timeoutMillis);
         if (nbytes > 0) {
             readIndex += nbytes;
-            logger.log(VantageLogger::VANTAGE_DEBUG2) << "Read " << readIndex << " bytes of " << requiredBytes << " bytes" << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Read " << readIndex << " bytes of " << requiredBytes << " bytes" << endl;
         }
         else if (nbytes < 0) {
             // Error, stop reading
@@ -332,7 +332,7 @@ SerialPort::readBytes(byte buffer[], size_t bufferSize, int requiredBytes, int t
         return false;
     }
     else {
-        logger.log(VantageLogger::VANTAGE_DEBUG3) << "Read buffer:" << Weather::dumpBuffer(buffer, requiredBytes);
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Read buffer:" << Weather::dumpBuffer(buffer, requiredBytes);
         return true;
     }
 }
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SeriesDownsampler.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace vws {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+SeriesDownsampler::parseMethod(const string & name, Method & method) {
+    if (name == "lttb")
+        method = Method::LTTB;
+    else if (name == "min-max")
+        method = Method::MIN_MAX;
+    else
+        return false;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+SeriesDownsampler::SeriesDownsampler(Method m, size_t pc, size_t tc) : method(m),
+                                                                       pointCount(pc),
+                                                                       targetCount(tc),
+                                                                       nextIndex(0),
+                                                                       anchorSelected(false),
+                                                                       anchor{0, 0.0, 0.0},
+                                                                       minMaxStarted(false),
+                                                                       minMaxBucket(0),
+                                                                       minimumPoint{0, 0.0, 0.0},
+                                                                       maximumPoint{0, 0.0, 0.0} {
+    //
+    // Largest-Triangle-Three-Buckets needs at least one bucket between the first and last points and
+    // min-max needs at least one bucket
+    //
+    if (method == Method::LTTB && targetCount < 3)
+        targetCount = 3;
+    else if (method == Method::MIN_MAX && targetCount < 2)
+        targetCount = 2;
+
+    selectAll = pointCount <= targetCount;
+    selectedIndices.reserve(selectAll ? pointCount : targetCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SeriesDownsampler::addPoint(size_t index, double x, const Measurement<double> & y) {
+    nextIndex = index + 1;
+
+    if (selectAll) {
+        selectedIndices.push_back(index);
+        return;
+    }
+
+    if (!y.isValid())
+        return;
+
+    Point point{index, x, y.getValue()};
+    if (method == Method::LTTB)
+        addLttbPoint(point);
+    else
+        addMinMaxPoint(point);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SeriesDownsampler::finish() {
+    if (selectAll)
+        return;
+
+    if (method == Method::MIN_MAX) {
+        if (minMaxStarted)
+            selectMinMaxPoints();
+
+        minMaxStarted = false;
+        return;
+    }
+
+    if (pendingBuckets.empty())
+        return;
+
+    //
+    // The last valid point is always selected, so it is removed from its bucket and is the third point of
+    // the triangle for the last bucket
+    //
+    Bucket & lastBucket = pendingBuckets.back();
+    Point lastPoint = lastBucket.points.back();
+    lastBucket.points.pop_back();
+    lastBucket.sumX -= lastPoint.x;
+    lastBucket.sumY -= lastPoint.y;
+
+    if (pendingBuckets.size() == 2) {
+        const Bucket & next = pendingBuckets[1];
+        if (next.points.empty())
+            selectLttbPoint(pendingBuckets[0], lastPoint.x, lastPoint.y);
+        else
+            selectLttbPoint(pendingBuckets[0], next.sumX / next.points.size(), next.sumY / next.points.size());
+    }
+
+    selectLttbPoint(pendingBuckets.back(), lastPoint.x, lastPoint.y);
+    selectedIndices.push_back(lastPoint.index);
+    pendingBuckets.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+const vector<size_t> &
+SeriesDownsampler::getSelectedIndices() const {
+    return selectedIndices;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+size_t
+SeriesDownsampler::getFirstUndecidedIndex() const {
+    if (selectAll)
+        return nextIndex;
+
+    if (method == Method::MIN_MAX) {
+        if (minMaxStarted)
+            return min(minimumPoint.index, maximumPoint.index);
+    }
+    else {
+        for (const Bucket & bucket : pendingBuckets) {
+            if (!bucket.points.empty())
+                return bucket.points.front().index;
+        }
+    }
+
+    return nextIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SeriesDownsampler::addLttbPoint(const Point & point) {
+    if (!anchorSelected) {
+        anchor = point;
+        anchorSelected = true;
+        selectedIndices.push_back(point.index);
+        return;
+    }
+
+    //
+    // The points between the first and the last point of the series are divided evenly into the buckets
+    //
+    size_t interiorCount = pointCount - 2;
+    size_t bucketCount = targetCount - 2;
+    size_t interiorIndex = point.index == 0 ? 0 : min(point.index - 1, interiorCount - 1);
+    size_t bucketNumber = (interiorIndex * bucketCount) / interiorCount;
+
+    if (pendingBuckets.empty() || pendingBuckets.back().bucketNumber != bucketNumber) {
+        //
+        // A point in a third bucket means that the bucket after the oldest bucket is complete, so the oldest bucket can be decided
+        //
+        if (pendingBuckets.size() == 2) {
+            const Bucket & next = pendingBuckets[1];
+            selectLttbPoint(pendingBuckets[0], next.sumX / next.points.size(), next.sumY / next.points.size());
+            pendingBuckets.erase(pendingBuckets.begin());
+        }
+
+        pendingBuckets.push_back(Bucket{bucketNumber, {}, 0.0, 0.0});
+    }
+
+    Bucket & bucket = pendingBuckets.back();
+    bucket.points.push_back(point);
+    bucket.sumX += point.x;
+    bucket.sumY += point.y;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SeriesDownsampler::selectLttbPoint(const Bucket & bucket, double nextX, double nextY) {
+    if (bucket.points.empty())
+        return;
+
+    const Point * selected = &bucket.points[0];
+    double largestArea = -1.0;
+    for (const Point & point : bucket.points) {
+        double area = fabs(((anchor.x - nextX) * (point.y - anchor.y)) - ((anchor.x - point.x) * (nextY - anchor.y)));
+        if (area > largestArea) {
+            largestArea = area;
+            selected = &point;
+        }
+    }
+
+    anchor = *selected;
+    selectedIndices.push_back(selected->index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SeriesDownsampler::addMinMaxPoint(const Point & point) {
+    size_t bucketCount = targetCount / 2;
+    size_t bucketNumber = (point.index * bucketCount) / pointCount;
+
+    if (minMaxStarted && bucketNumber != minMaxBucket)
+        selectMinMaxPoints();
+
+    if (!minMaxStarted) {
+        minMaxStarted = true;
+        minMaxBucket = bucketNumber;
+        minimumPoint = point;
+        maximumPoint = point;
+        return;
+    }
+
+    if (point.y < minimumPoint.y)
+        minimumPoint = point;
+
+    if (point.y > maximumPoint.y)
+        maximumPoint = point;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SeriesDownsampler::selectMinMaxPoints() {
+    if (minimumPoint.index == maximumPoint.index)
+        selectedIndices.push_back(minimumPoint.index);
+    else {
+        selectedIndices.push_back(min(minimumPoint.index, maximumPoint.index));
+        selectedIndices.push_back(max(minimumPoint.index, maximumPoint.index));
+    }
+
+    minMaxStarted = false;
+}
+
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2025 Bruce Beisel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SERIES_DOWNSAMPLER_H
+#define SERIES_DOWNSAMPLER_H
+
+#include <string>
+#include <vector>
+
+#include "Measurement.h"
+
+namespace vws {
+
+/**
+ * Select a bounded number of points from a series so that a graph of the selected points looks like a graph of
+ * the entire series. The points are added one at a time in order and only the points of the buckets that have not
+ * been decided yet are kept, so the series itself is never materialized. The result is the indices of the
+ * selected points in increasing order, which the caller uses to output the records of those points.
+ *
+ * Two methods are supported:
+ *     Largest-Triangle-Three-Buckets: The first and last points are always selected. The remaining points are divided
+ *                                     into (target - 2) buckets and the point of each bucket that forms the largest
+ *                                     triangle with the previously selected point and the average of the next bucket is selected.
+ *     Min-Max:                        The points are divided into (target / 2) buckets and the minimum and maximum
+ *                                     points of each bucket are selected.
+ *
+ * Points whose value is not valid are never selected. If the series does not have more points than the target, every point is selected.
+ */
+class SeriesDownsampler {
+public:
+    enum class Method {
+        LTTB,
+        MIN_MAX
+    };
+
+    /**
+     * Convert the name of a downsample method to the method.
+     *
+     * @param [in]  name   The name of the method, "lttb" or "min-max"
+     * @param [out] method The method if the name is known
+     * @return True if the name is known
+     */
+    static bool parseMethod(const std::string & name, Method & method);
+
+    /**
+     * Constructor.
+     *
+     * @param method      The downsample method
+     * @param pointCount  The number of points that will be added to the series
+     * @param targetCount The maximum number of points to select
+     */
+    SeriesDownsampler(Method method, size_t pointCount, size_t targetCount);
+
+    /**
+     * Add the next point of the series.
+     *
+     * @param index The index of the point, which must be one more than the index of the previous point
+     * @param x     The X coordinate of the point, which must not decrease
+     * @param y     The value of the point
+     */
+    void addPoint(size_t index, double x, const Measurement<double> & y);
+
+    /**
+     * Finish the series after the last point has been added and decide the remaining buckets.
+     */
+    void finish();
+
+    /**
+     * Get the indices of the selected points.
+     *
+     * @return The indices of the selected points in increasing order
+     */
+    const std::vector<size_t> & getSelectedIndices() const;
+
+    /**
+     * Get the index of the oldest point that may still be selected. A point before this index that has not been
+     * selected never will be, so a caller that is streaming a series can release the records of those points.
+     *
+     * @return The index of the oldest undecided point or the index of the next point if every point has been decided
+     */
+    size_t getFirstUndecidedIndex() const;
+
+private:
+    struct Point {
+        size_t index;
+        double x;
+        double y;
+    };
+
+    struct Bucket {
+        size_t             bucketNumber;  // The number of the bucket within the series
+        std::vector<Point> points;        // The valid points of the bucket
+        double             sumX;          // The sum of the X coordinates of the points
+        double             sumY;          // The sum of the values of the points
+    };
+
+    /**
+     * Add a valid point to the Largest-Triangle-Three-Buckets buckets, deciding the oldest bucket if this point
+     * completes the bucket after it.
+     *
+     * @param point The point
+     */
+    void addLttbPoint(const Point & point);
+
+    /**
+     * Select the point of a bucket that forms the largest triangle with the anchor point and the specified point.
+     *
+     * @param bucket The bucket from which a point is selected
+     * @param nextX  The X coordinate of the third point of the triangle
+     * @param nextY  The Y coordinate of the third point of the triangle
+     */
+    void selectLttbPoint(const Bucket & bucket, double nextX, double nextY);
+
+    /**
+     * Add a valid point to the current min-max bucket, selecting the minimum and maximum of the previous bucket
+     * if this point starts a new bucket.
+     *
+     * @param point The point
+     */
+    void addMinMaxPoint(const Point & point);
+
+    /**
+     * Select the minimum and maximum points of the current min-max bucket.
+     */
+    void selectMinMaxPoints();
+
+    Method              method;           // The downsample method
+    size_t              pointCount;       // The number of points in the series
+    size_t              targetCount;      // The maximum number of points to select
+    size_t              nextIndex;        // The index of the point after the most recently added point
+    bool                selectAll;        // Whether every point is selected because the series is not longer than the target
+    std::vector<size_t> selectedIndices;  // The indices of the selected points
+    bool                anchorSelected;   // Whether the first valid point has been selected
+    Point               anchor;           // The most recently selected point
+    std::vector<Bucket> pendingBuckets;   // The Largest-Triangle-Three-Buckets buckets that have not been decided, at most two
+    bool                minMaxStarted;    // Whether the current min-max bucket has a point
+    size_t              minMaxBucket;     // The number of the current min-max bucket
+    Point               minimumPoint;     // The minimum point of the current min-max bucket
+    Point               maximumPoint;     // The maximum point of the current min-max bucket
+};
+
+}
+
+#endif
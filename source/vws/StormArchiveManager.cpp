@@ -78,8 +78,8 @@ StormArchiveManager::validateArchive(fstream & stream) const {
 ////////////////////////////////////////////////////////////////////////////////
 void
 StormArchiveManager::updateArchive() {
-    std::lock_guard<std::mutex> guard(mutex);
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Updating storm archive file at " << stormArchiveFilename << endl;
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Updating storm archive file at " << stormArchiveFilename << endl;
 
     fstream stream;
     stream.open(stormArchiveFilename.c_str(), ios::in | ios::out | ios::app);
@@ -97,7 +97,7 @@ StormArchiveManager::updateArchive() {
         return;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Read " << stormData.size() << " storm records from EEPROM" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Read " << stormData.size() << " storm records from EEPROM" << endl;
 
     StormData lastRecord;
     DateTimeFields lastRecordTime;
@@ -108,7 +108,7 @@ StormArchiveManager::updateArchive() {
 
         if (readRecord(stream, lastRecord)) {
             lastRecordTime = lastRecord.getStormEnd();
-            logger.log(VantageLogger::VANTAGE_DEBUG2) << "Last storm record time " << lastRecordTime.formatDate() << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Last storm record time " << lastRecordTime.formatDate() << endl;
         }
         else {
             //
@@ -124,7 +124,7 @@ StormArchiveManager::updateArchive() {
         // Only store new storms and storms that are not in progress (stormEnd == 0)
         //
         if (record.getStormStart() > lastRecordTime && record.getStormEnd().isDateTimeValid()) {
-            logger.log(VantageLogger::VANTAGE_DEBUG2) << "Writing storm record with start time " << record.getStormStart().formatDate() << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Writing storm record with start time " << record.getStormStart().formatDate() << endl;
             writeRecord(stream, record);
         }
     }
@@ -136,7 +136,7 @@ StormArchiveManager::updateArchive() {
 ////////////////////////////////////////////////////////////////////////////////
 DateTimeFields
 StormArchiveManager::queryStorms(const DateTimeFields & start, const DateTimeFields & end, std::vector<StormData> & list) const {
-    std::lock_guard<std::mutex> guard(mutex);
+    std::shared_lock<std::shared_mutex> guard(mutex);
     list.clear();
     DateTimeFields lastRecordTime;
 
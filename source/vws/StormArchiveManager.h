@@ -20,7 +20,7 @@
 #include <string>
 #include <fstream>
 #include <vector>
-#include <mutex>
+#include <shared_mutex>
 #include "Weather.h"
 #include "StormData.h"
 
@@ -104,7 +104,7 @@ private:
 
     std::string          stormArchiveFilename;
     GraphDataRetriever & dataRetriever;
-    mutable std::mutex   mutex;
+    mutable std::shared_mutex mutex;
     VantageLogger &      logger;
 };
 
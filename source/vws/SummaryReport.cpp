@@ -19,6 +19,7 @@
 #include <sstream>
 #include "ArchivePacket.h"
 #include "ArchiveManager.h"
+#include "DaySummaryStore.h"
 #include "WindRoseData.h"
 #include "VantageEnums.h"
 #include "VantageLogger.h"
@@ -126,6 +127,47 @@ SummaryRecord::applyArchivePacket(const ArchivePacket & archivePacket) {
         soilMoistures[i].applyMeasurement(packetTime, archivePacket.getSoilMoisture(i));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SummaryRecord::applySummaryRecord(const SummaryRecord & summary) {
+    if (summary.startDate < startDate || summary.endDate > endDate || summary.packetCount == 0)
+        return;
+
+    packetCount += summary.packetCount;
+    totalRainfall += summary.totalRainfall;
+
+    outsideTemperature.applySummaryMeasurement(summary.outsideTemperature);
+    outsideHumidity.applySummaryMeasurement(summary.outsideHumidity);
+    solarRadiation.applySummaryMeasurement(summary.solarRadiation);
+    insideTemperature.applySummaryMeasurement(summary.insideTemperature);
+    rainfallRate.applySummaryMeasurement(summary.rainfallRate);
+    barometer.applySummaryMeasurement(summary.barometer);
+    insideHumidity.applySummaryMeasurement(summary.insideHumidity);
+    sustainedWindSpeed.applySummaryMeasurement(summary.sustainedWindSpeed);
+    gustWindSpeed.applySummaryMeasurement(summary.gustWindSpeed);
+    uvIndex.applySummaryMeasurement(summary.uvIndex);
+    et.applySummaryMeasurement(summary.et);
+
+    for (int i = 0; i < ArchivePacket::MAX_EXTRA_TEMPERATURES; i++)
+        extraTemperatures[i].applySummaryMeasurement(summary.extraTemperatures[i]);
+
+    for (int i = 0; i < ArchivePacket::MAX_EXTRA_HUMIDITIES; i++)
+        extraHumidities[i].applySummaryMeasurement(summary.extraHumidities[i]);
+
+    for (int i = 0; i < ArchivePacket::MAX_LEAF_TEMPERATURES; i++)
+        leafTemperatures[i].applySummaryMeasurement(summary.leafTemperatures[i]);
+
+    for (int i = 0; i < ArchivePacket::MAX_SOIL_TEMPERATURES; i++)
+        soilTemperatures[i].applySummaryMeasurement(summary.soilTemperatures[i]);
+
+    for (int i = 0; i < ArchivePacket::MAX_LEAF_WETNESSES; i++)
+        leafWetnesses[i].applySummaryMeasurement(summary.leafWetnesses[i]);
+
+    for (int i = 0; i < ArchivePacket::MAX_SOIL_MOISTURES; i++)
+        soilMoistures[i].applySummaryMeasurement(summary.soilMoistures[i]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
@@ -223,6 +265,58 @@ SummaryRecord::formatJSON() const {
     return ss.str();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+SummaryRecordSweep::SummaryRecordSweep(std::vector<SummaryRecord> & records) : records(records), cursor(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+SummaryRecord *
+SummaryRecordSweep::findRecord(DateTime time) {
+    if (records.empty())
+        return NULL;
+
+    while (cursor > 0 && time < records[cursor].startDate)
+        cursor--;
+
+    while (cursor < records.size() - 1 && time > records[cursor].endDate)
+        cursor++;
+
+    SummaryRecord & record = records[cursor];
+    if (time < record.startDate || time > record.endDate)
+        return NULL;
+    else
+        return &record;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SummaryRecordSweep::applyArchivePacket(const ArchivePacket & archivePacket) {
+    SummaryRecord * record = findRecord(archivePacket.getEpochDateTime());
+    if (record != NULL)
+        record->applyArchivePacket(archivePacket);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SummaryRecordSweep::applySummaryRecord(const SummaryRecord & summary) {
+    SummaryRecord * record = findRecord(summary.startDate);
+    if (record != NULL)
+        record->applySummaryRecord(summary);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SummaryRecordSweep::applyDaySummaryRecord(const SummaryRecord & daySummary) {
+    SummaryRecord * record = findRecord(daySummary.startDate);
+    if (record != NULL)
+        record->applyDaySummaryRecord(daySummary);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 SummaryReport::SummaryReport(SummaryPeriod period,
@@ -441,73 +535,91 @@ SummaryReport::incrementStartTime(DateTime time, SummaryPeriod period) {
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+SummaryReport::createSummaryRecords(SummaryPeriod period, DateTime startTime, DateTime endTime, std::vector<SummaryRecord> & records) {
+    DateTime summaryStart = startTime;
+    DateTime summaryEnd = calculateEndTime(summaryStart, period);
+
+    while (summaryEnd <= endTime) {
+        // TODO Should we create a new record if the summary start date is after today or
+        // before the start of the data archive?
+        SummaryRecord record(period, summaryStart, summaryEnd);
+        records.push_back(record);
+
+        summaryStart = incrementStartTime(summaryStart, period);
+        summaryEnd = calculateEndTime(summaryStart, period);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
 SummaryReport::loadData() {
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Loading data for summary report..." << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Loading data for summary report..." << endl;
 
-    vector<ArchivePacket> packets;
     DateTimeFields startDateTime;
     DateTimeFields endDateTime;
     startDateTime.setFromEpoch(startDate);
     endDateTime.setFromEpoch(endDate);
-    DateTimeFields lastRecordDate = archiveManager.queryArchiveRecords(startDateTime, endDateTime, packets);
 
-    if (!lastRecordDate.isDateTimeValid()) {
-        logger.log(VantageLogger::VANTAGE_INFO) << "Failed to read archive for summary report" << endl;
-        return false;
-    }
+    summaryRecords.clear();
+    createSummaryRecords(period, startDate, endDate, summaryRecords);
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Summary report received " << packets.size() << " packets from the archive" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Created " << summaryRecords.size() << " summary records" << endl;
 
-    summaryRecords.clear();
+    //
+    // Now build the summary records for calculating day-based statistics
+    //
+    vector<SummaryRecord> dayRecords;
+    createSummaryRecords(SummaryPeriod::DAY, startDate, endDate, dayRecords);
 
-    DateTime summaryStart = startDate;
-    DateTime summaryEnd = calculateEndTime(summaryStart, period);
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Created " << dayRecords.size() << " day summary records" << endl;
 
-    while (summaryEnd <= endDate) {
-        // TODO Should we create a new record if the summary start date is after today or
-        // before the start of the data archive?
-        SummaryRecord record(period, summaryStart, summaryEnd);
-        summaryRecords.push_back(record);
+    //
+    // Apply the day summaries that the archive manager has rolled up from the archive. The day summaries, the archive
+    // packets and all of the summary records are in time order, so everything is applied with sweeps that only offer
+    // each item to the one summary record that contains it.
+    //
+    vector<DaySummary> daySummaries;
+    DateTimeFields firstUnsummarizedTime = archiveManager.queryDaySummaries(startDateTime, endDateTime, daySummaries);
 
-        summaryStart = incrementStartTime(summaryStart, period);
-        summaryEnd = calculateEndTime(summaryStart, period);
-    }
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Summary report received " << daySummaries.size() << " day summaries from the archive" << endl;
+
+    SummaryRecordSweep daySweep(dayRecords);
+    for (auto & daySummary : daySummaries) {
+        daySweep.applySummaryRecord(daySummary.summaryRecord);
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Created " << summaryRecords.size() << " summary records" << endl;
+        for (int i = 0; i < 24; i++)
+            hourRainfallBuckets[i] += daySummary.hourRainfall[i];
+
+        daySummary.applyWindSamples(windRoseData);
+    }
 
     //
-    // Now build the summary records for calculating day-based statistics
+    // Only the archive packets that are not included in the day summaries, normally the packets of the current day, are
+    // read from the archive
     //
-    vector<SummaryRecord> dayRecords;
-    summaryStart = startDate;
-    summaryEnd = calculateEndTime(summaryStart, SummaryPeriod::DAY);
-    while (summaryEnd <= endDate) {
-        // TODO Should we create a new record if the summary start date is after today?
-        SummaryRecord record(SummaryPeriod::DAY, summaryStart, summaryEnd);
-        dayRecords.push_back(record);
-
-        summaryStart = incrementStartTime(summaryStart, SummaryPeriod::DAY);
-        summaryEnd = calculateEndTime(summaryStart, SummaryPeriod::DAY);
+    vector<ArchivePacket> packets;
+    if (firstUnsummarizedTime.isDateTimeValid() && !(endDateTime < firstUnsummarizedTime)) {
+        DateTimeFields packetStartTime = startDateTime < firstUnsummarizedTime ? firstUnsummarizedTime : startDateTime;
+        archiveManager.queryArchiveRecords(packetStartTime, endDateTime, packets);
+    }
+
+    if (daySummaries.size() == 0 && packets.size() == 0) {
+        logger.log(VantageLogger::VANTAGE_INFO) << "Failed to read archive for summary report" << endl;
+        return false;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG3) << "Created " << dayRecords.size() << " day summary records" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Summary report received " << packets.size() << " packets from the archive" << endl;
 
     //
     // Now that we have created all of the summary records, go through and apply the ArchivePackets
     //
-    bool firstPacket = true;
     for (auto & packet : packets) {
-        for (auto & summaryRecord : summaryRecords) {
-            summaryRecord.applyArchivePacket(packet);
-        }
-
-        for (auto & summaryRecord : dayRecords) {
-            summaryRecord.applyArchivePacket(packet);
-        }
+        daySweep.applyArchivePacket(packet);
 
         DateTime packetTime = packet.getEpochDateTime();
         struct tm tm;
@@ -517,13 +629,16 @@ SummaryReport::loadData() {
     }
 
     //
-    // For any period longer than a day, calculate average day highs and lows
+    // Build the summary records from the day records. For any period longer than a day, also calculate average day highs and lows.
     //
+    SummaryRecordSweep summarySweep(summaryRecords);
+    for (auto & dayRecord : dayRecords)
+        summarySweep.applySummaryRecord(dayRecord);
+
     if (period != SummaryPeriod::DAY) {
-        for (auto & summaryRecord : summaryRecords) {
-            for (auto & dayRecord : dayRecords)
-                summaryRecord.applyDaySummaryRecord(dayRecord);
-        }
+        SummaryRecordSweep daySummarySweep(summaryRecords);
+        for (auto & dayRecord : dayRecords)
+            daySummarySweep.applyDaySummaryRecord(dayRecord);
     }
 
     for (auto & summaryRecord : dayRecords)
@@ -64,6 +64,20 @@ public:
         }
     }
 
+    /**
+     * Combine another average into this average, as if the measurements applied to the other average had been applied to this one.
+     *
+     * @param other The average to combine into this average
+     */
+    void applyAverage(const MeasurementAverage<M> & other) {
+        if (other.sampleCount == 0)
+            return;
+
+        sampleCount += other.sampleCount;
+        sum.setValue(sum.getValue() + other.sum.getValue());
+        average.setValue(sum.getValue() / static_cast<M>(sampleCount));
+    }
+
     /**
      * Format the average value into JSON.
      *
@@ -270,6 +284,20 @@ public:
         }
     }
 
+    /**
+     * Combine another summary measurement that covers a subset of the time of this summary measurement. The result is the same
+     * as if the measurements applied to the other summary measurement had been applied to this one.
+     *
+     * @param other The summary measurement to combine into this summary measurement
+     */
+    void applySummaryMeasurement(const SummaryMeasurement<M,SE> & other) {
+        average.applyAverage(other.average);
+        averageDayHigh.applyAverage(other.averageDayHigh);
+        averageDayLow.applyAverage(other.averageDayLow);
+        high.applyMeasurement(other.high.extremeTime, other.high.extremeValue);
+        low.applyMeasurement(other.low.extremeTime, other.low.extremeValue);
+    }
+
     /**
      * Apply the extreme values for a given day and apply them to the average day high and day low of this measurement.
      *
@@ -349,6 +377,15 @@ public:
      */
     void applyArchivePacket(const ArchivePacket & archivePacket);
 
+    /**
+     * Combine a summary record whose time span falls within the time span of this summary record. The packet count,
+     * rainfall, averages and extremes are combined as if the archive packets applied to the other summary record
+     * had been applied to this summary record.
+     *
+     * @param summary The summary record to combine into this summary record
+     */
+    void applySummaryRecord(const SummaryRecord & summary);
+
     /**
      * Apply a summary record with a period of DAY to a summary record
      *
@@ -397,6 +434,55 @@ public:
     VantageLogger & logger;
 };
 
+/**
+ * Applies time ordered archive packets and summary records to a time ordered list of summary records with adjacent
+ * time spans. A cursor is advanced through the summary records so that each item is only offered to the summary record
+ * whose time span contains it, rather than to every summary record in the list.
+ */
+class SummaryRecordSweep {
+public:
+    /**
+     * Constructor.
+     *
+     * @param records The time ordered summary records to which the items will be applied
+     */
+    explicit SummaryRecordSweep(std::vector<SummaryRecord> & records);
+
+    /**
+     * Apply an archive packet to the summary record whose time span contains the time of the packet.
+     *
+     * @param archivePacket The packet to apply
+     */
+    void applyArchivePacket(const ArchivePacket & archivePacket);
+
+    /**
+     * Combine a summary record into the summary record whose time span contains the time span of the summary record.
+     *
+     * @param summary The summary record to combine
+     */
+    void applySummaryRecord(const SummaryRecord & summary);
+
+    /**
+     * Apply a day summary record to the summary record whose time span contains the day.
+     *
+     * @param daySummary The summary record for a day
+     */
+    void applyDaySummaryRecord(const SummaryRecord & daySummary);
+
+private:
+    /**
+     * Move the cursor to the summary record whose time span contains the specified time. The cursor normally only moves
+     * forward, but it will move backward if the items are not quite in time order, such as when DST ends.
+     *
+     * @param time The time to search for
+     * @return The summary record or NULL if no summary record contains the time
+     */
+    SummaryRecord * findRecord(DateTime time);
+
+    std::vector<SummaryRecord> & records;
+    size_t                       cursor;
+};
+
 /**
  * Statistics
  *
@@ -658,6 +744,16 @@ public:
      */
     std::string formatJSON() const;
 
+    /**
+     * Create the adjacent summary records for each period that ends within a time range.
+     *
+     * @param period    The period of the summary records
+     * @param startTime The start time of the first summary record
+     * @param endTime   The time at or before which the last summary record ends
+     * @param records   The list to which the summary records are added
+     */
+    static void createSummaryRecords(SummaryPeriod period, DateTime startTime, DateTime endTime, std::vector<SummaryRecord> & records);
+
 private:
     static DateTime normalizeStartTime(DateTime time, SummaryPeriod period);
     static DateTime normalizeEndTime(DateTime endTime, SummaryPeriod period);
@@ -17,11 +17,14 @@
 #ifndef VANTAGE_CRC_H
 #define VANTAGE_CRC_H
 
+#include <vector>
+
 #include "WeatherTypes.h"
 
 namespace vws {
 /**
- * Class to calculate and check the CRCs sent over the console's serial port.
+ * Class to calculate and check the CRCs sent over the console's serial port. The CRC is calculated 8 bytes at a time
+ * using tables that are generated at compile time.
  */
 class VantageCRC {
 public:
@@ -43,6 +46,21 @@ public:
      */
     static bool checkCRC(const byte * buffer, int length);
 
+    /**
+     * Check the CRCs of consecutive blocks where each block is followed by its 2 byte CRC, such as the pages of
+     * an archive dump or the records of a packet segment file. Unlike checkCRC(), nothing is logged.
+     *
+     * @param buffer          The buffer containing the blocks
+     * @param dataLength      The length of the data of each block, not including the CRC
+     * @param blockCount      The number of blocks in the buffer
+     * @param failedBlocks    The indices of the blocks whose CRC is not correct
+     * @param littleEndianCRC Whether the CRCs are stored least significant byte first. The console sends the CRC most significant byte first.
+     * @return The number of blocks whose CRC is not correct
+     */
+    static int checkCRCs(const byte * buffer, int dataLength, int blockCount, std::vector<int> & failedBlocks, bool littleEndianCRC = false);
+
+    static constexpr int CRC_LENGTH = 2;
+
 private:
     /**
      * Constructor with no implementation.
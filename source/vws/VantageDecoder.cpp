@@ -37,7 +37,7 @@ VantageLogger * logger = nullptr;
 Measurement<Temperature>
 VantageDecoder::decode16BitTemperature(const byte buffer[], int offset, bool scaleValue) {
     Measurement<Temperature> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
     Temperature scale = 1.0;
 
     if (scaleValue)
@@ -56,7 +56,7 @@ VantageDecoder::decode16BitTemperature(const byte buffer[], int offset, bool sca
 Measurement<Temperature>
 VantageDecoder::decode8BitTemperature(const byte buffer[], int offset) {
     Measurement<Temperature> measurement;
-    uint8 value8 = BitConverter::toUint8(buffer, offset);
+    uint8 value8 = BitConverter::load<uint8>(buffer, offset);
 
     if (value8 != INVALID_8BIT_TEMPERATURE)
         measurement.setValue(static_cast<Temperature>(value8 - TEMPERATURE_8BIT_OFFSET));
@@ -71,7 +71,7 @@ VantageDecoder::decode8BitTemperature(const byte buffer[], int offset) {
 Measurement<Pressure>
 VantageDecoder::decodeBarometricPressure(const byte buffer[], int offset) {
     Measurement<Pressure> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
 
     if (value16 != 0)
         measurement.setValue(static_cast<Pressure>(value16) / BAROMETER_SCALE);
@@ -86,7 +86,7 @@ VantageDecoder::decodeBarometricPressure(const byte buffer[], int offset) {
 Measurement<Humidity>
 VantageDecoder::decodeHumidity(const byte buffer[], int offset) {
     Measurement<Humidity> measurement;
-    uint8 value8 = BitConverter::toUint8(buffer, offset);
+    uint8 value8 = BitConverter::load<uint8>(buffer, offset);
 
     if (value8 != INVALID_HUMIDITY)
         measurement.setValue(static_cast<Humidity>(value8));
@@ -101,7 +101,7 @@ VantageDecoder::decodeHumidity(const byte buffer[], int offset) {
 Measurement<UvIndex>
 VantageDecoder::decodeUvIndex(const byte buffer[], int offset) {
     Measurement<UvIndex> measurement;
-    uint8 value8 = BitConverter::toUint8(buffer, offset);
+    uint8 value8 = BitConverter::load<uint8>(buffer, offset);
 
     if (value8 != INVALID_UV_INDEX)
         measurement.setValue(static_cast<UvIndex>(value8) / UV_INDEX_SCALE);
@@ -116,7 +116,7 @@ VantageDecoder::decodeUvIndex(const byte buffer[], int offset) {
 Measurement<Evapotranspiration>
 VantageDecoder::decodeArchiveET(const byte buffer[], int offset) {
     Measurement<Evapotranspiration> measurement;
-    uint8 value8 = BitConverter::toUint8(buffer, offset);
+    uint8 value8 = BitConverter::load<uint8>(buffer, offset);
 
     if (value8 != INVALID_ET)
         measurement.setValue(static_cast<Evapotranspiration>(value8) / DAY_ET_SCALE);
@@ -131,7 +131,7 @@ VantageDecoder::decodeArchiveET(const byte buffer[], int offset) {
 Measurement<Evapotranspiration>
 VantageDecoder::decodeDayET(const byte buffer[], int offset) {
     Measurement<Evapotranspiration> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
 
     if (value16 != INVALID_ET)
         measurement.setValue(static_cast<Evapotranspiration>(value16) / DAY_ET_SCALE);
@@ -146,7 +146,7 @@ VantageDecoder::decodeDayET(const byte buffer[], int offset) {
 Measurement<Evapotranspiration>
 VantageDecoder::decodeMonthYearET(const byte buffer[], int offset) {
     Measurement<Evapotranspiration> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
 
     if (value16 != INVALID_ET)
         measurement.setValue(static_cast<Evapotranspiration>(value16) / MONTH_YEAR_ET_SCALE);
@@ -161,7 +161,7 @@ VantageDecoder::decodeMonthYearET(const byte buffer[], int offset) {
 Measurement<SolarRadiation>
 VantageDecoder::decodeSolarRadiation(const byte buffer[], int offset) {
     Measurement<SolarRadiation> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
 
     if (value16 != INVALID_SOLAR_RADIATION)
         measurement.setValue(static_cast<SolarRadiation>(value16));
@@ -176,7 +176,7 @@ VantageDecoder::decodeSolarRadiation(const byte buffer[], int offset) {
 Measurement<Speed>
 VantageDecoder::decode8BitWindSpeed(const byte buffer[], int offset) {
     Measurement<Speed> measurement;
-    uint8 value8 = BitConverter::toUint8(buffer, offset);
+    uint8 value8 = BitConverter::load<uint8>(buffer, offset);
 
     if (value8 != INVALID_WIND_SPEED)
         measurement.setValue(static_cast<Speed>(value8));
@@ -191,7 +191,7 @@ VantageDecoder::decode8BitWindSpeed(const byte buffer[], int offset) {
 Measurement<Speed>
 VantageDecoder::decode16BitWindSpeed(const byte buffer[], int offset) {
     Measurement<Speed> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
 
     measurement.setValue(static_cast<Speed>(value16));
 
@@ -203,7 +203,7 @@ VantageDecoder::decode16BitWindSpeed(const byte buffer[], int offset) {
 Measurement<Speed>
 VantageDecoder::decodeAverageWindSpeed(const byte buffer[], int offset) {
     Measurement<Speed> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
 
     if (value16 != INVALID_16BIT_AVG_WIND_SPEED)
         measurement.setValue(static_cast<Speed>(value16) / AVG_WIND_SPEED_SCALE);
@@ -218,7 +218,7 @@ VantageDecoder::decodeAverageWindSpeed(const byte buffer[], int offset) {
 Measurement<HeadingIndex>
 VantageDecoder::decodeWindDirectionIndex(const byte buffer[], int offset) {
     Measurement<HeadingIndex> measurement;
-    HeadingIndex index = BitConverter::toUint8(buffer, offset);
+    HeadingIndex index = BitConverter::load<uint8>(buffer, offset);
 
     if (index != INVALID_WIND_DIRECTION_INDEX)
         measurement.setValue(index);
@@ -233,7 +233,7 @@ VantageDecoder::decodeWindDirectionIndex(const byte buffer[], int offset) {
 Measurement<Heading>
 VantageDecoder::decodeWindDirection(const byte buffer[], int offset) {
     Measurement<Heading> measurement;
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
 
     if (value16 != INVALID_WIND_DIRECTION1 && value16 != INVALID_WIND_DIRECTION2) {
         Heading heading;
@@ -267,7 +267,7 @@ VantageDecoder::decodeStormRain(const byte buffer[], int offset) {
     // Which is correct? Unfortunately, we cannot tell due to the fact that my rain
     // bucket reports in 1/100th of an inch, which yields that same value.
     //
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
     Rainfall rain = static_cast<Rainfall>(value16) * rainCollectorSizeInches;
 
     return rain;
@@ -292,7 +292,7 @@ VantageDecoder::decodeRain(const byte buffer[], int offset) {
     if (!rainCollectorSizeSet)
         logger->log(VantageLogger::VANTAGE_WARNING) << "Decoding rain value before rain collector size has been set. Using .01 inches" << std::endl;
     
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
     Rainfall rain = static_cast<Rainfall>(value16) * rainCollectorSizeInches;
 
     return rain;
@@ -303,7 +303,7 @@ VantageDecoder::decodeRain(const byte buffer[], int offset) {
 DateTimeFields
 VantageDecoder::decodeStormDate(const byte buffer[], int offset) {
     DateTimeFields stormDate;
-    uint16 value16 = BitConverter::toUint16(buffer, offset);
+    uint16 value16 = BitConverter::load<uint16>(buffer, offset);
 
     if (value16 != NO_STORM_ACTIVE_DATE) {
         int year = (value16 & 0x3F) + YEAR_OFFSET;
@@ -320,7 +320,7 @@ VantageDecoder::decodeStormDate(const byte buffer[], int offset) {
 ////////////////////////////////////////////////////////////////////////////////
 float
 VantageDecoder::decodeConsoleBatteryVoltage(const byte buffer[], int offset) {
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
     float consoleBatteryVoltage = static_cast<float>(value16 * 300) / 512.0F / 100.0F;
     return consoleBatteryVoltage;
 }
@@ -330,7 +330,7 @@ VantageDecoder::decodeConsoleBatteryVoltage(const byte buffer[], int offset) {
 Measurement<LeafWetness>
 VantageDecoder::decodeLeafWetness(const byte buffer[], int offset) {
     Measurement<LeafWetness> measurement;
-    uint8 value8 = BitConverter::toUint8(buffer, offset);
+    uint8 value8 = BitConverter::load<uint8>(buffer, offset);
 
     if (value8 != INVALID_LEAF_WETNESS && value8 >= MIN_LEAF_WETNESS_VALUE && value8 <= MAX_LEAF_WETNESS_VALUE)
         measurement.setValue(static_cast<LeafWetness>(value8));
@@ -345,7 +345,7 @@ VantageDecoder::decodeLeafWetness(const byte buffer[], int offset) {
 Measurement<SoilMoisture>
 VantageDecoder::decodeSoilMoisture(const byte buffer[], int offset) {
     Measurement<SoilMoisture> measurement;
-    uint8 value8 = BitConverter::toUint8(buffer, offset);
+    uint8 value8 = BitConverter::load<uint8>(buffer, offset);
 
     if (value8 != INVALID_SOIL_MOISTURE)
         measurement.setValue(static_cast<SoilMoisture>(value8));
@@ -359,7 +359,7 @@ VantageDecoder::decodeSoilMoisture(const byte buffer[], int offset) {
 ////////////////////////////////////////////////////////////////////////////////
 DateTimeFields
 VantageDecoder::decodeTime(const byte buffer[], int offset) {
-    int16 value16 = BitConverter::toInt16(buffer, offset);
+    int16 value16 = BitConverter::load<int16>(buffer, offset);
     int minute = value16 % 100;
     int hour = value16 / 100;
 
@@ -25,6 +25,7 @@
 #include <atomic>
 
 #include "Alarm.h"
+#include "ArchiveDownload.h"
 #include "ArchiveManager.h"
 #include "CommandQueue.h"
 #include "StormArchiveManager.h"
@@ -225,7 +226,7 @@ VantageDriver::mainLoop() {
             //
             if (!connectToConsole()) {
                 logger.log(VantageLogger::VANTAGE_ERROR) << "Not connected to console, trying again" << endl;
-                commandHandler.processNextCommand();
+                commandHandler.processQueuedCommands();
                 sleep(1);
                 continue;
             }
@@ -262,11 +263,11 @@ VantageDriver::mainLoop() {
             }
 
             //
-            // Verify the archive and store the results
-            // TODO This should probably move to the DataCommand thread
+            // Verify the archive and store the results. The verification runs on its own thread so that
+            // it does not delay the reading of the console.
             //
             if (lastArchiveVerifyTime + ARCHIVE_VERIFY_INTERVAL < now) {
-                archiveManager.verifyCurrentArchiveFile();
+                archiveManager.startCurrentArchiveVerification();
                 lastArchiveVerifyTime = now;
             }
 
@@ -276,11 +277,11 @@ VantageDriver::mainLoop() {
             station.currentValuesLoop(LOOP_PACKET_CYCLES);
 
             //
-            // Process the next event that the command handler has received (if any).
-            // Note that the events are expected to come in slowly as the
-            // events are typically human driven.
+            // Process all of the commands that the command handler has received (if any) before the LOOP
+            // is restarted. Commands often arrive in bursts when a user interface is loaded, and each
+            // restart of the LOOP costs a wake up of the console.
             //
-            commandHandler.processNextCommand();
+            commandHandler.processQueuedCommands();
 
             //
             // If the LOOP packet data indicates that a new archive packet is available
@@ -309,21 +310,24 @@ VantageDriver::mainLoop() {
 bool
 VantageDriver::synchronizeArchive() {
     logger.log(VantageLogger::VANTAGE_INFO) << "Synchronizing local archive from Vantage console's archive" << endl;
-    vector<ArchivePacket> list;
     bool result = false;
 
     DateTimeFields oldestRecordTime;
     DateTimeFields newestRecordTime;
     int count;
-    archiveManager.getArchiveRange(oldestRecordTime, newestRecordTime, count);
 
     for (int i = 0; i < SYNC_ARCHIVE_RETRIES && !result; i++) {
-        list.clear();
-        if (station.wakeupStation() && station.dumpAfter(newestRecordTime, list)) {
-            archiveManager.addPacketsToArchive(list);
+        //
+        // The records of the pages received before a failed attempt are already in the archive, so each
+        // attempt only dumps the records after the newest archived record
+        //
+        archiveManager.getArchiveRange(oldestRecordTime, newestRecordTime, count);
+
+        ArchiveDownload download(archiveManager);
+        if (station.wakeupStation() && station.dumpAfter(newestRecordTime, download)) {
             result = true;
-            if (list.size() > 0)
-                logger.log(VantageLogger::VANTAGE_DEBUG1) << "Newest archive packet time after sync is: " << list.at(list.size() - 1).getPacketDateTimeString() << endl;
+            if (download.getRecordsCommitted() > 0)
+                VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Newest archive packet time after sync is: " << download.getNewestRecordTime().formatDateTime() << endl;
             else
                 logger.log(VantageLogger::VANTAGE_INFO) << "No archive records were retrieved from the console during sync" << endl;
         }
@@ -357,8 +361,8 @@ VantageDriver::processLoopPacket(const LoopPacket & packet) {
     bool newArchiveRecordFlag = previousNextRecord != nextRecord;
     bool continueLoopPacketProcessing = !signalCaughtFlag && !commandReceivedFlag && !newArchiveRecordFlag;
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Continue current weather loop (LOOP): " << std::boolalpha << continueLoopPacketProcessing
-                                              << " (Signal Caught: " << signalCaughtFlag << " Command Received: " << commandReceivedFlag << " New Archive Record: " << newArchiveRecordFlag << ")" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Continue current weather loop (LOOP): " << std::boolalpha << continueLoopPacketProcessing
+                                                       << " (Signal Caught: " << signalCaughtFlag << " Command Received: " << commandReceivedFlag << " New Archive Record: " << newArchiveRecordFlag << ")" << endl;
 
     return continueLoopPacketProcessing;
 }
@@ -371,8 +375,8 @@ VantageDriver::processLoop2Packet(const Loop2Packet & packet) {
     bool commandReceivedFlag = commandHandler.isCommandAvailable();
     bool continueLoopPacketProcessing = !signalCaughtFlag && !commandReceivedFlag;
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Continue current weather loop (LOOP2): " << std::boolalpha << continueLoopPacketProcessing
-                                              << " (Signal Caught: " << signalCaughtFlag << " Command Received: " << commandReceivedFlag << ")" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Continue current weather loop (LOOP2): " << std::boolalpha << continueLoopPacketProcessing
+                                                       << " (Signal Caught: " << signalCaughtFlag << " Command Received: " << commandReceivedFlag << ")" << endl;
 
     return continueLoopPacketProcessing;
 }
@@ -17,6 +17,7 @@
 
 #include "VantageLogger.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <iomanip>
 #include <fstream>
@@ -26,7 +27,9 @@
 #include <stdio.h>
 #include <time.h>
 #include <math.h>
+#include <sstream>
 
+#include "LogRecordRing.h"
 #include "Weather.h"
 
 using namespace std;
@@ -43,11 +46,110 @@ string                   VantageLogger::currentLogFile("");
 bool                     VantageLogger::usingFilePattern = false;
 std::mutex               VantageLogger::mutex;
 
+vector<shared_ptr<LogRecordRing>> VantageLogger::rings;
+condition_variable                VantageLogger::writerCondition;
+thread                            VantageLogger::writerThread;
+bool                              VantageLogger::writerRunning = false;
+atomic<bool>                      VantageLogger::writerStopped(false);
+atomic<uint64_t>                  VantageLogger::nextSequence(0);
+atomic<uint64_t>                  VantageLogger::droppedRecords(0);
+uint64_t                          VantageLogger::reportedDroppedRecords = 0;
+uintmax_t                         VantageLogger::currentFileBytes = 0;
+
 const static char *LEVEL_STRINGS[] = {"ERROR  ", "WARNING", "INFO   ", "DEBUG1 ", "DEBUG2 ", "DEBUG3 "};
 
+//
+// Set when the log stream of a thread is destroyed at thread exit, after which the thread writes directly to the log stream
+//
+static thread_local bool threadLogStreamDestroyed = false;
+
+/**
+ * The log stream of a single thread. The stream buffer collects the text of a record, and the record is pushed onto the ring
+ * of the thread when the stream is flushed. The formatted time of the record header is cached for the current second.
+ */
+class VantageLogger::ThreadLogStream : public std::ostream {
+public:
+    ThreadLogStream() : std::ostream(&buffer), ring(registerRing()), cachedSecond(0) {
+        *this << std::boolalpha;
+    }
+
+    virtual ~ThreadLogStream() {
+        buffer.commit();
+        ring->abandon();
+        threadLogStreamDestroyed = true;
+    }
+
+    /**
+     * Start a new record, committing any text of a previous record that was not flushed.
+     *
+     * @param paddedLoggerName The logger name for the header
+     * @param level            The level of the record
+     */
+    void beginRecord(const string & paddedLoggerName, Level level) {
+        buffer.commit();
+
+        chrono::time_point now = std::chrono::system_clock::now();
+        time_t nowSeconds = std::chrono::system_clock::to_time_t(now);
+        int nowMillis = static_cast<int>((std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000).count());
+        if (nowSeconds != cachedSecond) {
+            struct tm tm;
+            Weather::localtime(nowSeconds, tm);
+            strftime(cachedTimeString, sizeof(cachedTimeString), "%Y-%m-%d %H:%M:%S", &tm);
+            cachedSecond = nowSeconds;
+        }
+
+        char header[100];
+        int length = snprintf(header, sizeof(header), ": %s.%03d --- %s --- ", cachedTimeString, nowMillis, LEVEL_STRINGS[level]);
+        buffer.sputn(paddedLoggerName.data(), paddedLoggerName.length());
+        buffer.sputn(header, length);
+    }
+
+    /**
+     * Push the text that has been written to the stream onto the ring of the thread.
+     */
+    void commit() {
+        buffer.commit();
+    }
+
+private:
+    class RecordBuffer : public std::stringbuf {
+    public:
+        explicit RecordBuffer(ThreadLogStream & stream) : stream(stream) {}
+
+        void commit() {
+            if (pptr() == pbase())
+                return;
+
+            string text = std::move(*this).str();
+            str(string());
+            if (!stream.ring->push(nextSequence.fetch_add(1, memory_order_relaxed), text))
+                droppedRecords.fetch_add(1, memory_order_relaxed);
+            else if (stream.ring->size() >= stream.ring->getCapacity() / 2)
+                wakeWriter();
+        }
+
+    protected:
+        virtual int sync() {
+            commit();
+            return 0;
+        }
+
+    private:
+        ThreadLogStream & stream;
+    };
+
+    RecordBuffer                   buffer{*this};
+    shared_ptr<LogRecordRing>      ring;
+    time_t                         cachedSecond;
+    char                           cachedTimeString[32];
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 VantageLogger::VantageLogger(const string & name) : loggerName(name), errnoSave(0) {
+    paddedLoggerName = name;
+    if (paddedLoggerName.length() < LOGGER_NAME_WIDTH)
+        paddedLoggerName.insert(0, LOGGER_NAME_WIDTH - paddedLoggerName.length(), ' ');
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +188,8 @@ VantageLogger::setLogLevel(Level level) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 VantageLogger::setLogStream(std::ostream &stream) {
+    std::lock_guard<std::mutex> guard(mutex);
+    writeRecords();
     loggerStream = &stream;
     maxFileSizeInMb = MAX_FILE_SIZE_INFINITE;
     usingFilePattern = false;
@@ -107,6 +211,8 @@ VantageLogger::buildLogFilename(int sequenceNumber) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 VantageLogger::setLogFileParameters(const std::string & prefix, int maximumFiles, int maxFileSizeMb) {
+    std::lock_guard<std::mutex> guard(mutex);
+    writeRecords();
     int digits = int(log10(maximumFiles) + 1);
     logFilePattern = prefix + "_%0" + std::to_string(digits) + "d.log";
     maxFiles = maximumFiles;
@@ -116,13 +222,6 @@ VantageLogger::setLogFileParameters(const std::string & prefix, int maximumFiles
     openLogFile();
 }
 
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-bool
-VantageLogger::isLogEnabled(Level level) const {
-    return level <= currentLevel;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
@@ -133,6 +232,11 @@ VantageLogger::openLogFile() {
         loggerStream = &cerr;
     }
 
+    std::error_code error;
+    currentFileBytes = filesystem::file_size(currentLogFile, error);
+    if (error)
+        currentFileBytes = 0;
+
     *loggerStream << std::boolalpha;
 }
 
@@ -181,10 +285,7 @@ VantageLogger::checkFileSize() {
     if (!usingFilePattern)
         return;
 
-    auto logFileSize = std::filesystem::file_size(currentLogFile);
-    auto logFileSizeInMb = logFileSize / 1024 / 1024;
-
-    if (logFileSizeInMb >= maxFileSizeInMb)
+    if (currentFileBytes / 1024 / 1024 >= static_cast<uintmax_t>(maxFileSizeInMb))
         advanceLogFile();
 }
 
@@ -192,25 +293,160 @@ VantageLogger::checkFileSize() {
 ////////////////////////////////////////////////////////////////////////////////
 ostream &
 VantageLogger::log(Level level) {
-    std::lock_guard<std::mutex> guard(mutex);
     errnoSave = errno;
+    if (!isLogEnabled(level))
+        return nullStream;
+
+    if (threadLogStreamDestroyed || writerStopped.load(memory_order_acquire))
+        return logDirect(level);
+
+    ThreadLogStream & stream = threadLogStream();
+    stream.beginRecord(paddedLoggerName, level);
+    return stream;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+ostream &
+VantageLogger::logDirect(Level level) {
+    std::lock_guard<std::mutex> guard(mutex);
     char timeString[100];
-    if (isLogEnabled(level)) {
-        checkFileSize();
-        chrono::time_point now = std::chrono::system_clock::now();
-        time_t nowSeconds = std::chrono::system_clock::to_time_t(now);
-        auto nowMillis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-        struct tm tm;
-        Weather::localtime(nowSeconds, tm);
-        strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S", &tm);
-        *loggerStream << setfill(' ') << setw(25) << loggerName << ": " << timeString << "." << setw(3) << setfill('0') << nowMillis.count() << " --- " << LEVEL_STRINGS[level] << " --- ";
-        return *loggerStream;
+    checkFileSize();
+    chrono::time_point now = std::chrono::system_clock::now();
+    time_t nowSeconds = std::chrono::system_clock::to_time_t(now);
+    auto nowMillis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    struct tm tm;
+    Weather::localtime(nowSeconds, tm);
+    strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S", &tm);
+    *loggerStream << paddedLoggerName << ": " << timeString << "." << setw(3) << setfill('0') << nowMillis.count() << " --- " << LEVEL_STRINGS[level] << " --- ";
+    return *loggerStream;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+VantageLogger::ThreadLogStream &
+VantageLogger::threadLogStream() {
+    static thread_local ThreadLogStream stream;
+    return stream;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+shared_ptr<LogRecordRing>
+VantageLogger::registerRing() {
+    std::lock_guard<std::mutex> guard(mutex);
+    shared_ptr<LogRecordRing> ring = make_shared<LogRecordRing>();
+    rings.push_back(ring);
+
+    if (!writerRunning && !writerStopped) {
+        writerRunning = true;
+        writerThread = thread(&VantageLogger::writerMain);
+        atexit(&VantageLogger::stopWriter);
     }
-    else {
-        return nullStream;
+
+    return ring;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageLogger::wakeWriter() {
+    writerCondition.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageLogger::writerMain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (writerRunning) {
+        writerCondition.wait_for(lock, chrono::milliseconds(WRITER_INTERVAL_MILLIS));
+        writeRecords();
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageLogger::stopWriter() {
+    //
+    // The log stream of the main thread has already been destroyed and committed its last record when this runs at exit
+    //
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        writerRunning = false;
+    }
+
+    writerCondition.notify_one();
+    if (writerThread.joinable())
+        writerThread.join();
+
+    std::lock_guard<std::mutex> guard(mutex);
+    writeRecords();
+    writerStopped = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageLogger::flush() {
+    if (!threadLogStreamDestroyed)
+        threadLogStream().commit();
+
+    std::lock_guard<std::mutex> guard(mutex);
+    writeRecords();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+uint64_t
+VantageLogger::getDroppedRecordCount() {
+    return droppedRecords.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageLogger::writeRecords() {
+    vector<LogRecordRing::Record> records;
+
+    for (auto it = rings.begin(); it != rings.end();) {
+        //
+        // The abandoned flag is read first so that the final records of an exiting thread are drained before its ring is discarded
+        //
+        bool abandoned = (*it)->isAbandoned();
+        (*it)->popAll(records);
+        if (abandoned)
+            it = rings.erase(it);
+        else
+            ++it;
+    }
+
+    //
+    // Each ring is in order, the sequence numbers restore the order across the threads
+    //
+    sort(records.begin(), records.end(), [](const LogRecordRing::Record & a, const LogRecordRing::Record & b) { return a.sequence < b.sequence; });
+
+    uint64_t dropped = droppedRecords.load();
+    if (dropped != reportedDroppedRecords) {
+        ostringstream oss;
+        oss << "VantageLogger: " << dropped - reportedDroppedRecords << " log records were dropped because the log writer could not keep up" << endl;
+        records.push_back(LogRecordRing::Record{0, oss.str()});
+        reportedDroppedRecords = dropped;
+    }
+
+    if (records.empty())
+        return;
+
+    for (const LogRecordRing::Record & record : records) {
+        checkFileSize();
+        loggerStream->write(record.text.data(), record.text.length());
+        currentFileBytes += record.text.length();
+    }
+
+    loggerStream->flush();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 std::string
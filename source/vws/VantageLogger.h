@@ -20,11 +20,44 @@
 #include <mutex>
 #include <string>
 #include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//
+// The most verbose log level that is compiled into the program. Release builds can define this as VANTAGE_DEBUG1 or VANTAGE_INFO
+// so that the VANTAGE_LOG() statements of the more verbose levels are removed by the compiler.
+//
+#ifndef VANTAGE_LOG_COMPILED_LEVEL
+#define VANTAGE_LOG_COMPILED_LEVEL VANTAGE_DEBUG3
+#endif
+
+/**
+ * Create a log entry only if the level is enabled. Unlike VantageLogger::log(), the arguments of the << chain are not evaluated
+ * when the level is disabled, and the statement is removed at compile time when the level is more verbose than
+ * VANTAGE_LOG_COMPILED_LEVEL. It is used as a statement in place of a log() call:
+ *
+ *     VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG3) << "Read buffer:" << Weather::dumpBuffer(buffer, length);
+ *
+ * The if/else form keeps an else that follows the statement bound to the caller's if.
+ */
+#define VANTAGE_LOG(logger, level) \
+    if ((level) > vws::VantageLogger::VANTAGE_LOG_COMPILED_LEVEL || !(logger).isLogEnabled(level)) {} else (logger).log(level)
 
 namespace vws {
+class LogRecordRing;
+
 /**
  * Home grown logger class that does not need any 3rd party libraries. It does not have the power of other available loggers, but
  * it is small and functional.
+ *
+ * Each thread formats its log records into its own stream. A record is complete when the stream is flushed, which std::endl does,
+ * and is then pushed onto the lock-free ring of the thread. A background writer thread drains the rings in batches, writes the
+ * records in the order in which they were created and rotates the log files. If a thread logs faster than the writer can keep up
+ * and its ring fills, the records that do not fit are dropped and counted.
  */
 class VantageLogger {
 public:
@@ -71,6 +104,18 @@ public:
      */
     static void setLogFileParameters(const std::string & prefix, int maxFiles, int maxFileSizeMb);
 
+    /**
+     * Write every log record that has been completed but not yet written by the background writer.
+     */
+    static void flush();
+
+    /**
+     * Get the number of log records that were dropped because the ring of the logging thread was full.
+     *
+     * @return The number of dropped records since the program started
+     */
+    static uint64_t getDroppedRecordCount();
+
     /**
      * Destructor.
      */
@@ -82,7 +127,9 @@ public:
      * @param The level
      * @return True if the level is currently enabled
      */
-    bool isLogEnabled(Level level) const;
+    bool isLogEnabled(Level level) const {
+        return level <= currentLevel;
+    }
 
     /**
      * Create a log entry.
@@ -101,8 +148,15 @@ public:
 
 private:
     static const int MAX_FILE_SIZE_INFINITE = -1;
+    static constexpr int WRITER_INTERVAL_MILLIS = 50;
+    static constexpr int LOGGER_NAME_WIDTH = 25;
     typedef std::map<std::string, VantageLogger *> LoggerMap;
 
+    /**
+     * The log stream of a single thread, defined in the implementation file.
+     */
+    class ThreadLogStream;
+
     /**
      * Private constructor, only getLogger() can create a new logger.
      * 
@@ -134,10 +188,52 @@ private:
     static void advanceLogFile();
 
     /**
-     * Check the size of the current log file. If it's too large, close it and open a new one.
+     * Check the number of bytes written to the current log file. If it's too large, close it and open a new one.
      */
     static void checkFileSize();
 
+    /**
+     * Get the log stream of the calling thread, creating it on the first call.
+     *
+     * @return The stream
+     */
+    static ThreadLogStream & threadLogStream();
+
+    /**
+     * Create the ring of a thread and start the writer thread if it is not running.
+     *
+     * @return The ring to which the thread pushes its records
+     */
+    static std::shared_ptr<LogRecordRing> registerRing();
+
+    /**
+     * Wake the writer thread so it drains the rings before its next interval.
+     */
+    static void wakeWriter();
+
+    /**
+     * The main loop of the writer thread.
+     */
+    static void writerMain();
+
+    /**
+     * Stop the writer thread and write the remaining records. Log records created after this are written directly to the log stream.
+     */
+    static void stopWriter();
+
+    /**
+     * Drain the rings and write their records to the log stream. The mutex must be held by the caller.
+     */
+    static void writeRecords();
+
+    /**
+     * Write the header of a log record directly to the log stream, which is used once the writer thread has stopped.
+     *
+     * @param level The level of the log entry
+     * @return The log stream
+     */
+    std::ostream & logDirect(Level level);
+
     /**
      * Collection of loggers, so that only one is create per name.
      */
@@ -163,10 +259,21 @@ private:
     static int         maxFiles;
     static int         maxFileSizeInMb;
     static std::string currentLogFile;
-    static std::mutex  mutex;
+    static std::mutex  mutex;                   // Guards the logger map, the log stream, the file parameters and the rings
+
+    static std::vector<std::shared_ptr<LogRecordRing>> rings;    // The rings of the threads that have logged
+    static std::condition_variable                     writerCondition;
+    static std::thread                                 writerThread;
+    static bool                                        writerRunning;
+    static std::atomic<bool>                           writerStopped;     // Set at exit, after which records are written directly
+    static std::atomic<uint64_t>                       nextSequence;      // The creation order of the records of all threads
+    static std::atomic<uint64_t>                       droppedRecords;
+    static uint64_t                                    reportedDroppedRecords;
+    static uintmax_t                                   currentFileBytes;  // The bytes in the current log file, used for rotation
 
     std::string loggerName;
-    int         errnoSave;  // The value of errno when a log() was called
+    std::string paddedLoggerName;  // The logger name right aligned for the record header
+    int         errnoSave;         // The value of errno when a log() was called
 };
 
 }
@@ -366,7 +366,7 @@ VantageStationNetwork::processLoopPacket(const LoopPacket & packet) {
         firstLoopPacketReceived = true;
         detectSensors(packet);
         console.consoleType = station.getConsoleType();
-        logger.log(VantageLogger::VANTAGE_DEBUG2) << "============== NETWORK ================" << endl << formatConfigurationJSON() << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "============== NETWORK ================" << endl << formatConfigurationJSON() << endl;
     }
 
     return true;
@@ -660,11 +660,11 @@ VantageStationNetwork::retrieveStationInfo() {
             windStationId = i + 1;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG2) << "++++++++ STATION DATA +++++++" << endl
-                                              << "Monitored Station Mask: " << static_cast<int>(monitoredStationMask) << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "++++++++ STATION DATA +++++++" << endl
+                                                       << "Monitored Station Mask: " << static_cast<int>(monitoredStationMask) << endl;
 
     for (int i = 0; i < ProtocolConstants::MAX_STATIONS; i++) {
-        logger.log(VantageLogger::VANTAGE_DEBUG2) << stationList[i] << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << stationList[i] << endl;
     }
 
     return true;
@@ -42,6 +42,7 @@
 #include "VantageLogger.h"
 #include "Weather.h"
 #include "LoopPacketListener.h"
+#include "ArchivePageProcessor.h"
 
 using namespace std;
 
@@ -51,6 +52,15 @@ using namespace ProtocolConstants;
 static constexpr int protectedEepromBytes[] = {0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xa, 0xf, 0x2d};
 static constexpr int NUM_PROTECTED_EEPROM_BYTES = sizeof(protectedEepromBytes) / sizeof(protectedEepromBytes[0]);
 
+//
+// The console updates the graph pointers and the graph data, which include the storm data and the receiver percentages,
+// as it runs. Reads of these regions always go to the console.
+//
+static constexpr unsigned volatileEepromRegions[][2] = {
+    {EepromConstants::EE_GRAPH_POINTERS_ADDRESS, EepromConstants::EE_GRAPH_POINTERS_SIZE},
+    {EepromConstants::EE_GRAPH_DATA_ADDRESS,     EepromConstants::EE_GRAPH_DATA_SIZE}
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 VantageWeatherStation::VantageWeatherStation(SerialPort & serialPort, int apm, Rainfall rcs) :
@@ -59,7 +69,9 @@ VantageWeatherStation::VantageWeatherStation(SerialPort & serialPort, int apm, R
                                                                         consoleType(VANTAGE_PRO_2),
                                                                         rainCollectorSize(rcs),
                                                                         archivingActive(false),
+                                                                        eepromShadowReads(0),
                                                                         logger(VantageLogger::getLogger("VantageWeatherStation")) {
+    memset(eepromShadow, 0, sizeof(eepromShadow));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,7 +100,7 @@ VantageWeatherStation::removeLoopPacketListener(LoopPacketListener & listener) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 VantageWeatherStation::processRainCollectorSizeChange(Rainfall bucketSize) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Received new rain bucket size of " << bucketSize << " inches" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Received new rain bucket size of " << bucketSize << " inches" << endl;
     rainCollectorSize = bucketSize;
 }
 
@@ -96,6 +108,11 @@ VantageWeatherStation::processRainCollectorSizeChange(Rainfall bucketSize) {
 ////////////////////////////////////////////////////////////////////////////////
 void
 VantageWeatherStation::consoleConnected() {
+    //
+    // Load the EEPROM before the other connection monitors retrieve their configuration from it
+    //
+    loadEepromShadow();
+
     ArchivePeriod archivePeriod;
     if (!retrieveArchivePeriod(archivePeriod))
         return;
@@ -107,7 +124,10 @@ VantageWeatherStation::consoleConnected() {
 ////////////////////////////////////////////////////////////////////////////////
 void
 VantageWeatherStation::consoleDisconnected() {
-    // Nothing to do on disconnect
+    //
+    // The EEPROM may be changed at the console while it is disconnected
+    //
+    eepromShadowLoaded.reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -139,7 +159,7 @@ VantageWeatherStation::wakeupStation() {
     bool awake = false;
 
     for (int i = 0; i < WAKEUP_TRIES && !awake; i++) {
-        logger.log(VantageLogger::VantageLogger::VANTAGE_DEBUG1) << "Wake up console attempt " << (i + 1) << " of " << WAKEUP_TRIES << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Wake up console attempt " << (i + 1) << " of " << WAKEUP_TRIES << endl;
         if (!serialPort.write(WAKEUP_COMMAND)) {
             logger.log(VantageLogger::VantageLogger::VANTAGE_WARNING) << "Write to console failed while waking up the console, aborting wake up sequence" << endl;
             return false;
@@ -327,7 +347,7 @@ VantageWeatherStation::currentValuesLoop(int records) {
         return;
 
     for (int i = 0; i < records && !terminateLoop && !resetNeeded; i++) {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Reading LOOP and LOOP2 Packets ---------------------------------" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Reading LOOP and LOOP2 Packets ---------------------------------" << endl;
         //
         // Loop packet comes first
         //
@@ -470,6 +490,68 @@ VantageWeatherStation::dump(vector<ArchivePacket> & list) {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::dumpAfter(const DateTimeFields & time, vector<ArchivePacket> & list) {
+    list.clear();
+
+    int numPages, firstRecord;
+    if (!startDumpAfter(time, numPages, firstRecord))
+        return false;
+
+    if (numPages == 0)
+        return true;
+
+    return readAfterArchivePages(time, list, firstRecord, numPages);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageWeatherStation::dumpAfter(const DateTimeFields & time, ArchivePageProcessor & processor) {
+    int numPages, firstRecord;
+    if (!startDumpAfter(time, numPages, firstRecord))
+        return false;
+
+    processor.beginDump(time, firstRecord, numPages);
+
+    int lastPageSequenceNumber = MAX_ARCHIVE_PAGE_SEQUENCE;
+    bool success = true;
+    for (int i = 0; i < numPages; i++) {
+        if (!receiveArchivePage(lastPageSequenceNumber)) {
+            serialPort.write(DMP_CANCEL_DOWNLOAD); // No need to check write() return as this is an abort sequence
+            success = false;
+            break;
+        }
+
+        //
+        // The processor queues the page for decoding, so the next page is requested without waiting for this
+        // page to be decoded and saved
+        //
+        processor.processArchivePage(buffer);
+
+        if (!serialPort.write(DMP_SEND_NEXT_PAGE)) {
+            success = false;
+            break;
+        }
+    }
+
+    //
+    // The processor finishes with the pages that were received, even if the dump was aborted
+    //
+    processor.endDump(success);
+
+    if (success)
+        logger.log(VantageLogger::VANTAGE_INFO) << "Received " << numPages << " pages from DMPAFT " << time << endl;
+    else {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "DMPAFT " << time << " failed" << endl;
+        wakeupStation();
+    }
+
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageWeatherStation::startDumpAfter(const DateTimeFields & time, int & numPages, int & firstRecord) {
     int year, month, monthDay, hour, minute;
 
     //
@@ -492,7 +574,6 @@ VantageWeatherStation::dumpAfter(const DateTimeFields & time, vector<ArchivePack
 
 
     logger.log(VantageLogger::VANTAGE_INFO) << "Sending DMPAFT " << time << " (Dump After) command" << endl;
-    list.clear();
 
     //
     // First send the dump after command and get an ACK back
@@ -546,14 +627,11 @@ VantageWeatherStation::dumpAfter(const DateTimeFields & time, vector<ArchivePack
         return false;
     }
 
-    int numPages = BitConverter::toInt16(buffer, 0);
-    int firstRecord = BitConverter::toInt16(buffer, 2);
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Dumping " << numPages << " archive pages. First record in page with new data = " << firstRecord << endl;
+    numPages = BitConverter::toInt16(buffer, 0);
+    firstRecord = BitConverter::toInt16(buffer, 2);
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Dumping " << numPages << " archive pages. First record in page with new data = " << firstRecord << endl;
 
-    if (numPages == 0)
-        return true;
-
-    return readAfterArchivePages(time, list, firstRecord, numPages);
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -564,11 +642,11 @@ VantageWeatherStation::calculateLinkQuality(int stationId, int windSampleCount,
 
     LinkQuality linkQuality = calculateLinkQuality(archivePeriodSeconds, stationId, windSampleCount, archiveRecordCount);
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Calculated link quality of " << fixed << setprecision(2) << linkQuality
-                                              << " with station ID=" << stationId
-                                              << " windSampleCount=" << windSampleCount
-                                              << " archivePeriod=" << archivePeriodMinutes
-                                              << " archiveRecordCount=" << archiveRecordCount << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Calculated link quality of " << fixed << setprecision(2) << linkQuality
+                                                       << " with station ID=" << stationId
+                                                       << " windSampleCount=" << windSampleCount
+                                                       << " archivePeriod=" << archivePeriodMinutes
+                                                       << " archiveRecordCount=" << archiveRecordCount << endl;
 
     return linkQuality;
 }
@@ -648,42 +726,104 @@ VantageWeatherStation::eepromReadDataBlock(byte buffer[], size_t bufferSize) {
     if (!serialPort.readBytes(buffer, bufferSize, EEPROM_DATA_BLOCK_SIZE + CRC_BYTES) || !VantageCRC::checkCRC(buffer, EEPROM_DATA_BLOCK_SIZE))
         return false;
 
+    updateEepromShadow(0, buffer, EEPROM_DATA_BLOCK_SIZE);
+
     return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
-VantageWeatherStation::eepromRead(unsigned address, unsigned count) {
-    logger.log(VantageLogger::VANTAGE_INFO) << "Sending EERD (EEPROM Read) command" << endl;
+VantageWeatherStation::loadEepromShadow() {
+    logger.log(VantageLogger::VANTAGE_INFO) << "Loading the EEPROM shadow" << endl;
 
-    ostringstream command;
-    command << READ_EEPROM_CMD << " " << uppercase << hex << address << " " << count << nouppercase;
-    if (!sendOKedCommand(command.str()))
+    if (!eepromReadDataBlock(buffer, sizeof(buffer))) {
+        logger.log(VantageLogger::VANTAGE_WARNING) << "Failed to load the EEPROM shadow, EEPROM reads will go to the console" << endl;
         return false;
+    }
 
-    //
-    // Read four bytes at a time, each read will contain a 2 digit hex code and a <LF><CR> sequence.
-    //
-    for (int i = 0; i < count; i++) {
-        if (serialPort.readBytes(this->buffer, sizeof(this->buffer), EEPROM_READ_LINE_LENGTH) &&
-            this->buffer[EEPROM_READ_LINE_LENGTH - 2] == ProtocolConstants::LINE_FEED &&
-            this->buffer[EEPROM_READ_LINE_LENGTH - 1] == ProtocolConstants::CARRIAGE_RETURN) {
+    return true;
+}
 
-            int value = strtol(this->buffer, nullptr, 16);
-            buffer[i] = value & BitConverter::ONE_BYTE_MASK;
-        }
-        else
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+int
+VantageWeatherStation::getEepromShadowReadCount() const {
+    return eepromShadowReads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageWeatherStation::isEepromAddressVolatile(unsigned address, unsigned count) {
+    for (const unsigned * region : volatileEepromRegions) {
+        if (address < region[0] + region[1] && region[0] < address + count)
+            return true;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageWeatherStation::readEepromShadow(unsigned address, unsigned count, byte output[]) const {
+    if (count == 0 || address + count > EEPROM_DATA_BLOCK_SIZE || isEepromAddressVolatile(address, count))
+        return false;
+
+    for (unsigned i = address; i < address + count; i++) {
+        if (!eepromShadowLoaded.test(i))
             return false;
     }
 
+    memcpy(output, &eepromShadow[address], count);
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageWeatherStation::updateEepromShadow(unsigned address, const byte data[], unsigned count) {
+    if (address + count > EEPROM_DATA_BLOCK_SIZE)
+        return;
+
+    memcpy(&eepromShadow[address], data, count);
+    for (unsigned i = address; i < address + count; i++)
+        eepromShadowLoaded.set(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+void
+VantageWeatherStation::invalidateEepromShadow(unsigned address, unsigned count) {
+    for (unsigned i = address; i < address + count && i < EEPROM_DATA_BLOCK_SIZE; i++)
+        eepromShadowLoaded.reset(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageWeatherStation::eepromRead(unsigned address, unsigned count) {
+    //
+    // The EERD command responds with a separate hex line for each byte, the binary read transfers the same bytes in one block
+    // and is usually served from the EEPROM shadow
+    //
+    return eepromBinaryRead(address, count);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::eepromBinaryRead(unsigned address, unsigned count, char * output) {
+    if (readEepromShadow(address, count, buffer)) {
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Read " << count << " EEPROM bytes at address 0x" << hex << address << dec << " from the shadow" << endl;
+        eepromShadowReads++;
+        if (output != nullptr)
+            memcpy(output, buffer, count);
+
+        return true;
+    }
+
     logger.log(VantageLogger::VANTAGE_INFO) << "Sending EEBRD (EEPROM Binary Read) command" << endl;
 
     ostringstream command;
@@ -695,6 +835,8 @@ VantageWeatherStation::eepromBinaryRead(unsigned address, unsigned count, char *
     if (!serialPort.readBytes(buffer, sizeof(buffer), count + CRC_BYTES) || !VantageCRC::checkCRC(buffer, count))
         return false;
 
+    updateEepromShadow(address, buffer, count);
+
     if (output != nullptr)
         memcpy(output, buffer, count);
 
@@ -726,7 +868,11 @@ VantageWeatherStation::eepromWriteByte(unsigned address, byte value) {
 
     ostringstream command;
     command << WRITE_EEPROM_CMD << " " << hex << address << " " << static_cast<int>(value);
-    return sendOKedCommand(command.str());
+    if (!sendOKedCommand(command.str()))
+        return false;
+
+    updateEepromShadow(address, &value, 1);
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -757,7 +903,14 @@ VantageWeatherStation::eepromBinaryWrite(unsigned address, const byte data[], un
 
     BitConverter::getBytes(crc, writeBuffer, count, CRC_BYTES, false);
 
-    return serialPort.write(writeBuffer, count + CRC_BYTES);
+    //
+    // The console acknowledges the data once the CRC is checked
+    //
+    if (!serialPort.write(writeBuffer, count + CRC_BYTES) || !consumeAck())
+        return false;
+
+    updateEepromShadow(address, data, count);
+    return true;
 }
 
 //
@@ -789,7 +942,7 @@ VantageWeatherStation::updateCalibrationAdjustments(const CalibrationAdjustments
         return false;
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG2) << "Calibration Adjustment buffer: " << Weather::dumpBuffer(buffer, sizeof(buffer)) << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Calibration Adjustment buffer: " << Weather::dumpBuffer(buffer, sizeof(buffer)) << endl;
 
     if (!eepromBinaryWrite(EepromConstants::EE_INSIDE_TEMP_CAL_ADDRESS, buffer, CalibrationAdjustmentsPacket::CALIBRATION_DATA_BLOCK_SIZE))
         return false;
@@ -812,7 +965,14 @@ VantageWeatherStation::updateBarometerReadingAndElevation(Pressure baroReadingIn
     // the proper OK response. Not sure what would be done differently if the NACK was handled
     // specifically.
     //
-    return sendOKedCommand(command.str());
+    if (!sendOKedCommand(command.str()))
+        return false;
+
+    //
+    // The console saves the barometer calibration and the elevation in the EEPROM
+    //
+    invalidateEepromShadow(EepromConstants::EE_BAR_GAIN_ADDRESS, EepromConstants::EE_ELEVATION_ADDRESS + 2 - EepromConstants::EE_BAR_GAIN_ADDRESS);
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -919,7 +1079,11 @@ bool
 VantageWeatherStation::clearAlarmThresholds() {
     logger.log(VantageLogger::VANTAGE_INFO) << "Sending CLRALM (Clear Alarm Thresholds) command" << endl;
 
-    return sendOKedWithDoneCommand(CLEAR_ALARM_THRESHOLDS_CMD);
+    if (!sendOKedWithDoneCommand(CLEAR_ALARM_THRESHOLDS_CMD))
+        return false;
+
+    invalidateEepromShadow(EepromConstants::EE_ALARM_THRESHOLDS_ADDRESS, EepromConstants::EE_ALARM_THRESHOLDS_SIZE);
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1093,16 +1257,16 @@ VantageWeatherStation::updateConsoleTime() {
         DateTime delta = abs(now - currentStationTime.getEpochDateTime());
         logger.log(VantageLogger::VANTAGE_INFO) << "Console time delta to actual time: " << delta << endl;
         if (delta < CONSOLE_TIME_DELTA_THRESHOLD_SECONDS) {
-            logger.log(VantageLogger::VANTAGE_DEBUG1) << "Not setting console time because it is close to actual time" << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Not setting console time because it is close to actual time" << endl;
             return true;
         }
         else if (currentStationTime.getHour() == 1) {
-            logger.log(VantageLogger::VANTAGE_DEBUG1) << "Not setting console time during the 1 AM hour due to possible DST issues. The console time will be checked during the next hour" << endl;
+            VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Not setting console time during the 1 AM hour due to possible DST issues. The console time will be checked during the next hour" << endl;
             return true;
         }
     }
     else {
-        logger.log(VantageLogger::VANTAGE_DEBUG1) << "Not setting console time due to error retrieving the current console time" << endl;
+        VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Not setting console time due to error retrieving the current console time" << endl;
         return false;
     }
 
@@ -1188,6 +1352,7 @@ VantageWeatherStation::updateArchivePeriod(ArchivePeriod period) {
     //
     if (sendOKedCommand(command.str())) {
         archivePeriodMinutes = static_cast<int>(period);
+        invalidateEepromShadow(EepromConstants::EE_ARCHIVE_PERIOD_ADDRESS, 1);
         return true;
     }
     else
@@ -1207,7 +1372,7 @@ VantageWeatherStation::retrieveArchivePeriod(ArchivePeriod & period) {
     period = static_cast<ArchivePeriod>(archivePeriodValue);
     archivePeriodMinutes = archivePeriodValue;
 
-    logger.log(VantageLogger::VantageLogger::VANTAGE_DEBUG1) <<  " Archive Period: " << archivePeriodValue << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) <<  " Archive Period: " << archivePeriodValue << endl;
 
     return true;
 }
@@ -1271,7 +1436,7 @@ VantageWeatherStation::determineIfArchivingIsActive() {
     logger.log(VantageLogger::VANTAGE_INFO) << "Checking if archiving is currently active" << endl;
     archivingActive = false;
 
-    logger.log(VantageLogger::VANTAGE_DEBUG2) << "Archive period for archiving active check is " << archivePeriodMinutes << " minutes" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Archive period for archiving active check is " << archivePeriodMinutes << " minutes" << endl;
 
     //
     // Dump after a time before what should be the last packet in the archive
@@ -1284,14 +1449,17 @@ VantageWeatherStation::determineIfArchivingIsActive() {
     dumpTime.setSecond(0);
 
     vector<ArchivePacket> packets;
-    logger.log(VantageLogger::VANTAGE_DEBUG2) << "Dumping archive after time " << dumpTime << " to see if archive is up to date" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG2) << "Dumping archive after time " << dumpTime << " to see if archive is up to date" << endl;
     dumpAfter(dumpTime, packets);
 
     //
     // If the dump after command returns at least one packet, archiving is active
     //
     archivingActive = packets.size() > 0;
-    logger.log(VantageLogger::VANTAGE_INFO) << "Archiving active: " << boolalpha << archivingActive << ". Last archive packet time: " << packets[0].getPacketDateTimeString() << endl;
+    if (archivingActive)
+        logger.log(VantageLogger::VANTAGE_INFO) << "Archiving active: " << boolalpha << archivingActive << ". Last archive packet time: " << packets[0].getPacketDateTimeString() << endl;
+    else
+        logger.log(VantageLogger::VANTAGE_INFO) << "Archiving active: " << boolalpha << archivingActive << endl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1338,7 +1506,7 @@ VantageWeatherStation::getConsoleType() const {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::readLoopPacket(LoopPacket & loopPacket) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Reading LOOP Packet" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Reading LOOP Packet" << endl;
 
     //
     // Read and decode the LOOP packet
@@ -1349,7 +1517,7 @@ VantageWeatherStation::readLoopPacket(LoopPacket & loopPacket) {
     if (!loopPacket.decodeLoopPacket(buffer))
         return false;
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "LOOP packet read successfully" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "LOOP packet read successfully" << endl;
     return true;
 }
 
@@ -1357,7 +1525,7 @@ VantageWeatherStation::readLoopPacket(LoopPacket & loopPacket) {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::readLoop2Packet(Loop2Packet & loop2Packet) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Reading LOOP2 Packet" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Reading LOOP2 Packet" << endl;
 
     //
     // Read and decode LOOP2 packet
@@ -1368,7 +1536,7 @@ VantageWeatherStation::readLoop2Packet(Loop2Packet & loop2Packet) {
     if (!loop2Packet.decodeLoop2Packet(buffer))
         return false;
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "LOOP2 packet read successfully" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "LOOP2 packet read successfully" << endl;
     return true;
 }
 
@@ -1425,8 +1593,20 @@ VantageWeatherStation::readAfterArchivePages(const DateTimeFields & afterTime, v
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::readNextArchivePage(vector<ArchivePacket> & list, int firstRecordInPageToProcess, const DateTimeFields & newestPacketTime, int & lastPageSequenceNumber) {
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Processing archive page. Newest packet time = " << newestPacketTime << endl;
+
+    if (!receiveArchivePage(lastPageSequenceNumber))
+        return false;
+
+    decodeArchivePage(list, buffer, firstRecordInPageToProcess, newestPacketTime);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+bool
+VantageWeatherStation::receiveArchivePage(int & lastPageSequenceNumber) {
     bool success = true;
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Processing archive page. Newest packet time = " << newestPacketTime << endl;
 
     int expectedPageSequenceValue = lastPageSequenceNumber;
     if (expectedPageSequenceValue == MAX_ARCHIVE_PAGE_SEQUENCE)
@@ -1440,7 +1620,7 @@ VantageWeatherStation::readNextArchivePage(vector<ArchivePacket> & list, int fir
     for (int i = 0; i < ARCHIVE_PAGE_READ_RETRIES; i++) {
         if (serialPort.readBytes(buffer, sizeof(buffer), ARCHIVE_PAGE_SIZE + CRC_BYTES)) {
             if (VantageCRC::checkCRC(buffer, ARCHIVE_PAGE_SIZE)) {
-                int pageSequence = decodeArchivePage(list, buffer, firstRecordInPageToProcess, newestPacketTime);
+                int pageSequence = BitConverter::toUint8(buffer, 0);
                 if (pageSequence == expectedPageSequenceValue) {
                     success = true;
                     lastPageSequenceNumber = pageSequence;
@@ -1480,8 +1660,8 @@ VantageWeatherStation::decodeArchivePage(vector<ArchivePacket> & list, const byt
     // Which page this is in a DMP or DMPAFT command
     //
     int pageSequence = BitConverter::toUint8(buffer, 0);
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Decoding archive page " << pageSequence
-                                              << ". Newest packet time = " << newestPacketTime << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Decoding archive page " << pageSequence
+                                                       << ". Newest packet time = " << newestPacketTime << endl;
 
     //
     // The first record value may not be zero in the case of a dump after command. The first record after the specified time may not be at the
@@ -1505,12 +1685,12 @@ VantageWeatherStation::decodeArchivePage(vector<ArchivePacket> & list, const byt
                 recordCount++;
             }
             else
-                logger.log(VantageLogger::VANTAGE_DEBUG1) << "Skipping archive record " << i << " in page " << pageSequence
-                                                          << " with date " << packet.getPacketDateTimeString() << endl;
+                VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Skipping archive record " << i << " in page " << pageSequence
+                                                                   << " with date " << packet.getPacketDateTimeString() << endl;
         }
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Page " << pageSequence << " contained " << recordCount << " records" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Page " << pageSequence << " contained " << recordCount << " records" << endl;
 
     return pageSequence;
 }
@@ -1519,7 +1699,7 @@ VantageWeatherStation::decodeArchivePage(vector<ArchivePacket> & list, const byt
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::sendOKedCommand(const string & command) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Sending command '" << command << "' that expects an OK response" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Sending command '" << command << "' that expects an OK response" << endl;
     bool success = false;
 
     for (int i = 0; i < COMMAND_RETRIES && !success; i++) {
@@ -1549,7 +1729,7 @@ VantageWeatherStation::sendOKedCommand(const string & command) {
         }
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Command " << command << " status is " << success << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Command " << command << " status is " << success << endl;
     return success;
 }
 
@@ -1557,7 +1737,7 @@ VantageWeatherStation::sendOKedCommand(const string & command) {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::sendOKedWithDoneCommand(const string & command) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Sending command '" << command << "' that expects an OK response followed by DONE" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Sending command '" << command << "' that expects an OK response followed by DONE" << endl;
     bool success = false;
 
     if (!sendOKedCommand(command))
@@ -1569,7 +1749,7 @@ VantageWeatherStation::sendOKedWithDoneCommand(const string & command) {
     // This is acceptable because the console will not respond to any other
     // command until the command that requires the DONE response is complete.
     //
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Waiting for 'DONE' to complete the command" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Waiting for 'DONE' to complete the command" << endl;
     if (!serialPort.readBytes(buffer, sizeof(buffer), DONE_RESPONSE.length(), 60000))
         success = false;
     else if (DONE_RESPONSE != buffer)
@@ -1580,7 +1760,7 @@ VantageWeatherStation::sendOKedWithDoneCommand(const string & command) {
     if (!success)
         wakeupStation();
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Command " << command << " final status is " << success << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Command " << command << " final status is " << success << endl;
     return success;
 }
 
@@ -1588,7 +1768,7 @@ VantageWeatherStation::sendOKedWithDoneCommand(const string & command) {
 ////////////////////////////////////////////////////////////////////////////////
 bool
 VantageWeatherStation::sendAckedCommand(const string & command) {
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Sending command '" << command << "' that expects and ACK response" << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Sending command '" << command << "' that expects and ACK response" << endl;
     bool success = false;
 
     //
@@ -1616,7 +1796,7 @@ VantageWeatherStation::sendAckedCommand(const string & command) {
         }
     }
 
-    logger.log(VantageLogger::VANTAGE_DEBUG1) << "Command " << command << " status is " << success << endl;
+    VANTAGE_LOG(logger, VantageLogger::VANTAGE_DEBUG1) << "Command " << command << " status is " << success << endl;
     return success;
 }
 
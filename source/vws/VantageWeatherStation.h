@@ -18,6 +18,7 @@
 #ifndef VANTAGE_WEATHER_STATION_H
 #define VANTAGE_WEATHER_STATION_H
 
+#include <bitset>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,7 @@ class CalibrationAdjustmentsPacket;
 class SerialPort;
 class VantageLogger;
 class LoopPacketListener;
+class ArchivePageProcessor;
 class ConsoleDiagnosticReport;
 
 struct BarometerCalibrationParameters {
@@ -60,6 +62,9 @@ public:
     using LinkQuality = double;
     static constexpr LinkQuality MAX_LINK_QUALITY = 100.0;
 
+    static constexpr int ARCHIVE_PAGE_SIZE = 265;         // 1 sequence byte, 5 52 byte records (260 bytes) and 4 spare bytes. 1 + 260 + 4 = 265 bytes
+    static constexpr int RECORDS_PER_ARCHIVE_PAGE = 5;    // The number of archive records per archive page
+
     /**
      * Constructor.
      * 
@@ -283,6 +288,18 @@ public:
      */
     bool dumpAfter(const DateTimeFields & time, std::vector<ArchivePacket> & archive);
 
+    /**
+     * Perform a pipelined dump of the archive after the specified time. Each page is passed to the processor as soon as it
+     * is validated and the next page is requested immediately, so the decoding and saving of the pages by the processor
+     * overlaps the reading of the following pages from the serial port.
+     *
+     * @param time      The fields that define the date and time after which to dump
+     * @param processor The processor of the pages that are received
+     *
+     * @return True if every page was received
+     */
+    bool dumpAfter(const DateTimeFields & time, ArchivePageProcessor & processor);
+
     /**
      * Calculate link quality for a given station ID.
      *
@@ -313,7 +330,7 @@ public:
     /////////////////////////////////////////////////////////////////////////////////
 
     /**
-     * Read the entire EEPROM data block.
+     * Read the entire EEPROM data block. The EEPROM shadow is refreshed with the data that is read.
      *
      * @param buffer     The buffer in which to read the EEPROM data
      * @param bufferSize The size of the buffer pointed to by buffer
@@ -322,7 +339,23 @@ public:
     bool eepromReadDataBlock(byte buffer[], size_t bufferSize);
 
     /**
-     * Read part of the EEPROM memory.
+     * Load the EEPROM shadow with a single GETEE command. Reads of the EEPROM that do not overlap a volatile region
+     * (the graph pointers and graph data) are then served from the shadow without a console round trip. The shadow is
+     * updated by the EEPROM writes and by the reads of the volatile regions.
+     *
+     * @return True if the shadow was loaded
+     */
+    bool loadEepromShadow();
+
+    /**
+     * Get the number of EEPROM reads that were served from the shadow.
+     *
+     * @return The number of reads
+     */
+    int getEepromShadowReadCount() const;
+
+    /**
+     * Read part of the EEPROM memory into the station's buffer.
      *
      * @param address The EEPROM address at which the reading will begin
      * @param count   The number of bytes to read
@@ -332,7 +365,7 @@ public:
     bool eepromRead(unsigned address, unsigned count);
 
     /**
-     * Read part of the EEPROM memory.
+     * Read part of the EEPROM memory, from the EEPROM shadow if the bytes are loaded and not volatile.
      *
      * @param address The EEPROM address at which the reading will begin
      * @param count   The number of bytes to read
@@ -621,8 +654,6 @@ private:
     static constexpr int CRC_BYTES = 2;                            // The number of bytes in the CRC
 
     static constexpr int NUM_ARCHIVE_PAGES = 512;         // The total number of pages in the console's memory
-    static constexpr int ARCHIVE_PAGE_SIZE = 265;         // 1 sequence byte, 5 52 byte records (260 bytes) and 4 spare bytes. 1 + 260 + 4 = 265 bytes
-    static constexpr int RECORDS_PER_ARCHIVE_PAGE = 5;    // The number of archive records per archive page
     static constexpr int MAX_ARCHIVE_PAGE_SEQUENCE = 255; // The maximum value for an archive page number, it wraps back to 0 if more pages are dumped
     static constexpr int DUMP_AFTER_RESPONSE_LENGTH = 4;  // The length of the response to the DMPAFT command
     static constexpr int EEPROM_READ_LINE_LENGTH = 4;     // The length of the response to the EEPROM READ command
@@ -683,6 +714,26 @@ private:
      */
     bool readNextArchivePage(std::vector<ArchivePacket> & packets, int firstRecordInPageToProcess, const DateTimeFields & newestPacketTime, int & lastPageSequenceNumber);
 
+    /**
+     * Read the next archive page into the buffer, retrying the read if the CRC check fails.
+     *
+     * @param [in/out] lastPageSequence The page sequence number of the last archive page dumped and returns the page sequence number that was read
+     *
+     * @return True if a page with a valid CRC and the expected page sequence was read
+     */
+    bool receiveArchivePage(int & lastPageSequenceNumber);
+
+    /**
+     * Send the DMPAFT command and the time, then read the size of the dump from the console.
+     *
+     * @param time        The fields that define the date and time after which to dump
+     * @param numPages    The number of pages that the console will dump
+     * @param firstRecord The first record in the first page that is part of the dump
+     *
+     * @return True if the console accepted the command and the dump has started
+     */
+    bool startDumpAfter(const DateTimeFields & time, int & numPages, int & firstRecord);
+
     /**
      * Decode an archive page that contains up to 5 packets.
      *
@@ -750,7 +801,44 @@ private:
      */
     void determineIfArchivingIsActive();
 
+    /**
+     * Check if an EEPROM address range overlaps a region that the console changes as it runs.
+     *
+     * @param address The start of the address range to check
+     * @param count   The number of addresses to be checked
+     * @return True if the range overlaps a volatile region
+     */
+    static bool isEepromAddressVolatile(unsigned address, unsigned count);
+
+    /**
+     * Copy an EEPROM address range from the shadow if every byte of the range is loaded and not volatile.
+     *
+     * @param address The start of the address range
+     * @param count   The number of bytes to copy
+     * @param output  The buffer to which the bytes are copied
+     * @return True if the bytes were copied
+     */
+    bool readEepromShadow(unsigned address, unsigned count, byte output[]) const;
+
+    /**
+     * Save the bytes that were read from or written to the console EEPROM in the shadow.
+     *
+     * @param address The start of the address range
+     * @param data    The bytes of the address range
+     * @param count   The number of bytes
+     */
+    void updateEepromShadow(unsigned address, const byte data[], unsigned count);
+
+    /**
+     * Mark an EEPROM address range of the shadow as not loaded, after a command that changes the EEPROM indirectly.
+     *
+     * @param address The start of the address range
+     * @param count   The number of bytes
+     */
+    void invalidateEepromShadow(unsigned address, unsigned count);
+
     typedef std::vector<LoopPacketListener *> LoopPacketListenerList;
+    typedef std::bitset<EEPROM_DATA_BLOCK_SIZE> EepromByteSet;
 
     SerialPort &               serialPort;               // The serial port object that communicates with the console
     byte                       buffer[BUFFER_SIZE];      // The buffer used for all reads
@@ -759,6 +847,9 @@ private:
     int                        archivePeriodMinutes;     // The number of minutes between archive records
     Rainfall                   rainCollectorSize;        // The amount of rain for each rain bucket tip
     bool                       archivingActive;          // Whether the console is currently archiving
+    byte                       eepromShadow[EEPROM_DATA_BLOCK_SIZE]; // The copy of the console EEPROM
+    EepromByteSet              eepromShadowLoaded;       // Which bytes of the shadow match the console EEPROM
+    int                        eepromShadowReads;        // The number of EEPROM reads served from the shadow
     VantageLogger &            logger;
 
 };
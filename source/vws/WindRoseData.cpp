@@ -51,26 +51,26 @@ WindSlice::~WindSlice() {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-WindSlice::applyWindSample(const Measurement<HeadingIndex> & sampleHeadingIndex, Speed sampleSpeed) {
-    totalSampleCount++;
+WindSlice::applyWindSample(const Measurement<HeadingIndex> & sampleHeadingIndex, Speed sampleSpeed, int sampleCount) {
+    totalSampleCount += sampleCount;
 
     if (sampleSpeed > 0.0)
-        windySampleCount++;
+        windySampleCount += sampleCount;
 
     if (sampleSpeed > 0.0 && headingIndex == sampleHeadingIndex.getValue()) {
-        sliceSampleCount++;
+        sliceSampleCount += sampleCount;
 
         if (sampleSpeed > maxSpeed)
             maxSpeed = sampleSpeed;
 
-        speedSum += sampleSpeed;
+        speedSum += sampleSpeed * sampleCount;
         speedAverage = speedSum / static_cast<Speed>(sliceSampleCount);
 
         double speedBin = ::round(sampleSpeed / speedBinIncrement);
         int speedBinIndex = static_cast<int>(speedBin) - 1;
         speedBinIndex = std::min(speedBinIndex, numSpeedBins - 1);
         speedBinIndex = std::max(speedBinIndex, 0);
-        speedBinSampleCount[speedBinIndex]++;
+        speedBinSampleCount[speedBinIndex] += sampleCount;
 
     }
 
@@ -132,7 +132,7 @@ WindRoseData::~WindRoseData() {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-WindRoseData::applyWindSample(const Measurement<HeadingIndex> & headingIndex, Speed speed) {
+WindRoseData::applyWindSample(const Measurement<HeadingIndex> & headingIndex, Speed speed, int sampleCount) {
     //
     // This is an odd occurrence that should never happen
     //
@@ -141,10 +141,10 @@ WindRoseData::applyWindSample(const Measurement<HeadingIndex> & headingIndex, Sp
         return;
     }
 
-    totalSamples++;
+    totalSamples += sampleCount;
 
     if (speed == 0.0)
-        calmSamples++;
+        calmSamples += sampleCount;
 
     //
     // Convert the speed to the units specified in the constructor. Note that it is assumed that the speed bins
@@ -170,7 +170,7 @@ WindRoseData::applyWindSample(const Measurement<HeadingIndex> & headingIndex, Sp
     }
 
     for (auto & slice : windSlices)
-        slice.applyWindSample(headingIndex, convertedSpeed);
+        slice.applyWindSample(headingIndex, convertedSpeed, sampleCount);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,8 +50,9 @@ public:
      *
      * @param headingIndex The wind direction index that this slice represents: 0 = N, 15 = NNW
      * @param speed        The speed of the wind for this sample
+     * @param sampleCount  The number of identical samples being applied
      */
-    void applyWindSample(const Measurement<HeadingIndex> & headingIndex, Speed speed);
+    void applyWindSample(const Measurement<HeadingIndex> & headingIndex, Speed speed, int sampleCount = 1);
 
     /**
      * Format the wind rose data into JSON.
@@ -106,8 +107,9 @@ public:
      *
      * @param headingIndex The index of the heading of the wind sample: 0 = North, 15 = NNW
      * @param speed        The speed of the wind for this sample
+     * @param sampleCount  The number of identical samples being applied
      */
-    void applyWindSample(const Measurement<HeadingIndex> & headingIndex, Speed speed);
+    void applyWindSample(const Measurement<HeadingIndex> & headingIndex, Speed speed, int sampleCount = 1);
 
     /**
      * Format the wind rose data into JSON.
@@ -86,7 +86,7 @@ sigHandler(int sig) {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 void
-startVWS(const string & dataDirectory, const string & serialPortName, vws::BaudRate baudRate, int socketPort) {
+startVWS(const string & dataDirectory, const string & serialPortName, vws::BaudRate baudRate, int socketPort, int dataCommandWorkers, bool useColumnarArchive, int archiveSyncInterval) {
 
     mainLogger->log(VantageLogger::VANTAGE_INFO) << "+++++++++++++++++++++++++++++++++++++" << endl;
     mainLogger->log(VantageLogger::VANTAGE_INFO) << "+++++++++++++ VWS START +++++++++++++" << endl;
@@ -109,7 +109,7 @@ startVWS(const string & dataDirectory, const string & serialPortName, vws::BaudR
         GraphDataRetriever graphDataRetriever(station);
         StormArchiveManager stormArchiveManager(dataDirectory, graphDataRetriever);
         ConsoleCommandHandler consoleCommandHandler(station, configuration, network, alarmManager);
-        DataCommandHandler dataCommandHandler(archiveManager, stormArchiveManager, currentWeatherManager, alarmManager);
+        DataCommandHandler dataCommandHandler(archiveManager, stormArchiveManager, currentWeatherManager, alarmManager, dataCommandWorkers);
         VantageDriver consoleDriver(station, archiveManager, consoleCommandHandler, stormArchiveManager);
         CommandSocket commandSocket(socketPort);
 
@@ -122,6 +122,14 @@ startVWS(const string & dataDirectory, const string & serialPortName, vws::BaudR
         station.addLoopPacketListener(network);
         station.addLoopPacketListener(consoleDriver);
 
+        if (useColumnarArchive)
+            archiveManager.enableColumnarArchive();
+
+        if (archiveSyncInterval < 0)
+            archiveManager.setDurabilityPolicy(ArchiveManager::DurabilityPolicy::SYNC_NEVER);
+        else if (archiveSyncInterval > 0)
+            archiveManager.setDurabilityPolicy(ArchiveManager::DurabilityPolicy::SYNC_PERIODIC, archiveSyncInterval);
+
         commandSocket.addCommandHandler(dataCommandHandler);
         commandSocket.addCommandHandler(consoleCommandHandler);
 
@@ -202,7 +210,7 @@ startVWS(const string & dataDirectory, const string & serialPortName, vws::BaudR
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
-const char * usage = "Usage: vws -p <weather station serial port> -d <data directory> [-b <baud rate>] [-s <command socket port>] [-v <debug verbosity (0-3, 0 = INFO)>] [-l <log file prefix>]";
+const char * usage = "Usage: vws -p <weather station serial port> -d <data directory> [-b <baud rate>] [-s <command socket port>] [-v <debug verbosity (0-3, 0 = INFO)>] [-l <log file prefix>] [-w <data command worker threads>] [-c (maintain columnar archive)] [-f <archive sync interval in seconds (0 = after every download, -1 = never)>]";
 
 int
 main(int argc, char *argv[]) {
@@ -221,20 +229,31 @@ main(int argc, char *argv[]) {
     VantageLogger::Level debugLevel;
     int debugLevelOption;
     int socketPort = DEFAULT_SOCKET_PORT;
+    int dataCommandWorkers = DataCommandHandler::DEFAULT_WORKER_COUNT;
     vws::BaudRate baudRate = vws::BaudRate::BR_19200;
+    bool useColumnarArchive = false;
+    int archiveSyncInterval = 0;
 
     bool errorFound = false;
     int opt;
-    while ((opt = getopt(argc, argv, "b:d:l:p:s:v:h")) != -1) {
+    while ((opt = getopt(argc, argv, "b:cd:f:l:p:s:v:w:h")) != -1) {
         switch (opt) {
             case 'b':
                 baudRate = vws::BaudRate::findBaudRateBySpeed(atoi(optarg));
                 break;
 
+            case 'c':
+                useColumnarArchive = true;
+                break;
+
             case 'd':
                 dataDirectory = optarg;
                 break;
 
+            case 'f':
+                archiveSyncInterval = atoi(optarg);
+                break;
+
             case 'l':
                 logFilePrefix = optarg;
                 VantageLogger::setLogFileParameters(logFilePrefix, 20, 25); // 20 25 MB files
@@ -278,6 +297,14 @@ main(int argc, char *argv[]) {
                 }
                 break;
 
+            case 'w':
+                dataCommandWorkers = atoi(optarg);
+                if (dataCommandWorkers < 1) {
+                    cerr << "Invalid data command worker thread count. Must be at least 1" << endl;
+                    errorFound = true;
+                }
+                break;
+
             case 'h':
             default:
                 errorFound = true;
@@ -300,5 +327,5 @@ main(int argc, char *argv[]) {
         exit(1);
     }
 
-    startVWS(dataDirectory, serialPortName, baudRate, socketPort);
+    startVWS(dataDirectory, serialPortName, baudRate, socketPort, dataCommandWorkers, useColumnarArchive, archiveSyncInterval);
 }